@@ -0,0 +1,46 @@
+#!/bin/sh
+
+# Sweep the logger benchmark over the logging types and the log sizes.
+# The storage manager binds to one logging type per process, so every
+# configuration gets a run of its own.
+#
+# Usage : logger_sweep.sh [path to the logger binary]
+# (run it from the build directory, e.g. ../scripts/benchmark/logger_sweep.sh)
+
+LOGGER=${1:-./src/logger}
+
+# Logging types (DRAM_NVM = 1, ..., SSD_SSD = 10)
+LOGGING_TYPES=${LOGGING_TYPES:-"1 2 3 4 5 6 7 8 9 10"}
+
+# # of transactions per backend
+TRANSACTIONS=${TRANSACTIONS:-"1000 10000 100000"}
+
+# Wait for the log flush on commit or not
+SYNC_COMMITS=${SYNC_COMMITS:-"1"}
+
+# Extra options passed to every run (e.g. "-b 4 -u 0.5")
+LOGGER_OPTIONS=${LOGGER_OPTIONS:-""}
+
+# Collects the summary line of every run
+RESULTS=${RESULTS:-logger_sweep.summary}
+
+if [ ! -x "$LOGGER" ]; then
+  echo "Missing logger binary :: $LOGGER"
+  exit 1
+fi
+
+rm -f "$RESULTS"
+
+for logging_type in $LOGGING_TYPES; do
+  for sync_commit in $SYNC_COMMITS; do
+    for transactions in $TRANSACTIONS; do
+      echo "logging_type $logging_type sync_commit $sync_commit" \
+           "transactions $transactions"
+      "$LOGGER" -l "$logging_type" -s "$sync_commit" -t "$transactions" \
+                $LOGGER_OPTIONS || exit 1
+
+      # Every run overwrites outputfile.summary
+      cat outputfile.summary >> "$RESULTS"
+    done
+  done
+done
@@ -0,0 +1,248 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// configuration.cpp
+//
+// Identification: benchmark/logger/configuration.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <iomanip>
+#include <sys/stat.h>
+
+#include "backend/benchmark/logger/configuration.h"
+#include "backend/storage/storage_manager.h"
+
+namespace peloton {
+namespace benchmark {
+namespace logger {
+
+void Usage(FILE *out) {
+  fprintf(out,
+          "Command line options : logger <options> \n"
+          "   -h --help              :  Print help message \n"
+          "   -l --logging_type      :  Logging type \n"
+          "   -s --sync_commit       :  Wait for the log flush on commit \n"
+          "   -t --transactions      :  # of transactions per backend \n"
+          "   -b --backend_count     :  # of backends \n"
+          "   -c --column_count      :  # of value columns \n"
+          "   -u --update_ratio      :  Fraction of updates \n"
+          "   -d --log_file_dir      :  Log file dir \n"
+          "   -f --data_file_size    :  Data file size (MB) \n"
+          "   -w --wait_timeout      :  Wait timeout (us) \n");
+  exit(EXIT_FAILURE);
+}
+
+static struct option opts[] = {
+    {"logging_type", optional_argument, NULL, 'l'},
+    {"sync_commit", optional_argument, NULL, 's'},
+    {"transactions", optional_argument, NULL, 't'},
+    {"backend_count", optional_argument, NULL, 'b'},
+    {"column_count", optional_argument, NULL, 'c'},
+    {"update_ratio", optional_argument, NULL, 'u'},
+    {"log_file_dir", optional_argument, NULL, 'd'},
+    {"data_file_size", optional_argument, NULL, 'f'},
+    {"wait_timeout", optional_argument, NULL, 'w'},
+    {NULL, 0, NULL, 0}};
+
+static void ValidateLoggingType(const configuration &state) {
+  if (state.logging_type <= LOGGING_TYPE_INVALID ||
+      state.logging_type > LOGGING_TYPE_SSD_SSD) {
+    std::cout << "Invalid logging_type :: " << state.logging_type
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "logging_type "
+            << " : " << LoggingTypeToString(state.logging_type) << std::endl;
+}
+
+static void ValidateTransactions(const configuration &state) {
+  if (state.transactions <= 0) {
+    std::cout << "Invalid transactions :: " << state.transactions
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "transactions "
+            << " : " << state.transactions << std::endl;
+}
+
+static void ValidateBackendCount(const configuration &state) {
+  if (state.backend_count <= 0) {
+    std::cout << "Invalid backend_count :: " << state.backend_count
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "backend_count "
+            << " : " << state.backend_count << std::endl;
+}
+
+static void ValidateColumnCount(const configuration &state) {
+  if (state.column_count <= 0) {
+    std::cout << "Invalid column_count :: " << state.column_count
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "column_count "
+            << " : " << state.column_count << std::endl;
+}
+
+static void ValidateUpdateRatio(const configuration &state) {
+  if (state.update_ratio < 0 || state.update_ratio > 1) {
+    std::cout << "Invalid update_ratio :: " << state.update_ratio
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "update_ratio "
+            << " : " << state.update_ratio << std::endl;
+}
+
+static void ValidateDataFileSize(const configuration &state) {
+  if (state.data_file_size == 0) {
+    std::cout << "Invalid data_file_size :: " << state.data_file_size
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "data_file_size "
+            << " : " << state.data_file_size << std::endl;
+}
+
+static void ValidateWaitTimeout(const configuration &state) {
+  if (state.wait_timeout < 0) {
+    std::cout << "Invalid wait_timeout :: " << state.wait_timeout
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "wait_timeout "
+            << " : " << state.wait_timeout << std::endl;
+}
+
+static void ValidateLogFileDir(configuration &state) {
+  // Pick the dir of the device the log is written to, unless given
+  if (state.log_file_dir.empty()) {
+    switch (state.logging_type) {
+      case LOGGING_TYPE_DRAM_NVM:
+      case LOGGING_TYPE_NVM_NVM:
+      case LOGGING_TYPE_HDD_NVM:
+      case LOGGING_TYPE_SSD_NVM:
+        state.log_file_dir = NVM_DIR;
+        break;
+
+      case LOGGING_TYPE_DRAM_HDD:
+      case LOGGING_TYPE_NVM_HDD:
+      case LOGGING_TYPE_HDD_HDD:
+        state.log_file_dir = HDD_DIR;
+        break;
+
+      case LOGGING_TYPE_DRAM_SSD:
+      case LOGGING_TYPE_NVM_SSD:
+      case LOGGING_TYPE_SSD_SSD:
+        state.log_file_dir = SSD_DIR;
+        break;
+
+      default:
+        state.log_file_dir = TMP_DIR;
+        break;
+    }
+  }
+
+  // Fallback to tmp if the device is not mounted
+  struct stat log_dir_stat;
+  int status = stat(state.log_file_dir.c_str(), &log_dir_stat);
+  if (status != 0 || S_ISDIR(log_dir_stat.st_mode) == false) {
+    std::cout << "Missing log_file_dir :: " << state.log_file_dir
+              << ", using " << TMP_DIR << std::endl;
+    state.log_file_dir = TMP_DIR;
+  }
+
+  std::cout << std::setw(20) << std::left << "log_file_dir "
+            << " : " << state.log_file_dir << std::endl;
+}
+
+void ParseArguments(int argc, char *argv[], configuration &state) {
+  // Default Values
+  state.logging_type = LOGGING_TYPE_DRAM_NVM;
+  state.sync_commit = false;
+
+  state.transactions = 10000;
+  state.backend_count = 1;
+
+  state.column_count = 10;
+  state.update_ratio = 0.5;
+
+  state.log_file_dir = "";
+  state.data_file_size = 512;
+  state.wait_timeout = 0;
+
+  // Parse args
+  while (1) {
+    int idx = 0;
+    int c = getopt_long(argc, argv, "hl:s:t:b:c:u:d:f:w:", opts, &idx);
+
+    if (c == -1) break;
+
+    switch (c) {
+      case 'l':
+        state.logging_type = (LoggingType)atoi(optarg);
+        break;
+      case 's':
+        state.sync_commit = atoi(optarg);
+        break;
+      case 't':
+        state.transactions = atoi(optarg);
+        break;
+      case 'b':
+        state.backend_count = atoi(optarg);
+        break;
+      case 'c':
+        state.column_count = atoi(optarg);
+        break;
+      case 'u':
+        state.update_ratio = atof(optarg);
+        break;
+      case 'd':
+        state.log_file_dir = optarg;
+        break;
+      case 'f':
+        state.data_file_size = atoi(optarg);
+        break;
+      case 'w':
+        state.wait_timeout = atoi(optarg);
+        break;
+
+      case 'h':
+        Usage(stderr);
+        break;
+
+      default:
+        fprintf(stderr, "\nUnknown option: -%c-\n", c);
+        Usage(stderr);
+    }
+  }
+
+  // Print configuration
+  ValidateLoggingType(state);
+  ValidateTransactions(state);
+  ValidateBackendCount(state);
+  ValidateColumnCount(state);
+  ValidateUpdateRatio(state);
+  ValidateDataFileSize(state);
+  ValidateWaitTimeout(state);
+  ValidateLogFileDir(state);
+
+  std::cout << std::setw(20) << std::left << "sync_commit "
+            << " : " << state.sync_commit << std::endl;
+}
+
+}  // namespace logger
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// configuration.h
+//
+// Identification: benchmark/logger/configuration.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <getopt.h>
+#include <vector>
+#include <sys/time.h>
+#include <iostream>
+
+#include "backend/common/types.h"
+
+namespace peloton {
+namespace benchmark {
+namespace logger {
+
+class configuration {
+ public:
+  LoggingType logging_type;
+
+  // wait for the log to be flushed before a commit returns
+  bool sync_commit;
+
+  // # of transactions run by every backend
+  int transactions;
+
+  // # of backend threads
+  int backend_count;
+
+  // # of value columns, besides the key
+  int column_count;
+
+  // fraction of transactions updating a tuple instead of inserting one
+  double update_ratio;
+
+  // log file dir
+  std::string log_file_dir;
+
+  // size of the pmem file (in MB)
+  size_t data_file_size;
+
+  // frequency with which the frontend logger collects records (in us)
+  int64_t wait_timeout;
+};
+
+void Usage(FILE *out);
+
+void ParseArguments(int argc, char *argv[], configuration &state);
+
+}  // namespace logger
+}  // namespace benchmark
+}  // namespace peloton
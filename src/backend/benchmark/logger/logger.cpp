@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// logger.cpp
+//
+// Identification: benchmark/logger/logger.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <iostream>
+#include <fstream>
+
+#include "backend/benchmark/logger/logger.h"
+#include "backend/benchmark/logger/configuration.h"
+#include "backend/benchmark/logger/workload.h"
+
+//===--------------------------------------------------------------------===//
+// GUC Variables
+//===--------------------------------------------------------------------===//
+
+extern LoggingType peloton_logging_mode;
+
+extern size_t peloton_data_file_size;
+
+extern int64_t peloton_wait_timeout;
+
+namespace peloton {
+namespace benchmark {
+namespace logger {
+
+configuration state;
+
+// Main Entry Point
+void RunBenchmark() {
+  // The storage manager and the loggers pick these up on first use,
+  // so there is one logging mode per run
+  peloton_logging_mode = state.logging_type;
+  peloton_data_file_size = state.data_file_size;
+  peloton_wait_timeout = state.wait_timeout;
+
+  CreateTable();
+
+  LoggingStats stats;
+
+  // Log the workload
+  RunWorkload(stats);
+
+  // Restart from the log
+  RunRecovery(stats);
+
+  WriteOutput(stats);
+}
+
+}  // namespace logger
+}  // namespace benchmark
+}  // namespace peloton
+
+int main(int argc, char **argv) {
+  peloton::benchmark::logger::ParseArguments(
+      argc, argv, peloton::benchmark::logger::state);
+
+  peloton::benchmark::logger::RunBenchmark();
+
+  return 0;
+}
@@ -0,0 +1,25 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// logger.h
+//
+// Identification: benchmark/logger/logger.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "backend/benchmark/logger/configuration.h"
+
+namespace peloton {
+namespace benchmark {
+namespace logger {
+
+extern configuration state;
+
+}  // namespace logger
+}  // namespace benchmark
+}  // namespace peloton
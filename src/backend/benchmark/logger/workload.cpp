@@ -0,0 +1,428 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// workload.cpp
+//
+// Identification: benchmark/logger/workload.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <cstdio>
+#include <sys/stat.h>
+
+#include "backend/benchmark/logger/workload.h"
+#include "backend/bridge/ddl/ddl_database.h"
+#include "backend/catalog/manager.h"
+#include "backend/catalog/schema.h"
+#include "backend/common/logger.h"
+#include "backend/common/pool.h"
+#include "backend/common/value_factory.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/logging/log_manager.h"
+#include "backend/storage/database.h"
+#include "backend/storage/data_table.h"
+#include "backend/storage/table_factory.h"
+#include "backend/storage/tile_group.h"
+#include "backend/storage/tuple.h"
+
+namespace peloton {
+namespace benchmark {
+namespace logger {
+
+#define LOGGER_DATABASE_OID 20000
+#define LOGGER_TABLE_OID 10000
+
+// length of the value columns
+#define FIELD_LENGTH 100
+
+storage::DataTable *user_table = nullptr;
+
+std::ofstream out("outputfile.summary");
+
+//===--------------------------------------------------------------------===//
+// Table
+//===--------------------------------------------------------------------===//
+
+static storage::DataTable *GetUserTable() {
+  std::vector<catalog::Column> columns;
+
+  catalog::Column key(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                      "YCSB_KEY", true);
+  columns.push_back(key);
+
+  for (int col_itr = 0; col_itr < state.column_count; col_itr++) {
+    catalog::Column field(VALUE_TYPE_VARCHAR, FIELD_LENGTH,
+                          "FIELD" + std::to_string(col_itr), false);
+    columns.push_back(field);
+  }
+
+  bool own_schema = true;
+  bool adapt_table = false;
+  return storage::TableFactory::GetDataTable(
+      LOGGER_DATABASE_OID, LOGGER_TABLE_OID, new catalog::Schema(columns),
+      "USERTABLE", DEFAULT_TUPLES_PER_TILEGROUP, own_schema, adapt_table);
+}
+
+void CreateTable() {
+  bridge::DDLDatabase::CreateDatabase(LOGGER_DATABASE_OID);
+
+  auto &manager = catalog::Manager::GetInstance();
+  storage::Database *db = manager.GetDatabaseWithOid(LOGGER_DATABASE_OID);
+
+  user_table = GetUserTable();
+  db->AddTable(user_table);
+}
+
+static void DropTable() {
+  auto &manager = catalog::Manager::GetInstance();
+  storage::Database *db = manager.GetDatabaseWithOid(LOGGER_DATABASE_OID);
+
+  db->DropTableWithOid(LOGGER_TABLE_OID);
+  user_table = nullptr;
+
+  bridge::DDLDatabase::DropDatabase(LOGGER_DATABASE_OID);
+}
+
+static size_t GetTupleCount() {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginReadOnlyTransaction();
+
+  size_t tuple_count = 0;
+  auto tile_group_count = user_table->GetTileGroupCount();
+  for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    auto tile_group = user_table->GetTileGroup(tile_group_itr);
+    tuple_count += tile_group->GetActiveTupleCount(txn->GetTransactionId());
+  }
+
+  txn_manager.EndReadOnlyTransaction();
+
+  return tuple_count;
+}
+
+//===--------------------------------------------------------------------===//
+// Logging
+//===--------------------------------------------------------------------===//
+
+static std::string GetLogFilePath() {
+  std::string file_path = state.log_file_dir;
+
+  // Add a trailing slash to a file path if needed
+  if (!file_path.empty() && file_path.back() != '/') file_path += '/';
+
+  if (IsSimilarToARIES(state.logging_type) == true) {
+    file_path += "aries.log";
+  } else {
+    file_path += "peloton.log";
+  }
+
+  return file_path;
+}
+
+static size_t GetLogFileSize() {
+  struct stat log_stat;
+
+  auto &log_manager = logging::LogManager::GetInstance();
+  if (stat(log_manager.GetLogFileName().c_str(), &log_stat) != 0) {
+    LOG_ERROR("Could not stat the log file");
+    return 0;
+  }
+
+  return log_stat.st_size;
+}
+
+// Bring the frontend logger to LOGGING mode, replaying the log on the way
+static void StartLogging(std::thread &frontend_thread) {
+  auto &log_manager = logging::LogManager::GetInstance();
+
+  frontend_thread =
+      std::thread(&logging::LogManager::StartStandbyMode, &log_manager);
+
+  log_manager.WaitForMode(LOGGING_STATUS_TYPE_STANDBY, true);
+
+  log_manager.StartRecoveryMode();
+
+  log_manager.WaitForMode(LOGGING_STATUS_TYPE_LOGGING, true);
+}
+
+static void EndLogging(std::thread &frontend_thread) {
+  auto &log_manager = logging::LogManager::GetInstance();
+
+  if (log_manager.EndLogging() == false) {
+    LOG_ERROR("Failed to terminate logging thread");
+  }
+
+  frontend_thread.join();
+}
+
+static void LogTupleRecord(LogRecordType log_record_type,
+                           concurrency::Transaction *txn,
+                           ItemPointer insert_location,
+                           ItemPointer delete_location,
+                           storage::Tuple *tuple) {
+  auto &log_manager = logging::LogManager::GetInstance();
+  if (log_manager.IsInLoggingMode() == false) return;
+
+  auto logger = log_manager.GetBackendLogger();
+  auto record = logger->GetTupleRecord(
+      log_record_type, txn->GetTransactionId(), user_table->GetOid(),
+      insert_location, delete_location, tuple, LOGGER_DATABASE_OID);
+  logger->Log(record);
+}
+
+//===--------------------------------------------------------------------===//
+// Transactions
+//===--------------------------------------------------------------------===//
+
+static bool InsertTuple(concurrency::Transaction *txn, storage::Tuple *tuple,
+                        ItemPointer &location) {
+  location = user_table->InsertTuple(txn, tuple);
+  if (location.block == INVALID_OID) {
+    return false;
+  }
+  txn->RecordInsert(location);
+
+  LogTupleRecord(LOGRECORD_TYPE_TUPLE_INSERT, txn, location,
+                 INVALID_ITEMPOINTER, tuple);
+  return true;
+}
+
+static bool UpdateTuple(concurrency::Transaction *txn, storage::Tuple *tuple,
+                        ItemPointer &location) {
+  ItemPointer delete_location = location;
+  if (user_table->DeleteTuple(txn, delete_location) == false) {
+    return false;
+  }
+  txn->RecordDelete(delete_location);
+
+  location = user_table->InsertTuple(txn, tuple);
+  if (location.block == INVALID_OID) {
+    return false;
+  }
+  txn->RecordInsert(location);
+
+  LogTupleRecord(LOGRECORD_TYPE_TUPLE_UPDATE, txn, location, delete_location,
+                 tuple);
+  return true;
+}
+
+struct BackendStats {
+  unsigned long commit_count = 0;
+
+  unsigned long abort_count = 0;
+
+  // # of tuples inserted by committed transactions
+  unsigned long insert_count = 0;
+};
+
+static void RunBackend(oid_t backend_id, BackendStats &stats) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto &log_manager = logging::LogManager::GetInstance();
+
+  std::mt19937_64 generator(backend_id);
+  std::uniform_real_distribution<double> distribution(0, 1);
+
+  // Every transaction writes the whole tuple
+  std::unique_ptr<VarlenPool> pool(new VarlenPool(BACKEND_TYPE_MM));
+  std::unique_ptr<storage::Tuple> tuple(
+      new storage::Tuple(user_table->GetSchema(), true));
+  std::string field(FIELD_LENGTH, 'a' + backend_id % 26);
+  for (int col_itr = 1; col_itr <= state.column_count; col_itr++) {
+    tuple->SetValue(col_itr, ValueFactory::GetStringValue(field, pool.get()),
+                    pool.get());
+  }
+
+  // Latest version of the tuples inserted by this backend
+  std::vector<int> keys;
+  std::vector<ItemPointer> locations;
+
+  for (int txn_itr = 0; txn_itr < state.transactions; txn_itr++) {
+    bool is_update = (locations.empty() == false &&
+                      distribution(generator) < state.update_ratio);
+    size_t offset = is_update ? generator() % locations.size() : 0;
+    int key = is_update ? keys[offset]
+                        : backend_id * state.transactions + txn_itr;
+    ItemPointer location = is_update ? locations[offset] : ItemPointer();
+
+    tuple->SetValue(0, ValueFactory::GetIntegerValue(key), nullptr);
+
+    auto txn = txn_manager.BeginTransaction();
+
+    bool status = is_update ? UpdateTuple(txn, tuple.get(), location)
+                            : InsertTuple(txn, tuple.get(), location);
+
+    if (status == false) {
+      txn->SetResult(Result::RESULT_FAILURE);
+      txn_manager.AbortTransaction();
+      stats.abort_count++;
+      continue;
+    }
+
+    if (txn_manager.CommitTransaction() != Result::RESULT_SUCCESS) {
+      stats.abort_count++;
+      continue;
+    }
+
+    stats.commit_count++;
+    if (is_update) {
+      locations[offset] = location;
+    } else {
+      keys.push_back(key);
+      locations.push_back(location);
+      stats.insert_count++;
+    }
+  }
+
+  // Remove the backend logger after flushing out all the changes
+  if (log_manager.IsInLoggingMode()) {
+    auto logger = log_manager.GetBackendLogger();
+
+    // Wait until frontend logger collects the data
+    logger->WaitForFlushing();
+
+    log_manager.RemoveBackendLogger(logger);
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Benchmark
+//===--------------------------------------------------------------------===//
+
+void RunWorkload(LoggingStats &stats) {
+  auto &log_manager = logging::LogManager::GetInstance();
+
+  // Start from an empty log
+  auto log_file_path = GetLogFilePath();
+  std::remove(log_file_path.c_str());
+
+  log_manager.SetLogFileName(log_file_path);
+  log_manager.SetSyncCommit(state.sync_commit);
+
+  std::thread frontend_thread;
+  StartLogging(frontend_thread);
+
+  auto fsync_count = log_manager.GetFsyncCount();
+
+  std::vector<BackendStats> backend_stats(state.backend_count);
+  std::vector<std::thread> backends;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (int backend_itr = 0; backend_itr < state.backend_count; backend_itr++) {
+    backends.push_back(std::thread(RunBackend, backend_itr,
+                                   std::ref(backend_stats[backend_itr])));
+  }
+
+  for (auto &backend : backends) {
+    backend.join();
+  }
+
+  auto end = std::chrono::steady_clock::now();
+  std::chrono::duration<double> elapsed_seconds = end - start;
+
+  // Flushes whatever is left
+  EndLogging(frontend_thread);
+
+  stats.duration = elapsed_seconds.count();
+  stats.log_file_size = GetLogFileSize();
+  stats.fsync_count = log_manager.GetFsyncCount() - fsync_count;
+
+  for (auto &backend_stat : backend_stats) {
+    stats.commit_count += backend_stat.commit_count;
+    stats.abort_count += backend_stat.abort_count;
+    stats.expected_tuple_count += backend_stat.insert_count;
+  }
+}
+
+void RunRecovery(LoggingStats &stats) {
+  // ARIES rebuilds the table from the log, so the volatile state is wiped
+  // as if the process was restarted. Peloton keeps the table in the data
+  // file and only has to fix up its commit marks.
+  if (IsSimilarToARIES(state.logging_type) == true) {
+    DropTable();
+
+    auto &manager = catalog::Manager::GetInstance();
+    manager.SetNextOid(0);
+    manager.ClearTileGroup();
+
+    auto &txn_manager = concurrency::TransactionManager::GetInstance();
+    txn_manager.ResetStates();
+
+    CreateTable();
+  }
+
+  std::thread frontend_thread;
+
+  auto start = std::chrono::steady_clock::now();
+
+  StartLogging(frontend_thread);
+
+  auto end = std::chrono::steady_clock::now();
+  std::chrono::duration<double, std::milli> elapsed_milliseconds =
+      end - start;
+
+  EndLogging(frontend_thread);
+
+  stats.recovery_duration = elapsed_milliseconds.count();
+  stats.recovered_tuple_count = GetTupleCount();
+}
+
+void WriteOutput(const LoggingStats &stats) {
+  double throughput =
+      (stats.duration > 0) ? stats.commit_count / stats.duration : 0;
+  double log_bytes_per_txn =
+      (stats.commit_count > 0)
+          ? static_cast<double>(stats.log_file_size) / stats.commit_count
+          : 0;
+  double fsyncs_per_txn =
+      (stats.commit_count > 0)
+          ? static_cast<double>(stats.fsync_count) / stats.commit_count
+          : 0;
+
+  std::cout << "----------------------------------------------------------\n";
+  std::cout << state.logging_type << " " << state.sync_commit << " "
+            << state.backend_count << " " << state.transactions << " "
+            << state.update_ratio << " " << state.wait_timeout << " :: ";
+  std::cout << throughput << " txn/s\n";
+
+  std::cout << "commits aborts log_bytes log_bytes/txn fsyncs fsyncs/txn "
+               "recovery_ms recovered_tuples\n";
+  std::cout << stats.commit_count << " " << stats.abort_count << " "
+            << stats.log_file_size << " " << log_bytes_per_txn << " "
+            << stats.fsync_count << " " << fsyncs_per_txn << " "
+            << stats.recovery_duration << " " << stats.recovered_tuple_count
+            << "\n";
+
+  if (stats.recovered_tuple_count != stats.expected_tuple_count) {
+    std::cout << "Recovered " << stats.recovered_tuple_count
+              << " tuples, expected " << stats.expected_tuple_count << "\n";
+  }
+
+  out << state.logging_type << " ";
+  out << state.sync_commit << " ";
+  out << state.backend_count << " ";
+  out << state.transactions << " ";
+  out << state.update_ratio << " ";
+  out << state.wait_timeout << " ";
+  out << throughput << " ";
+  out << log_bytes_per_txn << " ";
+  out << stats.fsync_count << " ";
+  out << stats.recovery_duration << "\n";
+  out.flush();
+}
+
+}  // namespace logger
+}  // namespace benchmark
+}  // namespace peloton
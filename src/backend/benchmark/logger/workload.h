@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// workload.h
+//
+// Identification: benchmark/logger/workload.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "backend/benchmark/logger/configuration.h"
+
+namespace peloton {
+
+namespace storage {
+class DataTable;
+}
+
+namespace benchmark {
+namespace logger {
+
+extern configuration state;
+
+extern storage::DataTable *user_table;
+
+// What a logging run and the recovery of its log cost
+struct LoggingStats {
+  unsigned long commit_count = 0;
+
+  unsigned long abort_count = 0;
+
+  // time spent running the transactions (in seconds)
+  double duration = 0;
+
+  size_t log_file_size = 0;
+
+  size_t fsync_count = 0;
+
+  // time spent replaying the log (in milliseconds)
+  double recovery_duration = 0;
+
+  // # of tuples visible after the recovery
+  size_t recovered_tuple_count = 0;
+
+  // # of tuples that were committed before the restart
+  size_t expected_tuple_count = 0;
+};
+
+void CreateTable();
+
+// Run the transactions with logging on, and then flush the log
+void RunWorkload(LoggingStats &stats);
+
+// Throw away the in-memory state, and rebuild it from the log
+void RunRecovery(LoggingStats &stats);
+
+void WriteOutput(const LoggingStats &stats);
+
+}  // namespace logger
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,160 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// configuration.cpp
+//
+// Identification: benchmark/tpcc/configuration.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <iomanip>
+#include <algorithm>
+
+#include "backend/benchmark/tpcc/configuration.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+void Usage(FILE *out) {
+  fprintf(out,
+          "Command line options : tpcc <options> \n"
+          "   -h --help              :  Print help message \n"
+          "   -w --warehouse_count   :  # of warehouses \n"
+          "   -i --item_count        :  # of items \n"
+          "   -c --customer_count    :  # of customers per district \n"
+          "   -g --tuples_per_tg     :  # of tuples per tilegroup \n"
+          "   -t --transactions      :  # of transactions per backend \n"
+          "   -b --backend_count     :  # of backends \n");
+  exit(EXIT_FAILURE);
+}
+
+static struct option opts[] = {
+    {"warehouse_count", optional_argument, NULL, 'w'},
+    {"item_count", optional_argument, NULL, 'i'},
+    {"customer_count", optional_argument, NULL, 'c'},
+    {"tuples_per_tg", optional_argument, NULL, 'g'},
+    {"transactions", optional_argument, NULL, 't'},
+    {"backend_count", optional_argument, NULL, 'b'},
+    {NULL, 0, NULL, 0}};
+
+static void ValidateWarehouseCount(const configuration &state) {
+  if (state.warehouse_count <= 0) {
+    std::cout << "Invalid warehouse_count :: " << state.warehouse_count
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "warehouse_count "
+            << " : " << state.warehouse_count << std::endl;
+}
+
+static void ValidateItemCount(const configuration &state) {
+  // An order has up to 15 distinct items
+  if (state.item_count < 15) {
+    std::cout << "Invalid item_count :: " << state.item_count << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "item_count "
+            << " : " << state.item_count << std::endl;
+}
+
+static void ValidateCustomerCount(const configuration &state) {
+  // The last 30% of the initial orders are new orders
+  if (state.customer_count < 10) {
+    std::cout << "Invalid customer_count :: " << state.customer_count
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "customer_count "
+            << " : " << state.customer_count << std::endl;
+}
+
+static void ValidateTuplesPerTileGroup(const configuration &state) {
+  if (state.tuples_per_tilegroup <= 0) {
+    std::cout << "Invalid tuples_per_tilegroup :: "
+              << state.tuples_per_tilegroup << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "tuples_per_tgroup "
+            << " : " << state.tuples_per_tilegroup << std::endl;
+}
+
+static void ValidateBackendCount(const configuration &state) {
+  if (state.backend_count <= 0) {
+    std::cout << "Invalid backend_count :: " << state.backend_count
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "backend_count "
+            << " : " << state.backend_count << std::endl;
+}
+
+void ParseArguments(int argc, char *argv[], configuration &state) {
+  // Default Values, the item and customer counts are the ones of the spec
+  state.warehouse_count = 1;
+  state.item_count = 100000;
+  state.customer_count = 3000;
+  state.tuples_per_tilegroup = DEFAULT_TUPLES_PER_TILEGROUP;
+
+  state.transactions = 10000;
+  state.backend_count = 1;
+
+  // Parse args
+  while (1) {
+    int idx = 0;
+    int c = getopt_long(argc, argv, "hw:i:c:g:t:b:", opts, &idx);
+
+    if (c == -1) break;
+
+    switch (c) {
+      case 'w':
+        state.warehouse_count = atoi(optarg);
+        break;
+      case 'i':
+        state.item_count = atoi(optarg);
+        break;
+      case 'c':
+        state.customer_count = atoi(optarg);
+        break;
+      case 'g':
+        state.tuples_per_tilegroup = atoi(optarg);
+        break;
+      case 't':
+        state.transactions = atoi(optarg);
+        break;
+      case 'b':
+        state.backend_count = atoi(optarg);
+        break;
+
+      case 'h':
+        Usage(stderr);
+        break;
+
+      default:
+        fprintf(stderr, "\nUnknown option: -%c-\n", c);
+        Usage(stderr);
+    }
+  }
+
+  // Print configuration
+  ValidateWarehouseCount(state);
+  ValidateItemCount(state);
+  ValidateCustomerCount(state);
+  ValidateTuplesPerTileGroup(state);
+  ValidateBackendCount(state);
+
+  std::cout << std::setw(20) << std::left << "transactions "
+            << " : " << state.transactions << std::endl;
+}
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
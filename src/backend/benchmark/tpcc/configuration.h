@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// configuration.h
+//
+// Identification: benchmark/tpcc/configuration.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <getopt.h>
+#include <vector>
+#include <sys/time.h>
+#include <iostream>
+
+#include "backend/storage/data_table.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+enum TransactionType {
+  TRANSACTION_TYPE_NEW_ORDER = 0,
+  TRANSACTION_TYPE_PAYMENT = 1,
+  TRANSACTION_TYPE_ORDER_STATUS = 2,
+  TRANSACTION_TYPE_DELIVERY = 3,
+  TRANSACTION_TYPE_STOCK_LEVEL = 4,
+
+  TRANSACTION_TYPE_COUNT = 5
+};
+
+class configuration {
+ public:
+  // # of warehouses loaded
+  int warehouse_count;
+
+  // # of items, and of stock rows per warehouse
+  int item_count;
+
+  // # of customers, and of initial orders, per district
+  int customer_count;
+
+  int tuples_per_tilegroup;
+
+  // # of transactions run by every backend
+  unsigned long transactions;
+
+  // # of backend threads
+  int backend_count;
+};
+
+void Usage(FILE *out);
+
+void ParseArguments(int argc, char *argv[], configuration &state);
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
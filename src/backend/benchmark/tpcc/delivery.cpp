@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// delivery.cpp
+//
+// Identification: benchmark/tpcc/delivery.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+#include "backend/benchmark/tpcc/loader.h"
+#include "backend/benchmark/tpcc/workload.h"
+#include "backend/common/value_factory.h"
+#include "backend/common/value_peeker.h"
+#include "backend/concurrency/transaction_manager.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+// Deliveries run inline, rather than being queued and deferred
+bool RunDelivery(const int w_id) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+
+  /////////////////////////////////////////////////////////
+  // INPUT
+  /////////////////////////////////////////////////////////
+
+  const int o_carrier_id = GetRandomInteger(1, 10);
+
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  auto now = GetTimestamp();
+
+  for (int d_id = 1; d_id <= DISTRICTS_PER_WAREHOUSE; d_id++) {
+    /////////////////////////////////////////////////////////
+    // OLDEST NEW ORDER
+    /////////////////////////////////////////////////////////
+
+    auto new_orders = ExecuteRead(context.get(), new_order_table,
+                                  SECONDARY_INDEX_OFFSET,
+                                  {ValueFactory::GetIntegerValue(d_id),
+                                   ValueFactory::GetIntegerValue(w_id)},
+                                  {NO_O_ID});
+    if (txn->GetResult() != Result::RESULT_SUCCESS) {
+      return EndTransaction(txn);
+    }
+
+    // Every order of the district was delivered
+    if (new_orders.empty()) continue;
+
+    int o_id = ValuePeeker::PeekInteger(new_orders[0][0]);
+    for (auto &new_order : new_orders) {
+      o_id = std::min(o_id, ValuePeeker::PeekInteger(new_order[0]));
+    }
+
+    std::vector<Value> order_key = {ValueFactory::GetIntegerValue(o_id),
+                                    ValueFactory::GetIntegerValue(d_id),
+                                    ValueFactory::GetIntegerValue(w_id)};
+
+    if (ExecuteDelete(context.get(), new_order_table, PRIMARY_INDEX_OFFSET,
+                      order_key) == false) {
+      return EndTransaction(txn);
+    }
+
+    /////////////////////////////////////////////////////////
+    // ORDERS AND ORDER_LINE
+    /////////////////////////////////////////////////////////
+
+    std::vector<Value> order;
+    if (ExecuteReadRow(context.get(), orders_table, PRIMARY_INDEX_OFFSET,
+                       order_key, {O_C_ID}, order) == false) {
+      return EndTransaction(txn);
+    }
+    const int c_id = ValuePeeker::PeekInteger(order[0]);
+
+    if (ExecuteUpdate(context.get(), orders_table, PRIMARY_INDEX_OFFSET,
+                      order_key,
+                      {{O_CARRIER_ID,
+                        ValueFactory::GetIntegerValue(o_carrier_id)}}) ==
+        false) {
+      return EndTransaction(txn);
+    }
+
+    auto order_lines =
+        ExecuteRead(context.get(), order_line_table, SECONDARY_INDEX_OFFSET,
+                    order_key, {OL_AMOUNT});
+
+    double amount = 0;
+    for (auto &order_line : order_lines) {
+      amount += ValuePeeker::PeekDouble(order_line[0]);
+    }
+
+    auto delivery_d = ValueFactory::GetTimestampValue(now);
+    if (ExecuteUpdate(context.get(), order_line_table, SECONDARY_INDEX_OFFSET,
+                      order_key, {{OL_DELIVERY_D, delivery_d}}) == false) {
+      return EndTransaction(txn);
+    }
+
+    /////////////////////////////////////////////////////////
+    // CUSTOMER
+    /////////////////////////////////////////////////////////
+
+    std::vector<Value> customer_key = {ValueFactory::GetIntegerValue(c_id),
+                                       ValueFactory::GetIntegerValue(d_id),
+                                       ValueFactory::GetIntegerValue(w_id)};
+    std::vector<Value> customer;
+    if (ExecuteReadRow(context.get(), customer_table, PRIMARY_INDEX_OFFSET,
+                       customer_key, {C_BALANCE, C_DELIVERY_CNT},
+                       customer) == false) {
+      return EndTransaction(txn);
+    }
+
+    const double c_balance = ValuePeeker::PeekDouble(customer[0]) + amount;
+    const int c_delivery_cnt = ValuePeeker::PeekInteger(customer[1]) + 1;
+
+    std::vector<std::pair<oid_t, Value>> customer_updates = {
+        {C_BALANCE, ValueFactory::GetDoubleValue(c_balance)},
+        {C_DELIVERY_CNT, ValueFactory::GetIntegerValue(c_delivery_cnt)}};
+    if (ExecuteUpdate(context.get(), customer_table, PRIMARY_INDEX_OFFSET,
+                      customer_key, customer_updates) == false) {
+      return EndTransaction(txn);
+    }
+  }
+
+  return EndTransaction(txn);
+}
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
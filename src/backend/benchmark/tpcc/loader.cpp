@@ -0,0 +1,684 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// loader.cpp
+//
+// Identification: benchmark/tpcc/loader.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <random>
+#include <cassert>
+
+#include "backend/benchmark/tpcc/loader.h"
+#include "backend/catalog/manager.h"
+#include "backend/catalog/schema.h"
+#include "backend/common/exception.h"
+#include "backend/common/value_factory.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/index/index_factory.h"
+#include "backend/storage/tuple.h"
+#include "backend/storage/data_table.h"
+#include "backend/storage/table_factory.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+storage::DataTable *warehouse_table;
+storage::DataTable *district_table;
+storage::DataTable *customer_table;
+storage::DataTable *history_table;
+storage::DataTable *new_order_table;
+storage::DataTable *orders_table;
+storage::DataTable *order_line_table;
+storage::DataTable *item_table;
+storage::DataTable *stock_table;
+
+#define TPCC_DATABASE_OID 100
+
+// Tuples are handed to the bulk-load path this many at a time
+#define TPCC_LOAD_BATCH_SIZE 1000
+
+//===--------------------------------------------------------------------===//
+// Random Data
+//===--------------------------------------------------------------------===//
+
+// Constants of the non-uniform random generator, the one of C_LAST differs
+// between the load and the run as required by the spec
+#define NURAND_C_LAST_LOAD 157
+#define NURAND_C_LAST_RUN 223
+#define NURAND_C_ID 259
+#define NURAND_OL_I_ID 7911
+
+// The first 1000 customers of a district get all the last names
+#define LAST_NAME_COUNT 1000
+
+static thread_local std::mt19937_64 generator;
+
+void SetRandomSeed(uint64_t seed) { generator.seed(seed); }
+
+int GetRandomInteger(const int lower, const int upper) {
+  std::uniform_int_distribution<int> distribution(lower, upper);
+  return distribution(generator);
+}
+
+double GetRandomDouble(const double lower, const double upper) {
+  std::uniform_real_distribution<double> distribution(lower, upper);
+  return distribution(generator);
+}
+
+static int GetNURand(const int a, const int x, const int y, const int c) {
+  return (((GetRandomInteger(0, a) | GetRandomInteger(x, y)) + c) %
+          (y - x + 1)) +
+         x;
+}
+
+std::string GetRandomAlphaNumericString(const int min_length,
+                                        const int max_length) {
+  static const char alphanumeric[] =
+      "0123456789"
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+      "abcdefghijklmnopqrstuvwxyz";
+
+  int length = GetRandomInteger(min_length, max_length);
+  std::string value(length, ' ');
+  for (int char_itr = 0; char_itr < length; char_itr++) {
+    value[char_itr] = alphanumeric[GetRandomInteger(
+        0, sizeof(alphanumeric) - 2)];
+  }
+
+  return value;
+}
+
+static std::string GetRandomNumericString(const int length) {
+  std::string value(length, ' ');
+  for (int char_itr = 0; char_itr < length; char_itr++) {
+    value[char_itr] = '0' + GetRandomInteger(0, 9);
+  }
+
+  return value;
+}
+
+// I_DATA and S_DATA, 10% of which contain "ORIGINAL"
+static std::string GetRandomData() {
+  std::string data = GetRandomAlphaNumericString(26, 50);
+
+  if (GetRandomInteger(1, 10) == 1) {
+    int position = GetRandomInteger(0, data.size() - 8);
+    data.replace(position, 8, "ORIGINAL");
+  }
+
+  return data;
+}
+
+static std::string GetRandomZip() {
+  return GetRandomNumericString(4) + "11111";
+}
+
+std::string GetLastName(const int number) {
+  static const char *syllables[] = {"BAR", "OUGHT", "ABLE", "PRI", "PRES",
+                                    "ESE", "ANTI",  "CALLY", "ATION", "EING"};
+
+  assert(number >= 0 && number < LAST_NAME_COUNT);
+  return std::string(syllables[number / 100]) +
+         syllables[(number / 10) % 10] + syllables[number % 10];
+}
+
+static int GetMaxLastNameNumber() {
+  return std::min(LAST_NAME_COUNT, state.customer_count) - 1;
+}
+
+std::string GetRandomLastName() {
+  return GetLastName(
+      GetNURand(255, 0, GetMaxLastNameNumber(), NURAND_C_LAST_RUN));
+}
+
+int GetRandomCustomerId() {
+  return GetNURand(1023, 1, state.customer_count, NURAND_C_ID);
+}
+
+int GetRandomItemId() {
+  return GetNURand(8191, 1, state.item_count, NURAND_OL_I_ID);
+}
+
+int64_t GetTimestamp() {
+  auto now = std::chrono::system_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+//===--------------------------------------------------------------------===//
+// Create Tables
+//===--------------------------------------------------------------------===//
+
+static catalog::Column GetColumn(ValueType type, const std::string &name,
+                                 oid_t varchar_length = 0) {
+  if (type == VALUE_TYPE_VARCHAR) {
+    return catalog::Column(type, varchar_length, name, false);
+  }
+
+  return catalog::Column(type, GetTypeSize(type), name, true);
+}
+
+static storage::DataTable *CreateTable(
+    const std::string &table_name, const oid_t table_oid,
+    const std::vector<catalog::Column> &columns) {
+  catalog::Schema *table_schema = new catalog::Schema(columns);
+
+  bool own_schema = true;
+  bool adapt_table = false;
+  return storage::TableFactory::GetDataTable(
+      TPCC_DATABASE_OID, table_oid, table_schema, table_name,
+      state.tuples_per_tilegroup, own_schema, adapt_table);
+}
+
+static void CreateIndex(storage::DataTable *table,
+                        const std::string &index_name, const oid_t index_oid,
+                        const std::vector<oid_t> &key_attrs,
+                        const bool primary) {
+  auto tuple_schema = table->GetSchema();
+  catalog::Schema *key_schema =
+      catalog::Schema::CopySchema(tuple_schema, key_attrs);
+  key_schema->SetIndexedColumns(key_attrs);
+
+  // Only primary keys are unique
+  auto constraint_type = primary ? INDEX_CONSTRAINT_TYPE_PRIMARY_KEY
+                                 : INDEX_CONSTRAINT_TYPE_DEFAULT;
+
+  index::IndexMetadata *index_metadata =
+      new index::IndexMetadata(index_name, index_oid, INDEX_TYPE_BTREE,
+                               constraint_type, tuple_schema, key_schema,
+                               primary);
+
+  index::Index *index = index::IndexFactory::GetInstance(index_metadata);
+  table->AddIndex(index);
+}
+
+void CreateTables() {
+  /////////////////////////////////////////////////////////
+  // WAREHOUSE
+  /////////////////////////////////////////////////////////
+
+  warehouse_table = CreateTable(
+      "WAREHOUSE", 1001,
+      {GetColumn(VALUE_TYPE_INTEGER, "W_ID"),
+       GetColumn(VALUE_TYPE_VARCHAR, "W_NAME", 10),
+       GetColumn(VALUE_TYPE_VARCHAR, "W_STREET_1", 20),
+       GetColumn(VALUE_TYPE_VARCHAR, "W_STREET_2", 20),
+       GetColumn(VALUE_TYPE_VARCHAR, "W_CITY", 20),
+       GetColumn(VALUE_TYPE_VARCHAR, "W_STATE", 2),
+       GetColumn(VALUE_TYPE_VARCHAR, "W_ZIP", 9),
+       GetColumn(VALUE_TYPE_DOUBLE, "W_TAX"),
+       GetColumn(VALUE_TYPE_DOUBLE, "W_YTD")});
+  CreateIndex(warehouse_table, "W_PKEY", 2001, {W_ID}, true);
+
+  /////////////////////////////////////////////////////////
+  // DISTRICT
+  /////////////////////////////////////////////////////////
+
+  district_table = CreateTable(
+      "DISTRICT", 1002,
+      {GetColumn(VALUE_TYPE_INTEGER, "D_ID"),
+       GetColumn(VALUE_TYPE_INTEGER, "D_W_ID"),
+       GetColumn(VALUE_TYPE_VARCHAR, "D_NAME", 10),
+       GetColumn(VALUE_TYPE_VARCHAR, "D_STREET_1", 20),
+       GetColumn(VALUE_TYPE_VARCHAR, "D_STREET_2", 20),
+       GetColumn(VALUE_TYPE_VARCHAR, "D_CITY", 20),
+       GetColumn(VALUE_TYPE_VARCHAR, "D_STATE", 2),
+       GetColumn(VALUE_TYPE_VARCHAR, "D_ZIP", 9),
+       GetColumn(VALUE_TYPE_DOUBLE, "D_TAX"),
+       GetColumn(VALUE_TYPE_DOUBLE, "D_YTD"),
+       GetColumn(VALUE_TYPE_INTEGER, "D_NEXT_O_ID")});
+  CreateIndex(district_table, "D_PKEY", 2002, {D_ID, D_W_ID}, true);
+
+  /////////////////////////////////////////////////////////
+  // CUSTOMER
+  /////////////////////////////////////////////////////////
+
+  customer_table = CreateTable(
+      "CUSTOMER", 1003,
+      {GetColumn(VALUE_TYPE_INTEGER, "C_ID"),
+       GetColumn(VALUE_TYPE_INTEGER, "C_D_ID"),
+       GetColumn(VALUE_TYPE_INTEGER, "C_W_ID"),
+       GetColumn(VALUE_TYPE_VARCHAR, "C_FIRST", 16),
+       GetColumn(VALUE_TYPE_VARCHAR, "C_MIDDLE", 2),
+       GetColumn(VALUE_TYPE_VARCHAR, "C_LAST", 16),
+       GetColumn(VALUE_TYPE_VARCHAR, "C_STREET_1", 20),
+       GetColumn(VALUE_TYPE_VARCHAR, "C_STREET_2", 20),
+       GetColumn(VALUE_TYPE_VARCHAR, "C_CITY", 20),
+       GetColumn(VALUE_TYPE_VARCHAR, "C_STATE", 2),
+       GetColumn(VALUE_TYPE_VARCHAR, "C_ZIP", 9),
+       GetColumn(VALUE_TYPE_VARCHAR, "C_PHONE", 16),
+       GetColumn(VALUE_TYPE_TIMESTAMP, "C_SINCE"),
+       GetColumn(VALUE_TYPE_VARCHAR, "C_CREDIT", 2),
+       GetColumn(VALUE_TYPE_DOUBLE, "C_CREDIT_LIM"),
+       GetColumn(VALUE_TYPE_DOUBLE, "C_DISCOUNT"),
+       GetColumn(VALUE_TYPE_DOUBLE, "C_BALANCE"),
+       GetColumn(VALUE_TYPE_DOUBLE, "C_YTD_PAYMENT"),
+       GetColumn(VALUE_TYPE_INTEGER, "C_PAYMENT_CNT"),
+       GetColumn(VALUE_TYPE_INTEGER, "C_DELIVERY_CNT"),
+       GetColumn(VALUE_TYPE_VARCHAR, "C_DATA", 500)});
+  CreateIndex(customer_table, "C_PKEY", 2003, {C_ID, C_D_ID, C_W_ID}, true);
+  CreateIndex(customer_table, "C_NAME_IDX", 2004, {C_D_ID, C_W_ID, C_LAST},
+              false);
+
+  /////////////////////////////////////////////////////////
+  // HISTORY
+  /////////////////////////////////////////////////////////
+
+  history_table = CreateTable(
+      "HISTORY", 1004,
+      {GetColumn(VALUE_TYPE_INTEGER, "H_C_ID"),
+       GetColumn(VALUE_TYPE_INTEGER, "H_C_D_ID"),
+       GetColumn(VALUE_TYPE_INTEGER, "H_C_W_ID"),
+       GetColumn(VALUE_TYPE_INTEGER, "H_D_ID"),
+       GetColumn(VALUE_TYPE_INTEGER, "H_W_ID"),
+       GetColumn(VALUE_TYPE_TIMESTAMP, "H_DATE"),
+       GetColumn(VALUE_TYPE_DOUBLE, "H_AMOUNT"),
+       GetColumn(VALUE_TYPE_VARCHAR, "H_DATA", 24)});
+
+  /////////////////////////////////////////////////////////
+  // NEW_ORDER
+  /////////////////////////////////////////////////////////
+
+  new_order_table = CreateTable(
+      "NEW_ORDER", 1005,
+      {GetColumn(VALUE_TYPE_INTEGER, "NO_O_ID"),
+       GetColumn(VALUE_TYPE_INTEGER, "NO_D_ID"),
+       GetColumn(VALUE_TYPE_INTEGER, "NO_W_ID")});
+  CreateIndex(new_order_table, "NO_PKEY", 2005, {NO_O_ID, NO_D_ID, NO_W_ID},
+              true);
+  CreateIndex(new_order_table, "NO_DISTRICT_IDX", 2006, {NO_D_ID, NO_W_ID},
+              false);
+
+  /////////////////////////////////////////////////////////
+  // ORDERS
+  /////////////////////////////////////////////////////////
+
+  orders_table = CreateTable(
+      "ORDERS", 1006,
+      {GetColumn(VALUE_TYPE_INTEGER, "O_ID"),
+       GetColumn(VALUE_TYPE_INTEGER, "O_C_ID"),
+       GetColumn(VALUE_TYPE_INTEGER, "O_D_ID"),
+       GetColumn(VALUE_TYPE_INTEGER, "O_W_ID"),
+       GetColumn(VALUE_TYPE_TIMESTAMP, "O_ENTRY_D"),
+       GetColumn(VALUE_TYPE_INTEGER, "O_CARRIER_ID"),
+       GetColumn(VALUE_TYPE_INTEGER, "O_OL_CNT"),
+       GetColumn(VALUE_TYPE_INTEGER, "O_ALL_LOCAL")});
+  CreateIndex(orders_table, "O_PKEY", 2007, {O_ID, O_D_ID, O_W_ID}, true);
+  CreateIndex(orders_table, "O_CUSTOMER_IDX", 2008, {O_C_ID, O_D_ID, O_W_ID},
+              false);
+
+  /////////////////////////////////////////////////////////
+  // ORDER_LINE
+  /////////////////////////////////////////////////////////
+
+  order_line_table = CreateTable(
+      "ORDER_LINE", 1007,
+      {GetColumn(VALUE_TYPE_INTEGER, "OL_O_ID"),
+       GetColumn(VALUE_TYPE_INTEGER, "OL_D_ID"),
+       GetColumn(VALUE_TYPE_INTEGER, "OL_W_ID"),
+       GetColumn(VALUE_TYPE_INTEGER, "OL_NUMBER"),
+       GetColumn(VALUE_TYPE_INTEGER, "OL_I_ID"),
+       GetColumn(VALUE_TYPE_INTEGER, "OL_SUPPLY_W_ID"),
+       GetColumn(VALUE_TYPE_TIMESTAMP, "OL_DELIVERY_D"),
+       GetColumn(VALUE_TYPE_INTEGER, "OL_QUANTITY"),
+       GetColumn(VALUE_TYPE_DOUBLE, "OL_AMOUNT"),
+       GetColumn(VALUE_TYPE_VARCHAR, "OL_DIST_INFO", 24)});
+  CreateIndex(order_line_table, "OL_PKEY", 2009,
+              {OL_O_ID, OL_D_ID, OL_W_ID, OL_NUMBER}, true);
+  CreateIndex(order_line_table, "OL_ORDER_IDX", 2010,
+              {OL_O_ID, OL_D_ID, OL_W_ID}, false);
+
+  /////////////////////////////////////////////////////////
+  // ITEM
+  /////////////////////////////////////////////////////////
+
+  item_table = CreateTable("ITEM", 1008,
+                           {GetColumn(VALUE_TYPE_INTEGER, "I_ID"),
+                            GetColumn(VALUE_TYPE_INTEGER, "I_IM_ID"),
+                            GetColumn(VALUE_TYPE_VARCHAR, "I_NAME", 24),
+                            GetColumn(VALUE_TYPE_DOUBLE, "I_PRICE"),
+                            GetColumn(VALUE_TYPE_VARCHAR, "I_DATA", 50)});
+  CreateIndex(item_table, "I_PKEY", 2011, {I_ID}, true);
+
+  /////////////////////////////////////////////////////////
+  // STOCK
+  /////////////////////////////////////////////////////////
+
+  std::vector<catalog::Column> stock_columns = {
+      GetColumn(VALUE_TYPE_INTEGER, "S_I_ID"),
+      GetColumn(VALUE_TYPE_INTEGER, "S_W_ID"),
+      GetColumn(VALUE_TYPE_INTEGER, "S_QUANTITY")};
+  for (int d_itr = 1; d_itr <= DISTRICTS_PER_WAREHOUSE; d_itr++) {
+    std::string name = (d_itr < 10 ? "S_DIST_0" : "S_DIST_");
+    stock_columns.push_back(
+        GetColumn(VALUE_TYPE_VARCHAR, name + std::to_string(d_itr), 24));
+  }
+  stock_columns.push_back(GetColumn(VALUE_TYPE_INTEGER, "S_YTD"));
+  stock_columns.push_back(GetColumn(VALUE_TYPE_INTEGER, "S_ORDER_CNT"));
+  stock_columns.push_back(GetColumn(VALUE_TYPE_INTEGER, "S_REMOTE_CNT"));
+  stock_columns.push_back(GetColumn(VALUE_TYPE_VARCHAR, "S_DATA", 50));
+
+  stock_table = CreateTable("STOCK", 1009, stock_columns);
+  CreateIndex(stock_table, "S_PKEY", 2012, {S_I_ID, S_W_ID}, true);
+}
+
+//===--------------------------------------------------------------------===//
+// Load Tables
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Buffers the tuples of a table, and inserts them through the
+ * bulk-load path once there are enough of them.
+ */
+class TupleLoader {
+ public:
+  TupleLoader(concurrency::Transaction *txn, storage::DataTable *table)
+      : txn(txn), table(table), pool(new VarlenPool(BACKEND_TYPE_MM)) {}
+
+  // The tuple to fill next
+  storage::Tuple *GetNextTuple() {
+    if (batch.size() == TPCC_LOAD_BATCH_SIZE) Flush();
+
+    batch.emplace_back(new storage::Tuple(table->GetSchema(), true));
+    return batch.back().get();
+  }
+
+  void SetInteger(storage::Tuple *tuple, oid_t column_id, int value) {
+    tuple->SetValue(column_id, ValueFactory::GetIntegerValue(value),
+                    pool.get());
+  }
+
+  void SetDouble(storage::Tuple *tuple, oid_t column_id, double value) {
+    tuple->SetValue(column_id, ValueFactory::GetDoubleValue(value),
+                    pool.get());
+  }
+
+  void SetTimestamp(storage::Tuple *tuple, oid_t column_id, int64_t value) {
+    tuple->SetValue(column_id, ValueFactory::GetTimestampValue(value),
+                    pool.get());
+  }
+
+  void SetString(storage::Tuple *tuple, oid_t column_id,
+                 const std::string &value) {
+    tuple->SetValue(column_id, ValueFactory::GetStringValue(value, pool.get()),
+                    pool.get());
+  }
+
+  void Flush() {
+    if (batch.empty()) return;
+
+    std::vector<const storage::Tuple *> batch_tuples;
+    for (auto &tuple : batch) batch_tuples.push_back(tuple.get());
+
+    std::vector<ItemPointer> locations;
+    bool status = table->InsertTuples(txn, batch_tuples, locations);
+    for (auto location : locations) txn->RecordInsert(location);
+
+    if (status == false) {
+      throw Exception("Failed to load table " + table->GetName());
+    }
+
+    // The table holds its own copy of the strings
+    batch.clear();
+    pool.reset(new VarlenPool(BACKEND_TYPE_MM));
+  }
+
+ private:
+  concurrency::Transaction *txn;
+
+  storage::DataTable *table;
+
+  std::vector<std::unique_ptr<storage::Tuple>> batch;
+
+  std::unique_ptr<VarlenPool> pool;
+};
+
+static void LoadItems(concurrency::Transaction *txn) {
+  TupleLoader loader(txn, item_table);
+
+  for (int i_id = 1; i_id <= state.item_count; i_id++) {
+    auto tuple = loader.GetNextTuple();
+    loader.SetInteger(tuple, I_ID, i_id);
+    loader.SetInteger(tuple, I_IM_ID, GetRandomInteger(1, 10000));
+    loader.SetString(tuple, I_NAME, GetRandomAlphaNumericString(14, 24));
+    loader.SetDouble(tuple, I_PRICE, GetRandomDouble(1.00, 100.00));
+    loader.SetString(tuple, I_DATA, GetRandomData());
+  }
+
+  loader.Flush();
+}
+
+static void LoadWarehouse(concurrency::Transaction *txn, const int w_id) {
+  TupleLoader loader(txn, warehouse_table);
+
+  auto tuple = loader.GetNextTuple();
+  loader.SetInteger(tuple, W_ID, w_id);
+  loader.SetString(tuple, W_NAME, GetRandomAlphaNumericString(6, 10));
+  loader.SetString(tuple, W_STREET_1, GetRandomAlphaNumericString(10, 20));
+  loader.SetString(tuple, W_STREET_2, GetRandomAlphaNumericString(10, 20));
+  loader.SetString(tuple, W_CITY, GetRandomAlphaNumericString(10, 20));
+  loader.SetString(tuple, W_STATE, GetRandomAlphaNumericString(2, 2));
+  loader.SetString(tuple, W_ZIP, GetRandomZip());
+  loader.SetDouble(tuple, W_TAX, GetRandomDouble(0.0, 0.2));
+  loader.SetDouble(tuple, W_YTD, 300000.00);
+
+  loader.Flush();
+}
+
+static void LoadStock(concurrency::Transaction *txn, const int w_id) {
+  TupleLoader loader(txn, stock_table);
+
+  for (int i_id = 1; i_id <= state.item_count; i_id++) {
+    auto tuple = loader.GetNextTuple();
+    loader.SetInteger(tuple, S_I_ID, i_id);
+    loader.SetInteger(tuple, S_W_ID, w_id);
+    loader.SetInteger(tuple, S_QUANTITY, GetRandomInteger(10, 100));
+    for (int d_itr = 0; d_itr < DISTRICTS_PER_WAREHOUSE; d_itr++) {
+      loader.SetString(tuple, S_DIST_01 + d_itr,
+                       GetRandomAlphaNumericString(24, 24));
+    }
+    loader.SetInteger(tuple, S_YTD, 0);
+    loader.SetInteger(tuple, S_ORDER_CNT, 0);
+    loader.SetInteger(tuple, S_REMOTE_CNT, 0);
+    loader.SetString(tuple, S_DATA, GetRandomData());
+  }
+
+  loader.Flush();
+}
+
+static void LoadDistricts(concurrency::Transaction *txn, const int w_id) {
+  TupleLoader loader(txn, district_table);
+
+  for (int d_id = 1; d_id <= DISTRICTS_PER_WAREHOUSE; d_id++) {
+    auto tuple = loader.GetNextTuple();
+    loader.SetInteger(tuple, D_ID, d_id);
+    loader.SetInteger(tuple, D_W_ID, w_id);
+    loader.SetString(tuple, D_NAME, GetRandomAlphaNumericString(6, 10));
+    loader.SetString(tuple, D_STREET_1, GetRandomAlphaNumericString(10, 20));
+    loader.SetString(tuple, D_STREET_2, GetRandomAlphaNumericString(10, 20));
+    loader.SetString(tuple, D_CITY, GetRandomAlphaNumericString(10, 20));
+    loader.SetString(tuple, D_STATE, GetRandomAlphaNumericString(2, 2));
+    loader.SetString(tuple, D_ZIP, GetRandomZip());
+    loader.SetDouble(tuple, D_TAX, GetRandomDouble(0.0, 0.2));
+    loader.SetDouble(tuple, D_YTD, 30000.00);
+    loader.SetInteger(tuple, D_NEXT_O_ID, state.customer_count + 1);
+  }
+
+  loader.Flush();
+}
+
+static void LoadCustomers(concurrency::Transaction *txn, const int w_id,
+                          const int d_id) {
+  TupleLoader customer_loader(txn, customer_table);
+  TupleLoader history_loader(txn, history_table);
+  auto now = GetTimestamp();
+
+  for (int c_id = 1; c_id <= state.customer_count; c_id++) {
+    int last_name_number;
+    if (c_id <= LAST_NAME_COUNT) {
+      last_name_number = c_id - 1;
+    } else {
+      last_name_number =
+          GetNURand(255, 0, GetMaxLastNameNumber(), NURAND_C_LAST_LOAD);
+    }
+
+    auto tuple = customer_loader.GetNextTuple();
+    customer_loader.SetInteger(tuple, C_ID, c_id);
+    customer_loader.SetInteger(tuple, C_D_ID, d_id);
+    customer_loader.SetInteger(tuple, C_W_ID, w_id);
+    customer_loader.SetString(tuple, C_FIRST,
+                              GetRandomAlphaNumericString(8, 16));
+    customer_loader.SetString(tuple, C_MIDDLE, "OE");
+    customer_loader.SetString(tuple, C_LAST, GetLastName(last_name_number));
+    customer_loader.SetString(tuple, C_STREET_1,
+                              GetRandomAlphaNumericString(10, 20));
+    customer_loader.SetString(tuple, C_STREET_2,
+                              GetRandomAlphaNumericString(10, 20));
+    customer_loader.SetString(tuple, C_CITY,
+                              GetRandomAlphaNumericString(10, 20));
+    customer_loader.SetString(tuple, C_STATE,
+                              GetRandomAlphaNumericString(2, 2));
+    customer_loader.SetString(tuple, C_ZIP, GetRandomZip());
+    customer_loader.SetString(tuple, C_PHONE, GetRandomNumericString(16));
+    customer_loader.SetTimestamp(tuple, C_SINCE, now);
+    customer_loader.SetString(tuple, C_CREDIT,
+                              GetRandomInteger(1, 10) == 1 ? "BC" : "GC");
+    customer_loader.SetDouble(tuple, C_CREDIT_LIM, 50000.00);
+    customer_loader.SetDouble(tuple, C_DISCOUNT, GetRandomDouble(0.0, 0.5));
+    customer_loader.SetDouble(tuple, C_BALANCE, -10.00);
+    customer_loader.SetDouble(tuple, C_YTD_PAYMENT, 10.00);
+    customer_loader.SetInteger(tuple, C_PAYMENT_CNT, 1);
+    customer_loader.SetInteger(tuple, C_DELIVERY_CNT, 0);
+    customer_loader.SetString(tuple, C_DATA,
+                              GetRandomAlphaNumericString(300, 500));
+
+    tuple = history_loader.GetNextTuple();
+    history_loader.SetInteger(tuple, H_C_ID, c_id);
+    history_loader.SetInteger(tuple, H_C_D_ID, d_id);
+    history_loader.SetInteger(tuple, H_C_W_ID, w_id);
+    history_loader.SetInteger(tuple, H_D_ID, d_id);
+    history_loader.SetInteger(tuple, H_W_ID, w_id);
+    history_loader.SetTimestamp(tuple, H_DATE, now);
+    history_loader.SetDouble(tuple, H_AMOUNT, 10.00);
+    history_loader.SetString(tuple, H_DATA,
+                             GetRandomAlphaNumericString(12, 24));
+  }
+
+  customer_loader.Flush();
+  history_loader.Flush();
+}
+
+static void LoadOrders(concurrency::Transaction *txn, const int w_id,
+                       const int d_id) {
+  TupleLoader orders_loader(txn, orders_table);
+  TupleLoader order_line_loader(txn, order_line_table);
+  TupleLoader new_order_loader(txn, new_order_table);
+  auto now = GetTimestamp();
+
+  // Every customer places one of the orders
+  std::vector<int> customer_ids;
+  for (int c_id = 1; c_id <= state.customer_count; c_id++) {
+    customer_ids.push_back(c_id);
+  }
+  std::shuffle(customer_ids.begin(), customer_ids.end(), generator);
+
+  // The last 30% of the orders are not delivered yet
+  const int new_order_start =
+      state.customer_count - (state.customer_count * 3) / 10 + 1;
+
+  for (int o_id = 1; o_id <= state.customer_count; o_id++) {
+    bool delivered = (o_id < new_order_start);
+    int ol_cnt = GetRandomInteger(5, 15);
+
+    auto tuple = orders_loader.GetNextTuple();
+    orders_loader.SetInteger(tuple, O_ID, o_id);
+    orders_loader.SetInteger(tuple, O_C_ID, customer_ids[o_id - 1]);
+    orders_loader.SetInteger(tuple, O_D_ID, d_id);
+    orders_loader.SetInteger(tuple, O_W_ID, w_id);
+    orders_loader.SetTimestamp(tuple, O_ENTRY_D, now);
+    orders_loader.SetInteger(tuple, O_CARRIER_ID,
+                             delivered ? GetRandomInteger(1, 10) : 0);
+    orders_loader.SetInteger(tuple, O_OL_CNT, ol_cnt);
+    orders_loader.SetInteger(tuple, O_ALL_LOCAL, 1);
+
+    for (int ol_number = 1; ol_number <= ol_cnt; ol_number++) {
+      tuple = order_line_loader.GetNextTuple();
+      order_line_loader.SetInteger(tuple, OL_O_ID, o_id);
+      order_line_loader.SetInteger(tuple, OL_D_ID, d_id);
+      order_line_loader.SetInteger(tuple, OL_W_ID, w_id);
+      order_line_loader.SetInteger(tuple, OL_NUMBER, ol_number);
+      order_line_loader.SetInteger(tuple, OL_I_ID,
+                                   GetRandomInteger(1, state.item_count));
+      order_line_loader.SetInteger(tuple, OL_SUPPLY_W_ID, w_id);
+      order_line_loader.SetTimestamp(tuple, OL_DELIVERY_D,
+                                     delivered ? now : 0);
+      order_line_loader.SetInteger(tuple, OL_QUANTITY, 5);
+      order_line_loader.SetDouble(
+          tuple, OL_AMOUNT, delivered ? 0 : GetRandomDouble(0.01, 9999.99));
+      order_line_loader.SetString(tuple, OL_DIST_INFO,
+                                  GetRandomAlphaNumericString(24, 24));
+    }
+
+    if (delivered == false) {
+      tuple = new_order_loader.GetNextTuple();
+      new_order_loader.SetInteger(tuple, NO_O_ID, o_id);
+      new_order_loader.SetInteger(tuple, NO_D_ID, d_id);
+      new_order_loader.SetInteger(tuple, NO_W_ID, w_id);
+    }
+  }
+
+  orders_loader.Flush();
+  order_line_loader.Flush();
+  new_order_loader.Flush();
+}
+
+void LoadTables() {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+
+  // The load is deterministic
+  SetRandomSeed(0);
+
+  auto txn = txn_manager.BeginTransaction();
+  LoadItems(txn);
+  txn_manager.CommitTransaction();
+
+  // One transaction per warehouse
+  for (int w_id = 1; w_id <= state.warehouse_count; w_id++) {
+    txn = txn_manager.BeginTransaction();
+
+    LoadWarehouse(txn, w_id);
+    LoadStock(txn, w_id);
+    LoadDistricts(txn, w_id);
+
+    for (int d_id = 1; d_id <= DISTRICTS_PER_WAREHOUSE; d_id++) {
+      LoadCustomers(txn, w_id, d_id);
+      LoadOrders(txn, w_id, d_id);
+    }
+
+    txn_manager.CommitTransaction();
+  }
+
+  std::cout << "Loaded " << state.warehouse_count << " warehouses\n";
+}
+
+void CreateAndLoadTables() {
+  CreateTables();
+
+  LoadTables();
+}
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,194 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// loader.h
+//
+// Identification: benchmark/tpcc/loader.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+
+#include "backend/benchmark/tpcc/configuration.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+extern configuration state;
+
+//===--------------------------------------------------------------------===//
+// Tables
+//===--------------------------------------------------------------------===//
+
+// Every table has its primary index at offset 0, and its secondary index,
+// if any, at offset 1. The columns of an index key are in table order.
+
+#define PRIMARY_INDEX_OFFSET 0
+#define SECONDARY_INDEX_OFFSET 1
+
+#define DISTRICTS_PER_WAREHOUSE 10
+
+// Money and rates are doubles rather than decimals, and null carrier ids
+// and delivery dates are zero.
+
+enum WarehouseColumn {
+  W_ID = 0,
+  W_NAME,
+  W_STREET_1,
+  W_STREET_2,
+  W_CITY,
+  W_STATE,
+  W_ZIP,
+  W_TAX,
+  W_YTD
+};
+
+enum DistrictColumn {
+  D_ID = 0,
+  D_W_ID,
+  D_NAME,
+  D_STREET_1,
+  D_STREET_2,
+  D_CITY,
+  D_STATE,
+  D_ZIP,
+  D_TAX,
+  D_YTD,
+  D_NEXT_O_ID
+};
+
+// Secondary index on (C_D_ID, C_W_ID, C_LAST)
+enum CustomerColumn {
+  C_ID = 0,
+  C_D_ID,
+  C_W_ID,
+  C_FIRST,
+  C_MIDDLE,
+  C_LAST,
+  C_STREET_1,
+  C_STREET_2,
+  C_CITY,
+  C_STATE,
+  C_ZIP,
+  C_PHONE,
+  C_SINCE,
+  C_CREDIT,
+  C_CREDIT_LIM,
+  C_DISCOUNT,
+  C_BALANCE,
+  C_YTD_PAYMENT,
+  C_PAYMENT_CNT,
+  C_DELIVERY_CNT,
+  C_DATA
+};
+
+// No index
+enum HistoryColumn {
+  H_C_ID = 0,
+  H_C_D_ID,
+  H_C_W_ID,
+  H_D_ID,
+  H_W_ID,
+  H_DATE,
+  H_AMOUNT,
+  H_DATA
+};
+
+// Secondary index on (NO_D_ID, NO_W_ID)
+enum NewOrderColumn { NO_O_ID = 0, NO_D_ID, NO_W_ID };
+
+// Secondary index on (O_C_ID, O_D_ID, O_W_ID)
+enum OrdersColumn {
+  O_ID = 0,
+  O_C_ID,
+  O_D_ID,
+  O_W_ID,
+  O_ENTRY_D,
+  O_CARRIER_ID,
+  O_OL_CNT,
+  O_ALL_LOCAL
+};
+
+// Secondary index on (OL_O_ID, OL_D_ID, OL_W_ID)
+enum OrderLineColumn {
+  OL_O_ID = 0,
+  OL_D_ID,
+  OL_W_ID,
+  OL_NUMBER,
+  OL_I_ID,
+  OL_SUPPLY_W_ID,
+  OL_DELIVERY_D,
+  OL_QUANTITY,
+  OL_AMOUNT,
+  OL_DIST_INFO
+};
+
+enum ItemColumn { I_ID = 0, I_IM_ID, I_NAME, I_PRICE, I_DATA };
+
+// S_DIST_01 to S_DIST_10 follow S_QUANTITY
+enum StockColumn {
+  S_I_ID = 0,
+  S_W_ID,
+  S_QUANTITY,
+  S_DIST_01,
+  S_YTD = S_DIST_01 + DISTRICTS_PER_WAREHOUSE,
+  S_ORDER_CNT,
+  S_REMOTE_CNT,
+  S_DATA
+};
+
+extern storage::DataTable *warehouse_table;
+extern storage::DataTable *district_table;
+extern storage::DataTable *customer_table;
+extern storage::DataTable *history_table;
+extern storage::DataTable *new_order_table;
+extern storage::DataTable *orders_table;
+extern storage::DataTable *order_line_table;
+extern storage::DataTable *item_table;
+extern storage::DataTable *stock_table;
+
+void CreateTables();
+
+void LoadTables();
+
+void CreateAndLoadTables();
+
+//===--------------------------------------------------------------------===//
+// Random Data
+//===--------------------------------------------------------------------===//
+
+// Seeds the generator of the calling thread
+void SetRandomSeed(uint64_t seed);
+
+// Uniform over [lower, upper]
+int GetRandomInteger(const int lower, const int upper);
+
+double GetRandomDouble(const double lower, const double upper);
+
+std::string GetRandomAlphaNumericString(const int min_length,
+                                        const int max_length);
+
+// Last name made of the three syllables of the digits of the number
+std::string GetLastName(const int number);
+
+// Last name of a customer to look up at run time
+std::string GetRandomLastName();
+
+// Customer id to look up at run time
+int GetRandomCustomerId();
+
+// Item id to order at run time
+int GetRandomItemId();
+
+// Microseconds since the epoch
+int64_t GetTimestamp();
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,211 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// new_order.cpp
+//
+// Identification: benchmark/tpcc/new_order.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+#include "backend/benchmark/tpcc/loader.h"
+#include "backend/benchmark/tpcc/workload.h"
+#include "backend/common/logger.h"
+#include "backend/common/value_factory.h"
+#include "backend/common/value_peeker.h"
+#include "backend/concurrency/transaction_manager.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+bool RunNewOrder(const int w_id) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+
+  /////////////////////////////////////////////////////////
+  // INPUT
+  /////////////////////////////////////////////////////////
+
+  const int d_id = GetRandomInteger(1, DISTRICTS_PER_WAREHOUSE);
+  const int c_id = GetRandomCustomerId();
+  const int ol_cnt = GetRandomInteger(5, 15);
+
+  // 1% of the orders have an unused item, and are rolled back
+  const bool rollback = (GetRandomInteger(1, 100) == 1);
+
+  std::vector<int> i_ids, supply_w_ids, quantities;
+  bool all_local = true;
+
+  for (int ol_itr = 0; ol_itr < ol_cnt; ol_itr++) {
+    // Items are distinct, so that no stock row is updated twice
+    int i_id;
+    do {
+      i_id = GetRandomItemId();
+    } while (std::find(i_ids.begin(), i_ids.end(), i_id) != i_ids.end());
+    i_ids.push_back(i_id);
+
+    // 1% of the items are supplied by a remote warehouse
+    int supply_w_id = w_id;
+    if (state.warehouse_count > 1 && GetRandomInteger(1, 100) == 1) {
+      do {
+        supply_w_id = GetRandomInteger(1, state.warehouse_count);
+      } while (supply_w_id == w_id);
+      all_local = false;
+    }
+    supply_w_ids.push_back(supply_w_id);
+
+    quantities.push_back(GetRandomInteger(1, 10));
+  }
+
+  if (rollback == true) i_ids.back() = state.item_count + 1;
+
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  auto now = GetTimestamp();
+
+  /////////////////////////////////////////////////////////
+  // WAREHOUSE, DISTRICT AND CUSTOMER
+  /////////////////////////////////////////////////////////
+
+  std::vector<Value> warehouse;
+  if (ExecuteReadRow(context.get(), warehouse_table, PRIMARY_INDEX_OFFSET,
+                     {ValueFactory::GetIntegerValue(w_id)}, {W_TAX},
+                     warehouse) == false) {
+    return EndTransaction(txn);
+  }
+
+  std::vector<Value> district_key = {ValueFactory::GetIntegerValue(d_id),
+                                     ValueFactory::GetIntegerValue(w_id)};
+  std::vector<Value> district;
+  if (ExecuteReadRow(context.get(), district_table, PRIMARY_INDEX_OFFSET,
+                     district_key, {D_TAX, D_NEXT_O_ID}, district) == false) {
+    return EndTransaction(txn);
+  }
+
+  const int o_id = ValuePeeker::PeekInteger(district[1]);
+  if (ExecuteUpdate(context.get(), district_table, PRIMARY_INDEX_OFFSET,
+                    district_key,
+                    {{D_NEXT_O_ID, ValueFactory::GetIntegerValue(o_id + 1)}}) ==
+      false) {
+    return EndTransaction(txn);
+  }
+
+  std::vector<Value> customer;
+  if (ExecuteReadRow(context.get(), customer_table, PRIMARY_INDEX_OFFSET,
+                     {ValueFactory::GetIntegerValue(c_id),
+                      ValueFactory::GetIntegerValue(d_id),
+                      ValueFactory::GetIntegerValue(w_id)},
+                     {C_DISCOUNT, C_LAST, C_CREDIT}, customer) == false) {
+    return EndTransaction(txn);
+  }
+
+  /////////////////////////////////////////////////////////
+  // ORDERS AND NEW_ORDER
+  /////////////////////////////////////////////////////////
+
+  if (ExecuteInsert(context.get(), orders_table,
+                    {ValueFactory::GetIntegerValue(o_id),
+                     ValueFactory::GetIntegerValue(c_id),
+                     ValueFactory::GetIntegerValue(d_id),
+                     ValueFactory::GetIntegerValue(w_id),
+                     ValueFactory::GetTimestampValue(now),
+                     ValueFactory::GetIntegerValue(0),
+                     ValueFactory::GetIntegerValue(ol_cnt),
+                     ValueFactory::GetIntegerValue(all_local)}) == false) {
+    return EndTransaction(txn);
+  }
+
+  if (ExecuteInsert(context.get(), new_order_table,
+                    {ValueFactory::GetIntegerValue(o_id),
+                     ValueFactory::GetIntegerValue(d_id),
+                     ValueFactory::GetIntegerValue(w_id)}) == false) {
+    return EndTransaction(txn);
+  }
+
+  /////////////////////////////////////////////////////////
+  // ITEMS
+  /////////////////////////////////////////////////////////
+
+  for (int ol_itr = 0; ol_itr < ol_cnt; ol_itr++) {
+    const int i_id = i_ids[ol_itr];
+    const int supply_w_id = supply_w_ids[ol_itr];
+    const int quantity = quantities[ol_itr];
+
+    auto items = ExecuteRead(context.get(), item_table, PRIMARY_INDEX_OFFSET,
+                             {ValueFactory::GetIntegerValue(i_id)},
+                             {I_PRICE, I_NAME, I_DATA});
+    if (txn->GetResult() != Result::RESULT_SUCCESS) {
+      return EndTransaction(txn);
+    }
+
+    // Unused item, roll back on purpose
+    if (items.empty()) {
+      LOG_TRACE("New order %d rolled back", o_id);
+      txn_manager.AbortTransaction();
+      return true;
+    }
+
+    std::vector<Value> stock_key = {ValueFactory::GetIntegerValue(i_id),
+                                    ValueFactory::GetIntegerValue(supply_w_id)};
+    std::vector<Value> stock;
+    if (ExecuteReadRow(context.get(), stock_table, PRIMARY_INDEX_OFFSET,
+                       stock_key,
+                       {S_QUANTITY, (oid_t)(S_DIST_01 + d_id - 1), S_YTD,
+                        S_ORDER_CNT, S_REMOTE_CNT, S_DATA},
+                       stock) == false) {
+      return EndTransaction(txn);
+    }
+
+    int s_quantity = ValuePeeker::PeekInteger(stock[0]);
+    if (s_quantity >= quantity + 10) {
+      s_quantity -= quantity;
+    } else {
+      s_quantity += 91 - quantity;
+    }
+
+    const int s_ytd = ValuePeeker::PeekInteger(stock[2]) + quantity;
+    const int s_order_cnt = ValuePeeker::PeekInteger(stock[3]) + 1;
+    int s_remote_cnt = ValuePeeker::PeekInteger(stock[4]);
+    if (supply_w_id != w_id) s_remote_cnt++;
+
+    std::vector<std::pair<oid_t, Value>> stock_updates = {
+        {S_QUANTITY, ValueFactory::GetIntegerValue(s_quantity)},
+        {S_YTD, ValueFactory::GetIntegerValue(s_ytd)},
+        {S_ORDER_CNT, ValueFactory::GetIntegerValue(s_order_cnt)},
+        {S_REMOTE_CNT, ValueFactory::GetIntegerValue(s_remote_cnt)}};
+    if (ExecuteUpdate(context.get(), stock_table, PRIMARY_INDEX_OFFSET,
+                      stock_key, stock_updates) == false) {
+      return EndTransaction(txn);
+    }
+
+    const double amount = quantity * ValuePeeker::PeekDouble(items[0][0]);
+
+    if (ExecuteInsert(
+            context.get(), order_line_table,
+            {ValueFactory::GetIntegerValue(o_id),
+             ValueFactory::GetIntegerValue(d_id),
+             ValueFactory::GetIntegerValue(w_id),
+             ValueFactory::GetIntegerValue(ol_itr + 1),
+             ValueFactory::GetIntegerValue(i_id),
+             ValueFactory::GetIntegerValue(supply_w_id),
+             ValueFactory::GetTimestampValue(0),
+             ValueFactory::GetIntegerValue(quantity),
+             ValueFactory::GetDoubleValue(amount),
+             stock[1]}) == false) {
+      return EndTransaction(txn);
+    }
+  }
+
+  return EndTransaction(txn);
+}
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// order_status.cpp
+//
+// Identification: benchmark/tpcc/order_status.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "backend/benchmark/tpcc/loader.h"
+#include "backend/benchmark/tpcc/workload.h"
+#include "backend/common/value_factory.h"
+#include "backend/common/value_peeker.h"
+#include "backend/concurrency/transaction_manager.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+bool RunOrderStatus(const int w_id) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+
+  /////////////////////////////////////////////////////////
+  // INPUT
+  /////////////////////////////////////////////////////////
+
+  const int d_id = GetRandomInteger(1, DISTRICTS_PER_WAREHOUSE);
+
+  // 60% of the customers are looked up by last name
+  const bool by_last_name = (GetRandomInteger(1, 100) <= 60);
+  int c_id = by_last_name ? 0 : GetRandomCustomerId();
+  const std::string c_last = by_last_name ? GetRandomLastName() : "";
+
+  auto txn = txn_manager.BeginReadOnlyTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  /////////////////////////////////////////////////////////
+  // CUSTOMER
+  /////////////////////////////////////////////////////////
+
+  if (by_last_name == true &&
+      GetCustomerIdByLastName(context.get(), w_id, d_id, c_last, c_id) ==
+          false) {
+    return EndTransaction(txn);
+  }
+
+  std::vector<Value> customer;
+  if (ExecuteReadRow(context.get(), customer_table, PRIMARY_INDEX_OFFSET,
+                     {ValueFactory::GetIntegerValue(c_id),
+                      ValueFactory::GetIntegerValue(d_id),
+                      ValueFactory::GetIntegerValue(w_id)},
+                     {C_BALANCE, C_FIRST, C_MIDDLE, C_LAST},
+                     customer) == false) {
+    return EndTransaction(txn);
+  }
+
+  /////////////////////////////////////////////////////////
+  // LAST ORDER
+  /////////////////////////////////////////////////////////
+
+  auto orders = ExecuteRead(context.get(), orders_table, SECONDARY_INDEX_OFFSET,
+                            {ValueFactory::GetIntegerValue(c_id),
+                             ValueFactory::GetIntegerValue(d_id),
+                             ValueFactory::GetIntegerValue(w_id)},
+                            {O_ID, O_ENTRY_D, O_CARRIER_ID});
+
+  // The customer may not have ordered anything yet
+  if (orders.empty()) return EndTransaction(txn);
+
+  int o_id = 0;
+  for (auto &order : orders) {
+    o_id = std::max(o_id, ValuePeeker::PeekInteger(order[0]));
+  }
+
+  ExecuteRead(context.get(), order_line_table, SECONDARY_INDEX_OFFSET,
+              {ValueFactory::GetIntegerValue(o_id),
+               ValueFactory::GetIntegerValue(d_id),
+               ValueFactory::GetIntegerValue(w_id)},
+              {OL_I_ID, OL_SUPPLY_W_ID, OL_QUANTITY, OL_AMOUNT,
+               OL_DELIVERY_D});
+
+  return EndTransaction(txn);
+}
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// payment.cpp
+//
+// Identification: benchmark/tpcc/payment.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "backend/benchmark/tpcc/loader.h"
+#include "backend/benchmark/tpcc/workload.h"
+#include "backend/common/value_factory.h"
+#include "backend/common/value_peeker.h"
+#include "backend/concurrency/transaction_manager.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+// C_DATA of bad credit customers is capped to this length
+#define C_DATA_LENGTH 500
+
+bool RunPayment(const int w_id) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+
+  /////////////////////////////////////////////////////////
+  // INPUT
+  /////////////////////////////////////////////////////////
+
+  const int d_id = GetRandomInteger(1, DISTRICTS_PER_WAREHOUSE);
+
+  // 15% of the customers belong to a remote warehouse
+  int c_w_id = w_id;
+  int c_d_id = d_id;
+  if (state.warehouse_count > 1 && GetRandomInteger(1, 100) <= 15) {
+    do {
+      c_w_id = GetRandomInteger(1, state.warehouse_count);
+    } while (c_w_id == w_id);
+    c_d_id = GetRandomInteger(1, DISTRICTS_PER_WAREHOUSE);
+  }
+
+  // 60% of the customers are looked up by last name
+  const bool by_last_name = (GetRandomInteger(1, 100) <= 60);
+  int c_id = by_last_name ? 0 : GetRandomCustomerId();
+  const std::string c_last = by_last_name ? GetRandomLastName() : "";
+
+  const double h_amount = GetRandomDouble(1.00, 5000.00);
+
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  auto pool = context->GetExecutorContextPool();
+  auto now = GetTimestamp();
+
+  /////////////////////////////////////////////////////////
+  // WAREHOUSE AND DISTRICT
+  /////////////////////////////////////////////////////////
+
+  std::vector<Value> warehouse_key = {ValueFactory::GetIntegerValue(w_id)};
+  std::vector<Value> warehouse;
+  if (ExecuteReadRow(context.get(), warehouse_table, PRIMARY_INDEX_OFFSET,
+                     warehouse_key, {W_NAME, W_YTD}, warehouse) == false) {
+    return EndTransaction(txn);
+  }
+
+  const double w_ytd = ValuePeeker::PeekDouble(warehouse[1]) + h_amount;
+  if (ExecuteUpdate(context.get(), warehouse_table, PRIMARY_INDEX_OFFSET,
+                    warehouse_key,
+                    {{W_YTD, ValueFactory::GetDoubleValue(w_ytd)}}) == false) {
+    return EndTransaction(txn);
+  }
+
+  std::vector<Value> district_key = {ValueFactory::GetIntegerValue(d_id),
+                                     ValueFactory::GetIntegerValue(w_id)};
+  std::vector<Value> district;
+  if (ExecuteReadRow(context.get(), district_table, PRIMARY_INDEX_OFFSET,
+                     district_key, {D_NAME, D_YTD}, district) == false) {
+    return EndTransaction(txn);
+  }
+
+  const double d_ytd = ValuePeeker::PeekDouble(district[1]) + h_amount;
+  if (ExecuteUpdate(context.get(), district_table, PRIMARY_INDEX_OFFSET,
+                    district_key,
+                    {{D_YTD, ValueFactory::GetDoubleValue(d_ytd)}}) == false) {
+    return EndTransaction(txn);
+  }
+
+  /////////////////////////////////////////////////////////
+  // CUSTOMER
+  /////////////////////////////////////////////////////////
+
+  if (by_last_name == true &&
+      GetCustomerIdByLastName(context.get(), c_w_id, c_d_id, c_last, c_id) ==
+          false) {
+    return EndTransaction(txn);
+  }
+
+  std::vector<Value> customer_key = {ValueFactory::GetIntegerValue(c_id),
+                                     ValueFactory::GetIntegerValue(c_d_id),
+                                     ValueFactory::GetIntegerValue(c_w_id)};
+  std::vector<Value> customer;
+  if (ExecuteReadRow(context.get(), customer_table, PRIMARY_INDEX_OFFSET,
+                     customer_key, {C_BALANCE, C_YTD_PAYMENT, C_PAYMENT_CNT,
+                                    C_CREDIT, C_DATA},
+                     customer) == false) {
+    return EndTransaction(txn);
+  }
+
+  const double c_balance = ValuePeeker::PeekDouble(customer[0]) - h_amount;
+  const double c_ytd_payment =
+      ValuePeeker::PeekDouble(customer[1]) + h_amount;
+  const int c_payment_cnt = ValuePeeker::PeekInteger(customer[2]) + 1;
+
+  std::vector<std::pair<oid_t, Value>> customer_updates = {
+      {C_BALANCE, ValueFactory::GetDoubleValue(c_balance)},
+      {C_YTD_PAYMENT, ValueFactory::GetDoubleValue(c_ytd_payment)},
+      {C_PAYMENT_CNT, ValueFactory::GetIntegerValue(c_payment_cnt)}};
+
+  // Bad credit customers keep a trace of their payments
+  if (ValuePeeker::PeekStringCopyWithoutNull(customer[3]) == "BC") {
+    std::string c_data = std::to_string(c_id) + " " + std::to_string(c_d_id) +
+                         " " + std::to_string(c_w_id) + " " +
+                         std::to_string(d_id) + " " + std::to_string(w_id) +
+                         " " + std::to_string(h_amount) + " " +
+                         ValuePeeker::PeekStringCopyWithoutNull(customer[4]);
+    c_data.resize(std::min<size_t>(c_data.size(), C_DATA_LENGTH));
+
+    customer_updates.emplace_back(
+        C_DATA, ValueFactory::GetStringValue(c_data, pool));
+  }
+
+  if (ExecuteUpdate(context.get(), customer_table, PRIMARY_INDEX_OFFSET,
+                    customer_key, customer_updates) == false) {
+    return EndTransaction(txn);
+  }
+
+  /////////////////////////////////////////////////////////
+  // HISTORY
+  /////////////////////////////////////////////////////////
+
+  std::string h_data = ValuePeeker::PeekStringCopyWithoutNull(warehouse[0]) +
+                       "    " +
+                       ValuePeeker::PeekStringCopyWithoutNull(district[0]);
+
+  ExecuteInsert(context.get(), history_table,
+                {ValueFactory::GetIntegerValue(c_id),
+                 ValueFactory::GetIntegerValue(c_d_id),
+                 ValueFactory::GetIntegerValue(c_w_id),
+                 ValueFactory::GetIntegerValue(d_id),
+                 ValueFactory::GetIntegerValue(w_id),
+                 ValueFactory::GetTimestampValue(now),
+                 ValueFactory::GetDoubleValue(h_amount),
+                 ValueFactory::GetStringValue(h_data, pool)});
+
+  return EndTransaction(txn);
+}
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
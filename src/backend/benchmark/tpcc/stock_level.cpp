@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// stock_level.cpp
+//
+// Identification: benchmark/tpcc/stock_level.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "backend/benchmark/tpcc/loader.h"
+#include "backend/benchmark/tpcc/workload.h"
+#include "backend/common/logger.h"
+#include "backend/common/value_factory.h"
+#include "backend/common/value_peeker.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/expression/expression_util.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+// # of recent orders of the district whose items are checked
+#define STOCK_LEVEL_ORDER_COUNT 20
+
+bool RunStockLevel(const int w_id) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+
+  /////////////////////////////////////////////////////////
+  // INPUT
+  /////////////////////////////////////////////////////////
+
+  const int d_id = GetRandomInteger(1, DISTRICTS_PER_WAREHOUSE);
+  const int threshold = GetRandomInteger(10, 20);
+
+  auto txn = txn_manager.BeginReadOnlyTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  /////////////////////////////////////////////////////////
+  // RECENT ITEMS
+  /////////////////////////////////////////////////////////
+
+  std::vector<Value> district;
+  if (ExecuteReadRow(context.get(), district_table, PRIMARY_INDEX_OFFSET,
+                     {ValueFactory::GetIntegerValue(d_id),
+                      ValueFactory::GetIntegerValue(w_id)},
+                     {D_NEXT_O_ID}, district) == false) {
+    return EndTransaction(txn);
+  }
+
+  const int next_o_id = ValuePeeker::PeekInteger(district[0]);
+  std::set<int> i_ids;
+
+  for (int o_id = next_o_id - STOCK_LEVEL_ORDER_COUNT; o_id < next_o_id;
+       o_id++) {
+    auto order_lines =
+        ExecuteRead(context.get(), order_line_table, SECONDARY_INDEX_OFFSET,
+                    {ValueFactory::GetIntegerValue(o_id),
+                     ValueFactory::GetIntegerValue(d_id),
+                     ValueFactory::GetIntegerValue(w_id)},
+                    {OL_I_ID});
+
+    for (auto &order_line : order_lines) {
+      i_ids.insert(ValuePeeker::PeekInteger(order_line[0]));
+    }
+  }
+
+  /////////////////////////////////////////////////////////
+  // LOW STOCK
+  /////////////////////////////////////////////////////////
+
+  int low_stock_count = 0;
+
+  for (auto i_id : i_ids) {
+    // S_QUANTITY < THRESHOLD
+    auto predicate = expression::ComparisonFactory(
+        EXPRESSION_TYPE_COMPARE_LESSTHAN,
+        expression::TupleValueFactory(0, S_QUANTITY),
+        expression::ConstantValueFactory(
+            ValueFactory::GetIntegerValue(threshold)));
+
+    auto stocks = ExecuteRead(context.get(), stock_table, PRIMARY_INDEX_OFFSET,
+                              {ValueFactory::GetIntegerValue(i_id),
+                               ValueFactory::GetIntegerValue(w_id)},
+                              {S_I_ID}, predicate);
+
+    low_stock_count += stocks.size();
+  }
+
+  LOG_TRACE("Stock level of district %d : %d", d_id, low_stock_count);
+
+  return EndTransaction(txn);
+}
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
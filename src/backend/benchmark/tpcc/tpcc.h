@@ -0,0 +1,25 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// tpcc.h
+//
+// Identification: benchmark/tpcc/tpcc.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "backend/benchmark/tpcc/configuration.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+extern configuration state;
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,450 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// workload.cpp
+//
+// Identification: benchmark/tpcc/workload.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <thread>
+#include <cassert>
+
+#include "backend/benchmark/tpcc/loader.h"
+#include "backend/benchmark/tpcc/workload.h"
+#include "backend/common/exception.h"
+#include "backend/common/types.h"
+#include "backend/common/value_factory.h"
+#include "backend/common/value_peeker.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/executor/logical_tile.h"
+#include "backend/executor/delete_executor.h"
+#include "backend/executor/index_scan_executor.h"
+#include "backend/executor/insert_executor.h"
+#include "backend/executor/update_executor.h"
+#include "backend/expression/expression_util.h"
+#include "backend/index/index.h"
+#include "backend/planner/delete_plan.h"
+#include "backend/planner/index_scan_plan.h"
+#include "backend/planner/insert_plan.h"
+#include "backend/planner/update_plan.h"
+#include "backend/storage/data_table.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+//===--------------------------------------------------------------------===//
+// Plans
+//===--------------------------------------------------------------------===//
+
+static planner::IndexScanPlan *GetKeyScanPlan(
+    storage::DataTable *table, const oid_t index_offset,
+    const std::vector<Value> &key_values, const std::vector<oid_t> &column_ids,
+    expression::AbstractExpression *predicate) {
+  auto index = table->GetIndex(index_offset);
+  assert(key_values.size() == index->GetColumnCount());
+
+  std::vector<oid_t> key_column_ids;
+  std::vector<ExpressionType> expr_types;
+  for (oid_t key_itr = 0; key_itr < key_values.size(); key_itr++) {
+    key_column_ids.push_back(key_itr);
+    expr_types.push_back(EXPRESSION_TYPE_COMPARE_EQUAL);
+  }
+
+  std::vector<expression::AbstractExpression *> runtime_keys;
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      index, key_column_ids, expr_types, key_values, runtime_keys);
+
+  return new planner::IndexScanPlan(table, predicate, column_ids,
+                                    index_scan_desc);
+}
+
+std::vector<std::vector<Value>> ExecuteRead(
+    executor::ExecutorContext *context, storage::DataTable *table,
+    const oid_t index_offset, const std::vector<Value> &key_values,
+    const std::vector<oid_t> &column_ids,
+    expression::AbstractExpression *predicate) {
+  std::vector<std::vector<Value>> rows;
+
+  std::unique_ptr<planner::IndexScanPlan> index_scan_node(GetKeyScanPlan(
+      table, index_offset, key_values, column_ids, predicate));
+  executor::IndexScanExecutor index_scan_executor(index_scan_node.get(),
+                                                  context);
+
+  if (index_scan_executor.Init() == false) {
+    context->GetTransaction()->SetResult(Result::RESULT_FAILURE);
+    return rows;
+  }
+
+  while (index_scan_executor.Execute() == true) {
+    std::unique_ptr<executor::LogicalTile> result_tile(
+        index_scan_executor.GetOutput());
+
+    for (oid_t tuple_id : *result_tile) {
+      std::vector<Value> row;
+      for (oid_t col_itr = 0; col_itr < column_ids.size(); col_itr++) {
+        row.push_back(result_tile->GetValue(tuple_id, col_itr));
+      }
+      rows.push_back(row);
+    }
+  }
+
+  return rows;
+}
+
+bool ExecuteReadRow(executor::ExecutorContext *context,
+                    storage::DataTable *table, const oid_t index_offset,
+                    const std::vector<Value> &key_values,
+                    const std::vector<oid_t> &column_ids,
+                    std::vector<Value> &row) {
+  auto rows =
+      ExecuteRead(context, table, index_offset, key_values, column_ids);
+
+  if (rows.size() != 1) {
+    context->GetTransaction()->SetResult(Result::RESULT_FAILURE);
+    return false;
+  }
+
+  row = rows[0];
+  return true;
+}
+
+bool ExecuteUpdate(executor::ExecutorContext *context,
+                   storage::DataTable *table, const oid_t index_offset,
+                   const std::vector<Value> &key_values,
+                   const std::vector<std::pair<oid_t, Value>> &updates) {
+  std::vector<oid_t> key_column_ids = {0};
+  std::unique_ptr<planner::IndexScanPlan> index_scan_node(GetKeyScanPlan(
+      table, index_offset, key_values, key_column_ids, nullptr));
+  executor::IndexScanExecutor index_scan_executor(index_scan_node.get(),
+                                                  context);
+
+  // Overwrite the updated columns, keep the rest
+  planner::ProjectInfo::TargetList target_list;
+  planner::ProjectInfo::DirectMapList direct_map_list;
+
+  oid_t column_count = table->GetSchema()->GetColumnCount();
+  for (oid_t col_itr = 0; col_itr < column_count; col_itr++) {
+    auto update = std::find_if(updates.begin(), updates.end(),
+                               [col_itr](const std::pair<oid_t, Value> &u) {
+                                 return u.first == col_itr;
+                               });
+
+    if (update != updates.end()) {
+      auto expression = expression::ConstantValueFactory(update->second);
+      target_list.emplace_back(col_itr, expression);
+    } else {
+      direct_map_list.emplace_back(col_itr, std::make_pair(0, col_itr));
+    }
+  }
+
+  auto project_info = new planner::ProjectInfo(std::move(target_list),
+                                               std::move(direct_map_list));
+  planner::UpdatePlan update_node(table, project_info);
+  executor::UpdateExecutor update_executor(&update_node, context);
+  update_executor.AddChild(&index_scan_executor);
+
+  auto txn = context->GetTransaction();
+  if (update_executor.Init() == false) {
+    txn->SetResult(Result::RESULT_FAILURE);
+    return false;
+  }
+
+  // Failures are reported through the transaction result
+  while (update_executor.Execute() == true)
+    ;
+
+  return (txn->GetResult() == Result::RESULT_SUCCESS);
+}
+
+bool ExecuteInsert(executor::ExecutorContext *context,
+                   storage::DataTable *table,
+                   const std::vector<Value> &values) {
+  planner::ProjectInfo::TargetList target_list;
+  planner::ProjectInfo::DirectMapList direct_map_list;
+
+  for (oid_t col_itr = 0; col_itr < values.size(); col_itr++) {
+    auto expression = expression::ConstantValueFactory(values[col_itr]);
+    target_list.emplace_back(col_itr, expression);
+  }
+
+  auto project_info = new planner::ProjectInfo(std::move(target_list),
+                                               std::move(direct_map_list));
+  planner::InsertPlan insert_node(table, project_info);
+  executor::InsertExecutor insert_executor(&insert_node, context);
+
+  auto txn = context->GetTransaction();
+  if (insert_executor.Init() == false) {
+    txn->SetResult(Result::RESULT_FAILURE);
+    return false;
+  }
+
+  insert_executor.Execute();
+
+  return (txn->GetResult() == Result::RESULT_SUCCESS);
+}
+
+bool ExecuteDelete(executor::ExecutorContext *context,
+                   storage::DataTable *table, const oid_t index_offset,
+                   const std::vector<Value> &key_values) {
+  std::vector<oid_t> key_column_ids = {0};
+  std::unique_ptr<planner::IndexScanPlan> index_scan_node(GetKeyScanPlan(
+      table, index_offset, key_values, key_column_ids, nullptr));
+  executor::IndexScanExecutor index_scan_executor(index_scan_node.get(),
+                                                  context);
+
+  planner::DeletePlan delete_node(table, false);
+  executor::DeleteExecutor delete_executor(&delete_node, context);
+  delete_executor.AddChild(&index_scan_executor);
+
+  auto txn = context->GetTransaction();
+  if (delete_executor.Init() == false) {
+    txn->SetResult(Result::RESULT_FAILURE);
+    return false;
+  }
+
+  // Failures are reported through the transaction result
+  while (delete_executor.Execute() == true)
+    ;
+
+  return (txn->GetResult() == Result::RESULT_SUCCESS);
+}
+
+bool EndTransaction(concurrency::Transaction *txn) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  bool status = (txn->GetResult() == Result::RESULT_SUCCESS);
+
+  if (txn->IsReadOnly()) {
+    txn_manager.EndReadOnlyTransaction();
+    return status;
+  }
+
+  if (status == false) {
+    txn_manager.AbortTransaction();
+    return false;
+  }
+
+  // Commit fails if an optimistic transaction doesn't validate
+  auto result = txn_manager.CommitTransaction();
+  return (result == Result::RESULT_SUCCESS);
+}
+
+bool GetCustomerIdByLastName(executor::ExecutorContext *context,
+                             const int c_w_id, const int c_d_id,
+                             const std::string &c_last, int &c_id) {
+  auto pool = context->GetExecutorContextPool();
+  auto customers = ExecuteRead(context, customer_table, SECONDARY_INDEX_OFFSET,
+                               {ValueFactory::GetIntegerValue(c_d_id),
+                                ValueFactory::GetIntegerValue(c_w_id),
+                                ValueFactory::GetStringValue(c_last, pool)},
+                               {C_ID, C_FIRST});
+
+  if (customers.empty()) {
+    context->GetTransaction()->SetResult(Result::RESULT_FAILURE);
+    return false;
+  }
+
+  std::sort(customers.begin(), customers.end(),
+            [](const std::vector<Value> &lhs, const std::vector<Value> &rhs) {
+              return lhs[1].Compare(rhs[1]) == VALUE_COMPARE_LESSTHAN;
+            });
+
+  // The one at position ceil(n / 2), counting from 1
+  auto &customer = customers[(customers.size() - 1) / 2];
+  c_id = ValuePeeker::PeekInteger(customer[0]);
+
+  return true;
+}
+
+//===--------------------------------------------------------------------===//
+// Workload
+//===--------------------------------------------------------------------===//
+
+struct BackendStats {
+  // in microseconds, of the committed transactions
+  std::vector<double> latencies[TRANSACTION_TYPE_COUNT];
+
+  unsigned long abort_counts[TRANSACTION_TYPE_COUNT] = {0};
+};
+
+static std::string GetTransactionName(TransactionType type) {
+  switch (type) {
+    case TRANSACTION_TYPE_NEW_ORDER:
+      return "NEW_ORDER";
+    case TRANSACTION_TYPE_PAYMENT:
+      return "PAYMENT";
+    case TRANSACTION_TYPE_ORDER_STATUS:
+      return "ORDER_STATUS";
+    case TRANSACTION_TYPE_DELIVERY:
+      return "DELIVERY";
+    case TRANSACTION_TYPE_STOCK_LEVEL:
+      return "STOCK_LEVEL";
+    default:
+      return "INVALID";
+  }
+}
+
+// The mix of the spec : 45% NewOrder, 43% Payment and 4% of the others
+static TransactionType GetTransactionType() {
+  int draw = GetRandomInteger(1, 100);
+
+  if (draw <= 45) return TRANSACTION_TYPE_NEW_ORDER;
+  if (draw <= 88) return TRANSACTION_TYPE_PAYMENT;
+  if (draw <= 92) return TRANSACTION_TYPE_ORDER_STATUS;
+  if (draw <= 96) return TRANSACTION_TYPE_DELIVERY;
+
+  return TRANSACTION_TYPE_STOCK_LEVEL;
+}
+
+static bool RunTransaction(TransactionType type, const int w_id) {
+  switch (type) {
+    case TRANSACTION_TYPE_NEW_ORDER:
+      return RunNewOrder(w_id);
+    case TRANSACTION_TYPE_PAYMENT:
+      return RunPayment(w_id);
+    case TRANSACTION_TYPE_ORDER_STATUS:
+      return RunOrderStatus(w_id);
+    case TRANSACTION_TYPE_DELIVERY:
+      return RunDelivery(w_id);
+    case TRANSACTION_TYPE_STOCK_LEVEL:
+      return RunStockLevel(w_id);
+    default:
+      throw Exception("Invalid transaction type");
+  }
+}
+
+static void RunBackend(oid_t backend_id, BackendStats &stats) {
+  SetRandomSeed(backend_id + 1);
+
+  // Backends are spread over the warehouses
+  const int w_id = (backend_id % state.warehouse_count) + 1;
+
+  for (unsigned long txn_itr = 0; txn_itr < state.transactions; txn_itr++) {
+    auto type = GetTransactionType();
+
+    auto start = std::chrono::steady_clock::now();
+    bool status = RunTransaction(type, w_id);
+    auto end = std::chrono::steady_clock::now();
+
+    if (status == false) {
+      stats.abort_counts[type]++;
+      continue;
+    }
+
+    std::chrono::duration<double, std::micro> latency = end - start;
+    stats.latencies[type].push_back(latency.count());
+  }
+}
+
+std::ofstream out("outputfile.summary");
+
+static double GetPercentile(const std::vector<double> &sorted_latencies,
+                            double percentile) {
+  if (sorted_latencies.empty()) return 0;
+
+  size_t rank = percentile * (sorted_latencies.size() - 1);
+  return sorted_latencies[rank];
+}
+
+static void WriteOutput(std::vector<BackendStats> &backend_stats,
+                        double duration) {
+  unsigned long commit_count = 0;
+  unsigned long abort_count = 0;
+  unsigned long new_order_count = 0;
+  for (auto &stats : backend_stats) {
+    for (int type = 0; type < TRANSACTION_TYPE_COUNT; type++) {
+      commit_count += stats.latencies[type].size();
+      abort_count += stats.abort_counts[type];
+    }
+    new_order_count += stats.latencies[TRANSACTION_TYPE_NEW_ORDER].size();
+  }
+
+  double tpmc = new_order_count / (duration / 60);
+  double abort_rate = 0;
+  if (commit_count + abort_count != 0) {
+    abort_rate = (double)abort_count / (commit_count + abort_count);
+  }
+
+  std::cout << "----------------------------------------------------------\n";
+  std::cout << state.warehouse_count << " " << state.item_count << " "
+            << state.customer_count << " " << state.backend_count << " :: ";
+  std::cout << tpmc << " tpmC " << abort_rate << " abort rate\n";
+
+  out << state.warehouse_count << " ";
+  out << state.item_count << " ";
+  out << state.customer_count << " ";
+  out << state.backend_count << " ";
+  out << tpmc << " ";
+  out << abort_rate << "\n";
+
+  // Latencies are in microseconds
+  std::cout << "txn count aborts avg p50 p95 p99 max\n";
+  for (int type = 0; type < TRANSACTION_TYPE_COUNT; type++) {
+    std::vector<double> latencies;
+    unsigned long type_abort_count = 0;
+    for (auto &stats : backend_stats) {
+      latencies.insert(latencies.end(), stats.latencies[type].begin(),
+                       stats.latencies[type].end());
+      type_abort_count += stats.abort_counts[type];
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    double sum = 0;
+    for (auto latency : latencies) sum += latency;
+    double average = latencies.empty() ? 0 : sum / latencies.size();
+    double max = latencies.empty() ? 0 : latencies.back();
+
+    std::cout << GetTransactionName((TransactionType)type) << " "
+              << latencies.size() << " " << type_abort_count << " "
+              << average << " " << GetPercentile(latencies, 0.50) << " "
+              << GetPercentile(latencies, 0.95) << " "
+              << GetPercentile(latencies, 0.99) << " " << max << "\n";
+
+    out << GetTransactionName((TransactionType)type) << " ";
+    out << latencies.size() << " ";
+    out << type_abort_count << " ";
+    out << average << " ";
+    out << GetPercentile(latencies, 0.50) << " ";
+    out << GetPercentile(latencies, 0.95) << " ";
+    out << GetPercentile(latencies, 0.99) << " ";
+    out << max << "\n";
+  }
+
+  out.flush();
+}
+
+void RunWorkload() {
+  std::vector<BackendStats> backend_stats(state.backend_count);
+  std::vector<std::thread> backends;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (int backend_itr = 0; backend_itr < state.backend_count; backend_itr++) {
+    backends.push_back(std::thread(RunBackend, backend_itr,
+                                   std::ref(backend_stats[backend_itr])));
+  }
+
+  for (auto &backend : backends) {
+    backend.join();
+  }
+
+  auto end = std::chrono::steady_clock::now();
+  std::chrono::duration<double> elapsed_seconds = end - start;
+
+  WriteOutput(backend_stats, elapsed_seconds.count());
+}
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
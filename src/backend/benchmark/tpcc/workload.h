@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// workload.h
+//
+// Identification: benchmark/tpcc/workload.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "backend/benchmark/tpcc/configuration.h"
+#include "backend/common/value.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/executor/executor_context.h"
+#include "backend/expression/abstract_expression.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+extern configuration state;
+
+void RunWorkload();
+
+//===--------------------------------------------------------------------===//
+// Transactions
+//===--------------------------------------------------------------------===//
+
+// Every transaction runs against the home warehouse of the backend, and
+// returns true if it committed. A NewOrder rolled back on purpose counts as
+// committed, as it does in the spec.
+
+bool RunNewOrder(const int w_id);
+
+bool RunPayment(const int w_id);
+
+bool RunOrderStatus(const int w_id);
+
+bool RunDelivery(const int w_id);
+
+bool RunStockLevel(const int w_id);
+
+/**
+ * @brief Pick the customer in the middle of the ones with the given last
+ * name, ordered by first name.
+ * @return false if there is none, and fails the transaction.
+ */
+bool GetCustomerIdByLastName(executor::ExecutorContext *context,
+                             const int c_w_id, const int c_d_id,
+                             const std::string &c_last, int &c_id);
+
+//===--------------------------------------------------------------------===//
+// Plans
+//===--------------------------------------------------------------------===//
+
+// Every statement looks up the full key of one of the indexes of a table,
+// and sets the transaction result on failure.
+
+/**
+ * @brief Read the given columns of the rows matching the key.
+ * The predicate, if any, is owned by the plan.
+ */
+std::vector<std::vector<Value>> ExecuteRead(
+    executor::ExecutorContext *context, storage::DataTable *table,
+    const oid_t index_offset, const std::vector<Value> &key_values,
+    const std::vector<oid_t> &column_ids,
+    expression::AbstractExpression *predicate = nullptr);
+
+/**
+ * @brief Read the given columns of the row matching a unique key.
+ * @return false if there is no such row, and fails the transaction.
+ */
+bool ExecuteReadRow(executor::ExecutorContext *context,
+                    storage::DataTable *table, const oid_t index_offset,
+                    const std::vector<Value> &key_values,
+                    const std::vector<oid_t> &column_ids,
+                    std::vector<Value> &row);
+
+// Overwrite the given columns of the rows matching the key
+bool ExecuteUpdate(executor::ExecutorContext *context,
+                   storage::DataTable *table, const oid_t index_offset,
+                   const std::vector<Value> &key_values,
+                   const std::vector<std::pair<oid_t, Value>> &updates);
+
+bool ExecuteInsert(executor::ExecutorContext *context,
+                   storage::DataTable *table, const std::vector<Value> &values);
+
+bool ExecuteDelete(executor::ExecutorContext *context,
+                   storage::DataTable *table, const oid_t index_offset,
+                   const std::vector<Value> &key_values);
+
+/**
+ * @brief Commit or abort the transaction, depending on its result.
+ * @return true if the transaction committed.
+ */
+bool EndTransaction(concurrency::Transaction *txn);
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,226 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// configuration.cpp
+//
+// Identification: benchmark/ycsb/configuration.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+#include "backend/benchmark/ycsb/configuration.h"
+
+namespace peloton {
+namespace benchmark {
+namespace ycsb {
+
+void Usage(FILE *out) {
+  fprintf(out,
+          "Command line options : ycsb <options> \n"
+          "   -h --help              :  Print help message \n"
+          "   -k --key_count         :  # of keys \n"
+          "   -c --column_count      :  # of value columns \n"
+          "   -g --tuples_per_tg     :  # of tuples per tilegroup \n"
+          "   -t --transactions      :  # of operations per backend \n"
+          "   -b --backend_count     :  # of backends \n"
+          "   -r --read_ratio        :  Fraction of reads \n"
+          "   -u --update_ratio      :  Fraction of updates \n"
+          "   -i --insert_ratio      :  Fraction of inserts \n"
+          "   -s --scan_ratio        :  Fraction of scans \n"
+          "   -z --zipf_theta        :  Skew of the keys, 0 is uniform \n"
+          "   -l --scan_length       :  # of tuples per scan \n");
+  exit(EXIT_FAILURE);
+}
+
+static struct option opts[] = {
+    {"key_count", optional_argument, NULL, 'k'},
+    {"column_count", optional_argument, NULL, 'c'},
+    {"tuples_per_tg", optional_argument, NULL, 'g'},
+    {"transactions", optional_argument, NULL, 't'},
+    {"backend_count", optional_argument, NULL, 'b'},
+    {"read_ratio", optional_argument, NULL, 'r'},
+    {"update_ratio", optional_argument, NULL, 'u'},
+    {"insert_ratio", optional_argument, NULL, 'i'},
+    {"scan_ratio", optional_argument, NULL, 's'},
+    {"zipf_theta", optional_argument, NULL, 'z'},
+    {"scan_length", optional_argument, NULL, 'l'},
+    {NULL, 0, NULL, 0}};
+
+static void ValidateKeyCount(const configuration &state) {
+  if (state.key_count <= 0) {
+    std::cout << "Invalid key_count :: " << state.key_count << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "key_count "
+            << " : " << state.key_count << std::endl;
+}
+
+static void ValidateColumnCount(const configuration &state) {
+  if (state.column_count <= 0) {
+    std::cout << "Invalid column_count :: " << state.column_count
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "column_count "
+            << " : " << state.column_count << std::endl;
+}
+
+static void ValidateTuplesPerTileGroup(const configuration &state) {
+  if (state.tuples_per_tilegroup <= 0) {
+    std::cout << "Invalid tuples_per_tilegroup :: "
+              << state.tuples_per_tilegroup << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "tuples_per_tgroup "
+            << " : " << state.tuples_per_tilegroup << std::endl;
+}
+
+static void ValidateBackendCount(const configuration &state) {
+  if (state.backend_count <= 0) {
+    std::cout << "Invalid backend_count :: " << state.backend_count
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "backend_count "
+            << " : " << state.backend_count << std::endl;
+}
+
+static void ValidateOperationMix(const configuration &state) {
+  for (auto ratio : {state.read_ratio, state.update_ratio,
+                     state.insert_ratio, state.scan_ratio}) {
+    if (ratio < 0 || ratio > 1) {
+      std::cout << "Invalid operation ratio :: " << ratio << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  double ratio_sum = state.read_ratio + state.update_ratio +
+                     state.insert_ratio + state.scan_ratio;
+  if (std::abs(ratio_sum - 1) > 1e-6) {
+    std::cout << "Operation ratios don't sum up to 1 :: " << ratio_sum
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "operation_mix "
+            << " : " << state.read_ratio << " " << state.update_ratio << " "
+            << state.insert_ratio << " " << state.scan_ratio << std::endl;
+}
+
+static void ValidateZipfTheta(const configuration &state) {
+  // The zipfian generator is not defined for theta = 1
+  if (state.zipf_theta < 0 || state.zipf_theta >= 1) {
+    std::cout << "Invalid zipf_theta :: " << state.zipf_theta << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "zipf_theta "
+            << " : " << state.zipf_theta << std::endl;
+}
+
+static void ValidateScanLength(const configuration &state) {
+  if (state.scan_length <= 0) {
+    std::cout << "Invalid scan_length :: " << state.scan_length << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "scan_length "
+            << " : " << state.scan_length << std::endl;
+}
+
+void ParseArguments(int argc, char *argv[], configuration &state) {
+  // Default Values
+  state.key_count = 100000;
+  state.column_count = 10;
+  state.tuples_per_tilegroup = DEFAULT_TUPLES_PER_TILEGROUP;
+
+  state.transactions = 10000;
+  state.backend_count = 1;
+
+  // Workload A
+  state.read_ratio = 0.5;
+  state.update_ratio = 0.5;
+  state.insert_ratio = 0;
+  state.scan_ratio = 0;
+
+  state.zipf_theta = 0.99;
+  state.scan_length = 100;
+
+  // Parse args
+  while (1) {
+    int idx = 0;
+    int c = getopt_long(argc, argv, "hk:c:g:t:b:r:u:i:s:z:l:", opts, &idx);
+
+    if (c == -1) break;
+
+    switch (c) {
+      case 'k':
+        state.key_count = atoi(optarg);
+        break;
+      case 'c':
+        state.column_count = atoi(optarg);
+        break;
+      case 'g':
+        state.tuples_per_tilegroup = atoi(optarg);
+        break;
+      case 't':
+        state.transactions = atoi(optarg);
+        break;
+      case 'b':
+        state.backend_count = atoi(optarg);
+        break;
+      case 'r':
+        state.read_ratio = atof(optarg);
+        break;
+      case 'u':
+        state.update_ratio = atof(optarg);
+        break;
+      case 'i':
+        state.insert_ratio = atof(optarg);
+        break;
+      case 's':
+        state.scan_ratio = atof(optarg);
+        break;
+      case 'z':
+        state.zipf_theta = atof(optarg);
+        break;
+      case 'l':
+        state.scan_length = atoi(optarg);
+        break;
+
+      case 'h':
+        Usage(stderr);
+        break;
+
+      default:
+        fprintf(stderr, "\nUnknown option: -%c-\n", c);
+        Usage(stderr);
+    }
+  }
+
+  // Print configuration
+  ValidateKeyCount(state);
+  ValidateColumnCount(state);
+  ValidateTuplesPerTileGroup(state);
+  ValidateBackendCount(state);
+  ValidateOperationMix(state);
+  ValidateZipfTheta(state);
+  ValidateScanLength(state);
+
+  std::cout << std::setw(20) << std::left << "transactions "
+            << " : " << state.transactions << std::endl;
+}
+
+}  // namespace ycsb
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// configuration.h
+//
+// Identification: benchmark/ycsb/configuration.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <getopt.h>
+#include <vector>
+#include <sys/time.h>
+#include <iostream>
+
+#include "backend/storage/data_table.h"
+
+namespace peloton {
+namespace benchmark {
+namespace ycsb {
+
+enum OperationType {
+  OPERATION_TYPE_READ = 0,
+  OPERATION_TYPE_UPDATE = 1,
+  OPERATION_TYPE_INSERT = 2,
+  OPERATION_TYPE_SCAN = 3,
+
+  OPERATION_TYPE_COUNT = 4
+};
+
+class configuration {
+ public:
+  // # of keys loaded
+  int key_count;
+
+  // # of value columns, besides the key
+  int column_count;
+
+  int tuples_per_tilegroup;
+
+  // # of operations run by every backend
+  unsigned long transactions;
+
+  // # of backend threads
+  int backend_count;
+
+  // operation mix, sums up to 1
+  double read_ratio;
+
+  double update_ratio;
+
+  double insert_ratio;
+
+  double scan_ratio;
+
+  // skew of the keys accessed, 0 for uniform
+  double zipf_theta;
+
+  // # of tuples read by a scan
+  int scan_length;
+};
+
+void Usage(FILE *out);
+
+void ParseArguments(int argc, char *argv[], configuration &state);
+
+}  // namespace ycsb
+}  // namespace benchmark
+}  // namespace peloton
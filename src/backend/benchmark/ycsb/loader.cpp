@@ -0,0 +1,155 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// loader.cpp
+//
+// Identification: benchmark/ycsb/loader.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cassert>
+
+#include "backend/benchmark/ycsb/loader.h"
+#include "backend/catalog/manager.h"
+#include "backend/catalog/schema.h"
+#include "backend/common/exception.h"
+#include "backend/common/value_factory.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/index/index_factory.h"
+#include "backend/storage/tuple.h"
+#include "backend/storage/data_table.h"
+#include "backend/storage/table_factory.h"
+
+namespace peloton {
+namespace benchmark {
+namespace ycsb {
+
+storage::DataTable *user_table;
+
+// Tuples are handed to the bulk-load path this many at a time
+#define YCSB_LOAD_BATCH_SIZE 1000
+
+void CreateTable() {
+  const oid_t col_count = state.column_count + 1;
+  const bool is_inlined = true;
+
+  // Create schema first, the key comes first
+  std::vector<catalog::Column> columns;
+
+  for (oid_t col_itr = 0; col_itr < col_count; col_itr++) {
+    auto column =
+        catalog::Column(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                        "" + std::to_string(col_itr), is_inlined);
+
+    columns.push_back(column);
+  }
+
+  catalog::Schema *table_schema = new catalog::Schema(columns);
+  std::string table_name("USERTABLE");
+
+  /////////////////////////////////////////////////////////
+  // Create table.
+  /////////////////////////////////////////////////////////
+
+  // Clean up
+  delete user_table;
+
+  bool own_schema = true;
+  bool adapt_table = false;
+  user_table = storage::TableFactory::GetDataTable(
+      INVALID_OID, INVALID_OID, table_schema, table_name,
+      state.tuples_per_tilegroup, own_schema, adapt_table);
+
+  // PRIMARY INDEX
+  std::vector<oid_t> key_attrs;
+
+  auto tuple_schema = user_table->GetSchema();
+  catalog::Schema *key_schema;
+  index::IndexMetadata *index_metadata;
+  bool unique;
+
+  key_attrs = {0};
+  key_schema = catalog::Schema::CopySchema(tuple_schema, key_attrs);
+  key_schema->SetIndexedColumns(key_attrs);
+
+  unique = true;
+
+  index_metadata = new index::IndexMetadata(
+      "primary_index", 123, INDEX_TYPE_BTREE,
+      INDEX_CONSTRAINT_TYPE_PRIMARY_KEY, tuple_schema, key_schema, unique);
+
+  index::Index *pkey_index = index::IndexFactory::GetInstance(index_metadata);
+  user_table->AddIndex(pkey_index);
+}
+
+void LoadTable() {
+  const oid_t col_count = state.column_count + 1;
+  const int tuple_count = state.key_count;
+
+  auto table_schema = user_table->GetSchema();
+
+  /////////////////////////////////////////////////////////
+  // Load in the data
+  /////////////////////////////////////////////////////////
+
+  // Insert tuples into tile_group.
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  const bool allocate = true;
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<VarlenPool> pool(new VarlenPool(BACKEND_TYPE_MM));
+
+  std::vector<std::unique_ptr<storage::Tuple>> batch;
+  std::vector<const storage::Tuple *> batch_tuples;
+  std::vector<ItemPointer> locations;
+
+  for (int rowid = 0; rowid < tuple_count; rowid++) {
+    storage::Tuple *tuple = new storage::Tuple(table_schema, allocate);
+
+    for (oid_t col_itr = 0; col_itr < col_count; col_itr++) {
+      auto value = ValueFactory::GetIntegerValue(rowid);
+      tuple->SetValue(col_itr, value, pool.get());
+    }
+
+    batch.emplace_back(tuple);
+    batch_tuples.push_back(tuple);
+
+    if (batch.size() < YCSB_LOAD_BATCH_SIZE && rowid + 1 < tuple_count) {
+      continue;
+    }
+
+    // Insert the batch through the bulk-load path
+    locations.clear();
+    bool status = user_table->InsertTuples(txn, batch_tuples, locations);
+    for (auto location : locations) txn->RecordInsert(location);
+
+    if (status == false) {
+      txn_manager.AbortTransaction();
+      throw Exception("Failed to load the table");
+    }
+
+    batch.clear();
+    batch_tuples.clear();
+  }
+
+  txn_manager.CommitTransaction();
+
+  std::cout << "Loaded " << tuple_count << " tuples\n";
+}
+
+void CreateAndLoadTable() {
+  CreateTable();
+
+  LoadTable();
+}
+
+}  // namespace ycsb
+}  // namespace benchmark
+}  // namespace peloton
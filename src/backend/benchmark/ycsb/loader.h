@@ -0,0 +1,33 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// loader.h
+//
+// Identification: benchmark/ycsb/loader.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "backend/benchmark/ycsb/configuration.h"
+
+namespace peloton {
+namespace benchmark {
+namespace ycsb {
+
+extern configuration state;
+
+extern storage::DataTable *user_table;
+
+void CreateTable();
+
+void LoadTable();
+
+void CreateAndLoadTable();
+
+}  // namespace ycsb
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,482 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// workload.cpp
+//
+// Identification: benchmark/ycsb/workload.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <cmath>
+#include <cassert>
+
+#include "backend/benchmark/ycsb/loader.h"
+#include "backend/benchmark/ycsb/workload.h"
+#include "backend/common/exception.h"
+#include "backend/common/types.h"
+#include "backend/common/value.h"
+#include "backend/common/value_factory.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/executor/executor_context.h"
+#include "backend/executor/abstract_executor.h"
+#include "backend/executor/logical_tile.h"
+#include "backend/executor/index_scan_executor.h"
+#include "backend/executor/insert_executor.h"
+#include "backend/executor/limit_executor.h"
+#include "backend/executor/update_executor.h"
+#include "backend/expression/expression_util.h"
+#include "backend/expression/constant_value_expression.h"
+#include "backend/index/index.h"
+#include "backend/planner/index_scan_plan.h"
+#include "backend/planner/insert_plan.h"
+#include "backend/planner/limit_plan.h"
+#include "backend/planner/update_plan.h"
+#include "backend/storage/data_table.h"
+
+namespace peloton {
+namespace benchmark {
+namespace ycsb {
+
+//===--------------------------------------------------------------------===//
+// Zipfian Generator
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Zipfian ranks over [0, n), as generated by YCSB (Gray et al.,
+ * "Quickly Generating Billion-Record Synthetic Databases").
+ * Ranks are scrambled over the key space with a FNV hash, so the popular
+ * keys are not clustered at the start of the index.
+ */
+class ZipfDistribution {
+ public:
+  ZipfDistribution(const uint64_t n, const double theta)
+      : n(n), theta(theta), uniform(0.0, 1.0) {
+    zetan = Zeta(n, theta);
+    double zeta2 = Zeta(2, theta);
+
+    alpha = 1.0 / (1.0 - theta);
+    eta = (1 - std::pow(2.0 / n, 1 - theta)) / (1 - zeta2 / zetan);
+  }
+
+  uint64_t GetNextNumber(std::mt19937_64 &generator) {
+    double u = uniform(generator);
+    double uz = u * zetan;
+
+    uint64_t rank;
+    if (uz < 1.0) {
+      rank = 0;
+    } else if (uz < 1.0 + std::pow(0.5, theta)) {
+      rank = 1;
+    } else {
+      rank = static_cast<uint64_t>(n * std::pow(eta * u - eta + 1, alpha));
+    }
+
+    return FNVHash(std::min(rank, n - 1)) % n;
+  }
+
+ private:
+  static double Zeta(const uint64_t n, const double theta) {
+    double sum = 0;
+    for (uint64_t i = 1; i <= n; i++) sum += 1.0 / std::pow(i, theta);
+
+    return sum;
+  }
+
+  static uint64_t FNVHash(uint64_t value) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (int byte_itr = 0; byte_itr < 8; byte_itr++) {
+      hash ^= value & 0xff;
+      hash *= 0x100000001b3ULL;
+      value >>= 8;
+    }
+
+    return hash;
+  }
+
+  const uint64_t n;
+
+  const double theta;
+
+  double zetan;
+
+  double alpha;
+
+  double eta;
+
+  std::uniform_real_distribution<double> uniform;
+};
+
+//===--------------------------------------------------------------------===//
+// Workload
+//===--------------------------------------------------------------------===//
+
+// Inserted keys follow the loaded ones
+static std::atomic<int> next_insert_key;
+
+struct BackendStats {
+  // in microseconds, of the committed operations
+  std::vector<double> latencies[OPERATION_TYPE_COUNT];
+
+  unsigned long abort_counts[OPERATION_TYPE_COUNT] = {0};
+};
+
+static std::string GetOperationName(OperationType type) {
+  switch (type) {
+    case OPERATION_TYPE_READ:
+      return "READ";
+    case OPERATION_TYPE_UPDATE:
+      return "UPDATE";
+    case OPERATION_TYPE_INSERT:
+      return "INSERT";
+    case OPERATION_TYPE_SCAN:
+      return "SCAN";
+    default:
+      return "INVALID";
+  }
+}
+
+static OperationType GetOperationType(std::mt19937_64 &generator) {
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  double draw = uniform(generator);
+
+  if (draw < state.read_ratio) return OPERATION_TYPE_READ;
+  draw -= state.read_ratio;
+  if (draw < state.update_ratio) return OPERATION_TYPE_UPDATE;
+  draw -= state.update_ratio;
+  if (draw < state.insert_ratio) return OPERATION_TYPE_INSERT;
+
+  return OPERATION_TYPE_SCAN;
+}
+
+static std::vector<oid_t> GetAllColumnIds() {
+  std::vector<oid_t> column_ids;
+  for (oid_t col_itr = 0; col_itr <= (oid_t)state.column_count; col_itr++) {
+    column_ids.push_back(col_itr);
+  }
+
+  return column_ids;
+}
+
+static planner::IndexScanPlan::IndexScanDesc GetKeyScanDesc(
+    ExpressionType expr_type, const int key) {
+  auto index = user_table->GetIndex(0);
+  std::vector<oid_t> key_column_ids = {0};
+  std::vector<ExpressionType> expr_types = {expr_type};
+  std::vector<Value> values = {ValueFactory::GetIntegerValue(key)};
+  std::vector<expression::AbstractExpression *> runtime_keys;
+
+  return planner::IndexScanPlan::IndexScanDesc(
+      index, key_column_ids, expr_types, values, runtime_keys);
+}
+
+// Drain the executor, touching every value of its output
+static bool ExecuteQuery(executor::AbstractExecutor *executor) {
+  bool status = executor->Init();
+  if (status == false) return false;
+
+  while (executor->Execute() == true) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor->GetOutput());
+    if (result_tile == nullptr) break;
+
+    auto column_count = result_tile->GetColumnCount();
+    for (oid_t tuple_id : *result_tile) {
+      for (oid_t col_itr = 0; col_itr < column_count; col_itr++) {
+        result_tile->GetValue(tuple_id, col_itr);
+      }
+    }
+  }
+
+  return true;
+}
+
+static void RunRead(concurrency::Transaction *txn, const int key) {
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  planner::IndexScanPlan index_scan_node(
+      user_table, nullptr, GetAllColumnIds(),
+      GetKeyScanDesc(EXPRESSION_TYPE_COMPARE_EQUAL, key));
+  executor::IndexScanExecutor index_scan_executor(&index_scan_node,
+                                                  context.get());
+
+  if (ExecuteQuery(&index_scan_executor) == false) {
+    txn->SetResult(Result::RESULT_FAILURE);
+  }
+}
+
+static void RunScan(concurrency::Transaction *txn, const int key) {
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  planner::IndexScanPlan index_scan_node(
+      user_table, nullptr, GetAllColumnIds(),
+      GetKeyScanDesc(EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO, key));
+  executor::IndexScanExecutor index_scan_executor(&index_scan_node,
+                                                  context.get());
+
+  planner::LimitPlan limit_node(state.scan_length, 0);
+  executor::LimitExecutor limit_executor(&limit_node, context.get());
+  limit_executor.AddChild(&index_scan_executor);
+
+  if (ExecuteQuery(&limit_executor) == false) {
+    txn->SetResult(Result::RESULT_FAILURE);
+  }
+}
+
+static void RunUpdate(concurrency::Transaction *txn, const int key,
+                      std::mt19937_64 &generator) {
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  std::vector<oid_t> key_column_ids = {0};
+  planner::IndexScanPlan index_scan_node(
+      user_table, nullptr, key_column_ids,
+      GetKeyScanDesc(EXPRESSION_TYPE_COMPARE_EQUAL, key));
+  executor::IndexScanExecutor index_scan_executor(&index_scan_node,
+                                                  context.get());
+
+  // Overwrite one of the fields, keep the rest
+  std::uniform_int_distribution<oid_t> field(1, state.column_count);
+  oid_t update_column = field(generator);
+  Value update_val = ValueFactory::GetIntegerValue(key + 1);
+
+  planner::ProjectInfo::TargetList target_list;
+  planner::ProjectInfo::DirectMapList direct_map_list;
+
+  for (oid_t col_itr = 0; col_itr <= (oid_t)state.column_count; col_itr++) {
+    if (col_itr == update_column) {
+      auto expression = expression::ConstantValueFactory(update_val);
+      target_list.emplace_back(col_itr, expression);
+    } else {
+      direct_map_list.emplace_back(col_itr, std::make_pair(0, col_itr));
+    }
+  }
+
+  auto project_info = new planner::ProjectInfo(std::move(target_list),
+                                               std::move(direct_map_list));
+  planner::UpdatePlan update_node(user_table, project_info);
+  executor::UpdateExecutor update_executor(&update_node, context.get());
+  update_executor.AddChild(&index_scan_executor);
+
+  bool status = update_executor.Init();
+  if (status == false) {
+    txn->SetResult(Result::RESULT_FAILURE);
+    return;
+  }
+
+  // Failures are reported through the transaction result
+  while (update_executor.Execute() == true)
+    ;
+}
+
+static void RunInsert(concurrency::Transaction *txn) {
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  Value insert_val = ValueFactory::GetIntegerValue(next_insert_key++);
+
+  planner::ProjectInfo::TargetList target_list;
+  planner::ProjectInfo::DirectMapList direct_map_list;
+
+  for (oid_t col_itr = 0; col_itr <= (oid_t)state.column_count; col_itr++) {
+    auto expression = expression::ConstantValueFactory(insert_val);
+    target_list.emplace_back(col_itr, expression);
+  }
+
+  auto project_info = new planner::ProjectInfo(std::move(target_list),
+                                               std::move(direct_map_list));
+  planner::InsertPlan insert_node(user_table, project_info);
+  executor::InsertExecutor insert_executor(&insert_node, context.get());
+
+  bool status = insert_executor.Init();
+  if (status == false) {
+    txn->SetResult(Result::RESULT_FAILURE);
+    return;
+  }
+
+  insert_executor.Execute();
+}
+
+// Run one operation in its own transaction, returns true if it committed
+static bool RunOperation(OperationType type, ZipfDistribution &zipf,
+                         std::mt19937_64 &generator) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  const int key = zipf.GetNextNumber(generator);
+
+  concurrency::Transaction *txn;
+  if (type == OPERATION_TYPE_READ || type == OPERATION_TYPE_SCAN) {
+    txn = txn_manager.BeginReadOnlyTransaction();
+  } else {
+    txn = txn_manager.BeginTransaction();
+  }
+
+  switch (type) {
+    case OPERATION_TYPE_READ:
+      RunRead(txn, key);
+      break;
+    case OPERATION_TYPE_UPDATE:
+      RunUpdate(txn, key, generator);
+      break;
+    case OPERATION_TYPE_INSERT:
+      RunInsert(txn);
+      break;
+    case OPERATION_TYPE_SCAN:
+      RunScan(txn, key);
+      break;
+    default:
+      throw Exception("Invalid operation type");
+  }
+
+  if (txn->IsReadOnly()) {
+    bool status = (txn->GetResult() == Result::RESULT_SUCCESS);
+    txn_manager.EndReadOnlyTransaction();
+    return status;
+  }
+
+  if (txn->GetResult() != Result::RESULT_SUCCESS) {
+    txn_manager.AbortTransaction();
+    return false;
+  }
+
+  // Commit fails if an optimistic transaction doesn't validate
+  auto result = txn_manager.CommitTransaction();
+  return (result == Result::RESULT_SUCCESS);
+}
+
+static void RunBackend(oid_t backend_id, BackendStats &stats) {
+  std::mt19937_64 generator(backend_id + 1);
+  ZipfDistribution zipf(state.key_count, state.zipf_theta);
+
+  for (unsigned long txn_itr = 0; txn_itr < state.transactions; txn_itr++) {
+    auto type = GetOperationType(generator);
+
+    auto start = std::chrono::steady_clock::now();
+    bool status = RunOperation(type, zipf, generator);
+    auto end = std::chrono::steady_clock::now();
+
+    if (status == false) {
+      stats.abort_counts[type]++;
+      continue;
+    }
+
+    std::chrono::duration<double, std::micro> latency = end - start;
+    stats.latencies[type].push_back(latency.count());
+  }
+}
+
+std::ofstream out("outputfile.summary");
+
+static double GetPercentile(const std::vector<double> &sorted_latencies,
+                            double percentile) {
+  if (sorted_latencies.empty()) return 0;
+
+  size_t rank = percentile * (sorted_latencies.size() - 1);
+  return sorted_latencies[rank];
+}
+
+static void WriteOutput(std::vector<BackendStats> &backend_stats,
+                        double duration) {
+  unsigned long commit_count = 0;
+  for (auto &stats : backend_stats) {
+    for (int type = 0; type < OPERATION_TYPE_COUNT; type++) {
+      commit_count += stats.latencies[type].size();
+    }
+  }
+
+  double throughput = commit_count / duration;
+
+  std::cout << "----------------------------------------------------------\n";
+  std::cout << state.key_count << " " << state.column_count << " "
+            << state.backend_count << " " << state.read_ratio << " "
+            << state.update_ratio << " " << state.insert_ratio << " "
+            << state.scan_ratio << " " << state.zipf_theta << " :: ";
+  std::cout << throughput << " txn/s\n";
+
+  out << state.key_count << " ";
+  out << state.column_count << " ";
+  out << state.backend_count << " ";
+  out << state.read_ratio << " ";
+  out << state.update_ratio << " ";
+  out << state.insert_ratio << " ";
+  out << state.scan_ratio << " ";
+  out << state.zipf_theta << " ";
+  out << throughput << "\n";
+
+  // Latencies are in microseconds
+  std::cout << "op count aborts avg p50 p95 p99 max\n";
+  for (int type = 0; type < OPERATION_TYPE_COUNT; type++) {
+    std::vector<double> latencies;
+    unsigned long abort_count = 0;
+    for (auto &stats : backend_stats) {
+      latencies.insert(latencies.end(), stats.latencies[type].begin(),
+                       stats.latencies[type].end());
+      abort_count += stats.abort_counts[type];
+    }
+
+    if (latencies.empty() && abort_count == 0) continue;
+
+    std::sort(latencies.begin(), latencies.end());
+    double sum = 0;
+    for (auto latency : latencies) sum += latency;
+    double average = latencies.empty() ? 0 : sum / latencies.size();
+    double max = latencies.empty() ? 0 : latencies.back();
+
+    std::cout << GetOperationName((OperationType)type) << " "
+              << latencies.size() << " " << abort_count << " " << average
+              << " " << GetPercentile(latencies, 0.50) << " "
+              << GetPercentile(latencies, 0.95) << " "
+              << GetPercentile(latencies, 0.99) << " " << max << "\n";
+
+    out << GetOperationName((OperationType)type) << " ";
+    out << latencies.size() << " ";
+    out << abort_count << " ";
+    out << average << " ";
+    out << GetPercentile(latencies, 0.50) << " ";
+    out << GetPercentile(latencies, 0.95) << " ";
+    out << GetPercentile(latencies, 0.99) << " ";
+    out << max << "\n";
+  }
+
+  out.flush();
+}
+
+void RunWorkload() {
+  next_insert_key = state.key_count;
+
+  std::vector<BackendStats> backend_stats(state.backend_count);
+  std::vector<std::thread> backends;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (int backend_itr = 0; backend_itr < state.backend_count; backend_itr++) {
+    backends.push_back(std::thread(RunBackend, backend_itr,
+                                   std::ref(backend_stats[backend_itr])));
+  }
+
+  for (auto &backend : backends) {
+    backend.join();
+  }
+
+  auto end = std::chrono::steady_clock::now();
+  std::chrono::duration<double> elapsed_seconds = end - start;
+
+  WriteOutput(backend_stats, elapsed_seconds.count());
+}
+
+}  // namespace ycsb
+}  // namespace benchmark
+}  // namespace peloton
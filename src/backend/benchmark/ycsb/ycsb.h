@@ -0,0 +1,25 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// ycsb.h
+//
+// Identification: benchmark/ycsb/ycsb.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "backend/benchmark/ycsb/configuration.h"
+
+namespace peloton {
+namespace benchmark {
+namespace ycsb {
+
+extern configuration state;
+
+}  // namespace ycsb
+}  // namespace benchmark
+}  // namespace peloton
@@ -10,13 +10,16 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <assert.h>
 #include <sys/types.h>
 #include <unistd.h>
 
 #include "backend/bridge/ddl/bridge.h"
+#include "backend/bridge/dml/tuple/tuple_transformer.h"
 #include "backend/common/logger.h"
+#include "backend/storage/table_stats.h"
 
 #include "postgres.h"
 #include "c.h"
@@ -30,12 +33,16 @@
 #include "catalog/pg_class.h"
 #include "catalog/pg_database.h"
 #include "catalog/pg_namespace.h"
+#include "catalog/pg_statistic.h"
 #include "catalog/pg_type.h"
 #include "common/fe_memutils.h"
+#include "parser/parse_oper.h"
+#include "utils/array.h"
 #include "utils/rel.h"
 #include "utils/ruleutils.h"
 #include "utils/builtins.h"
 #include "utils/lsyscache.h"
+#include "utils/pg_locale.h"
 #include "utils/snapmgr.h"
 #include "utils/syscache.h"
 #include "parser/parse_type.h"
@@ -317,5 +324,203 @@ void Bridge::SetNumberOfTuples(Oid relation_id, float num_tuples) {
   heap_close(pg_class_rel, RowExclusiveLock);
 }
 
+/**
+ * @brief Can the values of the column be handed to Postgres as datums of
+ * the column type ?
+ * @param atttypid type of the column
+ * @param value_type type of the values Peloton stores for it
+ */
+static bool HasCompatibleDatums(Oid atttypid, ValueType value_type) {
+  switch (atttypid) {
+    case POSTGRES_VALUE_TYPE_SMALLINT:
+      return value_type == VALUE_TYPE_SMALLINT;
+    case POSTGRES_VALUE_TYPE_INTEGER:
+      return value_type == VALUE_TYPE_INTEGER;
+    case POSTGRES_VALUE_TYPE_BIGINT:
+      return value_type == VALUE_TYPE_BIGINT;
+    case POSTGRES_VALUE_TYPE_DOUBLE:
+      return value_type == VALUE_TYPE_DOUBLE;
+    case POSTGRES_VALUE_TYPE_TEXT:
+    case POSTGRES_VALUE_TYPE_BPCHAR:
+    case POSTGRES_VALUE_TYPE_VARCHAR2:
+      return value_type == VALUE_TYPE_VARCHAR;
+    case POSTGRES_VALUE_TYPE_TIMESTAMPS:
+      return value_type == VALUE_TYPE_TIMESTAMP;
+    case POSTGRES_VALUE_TYPE_DECIMAL:
+      return value_type == VALUE_TYPE_DECIMAL;
+    default:
+      return false;
+  }
+}
+
+/**
+ * @brief Setting the column statistics, like ANALYZE does (see
+ * update_attstats). The most common values and the histogram are only
+ * stored for the types whose datums Peloton can build. Peloton sorts
+ * strings bytewise, so their histograms are only stored under the C
+ * collation, where Postgres orders them the same way.
+ * @param relation_id relation id
+ * @param stats statistics of the table
+ */
+void Bridge::SetColumnStats(Oid relation_id,
+                            const storage::TableStatsSnapshot &stats) {
+  assert(relation_id);
+
+  Relation pg_statistic_rel = heap_open(StatisticRelationId, RowExclusiveLock);
+
+  for (size_t column_itr = 0; column_itr < stats.columns.size();
+       column_itr++) {
+    auto &column_stats = stats.columns[column_itr];
+    AttrNumber attnum = column_itr + 1;
+
+    Oid atttypid = get_atttype(relation_id, attnum);
+    if (atttypid == InvalidOid) continue;
+
+    int32 atttypmod;
+    Oid attcollation;
+    get_atttypetypmodcoll(relation_id, attnum, &atttypid, &atttypmod,
+                          &attcollation);
+    bool sorted_bytewise =
+        (OidIsValid(attcollation) == false || lc_collate_is_c(attcollation));
+
+    int16 typlen;
+    bool typbyval;
+    char typalign;
+    get_typlenbyvalalign(atttypid, &typlen, &typbyval, &typalign);
+
+    Datum values[Natts_pg_statistic];
+    bool nulls[Natts_pg_statistic];
+    bool replaces[Natts_pg_statistic];
+    for (int attr_itr = 0; attr_itr < Natts_pg_statistic; attr_itr++) {
+      values[attr_itr] = (Datum)0;
+      nulls[attr_itr] = false;
+      replaces[attr_itr] = true;
+    }
+
+    // Many distinct values are stored as a fraction of the rows (negated),
+    // so that the estimate scales as the table grows
+    float4 distinct = column_stats.distinct_count;
+    if (stats.tuple_count > 0 &&
+        column_stats.distinct_count > 0.1 * stats.tuple_count) {
+      distinct =
+          -std::min(1.0, column_stats.distinct_count / stats.tuple_count);
+    }
+
+    int32 width = column_stats.average_width + 0.5;
+    if (typlen == -1) width += VARHDRSZ;
+
+    values[Anum_pg_statistic_starelid - 1] = ObjectIdGetDatum(relation_id);
+    values[Anum_pg_statistic_staattnum - 1] = Int16GetDatum(attnum);
+    values[Anum_pg_statistic_stainherit - 1] = BoolGetDatum(false);
+    values[Anum_pg_statistic_stanullfrac - 1] =
+        Float4GetDatum(column_stats.null_fraction);
+    values[Anum_pg_statistic_stawidth - 1] = Int32GetDatum(width);
+    values[Anum_pg_statistic_stadistinct - 1] = Float4GetDatum(distinct);
+
+    // Fill the slots
+    int16 kinds[STATISTIC_NUM_SLOTS] = {0};
+    Oid operators[STATISTIC_NUM_SLOTS] = {InvalidOid};
+    ArrayType *numbers[STATISTIC_NUM_SLOTS] = {nullptr};
+    ArrayType *slot_values[STATISTIC_NUM_SLOTS] = {nullptr};
+    int slot_count = 0;
+
+    auto &common_values = column_stats.most_common_values;
+    auto &bounds = column_stats.histogram_bounds;
+    ValueType value_type = VALUE_TYPE_INVALID;
+    if (common_values.empty() == false) {
+      value_type = common_values[0].GetValueType();
+    } else if (bounds.empty() == false) {
+      value_type = bounds[0].GetValueType();
+    }
+
+    if (HasCompatibleDatums(atttypid, value_type)) {
+      Oid lt_operator, eq_operator;
+      get_sort_group_operators(atttypid, false, false, false, &lt_operator,
+                               &eq_operator, NULL, NULL);
+
+      if (common_values.empty() == false && OidIsValid(eq_operator)) {
+        auto count = common_values.size();
+        Datum *value_datums = (Datum *)palloc(count * sizeof(Datum));
+        Datum *number_datums = (Datum *)palloc(count * sizeof(Datum));
+        for (size_t value_itr = 0; value_itr < count; value_itr++) {
+          value_datums[value_itr] =
+              TupleTransformer::GetDatum(common_values[value_itr]);
+          number_datums[value_itr] =
+              Float4GetDatum(column_stats.most_common_frequencies[value_itr]);
+        }
+
+        kinds[slot_count] = STATISTIC_KIND_MCV;
+        operators[slot_count] = eq_operator;
+        numbers[slot_count] =
+            construct_array(number_datums, count, FLOAT4OID, sizeof(float4),
+                            FLOAT4PASSBYVAL, 'i');
+        slot_values[slot_count] = construct_array(
+            value_datums, count, atttypid, typlen, typbyval, typalign);
+        slot_count++;
+      }
+
+      if (bounds.size() >= 2 && OidIsValid(lt_operator) && sorted_bytewise) {
+        auto count = bounds.size();
+        Datum *value_datums = (Datum *)palloc(count * sizeof(Datum));
+        for (size_t value_itr = 0; value_itr < count; value_itr++) {
+          value_datums[value_itr] =
+              TupleTransformer::GetDatum(bounds[value_itr]);
+        }
+
+        kinds[slot_count] = STATISTIC_KIND_HISTOGRAM;
+        operators[slot_count] = lt_operator;
+        slot_values[slot_count] = construct_array(
+            value_datums, count, atttypid, typlen, typbyval, typalign);
+        slot_count++;
+      }
+    }
+
+    for (int slot_itr = 0; slot_itr < STATISTIC_NUM_SLOTS; slot_itr++) {
+      values[Anum_pg_statistic_stakind1 - 1 + slot_itr] =
+          Int16GetDatum(kinds[slot_itr]);
+      values[Anum_pg_statistic_staop1 - 1 + slot_itr] =
+          ObjectIdGetDatum(operators[slot_itr]);
+
+      if (numbers[slot_itr] != nullptr) {
+        values[Anum_pg_statistic_stanumbers1 - 1 + slot_itr] =
+            PointerGetDatum(numbers[slot_itr]);
+      } else {
+        nulls[Anum_pg_statistic_stanumbers1 - 1 + slot_itr] = true;
+      }
+
+      if (slot_values[slot_itr] != nullptr) {
+        values[Anum_pg_statistic_stavalues1 - 1 + slot_itr] =
+            PointerGetDatum(slot_values[slot_itr]);
+      } else {
+        nulls[Anum_pg_statistic_stavalues1 - 1 + slot_itr] = true;
+      }
+    }
+
+    // Replace the existing tuple, if any
+    HeapTuple tuple;
+    HeapTuple old_tuple =
+        SearchSysCache3(STATRELATTINH, ObjectIdGetDatum(relation_id),
+                        Int16GetDatum(attnum), BoolGetDatum(false));
+
+    if (HeapTupleIsValid(old_tuple)) {
+      tuple = heap_modify_tuple(old_tuple, RelationGetDescr(pg_statistic_rel),
+                                values, nulls, replaces);
+      ReleaseSysCache(old_tuple);
+      simple_heap_update(pg_statistic_rel, &tuple->t_self, tuple);
+    } else {
+      tuple =
+          heap_form_tuple(RelationGetDescr(pg_statistic_rel), values, nulls);
+      simple_heap_insert(pg_statistic_rel, tuple);
+    }
+
+    /* keep the catalog indexes up to date */
+    CatalogUpdateIndexes(pg_statistic_rel, tuple);
+
+    heap_freetuple(tuple);
+  }
+
+  heap_close(pg_statistic_rel, RowExclusiveLock);
+}
+
 }  // namespace bridge
 }  // namespace peloton
@@ -16,6 +16,11 @@
 #include "access/htup.h"
 
 namespace peloton {
+
+namespace storage {
+struct TableStatsSnapshot;
+}
+
 namespace bridge {
 
 //===--------------------------------------------------------------------===//
@@ -54,6 +59,9 @@ class Bridge {
   //===--------------------------------------------------------------------===//
 
   static void SetNumberOfTuples(Oid relation_id, float num_of_tuples);
+
+  static void SetColumnStats(Oid relation_id,
+                             const storage::TableStatsSnapshot &stats);
 };
 
 }  // namespace bridge
@@ -16,8 +16,12 @@
 #include "backend/catalog/manager.h"
 
 #include "postmaster/peloton.h"
+#include "catalog/pg_class.h"
 #include "nodes/parsenodes.h"
+#include "nodes/plannodes.h"
+#include "parser/parsetree.h"
 #include "commands/dbcommands.h"
+#include "storage/lmgr.h"
 
 namespace peloton {
 namespace bridge {
@@ -79,6 +83,41 @@ bool DDLDatabase::ExecVacuumStmt(Node *parsetree) {
   return true;
 }
 
+/**
+ * @brief Refresh the statistics of the tables modified by a statement, if
+ * they went stale. Tables that are being analyzed are skipped.
+ * @param the planned statement
+ */
+void DDLDatabase::RefreshStats(PlannedStmt *planned_stmt) {
+  if (planned_stmt == nullptr || planned_stmt->commandType == CMD_SELECT) {
+    return;
+  }
+
+  oid_t database_oid = Bridge::GetCurrentDatabaseOid();
+  auto &manager = catalog::Manager::GetInstance();
+  auto db = manager.GetDatabaseWithOid(database_oid);
+  if (db == nullptr) return;
+
+  ListCell *result_relation;
+  foreach (result_relation, planned_stmt->resultRelations) {
+    int rt_index = lfirst_int(result_relation);
+    RangeTblEntry *rte = rt_fetch(rt_index, planned_stmt->rtable);
+    if (rte->rtekind != RTE_RELATION || rte->relkind != RELKIND_RELATION) {
+      continue;
+    }
+
+    // Like auto-analyze, don't wait for anyone. The statistics are written
+    // to pg_class and pg_statistic in the statement's transaction, so the
+    // lock is held until it ends, like ANALYZE does.
+    if (ConditionalLockRelationOid(rte->relid, ShareUpdateExclusiveLock) ==
+        false) {
+      continue;
+    }
+
+    db->RefreshStatsWithOid(rte->relid);
+  }
+}
+
 /**
  * @brief Create database.
  * @param database_oid database id
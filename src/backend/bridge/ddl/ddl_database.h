@@ -17,6 +17,7 @@
 #include "nodes/nodes.h"
 
 struct peloton_status;
+struct PlannedStmt;
 
 namespace peloton {
 namespace bridge {
@@ -38,6 +39,8 @@ class DDLDatabase {
 
   static bool ExecVacuumStmt(Node *parsetree);
 
+  static void RefreshStats(PlannedStmt *planned_stmt);
+
   static bool CreateDatabase(oid_t database_oid);
 
   // TODO
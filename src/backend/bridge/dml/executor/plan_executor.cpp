@@ -12,9 +12,10 @@
 
 #include "plan_executor.h"
 #include <cassert>
+#include <cstdio>
 
 #include "backend/bridge/dml/mapper/mapper.h"
-#include "backend/bridge/dml/tuple/tuple_transformer.h"
+#include "backend/bridge/dml/tuple/tuple_buffer.h"
 #include "backend/common/logger.h"
 #include "backend/concurrency/transaction_manager.h"
 #include "backend/executor/executors.h"
@@ -37,13 +38,23 @@ executor::AbstractExecutor *BuildExecutorTree(
 
 void CleanExecutorTree(executor::AbstractExecutor *root);
 
+void PrintExecutorStats(const executor::AbstractExecutor *root,
+                        std::string prefix, std::string &output);
+
+bool IsReadOnlyPlan(const planner::AbstractPlan *plan);
+
+bool GetAsOfCommitId(cid_t &as_of_cid);
+
 /**
  * @brief Build a executor tree and execute it.
+ * @param instrument Time every executor, and report the runtime
+ * statistics of the tree in the status.
  * @return status of execution.
  */
 peloton_status PlanExecutor::ExecutePlan(const planner::AbstractPlan *plan,
                                          ParamListInfo param_list,
-                                         TupleDesc tuple_desc) {
+                                         TupleDesc tuple_desc,
+                                         bool instrument) {
   peloton_status p_status;
 
   if (plan == nullptr) return p_status;
@@ -53,14 +64,42 @@ peloton_status PlanExecutor::ExecutePlan(const planner::AbstractPlan *plan,
   bool status;
   bool init_failure = false;
   bool single_statement_txn = false;
-  List *slots = NULL;
+  Result result = Result::RESULT_INVALID;
+  TupleBuffer *tuple_buffer = nullptr;
 
   auto &txn_manager = concurrency::TransactionManager::GetInstance();
   auto txn = peloton::concurrency::current_txn;
+  bool read_only = IsReadOnlyPlan(plan);
+  cid_t as_of_cid = INVALID_CID;
+
+  if (GetAsOfCommitId(as_of_cid) == false) {
+    p_status.m_result = Result::RESULT_FAILURE;
+    return p_status;
+  }
+
+  // Time travel only reads, on its own
+  if (as_of_cid != INVALID_CID && (txn != nullptr || read_only == false)) {
+    LOG_ERROR("Only single read statements can run as of a past commit");
+    p_status.m_result = Result::RESULT_FAILURE;
+    return p_status;
+  }
+
   // This happens for single statement queries in PG
   if (txn == nullptr) {
     single_statement_txn = true;
-    txn = txn_manager.BeginTransaction();
+
+    // Plain reads skip the commit path
+    if (as_of_cid != INVALID_CID) {
+      txn = txn_manager.BeginTimeTravelTransaction(as_of_cid);
+      if (txn == nullptr) {
+        p_status.m_result = Result::RESULT_FAILURE;
+        return p_status;
+      }
+    } else if (read_only) {
+      txn = txn_manager.BeginReadOnlyTransaction();
+    } else {
+      txn = txn_manager.BeginTransaction();
+    }
   }
   assert(txn);
 
@@ -68,6 +107,7 @@ peloton_status PlanExecutor::ExecutePlan(const planner::AbstractPlan *plan,
   LOG_TRACE("Building the executor tree");
 
   auto executor_context = BuildExecutorContext(param_list, txn);
+  executor_context->instrument = instrument;
 
   // Build the executor tree
 
@@ -105,22 +145,16 @@ peloton_status PlanExecutor::ExecutePlan(const planner::AbstractPlan *plan,
       continue;
     }
 
-    // Go over the logical tile
-    for (oid_t tuple_id : *logical_tile) {
-      expression::ContainerTuple<executor::LogicalTile> cur_tuple(
-          logical_tile.get(), tuple_id);
-
-      auto slot = TupleTransformer::GetPostgresTuple(&cur_tuple, tuple_desc);
-
-      if (slot != nullptr) {
-        slots = lappend(slots, slot);
-      }
+    // Convert the logical tile in one go
+    if (tuple_buffer == nullptr) {
+      tuple_buffer = new TupleBuffer(tuple_desc);
     }
+    tuple_buffer->AppendLogicalTile(logical_tile.get());
   }
 
   // Set the result
   p_status.m_processed = executor_context->num_processed;
-  p_status.m_result_slots = slots;
+  p_status.m_result_buffer = tuple_buffer;
 
 // final cleanup
 cleanup:
@@ -128,13 +162,18 @@ cleanup:
   LOG_TRACE("About to commit: single stmt: %d, init_failure: %d, status: %d",
             single_statement_txn, init_failure, txn->GetResult());
 
+  // The transaction is gone once committed or aborted
+  result = txn->GetResult();
+
   // should we commit or abort ?
-  if (single_statement_txn == true || init_failure == true) {
-    auto status = txn->GetResult();
-    switch (status) {
+  if (txn->IsReadOnly()) {
+    // Nothing to commit or roll back
+    txn_manager.EndReadOnlyTransaction();
+  } else if (single_statement_txn == true || init_failure == true) {
+    switch (result) {
       case Result::RESULT_SUCCESS:
-        // Commit
-        txn_manager.CommitTransaction();
+        // Commit, which fails if an optimistic transaction doesn't validate
+        result = txn_manager.CommitTransaction();
 
         break;
 
@@ -144,13 +183,17 @@ cleanup:
         txn_manager.AbortTransaction();
     }
   }
+  if (instrument) {
+    PrintExecutorStats(executor_tree, "", p_status.m_executor_stats);
+  }
+
   // clean up executor tree
   CleanExecutorTree(executor_tree);
 
   // Clean executor context
   delete executor_context;
 
-  p_status.m_result = txn->GetResult();
+  p_status.m_result = result;
   return p_status;
 }
 
@@ -174,6 +217,52 @@ void PlanExecutor::PrintPlan(const planner::AbstractPlan *plan,
   }
 }
 
+/**
+ * @brief Check whether the plan tree has no Insert/Update/Delete node.
+ * @param The plan tree
+ * @return true if executing the plan can't write anything.
+ */
+bool IsReadOnlyPlan(const planner::AbstractPlan *plan) {
+  switch (plan->GetPlanNodeType()) {
+    case PLAN_NODE_TYPE_INSERT:
+    case PLAN_NODE_TYPE_UPDATE:
+    case PLAN_NODE_TYPE_DELETE:
+      return false;
+
+    default:
+      break;
+  }
+
+  for (auto child : plan->GetChildren()) {
+    if (IsReadOnlyPlan(child) == false) return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Resolve the commit id the session reads as of.
+ * @param The commit id, INVALID_CID for the current snapshot
+ * @return false if the time is out of the retention window.
+ */
+bool GetAsOfCommitId(cid_t &as_of_cid) {
+  as_of_cid = INVALID_CID;
+
+  if (peloton_as_of_cid != 0) {
+    as_of_cid = peloton_as_of_cid;
+  } else if (peloton_as_of_time != 0) {
+    auto &txn_manager = concurrency::TransactionManager::GetInstance();
+    as_of_cid = txn_manager.GetCommitIdAsOf(peloton_as_of_time);
+    if (as_of_cid == INVALID_CID) {
+      LOG_ERROR("Cannot read as of time %d, out of the retention window",
+                peloton_as_of_time);
+      return false;
+    }
+  }
+
+  return true;
+}
+
 /**
  * @brief Build Executor Context
  */
@@ -262,6 +351,11 @@ executor::AbstractExecutor *BuildExecutorTree(
       child_executor = new executor::OrderByExecutor(plan, executor_context);
       break;
 
+    case PLAN_NODE_TYPE_SETOP:
+    case PLAN_NODE_TYPE_DISTINCT:
+      child_executor = new executor::HashSetOpExecutor(plan, executor_context);
+      break;
+
     default:
       LOG_ERROR("Unsupported plan node type : %d ", plan_node_type);
       break;
@@ -284,6 +378,42 @@ executor::AbstractExecutor *BuildExecutorTree(
   return root;
 }
 
+/**
+ * @brief Render the runtime statistics of the executor tree, one line per
+ * executor, in the EXPLAIN ANALYZE style.
+ * @param The current executor tree
+ * @param Indentation of the current executor
+ * @param The string the lines are appended to
+ * @return none.
+ */
+void PrintExecutorStats(const executor::AbstractExecutor *root,
+                        std::string prefix, std::string &output) {
+  if (root == nullptr) return;
+
+  auto &stats = root->GetStats();
+  char buffer[256];
+
+  snprintf(buffer, sizeof(buffer),
+           "%s->  %s  (time=%.3f ms cpu=%.3f ms calls=%lu tiles=%lu rows=%lu",
+           prefix.c_str(),
+           PlanNodeTypeToString(root->GetRawNode()->GetPlanNodeType()).c_str(),
+           stats.wall_time, stats.cpu_time, stats.execute_count,
+           stats.output_tile_count, stats.output_tuple_count);
+  output += buffer;
+
+  if (stats.peak_memory_usage != 0) {
+    snprintf(buffer, sizeof(buffer), " memory=%lukB",
+             (stats.peak_memory_usage + 1023) / 1024);
+    output += buffer;
+  }
+  output += ")\n";
+
+  // Recurse
+  for (auto child : root->GetChildren()) {
+    PrintExecutorStats(child, prefix + "      ", output);
+  }
+}
+
 /**
  * @brief Clean up the executor tree.
  * @param The current executor tree
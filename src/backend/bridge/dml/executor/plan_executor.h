@@ -19,6 +19,16 @@
 #include "access/tupdesc.h"
 #include "postmaster/peloton.h"
 
+//===--------------------------------------------------------------------===//
+// GUC Variables
+//===--------------------------------------------------------------------===//
+
+// Commit id, or else unix time, the reads of the session are run as of.
+// Zero reads the current snapshot.
+extern int peloton_as_of_cid;
+
+extern int peloton_as_of_time;
+
 namespace peloton {
 namespace bridge {
 
@@ -40,7 +50,8 @@ class PlanExecutor {
 
   static peloton_status ExecutePlan(const planner::AbstractPlan *plan,
                                     ParamListInfo m_param_list,
-                                    TupleDesc m_tuple_desc);
+                                    TupleDesc m_tuple_desc,
+                                    bool instrument = false);
 
  private:
 };
@@ -0,0 +1,203 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// tuple_buffer.cpp
+//
+// Identification: src/backend/bridge/dml/tuple/tuple_buffer.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "backend/bridge/dml/tuple/tuple_buffer.h"
+#include "backend/bridge/dml/tuple/tuple_transformer.h"
+#include "backend/common/logger.h"
+#include "backend/executor/logical_tile.h"
+#include "backend/storage/tile.h"
+
+#include "utils/palloc.h"
+
+namespace peloton {
+namespace bridge {
+
+// Initial # of tuples the buffer is sized for
+static const size_t kInitialTupleCapacity = 64;
+
+//===--------------------------------------------------------------------===//
+// Fixed-length column helpers
+//===--------------------------------------------------------------------===//
+
+static inline bool IsNullValue(int16_t value) { return value == INT16_NULL; }
+static inline bool IsNullValue(int32_t value) { return value == INT32_NULL; }
+static inline bool IsNullValue(int64_t value) { return value == INT64_NULL; }
+static inline bool IsNullValue(double value) { return value <= DOUBLE_NULL; }
+
+static inline Datum ToDatum(int16_t value) { return Int16GetDatum(value); }
+static inline Datum ToDatum(int32_t value) { return Int32GetDatum(value); }
+static inline Datum ToDatum(int64_t value) { return Int64GetDatum(value); }
+static inline Datum ToDatum(double value) { return Float8GetDatum(value); }
+
+/**
+ * @brief Copy a fixed-length column straight from tile storage.
+ * Bypasses Value construction and the per-type dispatch in GetDatum.
+ */
+template <typename ColumnType>
+static void CopyFixedLengthColumn(
+    const storage::ColumnAccessor &accessor,
+    const executor::LogicalTile::PositionList &position_list,
+    const std::vector<oid_t> &tuple_ids, const size_t stride,
+    Datum *datum_itr, bool *null_itr) {
+  for (auto tuple_id : tuple_ids) {
+    oid_t base_tuple_id = position_list[tuple_id];
+
+    if (base_tuple_id == NULL_OID) {
+      *datum_itr = PointerGetDatum(nullptr);
+      *null_itr = true;
+    } else {
+      ColumnType value =
+          accessor.GetFixedLengthValue<ColumnType>(base_tuple_id);
+      *datum_itr = ToDatum(value);
+      *null_itr = IsNullValue(value);
+    }
+
+    datum_itr += stride;
+    null_itr += stride;
+  }
+}
+
+TupleBuffer::TupleBuffer(TupleDesc tuple_desc)
+    : tuple_desc(tuple_desc), natts(tuple_desc->natts) {
+  slot = MakeSingleTupleTableSlot(tuple_desc);
+}
+
+TupleBuffer::~TupleBuffer() {
+  // Clean up any varlena's
+  for (size_t att_itr = 0; att_itr < natts; ++att_itr) {
+    if (tuple_desc->attrs[att_itr]->attlen >= 0) continue;
+
+    for (size_t tuple_itr = 0; tuple_itr < tuple_count; ++tuple_itr) {
+      size_t offset = tuple_itr * natts + att_itr;
+      if (nulls[offset]) continue;
+
+      pfree((void *)(datums[offset]));
+    }
+  }
+
+  if (datums != nullptr) pfree(datums);
+  if (nulls != nullptr) pfree(nulls);
+
+  ExecDropSingleTupleTableSlot(slot);
+}
+
+/**
+ * @brief Grow the datum and null arrays to hold at least tuple_count tuples.
+ */
+void TupleBuffer::Reserve(size_t required_count) {
+  if (required_count <= tuple_capacity) return;
+
+  size_t new_capacity =
+      std::max({required_count, 2 * tuple_capacity, kInitialTupleCapacity});
+  size_t entry_count = new_capacity * std::max<size_t>(natts, 1);
+
+  if (datums == nullptr) {
+    datums = (Datum *)palloc(entry_count * sizeof(Datum));
+    nulls = (bool *)palloc(entry_count * sizeof(bool));
+  } else {
+    datums = (Datum *)repalloc(datums, entry_count * sizeof(Datum));
+    nulls = (bool *)repalloc(nulls, entry_count * sizeof(bool));
+  }
+
+  tuple_capacity = new_capacity;
+}
+
+/**
+ * @brief Convert the visible tuples of a logical tile, a column at a time.
+ * Fixed-length columns are read directly from their base tiles; the rest
+ * go through TupleTransformer::GetDatum.
+ */
+void TupleBuffer::AppendLogicalTile(executor::LogicalTile *logical_tile) {
+  assert(logical_tile);
+
+  std::vector<oid_t> tuple_ids;
+  tuple_ids.reserve(logical_tile->GetTupleCount());
+  for (oid_t tuple_id : *logical_tile) {
+    tuple_ids.push_back(tuple_id);
+  }
+
+  if (tuple_ids.empty()) return;
+
+  assert(natts <= logical_tile->GetColumnCount());
+  Reserve(tuple_count + tuple_ids.size());
+
+  const auto &position_lists = logical_tile->GetPositionLists();
+
+  for (oid_t att_itr = 0; att_itr < natts; ++att_itr) {
+    const auto &column_info = logical_tile->GetColumnInfo(att_itr);
+    const auto &position_list = position_lists[column_info.position_list_idx];
+    const auto &accessor = column_info.accessor;
+
+    Datum *datum_itr = datums + tuple_count * natts + att_itr;
+    bool *null_itr = nulls + tuple_count * natts + att_itr;
+
+    switch (accessor.column_type) {
+      case VALUE_TYPE_SMALLINT:
+        CopyFixedLengthColumn<int16_t>(accessor, position_list, tuple_ids,
+                                       natts, datum_itr, null_itr);
+        break;
+
+      case VALUE_TYPE_INTEGER:
+        CopyFixedLengthColumn<int32_t>(accessor, position_list, tuple_ids,
+                                       natts, datum_itr, null_itr);
+        break;
+
+      case VALUE_TYPE_BIGINT:
+      case VALUE_TYPE_TIMESTAMP:
+        CopyFixedLengthColumn<int64_t>(accessor, position_list, tuple_ids,
+                                       natts, datum_itr, null_itr);
+        break;
+
+      case VALUE_TYPE_DOUBLE:
+        CopyFixedLengthColumn<double>(accessor, position_list, tuple_ids,
+                                      natts, datum_itr, null_itr);
+        break;
+
+      default:
+        for (auto tuple_id : tuple_ids) {
+          Value value = logical_tile->GetValue(tuple_id, att_itr);
+          *datum_itr = TupleTransformer::GetDatum(value);
+          *null_itr = value.IsNull();
+
+          datum_itr += natts;
+          null_itr += natts;
+        }
+        break;
+    }
+  }
+
+  tuple_count += tuple_ids.size();
+}
+
+/**
+ * @brief Store the tuple as a virtual tuple in the shared slot.
+ * The slot is only valid until the next call.
+ */
+TupleTableSlot *TupleBuffer::GetSlot(size_t tuple_offset) {
+  assert(tuple_offset < tuple_count);
+
+  ExecClearTuple(slot);
+
+  std::memcpy(slot->tts_values, datums + tuple_offset * natts,
+              natts * sizeof(Datum));
+  std::memcpy(slot->tts_isnull, nulls + tuple_offset * natts,
+              natts * sizeof(bool));
+
+  return ExecStoreVirtualTuple(slot);
+}
+
+}  // namespace bridge
+}  // namespace peloton
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// tuple_buffer.h
+//
+// Identification: src/backend/bridge/dml/tuple/tuple_buffer.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "postgres.h"
+#include "access/tupdesc.h"
+#include "executor/tuptable.h"
+
+#include "backend/common/types.h"
+
+namespace peloton {
+
+namespace executor {
+class LogicalTile;
+}
+
+namespace bridge {
+
+//===--------------------------------------------------------------------===//
+// Tuple Buffer
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Result tuples handed back to Postgres as virtual tuples.
+ *
+ * Logical tiles are converted a column at a time into flat datum/null
+ * arrays instead of forming one heap tuple and one slot per row.
+ * The rows are then handed out through a single slot that is reused
+ * for every tuple, so no per-row palloc/heap_form_tuple is needed.
+ */
+class TupleBuffer {
+ public:
+  TupleBuffer(const TupleBuffer &) = delete;
+  TupleBuffer &operator=(const TupleBuffer &) = delete;
+  TupleBuffer(TupleBuffer &&) = delete;
+  TupleBuffer &operator=(TupleBuffer &&) = delete;
+
+  TupleBuffer(TupleDesc tuple_desc);
+
+  ~TupleBuffer();
+
+  // Append the visible tuples of the logical tile
+  void AppendLogicalTile(executor::LogicalTile *logical_tile);
+
+  // Store the tuple at given offset in the shared slot
+  TupleTableSlot *GetSlot(size_t tuple_offset);
+
+  size_t GetTupleCount() const { return tuple_count; }
+
+ private:
+  void Reserve(size_t tuple_count);
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  TupleDesc tuple_desc;
+
+  // # of attributes in every tuple
+  size_t natts;
+
+  // datums and nulls, stored row by row (natts entries per tuple)
+  Datum *datums = nullptr;
+
+  bool *nulls = nullptr;
+
+  size_t tuple_count = 0;
+
+  size_t tuple_capacity = 0;
+
+  // the slot reused for all tuples
+  TupleTableSlot *slot = nullptr;
+};
+
+}  // namespace bridge
+}  // namespace peloton
@@ -17,6 +17,7 @@
 #include "backend/catalog/manager.h"
 #include "backend/storage/database.h"
 #include "backend/storage/data_table.h"
+#include "backend/storage/eviction_manager.h"
 
 namespace peloton {
 namespace catalog {
@@ -30,48 +31,129 @@ Manager &Manager::GetInstance() {
 // OBJECT MAP
 //===--------------------------------------------------------------------===//
 
+Manager::Manager()
+    : locator(new std::atomic<LocatorSegment *>[LOCATOR_SEGMENT_COUNT]) {
+  for (oid_t segment_itr = 0; segment_itr < LOCATOR_SEGMENT_COUNT;
+       segment_itr++) {
+    locator[segment_itr].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+Manager::~Manager() {
+  for (oid_t segment_itr = 0; segment_itr < LOCATOR_SEGMENT_COUNT;
+       segment_itr++) {
+    delete locator[segment_itr].load(std::memory_order_relaxed);
+  }
+}
+
+LocatorSegment *Manager::GetLocatorSegment(const oid_t oid, bool create) {
+  // The directory only covers 32-bit oids, and INVALID_OID is beyond it
+  oid_t segment_offset = oid >> LOCATOR_SEGMENT_BITS;
+  if (segment_offset >= (oid_t)LOCATOR_SEGMENT_COUNT) return nullptr;
+
+  auto &segment_slot = locator[segment_offset];
+  LocatorSegment *segment = segment_slot.load(std::memory_order_acquire);
+
+  if (segment != nullptr || create == false) return segment;
+
+  // Publish a new segment, unless another thread beat us to it
+  LocatorSegment *new_segment = new LocatorSegment();
+  if (segment_slot.compare_exchange_strong(segment, new_segment,
+                                           std::memory_order_acq_rel)) {
+    return new_segment;
+  }
+
+  delete new_segment;
+  return segment;
+}
+
 void Manager::AddTileGroup(
     const oid_t oid, const std::shared_ptr<storage::TileGroup> &location) {
-  std::shared_ptr<storage::TileGroup> old_location;
-
-  {
-    std::lock_guard<std::mutex> lock(locator_mutex);
+  auto segment = GetLocatorSegment(oid, true);
+  if (segment == nullptr) {
+    throw CatalogException("Tile group oid out of range : " +
+                           std::to_string(oid));
+  }
 
-    // drop the catalog reference to the old tile group
-    locator.erase(oid);
+  auto &entry = segment->entries[oid & (LOCATOR_SEGMENT_SIZE - 1)];
 
-    // add a catalog reference to the tile group
-    locator[oid] = location;
+  // a new or restored tile group starts out hot
+  if (location != nullptr) {
+    location->RecordAccess(storage::EvictionManager::GetAccessEpoch());
   }
+
+  // add a catalog reference to the tile group,
+  // dropping the catalog reference to the old tile group
+  std::atomic_store(&entry, location);
 }
 
 void Manager::DropTileGroup(const oid_t oid) {
-  {
-    std::lock_guard<std::mutex> lock(locator_mutex);
-    // drop the catalog reference to the tile group
-    locator.erase(oid);
+  auto segment = GetLocatorSegment(oid, false);
+  if (segment == nullptr) return;
+
+  // drop the catalog reference to the tile group
+  auto &entry = segment->entries[oid & (LOCATOR_SEGMENT_SIZE - 1)];
+  std::atomic_store(&entry, std::shared_ptr<storage::TileGroup>());
+
+  // drop the on-disk copy too, if the tile group was evicted
+  if (storage::EvictionManager::HasEvictedTileGroups()) {
+    storage::EvictionManager::GetInstance().DropTileGroup(oid);
   }
 }
 
 std::shared_ptr<storage::TileGroup> Manager::GetTileGroup(const oid_t oid) {
-  std::shared_ptr<storage::TileGroup> location;
+  // Check if the tile group exists in the lookup directory
+  auto segment = GetLocatorSegment(oid, false);
+  if (segment == nullptr) return std::shared_ptr<storage::TileGroup>();
 
-  {
-    std::lock_guard<std::mutex> lock(locator_mutex);
-    // Check if the tile group exists in the lookup directory
-    if (locator.find(oid) != locator.end()) {
-      location = locator.at(oid);
-    }
+  auto &entry = segment->entries[oid & (LOCATOR_SEGMENT_SIZE - 1)];
+  auto tile_group = std::atomic_load(&entry);
+
+  if (tile_group != nullptr) {
+    tile_group->RecordAccess(storage::EvictionManager::GetAccessEpoch());
+    return tile_group;
   }
 
-  return location;
+  // Fault in the tile group if it was evicted
+  if (storage::EvictionManager::HasEvictedTileGroups()) {
+    return storage::EvictionManager::GetInstance().FetchTileGroup(oid);
+  }
+
+  return tile_group;
+}
+
+std::shared_ptr<storage::TileGroup> Manager::GetResidentTileGroup(
+    const oid_t oid) {
+  auto segment = GetLocatorSegment(oid, false);
+  if (segment == nullptr) return std::shared_ptr<storage::TileGroup>();
+
+  auto &entry = segment->entries[oid & (LOCATOR_SEGMENT_SIZE - 1)];
+  return std::atomic_load(&entry);
+}
+
+std::shared_ptr<storage::TileGroup> Manager::ExchangeTileGroup(
+    const oid_t oid, const std::shared_ptr<storage::TileGroup> &location) {
+  auto segment = GetLocatorSegment(oid, true);
+  if (segment == nullptr) return std::shared_ptr<storage::TileGroup>();
+
+  auto &entry = segment->entries[oid & (LOCATOR_SEGMENT_SIZE - 1)];
+  return std::atomic_exchange(&entry, location);
 }
 
 // used for logging test
 void Manager::ClearTileGroup() {
-  {
-    std::lock_guard<std::mutex> lock(locator_mutex);
-    locator.clear();
+  for (oid_t segment_itr = 0; segment_itr < LOCATOR_SEGMENT_COUNT;
+       segment_itr++) {
+    auto segment = locator[segment_itr].load(std::memory_order_acquire);
+    if (segment == nullptr) continue;
+
+    for (auto &entry : segment->entries) {
+      std::atomic_store(&entry, std::shared_ptr<storage::TileGroup>());
+    }
+  }
+
+  if (storage::EvictionManager::HasEvictedTileGroups()) {
+    storage::EvictionManager::GetInstance().Clear();
   }
 }
 
@@ -38,12 +38,30 @@ namespace catalog {
 // Manager
 //===--------------------------------------------------------------------===//
 
-typedef std::unordered_map<oid_t, std::shared_ptr<storage::TileGroup>>
-    lookup_dir;
+// # of bits of the tile group oid that index into a locator segment
+#define LOCATOR_SEGMENT_BITS 16
+
+#define LOCATOR_SEGMENT_SIZE (1 << LOCATOR_SEGMENT_BITS)
+
+#define LOCATOR_SEGMENT_COUNT (1 << (32 - LOCATOR_SEGMENT_BITS))
+
+/**
+ * A fixed-size chunk of the tile group directory.
+ * Entries are only read and written with the std::atomic_* shared_ptr
+ * operations. These are not lock-free: libstdc++ guards them with a small
+ * pool of spinlocks hashed on the entry's address, so lookups of different
+ * tile groups mostly take different locks, but there is no single-load
+ * fast path.
+ */
+struct LocatorSegment {
+  std::shared_ptr<storage::TileGroup> entries[LOCATOR_SEGMENT_SIZE];
+};
 
 class Manager {
  public:
-  Manager() {}
+  Manager();
+
+  ~Manager();
 
   // Singleton
   static Manager &GetInstance();
@@ -58,15 +76,25 @@ class Manager {
 
   void SetNextOid(oid_t next_oid) { oid = next_oid; }
 
+  // Throws a CatalogException if the oid is beyond the directory
   void AddTileGroup(const oid_t oid,
                     const std::shared_ptr<storage::TileGroup> &location);
 
   void DropTileGroup(const oid_t oid);
 
+  // Faults the tile group back in if it was evicted
   std::shared_ptr<storage::TileGroup> GetTileGroup(const oid_t oid);
 
   void ClearTileGroup(void);
 
+  // Look up the tile group without recording an access or faulting it in
+  std::shared_ptr<storage::TileGroup> GetResidentTileGroup(const oid_t oid);
+
+  // Replace the directory entry, returning the old one.
+  // Used by the eviction manager.
+  std::shared_ptr<storage::TileGroup> ExchangeTileGroup(
+      const oid_t oid, const std::shared_ptr<storage::TileGroup> &location);
+
   //===--------------------------------------------------------------------===//
   // DATABASE
   //===--------------------------------------------------------------------===//
@@ -99,15 +127,20 @@ class Manager {
   Manager(Manager const &) = delete;
 
  private:
+  // Get the directory segment covering the oid, allocating it if needed.
+  // Returns null for oids beyond the directory (2^32 and up).
+  LocatorSegment *GetLocatorSegment(const oid_t oid, bool create);
+
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
 
   std::atomic<oid_t> oid = ATOMIC_VAR_INIT(START_OID);
 
-  lookup_dir locator;
-
-  std::mutex locator_mutex;
+  // Tile group directory, indexed by tile group oid.
+  // Segments are allocated on first use and published with a CAS;
+  // they are only freed when the manager goes away.
+  std::unique_ptr<std::atomic<LocatorSegment *>[]> locator;
 
   // DATABASES
 
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// hyperloglog.cpp
+//
+// Identification: src/backend/common/hyperloglog.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "backend/common/hyperloglog.h"
+#include "backend/common/value.h"
+
+namespace peloton {
+
+void HyperLogLog::AddHash(uint64_t hash) {
+  // The low bits pick the register, the rest give the rank
+  size_t register_index = hash & (HYPERLOGLOG_REGISTER_COUNT - 1);
+  uint64_t remaining = hash >> HYPERLOGLOG_REGISTER_BITS;
+
+  uint8_t rank;
+  if (remaining == 0) {
+    rank = 64 - HYPERLOGLOG_REGISTER_BITS + 1;
+  } else {
+    rank = __builtin_ctzll(remaining) + 1;
+  }
+
+  registers[register_index] = std::max(registers[register_index], rank);
+}
+
+void HyperLogLog::AddValue(const Value &value) {
+  assert(value.IsNull() == false);
+  AddHash(HashValue(value));
+}
+
+void HyperLogLog::Merge(const HyperLogLog &other) {
+  for (size_t register_itr = 0; register_itr < HYPERLOGLOG_REGISTER_COUNT;
+       register_itr++) {
+    registers[register_itr] =
+        std::max(registers[register_itr], other.registers[register_itr]);
+  }
+}
+
+double HyperLogLog::Estimate() const {
+  const double register_count = HYPERLOGLOG_REGISTER_COUNT;
+  const double alpha = 0.7213 / (1 + 1.079 / register_count);
+
+  double sum = 0;
+  size_t zero_count = 0;
+  for (auto rank : registers) {
+    sum += std::ldexp(1.0, -rank);
+    if (rank == 0) zero_count++;
+  }
+
+  double estimate = alpha * register_count * register_count / sum;
+
+  // Small range correction, count the empty registers instead
+  if (estimate <= 2.5 * register_count && zero_count > 0) {
+    estimate = register_count * std::log(register_count / zero_count);
+  }
+
+  return estimate;
+}
+
+void HyperLogLog::Reset() {
+  std::fill(registers.begin(), registers.end(), 0);
+}
+
+uint64_t HyperLogLog::HashValue(const Value &value) {
+  std::size_t seed = 0;
+  value.HashCombine(seed);
+
+  // HashCombine leaves small integers poorly mixed, finish it off
+  return MixHash(seed);
+}
+
+uint64_t HyperLogLog::MixHash(uint64_t key) {
+  uint64_t hash = key;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+
+  return hash;
+}
+
+}  // End peloton namespace
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// hyperloglog.h
+//
+// Identification: src/backend/common/hyperloglog.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace peloton {
+
+class Value;
+
+// 2^bits registers, i.e. 4 KB per sketch and ~1.6% standard error
+static const size_t HYPERLOGLOG_REGISTER_BITS = 12;
+
+static const size_t HYPERLOGLOG_REGISTER_COUNT = 1
+                                                 << HYPERLOGLOG_REGISTER_BITS;
+
+//===--------------------------------------------------------------------===//
+// HyperLogLog
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Sketch of the number of distinct values in a stream.
+ *
+ * Sketches over disjoint parts of a table can be merged into a sketch of
+ * the whole table, so the parts can be built in parallel and kept around.
+ * Not thread-safe.
+ */
+class HyperLogLog {
+ public:
+  HyperLogLog() : registers(HYPERLOGLOG_REGISTER_COUNT, 0) {}
+
+  // Add a well-mixed 64-bit hash
+  void AddHash(uint64_t hash);
+
+  // Add a non-null value
+  void AddValue(const Value &value);
+
+  // Fold in the other sketch
+  void Merge(const HyperLogLog &other);
+
+  // Estimated # of distinct values added so far
+  double Estimate() const;
+
+  void Reset();
+
+  // 64-bit hash of a value, with all the bits mixed
+  static uint64_t HashValue(const Value &value);
+
+  // Spread the bits of the key over the whole hash
+  static uint64_t MixHash(uint64_t key);
+
+ private:
+  std::vector<uint8_t> registers;
+};
+
+}  // End peloton namespace
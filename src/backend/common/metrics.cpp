@@ -0,0 +1,280 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// metrics.cpp
+//
+// Identification: src/backend/common/metrics.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+#include <sstream>
+
+#include "backend/common/metrics.h"
+#include "backend/common/logger.h"
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// Counter
+//===--------------------------------------------------------------------===//
+
+void *MetricsCounter::operator new(size_t size) {
+  void *ptr = nullptr;
+  if (posix_memalign(&ptr, alignof(MetricsCounter), size) != 0) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void MetricsCounter::operator delete(void *ptr) { free(ptr); }
+
+int64_t MetricsCounter::GetValue() const {
+  int64_t value = 0;
+  for (auto &slot : slots) {
+    value += slot.value.load(std::memory_order_relaxed);
+  }
+  return value;
+}
+
+void MetricsCounter::Reset() {
+  for (auto &slot : slots) {
+    slot.value.store(0, std::memory_order_relaxed);
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Histogram
+//===--------------------------------------------------------------------===//
+
+MetricsHistogram::MetricsHistogram() { Reset(); }
+
+size_t MetricsHistogram::GetBucketIndex(uint64_t value) {
+  // Small values get a bucket each
+  if (value < METRICS_HISTOGRAM_SUB_BUCKET_COUNT) {
+    return value;
+  }
+
+  // Keep the leading bits of the value, below its most significant one
+  size_t msb = 63 - __builtin_clzll(value);
+  size_t shift = msb - METRICS_HISTOGRAM_SUB_BUCKET_BITS;
+  size_t sub_bucket = (value >> shift) - METRICS_HISTOGRAM_SUB_BUCKET_COUNT;
+
+  return (shift + 1) * METRICS_HISTOGRAM_SUB_BUCKET_COUNT + sub_bucket;
+}
+
+uint64_t MetricsHistogram::GetBucketUpperBound(size_t bucket_index) {
+  if (bucket_index < METRICS_HISTOGRAM_SUB_BUCKET_COUNT) {
+    return bucket_index;
+  }
+
+  size_t shift = bucket_index / METRICS_HISTOGRAM_SUB_BUCKET_COUNT - 1;
+  uint64_t leading = bucket_index % METRICS_HISTOGRAM_SUB_BUCKET_COUNT +
+                     METRICS_HISTOGRAM_SUB_BUCKET_COUNT;
+
+  uint64_t lower_bound = leading << shift;
+  uint64_t width = uint64_t(1) << shift;
+  return lower_bound + (width - 1);
+}
+
+void MetricsHistogram::Record(uint64_t value) {
+  buckets[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  sum.fetch_add(value, std::memory_order_relaxed);
+
+  uint64_t current_max = max.load(std::memory_order_relaxed);
+  while (value > current_max &&
+         max.compare_exchange_weak(current_max, value,
+                                   std::memory_order_relaxed) == false)
+    ;
+}
+
+MetricsHistogramSnapshot MetricsHistogram::GetSnapshot() const {
+  MetricsHistogramSnapshot snapshot;
+
+  // Values recorded during the copy may only be counted in some fields
+  snapshot.buckets.reserve(METRICS_HISTOGRAM_BUCKET_COUNT);
+  for (auto &bucket : buckets) {
+    snapshot.buckets.push_back(bucket.load(std::memory_order_relaxed));
+    snapshot.count += snapshot.buckets.back();
+  }
+  snapshot.sum = sum.load(std::memory_order_relaxed);
+  snapshot.max = max.load(std::memory_order_relaxed);
+
+  return snapshot;
+}
+
+void MetricsHistogram::Reset() {
+  for (auto &bucket : buckets) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  sum.store(0, std::memory_order_relaxed);
+  max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t MetricsHistogramSnapshot::GetValueAtPercentile(
+    double percentile) const {
+  if (count == 0) return 0;
+
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  uint64_t rank = static_cast<uint64_t>(percentile / 100 * count + 0.5);
+  if (rank == 0) rank = 1;
+
+  uint64_t seen = 0;
+  for (size_t bucket_itr = 0; bucket_itr < buckets.size(); bucket_itr++) {
+    seen += buckets[bucket_itr];
+    if (seen >= rank) {
+      return std::min(MetricsHistogram::GetBucketUpperBound(bucket_itr), max);
+    }
+  }
+
+  return max;
+}
+
+uint64_t MetricsLatencyTimer::GetMicros() {
+  auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+//===--------------------------------------------------------------------===//
+// Registry
+//===--------------------------------------------------------------------===//
+
+MetricsRegistry::~MetricsRegistry() { StopDumping(); }
+
+MetricsRegistry &MetricsRegistry::GetInstance() {
+  // Never destroyed, static objects may still update metrics at exit
+  static MetricsRegistry *metrics_registry = new MetricsRegistry();
+  return *metrics_registry;
+}
+
+MetricsCounter *MetricsRegistry::GetCounter(const std::string &name) {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+
+  auto &counter = counters[name];
+  if (counter == nullptr) counter.reset(new MetricsCounter());
+  return counter.get();
+}
+
+MetricsHistogram *MetricsRegistry::GetHistogram(const std::string &name) {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+
+  auto &histogram = histograms[name];
+  if (histogram == nullptr) histogram.reset(new MetricsHistogram());
+  return histogram.get();
+}
+
+std::vector<MetricsSample> MetricsRegistry::GetSamples() {
+  std::vector<MetricsSample> samples;
+  std::lock_guard<std::mutex> lock(registry_mutex);
+
+  for (auto &entry : counters) {
+    MetricsSample sample;
+    sample.name = entry.first;
+    sample.kind = "counter";
+    sample.count = entry.second->GetValue();
+    samples.push_back(sample);
+  }
+
+  for (auto &entry : histograms) {
+    auto snapshot = entry.second->GetSnapshot();
+
+    MetricsSample sample;
+    sample.name = entry.first;
+    sample.kind = "histogram";
+    sample.count = snapshot.count;
+    sample.mean = snapshot.GetMean();
+    sample.p50 = snapshot.GetValueAtPercentile(50);
+    sample.p95 = snapshot.GetValueAtPercentile(95);
+    sample.p99 = snapshot.GetValueAtPercentile(99);
+    sample.max = snapshot.max;
+    samples.push_back(sample);
+  }
+
+  std::sort(samples.begin(), samples.end(),
+            [](const MetricsSample &a, const MetricsSample &b) {
+              return a.name < b.name;
+            });
+
+  return samples;
+}
+
+std::string MetricsRegistry::GetInfo() {
+  std::ostringstream os;
+
+  for (auto &sample : GetSamples()) {
+    os << sample.name << " " << sample.count;
+    if (sample.kind == "histogram") {
+      os << " mean=" << sample.mean << " p50=" << sample.p50
+         << " p95=" << sample.p95 << " p99=" << sample.p99
+         << " max=" << sample.max;
+    }
+    os << "\n";
+  }
+
+  return os.str();
+}
+
+bool MetricsRegistry::DumpToFile(const std::string &file_name) {
+  FILE *file = fopen(file_name.c_str(), "a");
+  if (file == nullptr) {
+    LOG_ERROR("Could not open metrics file :: %s", file_name.c_str());
+    return false;
+  }
+
+  auto info = GetInfo();
+  fprintf(file, "# %" PRId64 "\n%s", static_cast<int64_t>(time(nullptr)),
+          info.c_str());
+  fclose(file);
+
+  return true;
+}
+
+void MetricsRegistry::StartDumping(const std::string &file_name,
+                                   int interval) {
+  std::lock_guard<std::mutex> lock(dumper_mutex);
+  if (dumper.joinable() || interval <= 0) return;
+
+  stop_dumping = false;
+  dumper = std::thread(&MetricsRegistry::RunDumper, this, file_name, interval);
+}
+
+void MetricsRegistry::StopDumping() {
+  {
+    std::lock_guard<std::mutex> lock(dumper_mutex);
+    stop_dumping = true;
+  }
+  dumper_cv.notify_all();
+
+  if (dumper.joinable()) dumper.join();
+}
+
+void MetricsRegistry::RunDumper(std::string file_name, int interval) {
+  std::unique_lock<std::mutex> lock(dumper_mutex);
+
+  while (stop_dumping == false) {
+    dumper_cv.wait_for(lock, std::chrono::seconds(interval));
+    if (stop_dumping == true) break;
+
+    lock.unlock();
+    DumpToFile(file_name);
+    lock.lock();
+  }
+}
+
+void MetricsRegistry::Reset() {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+
+  for (auto &entry : counters) entry.second->Reset();
+  for (auto &entry : histograms) entry.second->Reset();
+}
+
+}  // End peloton namespace
@@ -0,0 +1,252 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// metrics.h
+//
+// Identification: src/backend/common/metrics.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace peloton {
+
+// Counter slots get a cache line each
+static const size_t METRICS_CACHE_LINE_SIZE = 64;
+
+// Counters are striped over this many slots, one per thread
+// (threads beyond that share slots)
+static const size_t METRICS_COUNTER_SLOT_COUNT = 64;
+
+// Histogram buckets split every power of two into 2^bits linear buckets,
+// which bounds the relative error of a recorded value to 1/16
+static const size_t METRICS_HISTOGRAM_SUB_BUCKET_BITS = 4;
+
+static const size_t METRICS_HISTOGRAM_SUB_BUCKET_COUNT =
+    1 << METRICS_HISTOGRAM_SUB_BUCKET_BITS;
+
+static const size_t METRICS_HISTOGRAM_BUCKET_COUNT =
+    (64 - METRICS_HISTOGRAM_SUB_BUCKET_BITS + 1) *
+    METRICS_HISTOGRAM_SUB_BUCKET_COUNT;
+
+//===--------------------------------------------------------------------===//
+// Counter
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Lock-free counter, aggregated on read.
+ *
+ * Every thread adds into its own cache line, so hot counters do not
+ * bounce between cores. Deltas may be negative, for gauges.
+ */
+class MetricsCounter {
+ public:
+  MetricsCounter(const MetricsCounter &) = delete;
+  MetricsCounter &operator=(const MetricsCounter &) = delete;
+
+  MetricsCounter() {}
+
+  // Plain new only honors the alignment of the slots as of C++17
+  static void *operator new(size_t size);
+
+  static void operator delete(void *ptr);
+
+  inline void Increment(int64_t delta = 1) {
+    slots[GetThreadSlot()].value.fetch_add(delta, std::memory_order_relaxed);
+  }
+
+  inline void Decrement(int64_t delta = 1) { Increment(-delta); }
+
+  // Sum over all the threads
+  int64_t GetValue() const;
+
+  void Reset();
+
+ private:
+  struct alignas(METRICS_CACHE_LINE_SIZE) Slot {
+    std::atomic<int64_t> value = ATOMIC_VAR_INIT(0);
+  };
+
+  static_assert(sizeof(Slot) == METRICS_CACHE_LINE_SIZE,
+                "a counter slot must fill a cache line");
+
+  static inline size_t GetThreadSlot() {
+    static std::atomic<size_t> next_slot(0);
+    static thread_local size_t slot =
+        next_slot++ % METRICS_COUNTER_SLOT_COUNT;
+    return slot;
+  }
+
+  Slot slots[METRICS_COUNTER_SLOT_COUNT];
+};
+
+//===--------------------------------------------------------------------===//
+// Histogram
+//===--------------------------------------------------------------------===//
+
+// Point in time copy of a histogram
+struct MetricsHistogramSnapshot {
+  uint64_t count = 0;
+
+  uint64_t sum = 0;
+
+  uint64_t max = 0;
+
+  std::vector<uint64_t> buckets;
+
+  double GetMean() const { return count == 0 ? 0 : (double)sum / count; }
+
+  // Highest value equivalent to the value at the percentile (0 to 100)
+  uint64_t GetValueAtPercentile(double percentile) const;
+};
+
+/**
+ * @brief HDR-style histogram with log-linear buckets.
+ *
+ * Values up to 2^64 are recorded with a bounded relative error, in a
+ * fixed set of buckets, so recording is a couple of relaxed atomic adds.
+ * Latencies are recorded in microseconds.
+ */
+class MetricsHistogram {
+ public:
+  MetricsHistogram(const MetricsHistogram &) = delete;
+  MetricsHistogram &operator=(const MetricsHistogram &) = delete;
+
+  MetricsHistogram();
+
+  void Record(uint64_t value);
+
+  MetricsHistogramSnapshot GetSnapshot() const;
+
+  void Reset();
+
+  static size_t GetBucketIndex(uint64_t value);
+
+  // Largest value that falls into the bucket
+  static uint64_t GetBucketUpperBound(size_t bucket_index);
+
+ private:
+  std::atomic<uint64_t> sum;
+
+  std::atomic<uint64_t> max;
+
+  std::atomic<uint64_t> buckets[METRICS_HISTOGRAM_BUCKET_COUNT];
+};
+
+// Records the time since its creation into a histogram (in microseconds)
+class MetricsLatencyTimer {
+ public:
+  MetricsLatencyTimer(MetricsHistogram *histogram)
+      : histogram(histogram), start(GetMicros()) {}
+
+  ~MetricsLatencyTimer() { histogram->Record(GetMicros() - start); }
+
+  // Monotonic clock, in microseconds
+  static uint64_t GetMicros();
+
+ private:
+  MetricsHistogram *histogram;
+
+  uint64_t start;
+};
+
+//===--------------------------------------------------------------------===//
+// Registry
+//===--------------------------------------------------------------------===//
+
+// One row of the metrics view
+struct MetricsSample {
+  std::string name;
+
+  // "counter" or "histogram"
+  std::string kind;
+
+  // Counter value, or # of recorded values
+  int64_t count = 0;
+
+  // Only set for histograms
+  double mean = 0;
+  uint64_t p50 = 0;
+  uint64_t p95 = 0;
+  uint64_t p99 = 0;
+  uint64_t max = 0;
+};
+
+/**
+ * @brief Engine-wide set of named metrics.
+ *
+ * Metrics are created on first lookup and live as long as the process,
+ * so callers look them up once and keep the pointer. Names are dotted,
+ * the first part being the module (txn, log, index, storage, pool).
+ */
+class MetricsRegistry {
+ public:
+  MetricsRegistry(const MetricsRegistry &) = delete;
+  MetricsRegistry &operator=(const MetricsRegistry &) = delete;
+
+  MetricsRegistry() {}
+
+  // Stops the dump thread
+  ~MetricsRegistry();
+
+  // Singleton
+  static MetricsRegistry &GetInstance();
+
+  MetricsCounter *GetCounter(const std::string &name);
+
+  MetricsHistogram *GetHistogram(const std::string &name);
+
+  // All the metrics, sorted by name
+  std::vector<MetricsSample> GetSamples();
+
+  // One line per metric
+  std::string GetInfo();
+
+  // Append a timestamped dump of all the metrics to the file
+  bool DumpToFile(const std::string &file_name);
+
+  /**
+   * @brief Dump the metrics to the file every interval seconds, from a
+   * background thread. Only the first call starts the thread.
+   */
+  void StartDumping(const std::string &file_name, int interval);
+
+  void StopDumping();
+
+  // Zero all the metrics, mainly for tests
+  void Reset();
+
+ private:
+  void RunDumper(std::string file_name, int interval);
+
+  // guards the maps, not the metrics themselves
+  std::mutex registry_mutex;
+
+  std::map<std::string, std::unique_ptr<MetricsCounter>> counters;
+
+  std::map<std::string, std::unique_ptr<MetricsHistogram>> histograms;
+
+  // Periodic dumps
+  std::mutex dumper_mutex;
+
+  std::condition_variable dumper_cv;
+
+  std::thread dumper;
+
+  bool stop_dumping = false;
+};
+
+}  // End peloton namespace
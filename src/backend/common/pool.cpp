@@ -10,10 +10,23 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cassert>
+
 #include "backend/common/pool.h"
+#include "backend/common/varlen.h"
+#include "backend/common/logger.h"
+#include "backend/common/metrics.h"
 
 namespace peloton {
 
+// Bytes handed out by all the pools
+static MetricsCounter *GetUsedMemoryCounter() {
+  static MetricsCounter *used_memory_counter =
+      MetricsRegistry::GetInstance().GetCounter("pool.varlen_used_bytes");
+  return used_memory_counter;
+}
+
 void VarlenPool::Init() {
   auto &storage_manager = storage::StorageManager::GetInstance();
   char *storage = reinterpret_cast<char *>(
@@ -23,123 +36,387 @@ void VarlenPool::Init() {
 }
 
 VarlenPool::~VarlenPool() {
+  GetUsedMemoryCounter()->Decrement(used_memory);
+
   auto &storage_manager = storage::StorageManager::GetInstance();
 
-  for (std::size_t ii = 0; ii < chunks.size(); ii++) {
-    storage_manager.Release(backend_type, chunks[ii].chunk_data);
+  for (auto &chunk : chunks) {
+    storage_manager.Release(backend_type, chunk.chunk_data);
   }
 
-  for (std::size_t ii = 0; ii < oversize_chunks.size(); ii++) {
-    storage_manager.Release(backend_type, oversize_chunks[ii].chunk_data);
+  for (auto &oversize_chunk : oversize_chunks) {
+    storage_manager.Release(backend_type, oversize_chunk.first);
   }
 }
 
-// Allocate a continous block of memory of the specified size.
-void *VarlenPool::Allocate(std::size_t size) {
-  void *retval = nullptr;
+uint32_t VarlenPool::GetSizeClass(std::size_t size) const {
+  std::size_t block_size = size + sizeof(BlockHeader);
 
-  // Protect using pool lock
-  // TODO: Can make locking more fine-grained
-  {
-    std::lock_guard<std::mutex> pool_lock(pool_mutex);
-
-    // See if there is space in the current chunk
-    Chunk *current_chunk = &chunks[current_chunk_index];
-    if (size > current_chunk->size - current_chunk->offset) {
-      // Not enough space. Check if it is greater than our allocation size.
-      if (size > allocation_size) {
-        // Allocate an oversize chunk that will not be reused.
-        auto &storage_manager = storage::StorageManager::GetInstance();
-        char *storage = reinterpret_cast<char *>(
-            storage_manager.Allocate(backend_type, size));
-
-        oversize_chunks.push_back(Chunk(nexthigher(size), storage));
-        Chunk &newChunk = oversize_chunks.back();
-        newChunk.offset = size;
-        return newChunk.chunk_data;
-      }
+  uint32_t size_class = 0;
+  while (size_class < VARLEN_POOL_SIZE_CLASS_COUNT &&
+         GetBlockSize(size_class) < block_size) {
+    size_class++;
+  }
 
-      // Check if there is an already allocated chunk we can use.
-      current_chunk_index++;
-
-      if (current_chunk_index < chunks.size()) {
-        current_chunk = &chunks[current_chunk_index];
-        current_chunk->offset = size;
-        return current_chunk->chunk_data;
-      } else {
-        // Need to allocate a new chunk
-        auto &storage_manager = storage::StorageManager::GetInstance();
-        char *storage = reinterpret_cast<char *>(
-            storage_manager.Allocate(backend_type, allocation_size));
-
-        chunks.push_back(Chunk(allocation_size, storage));
-        Chunk &new_chunk = chunks.back();
-        new_chunk.offset = size;
-        return new_chunk.chunk_data;
-      }
-    }
+  // Blocks never span chunks
+  if (size_class < VARLEN_POOL_SIZE_CLASS_COUNT &&
+      GetBlockSize(size_class) > allocation_size) {
+    return VARLEN_POOL_SIZE_CLASS_COUNT;
+  }
 
-    // Get the offset into the current chunk. Then increment the
-    // offset counter by the amount being allocated.
-    retval = current_chunk->chunk_data + current_chunk->offset;
-    current_chunk->offset += size;
+  return size_class;
+}
 
-    // Ensure 8 byte alignment of future allocations
-    current_chunk->offset += (8 - (current_chunk->offset % 8));
-    if (current_chunk->offset > current_chunk->size) {
-      current_chunk->offset = current_chunk->size;
-    }
-  }
+VarlenPool::Shard &VarlenPool::GetShard() {
+  // Threads are spread over the shards on first use
+  static std::atomic<std::size_t> next_shard_id(0);
+  static thread_local std::size_t shard_id =
+      next_shard_id++ % VARLEN_POOL_SHARD_COUNT;
 
-  return retval;
+  return shards[shard_id];
 }
 
+// Allocate a continous block of memory of the specified size.
+void *VarlenPool::Allocate(std::size_t size) { return Allocate(size, false); }
+
 // Allocate a continous block of memory of the specified size conveniently
 // initialized to 0s
 void *VarlenPool::AllocateZeroes(std::size_t size) {
   return ::memset(Allocate(size), 0, size);
 }
 
-void VarlenPool::Purge() {
-  // Protect using pool lock
+void *VarlenPool::AllocateRelocatable(std::size_t size) {
+  assert(size >= sizeof(Varlen *));
+  return Allocate(size, true);
+}
+
+void *VarlenPool::Allocate(std::size_t size, bool relocatable) {
+  uint32_t size_class = GetSizeClass(size);
+  if (size_class == VARLEN_POOL_SIZE_CLASS_COUNT) {
+    return AllocateOversize(size);
+  }
+
+  auto &shard = GetShard();
+  std::lock_guard<std::mutex> shard_lock(shard.shard_mutex);
+
+  return AllocateBlockLocked(shard, size_class, relocatable);
+}
+
+void *VarlenPool::AllocateBlockLocked(Shard &shard, uint32_t size_class,
+                                      bool relocatable) {
+  const std::size_t block_size = GetBlockSize(size_class);
+  BlockHeader *header;
+
+  auto &free_list = shard.free_lists[relocatable][size_class];
+  if (free_list != nullptr) {
+    // Reuse a freed block
+    header = GetHeader(free_list);
+    free_list = free_list->next;
+  } else {
+    // Carve a new block out of the shard's current chunk
+    Chunk *&chunk = shard.current_chunks[relocatable];
+    if (chunk == nullptr || chunk->size - chunk->offset < block_size) {
+      if (chunk != nullptr) RetireChunkLocked(shard, chunk);
+      chunk = GetEmptyChunk(relocatable);
+    }
+
+    header = reinterpret_cast<BlockHeader *>(chunk->chunk_data + chunk->offset);
+    chunk->offset += block_size;
+  }
+
+  header->size_class = size_class;
+  header->state =
+      relocatable ? BLOCK_STATE_RELOCATABLE : BLOCK_STATE_ALLOCATED;
+  AddUsedMemory(block_size);
+
+  return header + 1;
+}
+
+void *VarlenPool::AllocateOversize(std::size_t size) {
+  std::size_t chunk_size = size + sizeof(BlockHeader);
+
+  auto &storage_manager = storage::StorageManager::GetInstance();
+  char *storage = reinterpret_cast<char *>(
+      storage_manager.Allocate(backend_type, chunk_size));
+
   {
-    std::lock_guard<std::mutex> pool_lock(pool_mutex);
+    std::lock_guard<std::mutex> chunk_lock(chunk_mutex);
+    oversize_chunks[storage] = chunk_size;
+  }
+
+  auto header = reinterpret_cast<BlockHeader *>(storage);
+  header->size_class = VARLEN_POOL_SIZE_CLASS_COUNT;
+  header->state = BLOCK_STATE_ALLOCATED;
+  AddUsedMemory(chunk_size);
+
+  return header + 1;
+}
+
+void VarlenPool::RetireChunkLocked(Shard &shard, Chunk *chunk) {
+  while (chunk->size - chunk->offset >= VARLEN_POOL_MIN_BLOCK_SIZE) {
+    std::size_t remaining = chunk->size - chunk->offset;
+
+    // Largest block that still fits
+    uint32_t size_class = VARLEN_POOL_SIZE_CLASS_COUNT - 1;
+    while (GetBlockSize(size_class) > remaining) size_class--;
+
+    auto header =
+        reinterpret_cast<BlockHeader *>(chunk->chunk_data + chunk->offset);
+    header->size_class = size_class;
+    header->state = BLOCK_STATE_FREE;
+
+    auto &free_list = shard.free_lists[chunk->relocatable][size_class];
+    auto block = reinterpret_cast<FreeBlock *>(header + 1);
+    block->next = free_list;
+    free_list = block;
+
+    chunk->offset += GetBlockSize(size_class);
+  }
+}
+
+Chunk *VarlenPool::GetEmptyChunk(bool relocatable) {
+  std::lock_guard<std::mutex> chunk_lock(chunk_mutex);
+
+  Chunk *empty_chunk = nullptr;
+  for (auto &chunk : chunks) {
+    if (chunk.in_use == false) {
+      empty_chunk = &chunk;
+      break;
+    }
+  }
+
+  // Need to allocate a new chunk
+  if (empty_chunk == nullptr) {
+    auto &storage_manager = storage::StorageManager::GetInstance();
+    char *storage = reinterpret_cast<char *>(
+        storage_manager.Allocate(backend_type, allocation_size));
+
+    chunks.push_back(Chunk(allocation_size, storage));
+    empty_chunk = &chunks.back();
+  }
+
+  empty_chunk->offset = 0;
+  empty_chunk->in_use = true;
+  empty_chunk->relocatable = relocatable;
+
+  return empty_chunk;
+}
+
+void VarlenPool::Free(void *ptr) {
+  if (ptr == nullptr) return;
+
+  auto header = GetHeader(ptr);
+
+  // Oversize chunks go back to the storage manager right away
+  if (header->size_class == VARLEN_POOL_SIZE_CLASS_COUNT) {
+    char *storage = reinterpret_cast<char *>(header);
+
+    {
+      std::lock_guard<std::mutex> chunk_lock(chunk_mutex);
+      auto oversize_itr = oversize_chunks.find(storage);
+      assert(oversize_itr != oversize_chunks.end());
+      AddUsedMemory(-static_cast<int64_t>(oversize_itr->second));
+      oversize_chunks.erase(oversize_itr);
+    }
+
+    auto &storage_manager = storage::StorageManager::GetInstance();
+    storage_manager.Release(backend_type, storage);
+    return;
+  }
+
+  auto &shard = GetShard();
+  std::lock_guard<std::mutex> shard_lock(shard.shard_mutex);
+
+  assert(header->state == BLOCK_STATE_ALLOCATED ||
+         header->state == BLOCK_STATE_RELOCATABLE);
+  bool relocatable = (header->state == BLOCK_STATE_RELOCATABLE);
+  header->state = BLOCK_STATE_FREE;
+
+  auto &free_list = shard.free_lists[relocatable][header->size_class];
+  auto block = reinterpret_cast<FreeBlock *>(ptr);
+  block->next = free_list;
+  free_list = block;
+
+  AddUsedMemory(-static_cast<int64_t>(GetBlockSize(header->size_class)));
+}
 
-    // Erase any oversize chunks that were allocated
-    const std::size_t numOversizeChunks = oversize_chunks.size();
-    for (std::size_t ii = 0; ii < numOversizeChunks; ii++) {
-      auto &storage_manager = storage::StorageManager::GetInstance();
-      storage_manager.Release(backend_type, oversize_chunks[ii].chunk_data);
+std::size_t VarlenPool::Compact() {
+  // Stop the world, shards first
+  std::vector<std::unique_lock<std::mutex>> shard_locks;
+  for (auto &shard : shards) {
+    shard_locks.emplace_back(shard.shard_mutex);
+  }
+  std::unique_lock<std::mutex> chunk_lock(chunk_mutex);
+
+  // Find the sparse relocatable chunks
+  std::vector<Chunk *> sparse_chunks;
+  for (auto &chunk : chunks) {
+    if (chunk.in_use == false || chunk.relocatable == false) continue;
+
+    std::size_t live_bytes = 0;
+    for (uint64_t offset = 0; offset < chunk.offset;) {
+      auto header = reinterpret_cast<BlockHeader *>(chunk.chunk_data + offset);
+      if (header->state == BLOCK_STATE_RELOCATABLE) {
+        live_bytes += GetBlockSize(header->size_class);
+      }
+      offset += GetBlockSize(header->size_class);
     }
-    oversize_chunks.clear();
 
-    // Set the current chunk to the first in the list
-    current_chunk_index = 0;
-    std::size_t num_chunks = chunks.size();
+    if (live_bytes < chunk.offset * VARLEN_POOL_COMPACTION_THRESHOLD) {
+      sparse_chunks.push_back(&chunk);
+    }
+  }
 
-    // If more then maxChunkCount chunks are allocated erase all extra chunks
-    if (num_chunks > max_chunk_count) {
-      for (std::size_t ii = max_chunk_count; ii < num_chunks; ii++) {
-        auto &storage_manager = storage::StorageManager::GetInstance();
-        storage_manager.Release(backend_type, chunks[ii].chunk_data);
+  if (sparse_chunks.empty()) return 0;
+
+  // Take the free blocks of the sparse chunks off the free lists,
+  // and stop carving from them
+  for (auto chunk : sparse_chunks) {
+    for (uint64_t offset = 0; offset < chunk->offset;) {
+      auto header = reinterpret_cast<BlockHeader *>(chunk->chunk_data + offset);
+      if (header->state == BLOCK_STATE_FREE) {
+        header->state = BLOCK_STATE_EVACUATED;
       }
-      chunks.resize(max_chunk_count);
+      offset += GetBlockSize(header->size_class);
     }
+  }
 
-    num_chunks = chunks.size();
-    for (std::size_t ii = 0; ii < num_chunks; ii++) {
-      chunks[ii].offset = 0;
+  for (auto &shard : shards) {
+    auto &current_chunk = shard.current_chunks[true];
+    if (std::find(sparse_chunks.begin(), sparse_chunks.end(), current_chunk) !=
+        sparse_chunks.end()) {
+      current_chunk = nullptr;
+    }
+
+    for (auto &free_list : shard.free_lists[true]) {
+      FreeBlock **link = &free_list;
+      while (*link != nullptr) {
+        if (GetHeader(*link)->state == BLOCK_STATE_EVACUATED) {
+          *link = (*link)->next;
+        } else {
+          link = &(*link)->next;
+        }
+      }
     }
   }
+
+  // Move the live blocks, new chunks may get allocated along the way
+  chunk_lock.unlock();
+
+  auto &target_shard = shards[0];
+  for (auto chunk : sparse_chunks) {
+    for (uint64_t offset = 0; offset < chunk->offset;) {
+      auto header = reinterpret_cast<BlockHeader *>(chunk->chunk_data + offset);
+      const std::size_t block_size = GetBlockSize(header->size_class);
+
+      if (header->state == BLOCK_STATE_RELOCATABLE) {
+        void *block = header + 1;
+        void *new_block =
+            AllocateBlockLocked(target_shard, header->size_class, true);
+        ::memcpy(new_block, block, block_size - sizeof(BlockHeader));
+
+        // Patch the owner through the back-pointer
+        Varlen *owner = *reinterpret_cast<Varlen **>(block);
+        owner->UpdateStringLocation(new_block);
+
+        AddUsedMemory(-static_cast<int64_t>(block_size));
+      }
+
+      offset += block_size;
+    }
+  }
+
+  // Release the evacuated chunks, or keep them around for reuse
+  chunk_lock.lock();
+
+  auto &storage_manager = storage::StorageManager::GetInstance();
+  std::size_t released_bytes = 0;
+
+  for (auto chunk_itr = chunks.begin(); chunk_itr != chunks.end();) {
+    bool evacuated =
+        std::find(sparse_chunks.begin(), sparse_chunks.end(), &(*chunk_itr)) !=
+        sparse_chunks.end();
+
+    if (evacuated == false) {
+      chunk_itr++;
+      continue;
+    }
+
+    chunk_itr->offset = 0;
+    chunk_itr->in_use = false;
+
+    if (chunks.size() > max_chunk_count) {
+      storage_manager.Release(backend_type, chunk_itr->chunk_data);
+      released_bytes += chunk_itr->size;
+      chunk_itr = chunks.erase(chunk_itr);
+    } else {
+      chunk_itr++;
+    }
+  }
+
+  LOG_TRACE("Evacuated %lu chunks, released %lu bytes", sparse_chunks.size(),
+            released_bytes);
+
+  return released_bytes;
+}
+
+void VarlenPool::Purge() {
+  // Protect using pool locks
+  std::vector<std::unique_lock<std::mutex>> shard_locks;
+  for (auto &shard : shards) {
+    shard_locks.emplace_back(shard.shard_mutex);
+  }
+  std::lock_guard<std::mutex> chunk_lock(chunk_mutex);
+
+  auto &storage_manager = storage::StorageManager::GetInstance();
+
+  // Erase any oversize chunks that were allocated
+  for (auto &oversize_chunk : oversize_chunks) {
+    storage_manager.Release(backend_type, oversize_chunk.first);
+  }
+  oversize_chunks.clear();
+
+  // Forget about all the blocks
+  for (auto &shard : shards) {
+    shard.current_chunks[false] = nullptr;
+    shard.current_chunks[true] = nullptr;
+    for (auto &free_lists : shard.free_lists) {
+      std::fill(std::begin(free_lists), std::end(free_lists), nullptr);
+    }
+  }
+
+  // If more then maxChunkCount chunks are allocated erase all extra chunks
+  while (chunks.size() > max_chunk_count) {
+    storage_manager.Release(backend_type, chunks.back().chunk_data);
+    chunks.pop_back();
+  }
+
+  for (auto &chunk : chunks) {
+    chunk.offset = 0;
+    chunk.in_use = false;
+  }
+
+  AddUsedMemory(-used_memory);
 }
 
 int64_t VarlenPool::GetAllocatedMemory() {
+  std::lock_guard<std::mutex> chunk_lock(chunk_mutex);
+
   int64_t total = 0;
-  total += chunks.size() * allocation_size;
-  for (uint32_t i = 0; i < oversize_chunks.size(); i++) {
-    total += oversize_chunks[i].getSize();
+  for (auto &chunk : chunks) {
+    total += chunk.getSize();
+  }
+  for (auto &oversize_chunk : oversize_chunks) {
+    total += oversize_chunk.second;
   }
   return total;
 }
 
+int64_t VarlenPool::GetUsedMemory() { return used_memory; }
+
+void VarlenPool::AddUsedMemory(int64_t delta) {
+  used_memory += delta;
+  GetUsedMemoryCounter()->Increment(delta);
+}
+
 }  // End peloton namespace
@@ -19,7 +19,10 @@
 #include <climits>
 #include <string.h>
 
+#include <atomic>
+#include <list>
 #include <mutex>
+#include <unordered_map>
 
 #include "backend/storage/storage_manager.h"
 
@@ -27,6 +30,17 @@ namespace peloton {
 
 static const size_t TEMP_POOL_CHUNK_SIZE = 1024 * 1024;  // 1 MB
 
+// Blocks are carved in power-of-two size classes, from 16 bytes up to 64 KB.
+// Larger requests get an oversize chunk of their own.
+static const size_t VARLEN_POOL_MIN_BLOCK_SIZE = 16;
+static const size_t VARLEN_POOL_SIZE_CLASS_COUNT = 13;
+
+// # of allocation shards, threads are spread over them
+static const size_t VARLEN_POOL_SHARD_COUNT = 8;
+
+// Compaction evacuates chunks with less than this fraction of live bytes
+static const double VARLEN_POOL_COMPACTION_THRESHOLD = 0.5;
+
 //===--------------------------------------------------------------------===//
 // Chunk of memory allocated on the heap
 //===--------------------------------------------------------------------===//
@@ -43,6 +57,12 @@ class Chunk {
   uint64_t offset;
   uint64_t size;
   char *chunk_data;
+
+  // Only holds relocatable blocks, so it can be evacuated
+  bool relocatable = false;
+
+  // Handed out to a shard
+  bool in_use = false;
 };
 
 // Find next higher power of two
@@ -59,9 +79,19 @@ inline T nexthigher(T k) {
 //===--------------------------------------------------------------------===//
 
 /**
- * A memory pool that provides fast allocation and deallocation. The
- * only way to release memory is to free all memory in the pool by
- * calling purge.
+ * A memory pool for uninlined data.
+ *
+ * Blocks come in power-of-two size classes and freed blocks are kept on
+ * per-class free lists for reuse. Threads are spread over a set of shards,
+ * each with its own lock, chunks and free lists, so that concurrent
+ * inserts into a tile don't serialize on a single pool lock.
+ *
+ * Relocatable blocks start with a back-pointer to the Varlen that owns
+ * them, and are carved from their own chunks. Compact() moves the live
+ * relocatable blocks out of sparse chunks and patches their owners through
+ * the back-pointers, so the emptied chunks can be reused or released.
+ *
+ * Purge() still frees all the memory in the pool at once.
  */
 class VarlenPool {
   VarlenPool(const VarlenPool &) = delete;
@@ -71,8 +101,7 @@ class VarlenPool {
   VarlenPool(BackendType backend_type)
       : backend_type(backend_type),
         allocation_size(TEMP_POOL_CHUNK_SIZE),
-        max_chunk_count(1),
-        current_chunk_index(0) {
+        max_chunk_count(1) {
     Init();
   }
 
@@ -80,8 +109,7 @@ class VarlenPool {
              uint64_t max_chunk_count)
       : backend_type(backend_type),
         allocation_size(allocation_size),
-        max_chunk_count(static_cast<std::size_t>(max_chunk_count)),
-        current_chunk_index(0) {
+        max_chunk_count(static_cast<std::size_t>(max_chunk_count)) {
     Init();
   }
 
@@ -96,23 +124,119 @@ class VarlenPool {
   // initialized to 0s
   void *AllocateZeroes(std::size_t size);
 
+  /**
+   * Allocate a block that Compact() may move. The block must start with a
+   * pointer to the Varlen that owns it.
+   */
+  void *AllocateRelocatable(std::size_t size);
+
+  // Return a block to the pool
+  void Free(void *ptr);
+
+  /**
+   * @brief Evacuate sparse relocatable chunks.
+   *
+   * Must not run concurrently with readers of the pool's strings, since
+   * their memory moves underneath them.
+   *
+   * The engine does not call it yet. Old tuple versions are never
+   * reclaimed, so their strings are never freed; only overwritten values
+   * and aborted inserts give blocks back.
+   *
+   * @return # of bytes of chunk memory released.
+   */
+  std::size_t Compact();
+
   void Purge();
 
   int64_t GetAllocatedMemory();
 
+  // # of bytes in blocks that are currently handed out
+  int64_t GetUsedMemory();
+
  private:
+  enum BlockState : uint32_t {
+    BLOCK_STATE_FREE = 0,
+    BLOCK_STATE_ALLOCATED = 1,
+    BLOCK_STATE_RELOCATABLE = 2,
+    BLOCK_STATE_EVACUATED = 3
+  };
+
+  // Precedes every block handed out by the pool
+  struct BlockHeader {
+    uint32_t size_class;
+    BlockState state;
+  };
+
+  // Free blocks are chained through their payload
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+
+  struct Shard {
+    std::mutex shard_mutex;
+
+    // chunks blocks are currently carved from,
+    // indexed by the relocatable flag
+    Chunk *current_chunks[2] = {nullptr, nullptr};
+
+    FreeBlock *free_lists[2][VARLEN_POOL_SIZE_CLASS_COUNT] = {};
+  };
+
+  static inline BlockHeader *GetHeader(const void *ptr) {
+    return const_cast<BlockHeader *>(
+        reinterpret_cast<const BlockHeader *>(ptr) - 1);
+  }
+
+  static inline std::size_t GetBlockSize(uint32_t size_class) {
+    return VARLEN_POOL_MIN_BLOCK_SIZE << size_class;
+  }
+
+  // Size class of the block holding a payload of the given size,
+  // VARLEN_POOL_SIZE_CLASS_COUNT if it only fits in an oversize chunk
+  uint32_t GetSizeClass(std::size_t size) const;
+
+  Shard &GetShard();
+
+  void *Allocate(std::size_t size, bool relocatable);
+
+  void *AllocateBlockLocked(Shard &shard, uint32_t size_class,
+                            bool relocatable);
+
+  void *AllocateOversize(std::size_t size);
+
+  // Turn the unused tail of a chunk into free blocks
+  void RetireChunkLocked(Shard &shard, Chunk *chunk);
+
+  // Get an empty chunk, reusing a released one if possible
+  Chunk *GetEmptyChunk(bool relocatable);
+
+  // Also kept in the engine-wide metrics
+  void AddUsedMemory(int64_t delta);
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
   // backend type
   BackendType backend_type;
 
   const uint64_t allocation_size;
   std::size_t max_chunk_count;
-  std::size_t current_chunk_index;
-  std::vector<Chunk> chunks;
 
-  // Oversize chunks that will be freed and not reused.
-  std::vector<Chunk> oversize_chunks;
+  Shard shards[VARLEN_POOL_SHARD_COUNT];
+
+  // guards chunks and oversize_chunks
+  // (taken after any shard lock)
+  std::mutex chunk_mutex;
+
+  // list, so that chunk addresses stay stable
+  std::list<Chunk> chunks;
+
+  // Oversize chunks, freed as soon as their block is freed.
+  std::unordered_map<char *, std::size_t> oversize_chunks;
 
-  std::mutex pool_mutex;
+  std::atomic<int64_t> used_memory = ATOMIC_VAR_INIT(0);
 };
 
 }  // End peloton namespace
@@ -0,0 +1,195 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// task_scheduler.cpp
+//
+// Identification: src/backend/common/task_scheduler.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+#include "backend/common/task_scheduler.h"
+#include "backend/common/logger.h"
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// Task Scheduler
+//===--------------------------------------------------------------------===//
+
+TaskScheduler::TaskScheduler(size_t worker_count) {
+  if (worker_count == 0) {
+    worker_count = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  for (size_t worker_itr = 0; worker_itr < worker_count; worker_itr++) {
+    queues.emplace_back(new TaskQueue());
+  }
+
+  for (size_t worker_itr = 0; worker_itr < worker_count; worker_itr++) {
+    workers.emplace_back(&TaskScheduler::RunWorker, this, worker_itr);
+  }
+
+  LOG_INFO("Task scheduler started with %lu workers", worker_count);
+}
+
+TaskScheduler::~TaskScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(idle_mutex);
+    shutdown = true;
+  }
+  idle_cv.notify_all();
+
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+TaskScheduler &TaskScheduler::GetInstance() {
+  static TaskScheduler scheduler;
+  return scheduler;
+}
+
+void TaskScheduler::Submit(Task &&task) {
+  auto queue_id = next_queue++ % queues.size();
+  auto &queue = queues[queue_id];
+
+  // Count the task under the queue lock, so that a worker can't pop it
+  // (and decrement the count) before it was counted
+  {
+    std::lock_guard<std::mutex> lock(queue->queue_mutex);
+    queue->tasks.push_back(std::move(task));
+    queued_task_count++;
+  }
+
+  // Wake up an idle worker. Taking the idle mutex orders the notification
+  // after a worker that just found no task started waiting.
+  {
+    std::lock_guard<std::mutex> lock(idle_mutex);
+  }
+  idle_cv.notify_one();
+}
+
+bool TaskScheduler::GetTask(size_t worker_id, Task &task) {
+  auto queue_count = queues.size();
+
+  for (size_t queue_itr = 0; queue_itr < queue_count; queue_itr++) {
+    auto &queue = queues[(worker_id + queue_itr) % queue_count];
+    bool own_queue = (queue_itr == 0);
+
+    std::lock_guard<std::mutex> lock(queue->queue_mutex);
+    if (queue->tasks.empty()) continue;
+
+    // Take the oldest task from our own queue, steal the newest otherwise
+    if (own_queue) {
+      task = std::move(queue->tasks.front());
+      queue->tasks.pop_front();
+    } else {
+      task = std::move(queue->tasks.back());
+      queue->tasks.pop_back();
+    }
+
+    queued_task_count--;
+    return true;
+  }
+
+  return false;
+}
+
+void TaskScheduler::RunWorker(size_t worker_id) {
+  for (;;) {
+    Task task;
+
+    if (GetTask(worker_id, task)) {
+      std::exception_ptr exception;
+      auto start = std::chrono::steady_clock::now();
+
+      try {
+        task.function();
+      } catch (...) {
+        exception = std::current_exception();
+      }
+
+      auto task_time = std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now() - start).count();
+      task.group->TaskDone(task_time, exception);
+      continue;
+    }
+
+    // Nothing to do, wait for more tasks
+    std::unique_lock<std::mutex> lock(idle_mutex);
+    idle_cv.wait(lock, [this] { return shutdown || queued_task_count > 0; });
+
+    if (shutdown && queued_task_count == 0) {
+      break;
+    }
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Task Group
+//===--------------------------------------------------------------------===//
+
+TaskGroup::TaskGroup(TaskScheduler &scheduler) : scheduler(scheduler) {}
+
+TaskGroup::~TaskGroup() {
+  std::unique_lock<std::mutex> lock(group_mutex);
+  done_cv.wait(lock, [this] { return pending_task_count == 0; });
+}
+
+void TaskGroup::Submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(group_mutex);
+    pending_task_count++;
+  }
+
+  scheduler.Submit({std::move(task), this});
+}
+
+void TaskGroup::SubmitMorsels(oid_t morsel_count,
+                              const std::function<void(oid_t)> &morsel_task) {
+  for (oid_t morsel_itr = 0; morsel_itr < morsel_count; morsel_itr++) {
+    Submit([morsel_task, morsel_itr] { morsel_task(morsel_itr); });
+  }
+}
+
+void TaskGroup::Wait() {
+  std::exception_ptr exception;
+
+  {
+    std::unique_lock<std::mutex> lock(group_mutex);
+    done_cv.wait(lock, [this] { return pending_task_count == 0; });
+
+    exception = first_exception;
+    first_exception = nullptr;
+  }
+
+  if (exception != nullptr) {
+    std::rethrow_exception(exception);
+  }
+}
+
+void TaskGroup::TaskDone(uint64_t task_time, std::exception_ptr exception) {
+  completed_task_count++;
+  busy_time += task_time;
+
+  std::lock_guard<std::mutex> lock(group_mutex);
+  assert(pending_task_count > 0);
+
+  if (exception != nullptr && first_exception == nullptr) {
+    first_exception = exception;
+  }
+
+  // Notify while holding the lock, the group may go away right after
+  if (--pending_task_count == 0) {
+    done_cv.notify_all();
+  }
+}
+
+}  // End peloton namespace
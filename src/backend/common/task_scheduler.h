@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// task_scheduler.h
+//
+// Identification: src/backend/common/task_scheduler.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "backend/common/types.h"
+
+namespace peloton {
+
+class TaskGroup;
+
+//===--------------------------------------------------------------------===//
+// Task Scheduler
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Engine-wide pool of worker threads.
+ *
+ * Every worker owns a task queue. Submitted tasks are spread over the
+ * queues round-robin; a worker drains its own queue in FIFO order and
+ * steals from the other queues once it runs dry. Tasks are always
+ * submitted through a TaskGroup, which does the per-query accounting.
+ */
+class TaskScheduler {
+  friend class TaskGroup;
+
+ public:
+  TaskScheduler(const TaskScheduler &) = delete;
+  TaskScheduler &operator=(const TaskScheduler &) = delete;
+  TaskScheduler(TaskScheduler &&) = delete;
+  TaskScheduler &operator=(TaskScheduler &&) = delete;
+
+  // worker_count of 0 means one worker per hardware thread
+  TaskScheduler(size_t worker_count = 0);
+
+  // Drains the queues and joins the workers
+  ~TaskScheduler();
+
+  // Singleton
+  static TaskScheduler &GetInstance();
+
+  size_t GetWorkerCount() const { return workers.size(); }
+
+ private:
+  struct Task {
+    std::function<void()> function;
+    TaskGroup *group;
+  };
+
+  struct TaskQueue {
+    std::mutex queue_mutex;
+    std::deque<Task> tasks;
+  };
+
+  void Submit(Task &&task);
+
+  // Get a task, first from the worker's own queue, then from the others
+  bool GetTask(size_t worker_id, Task &task);
+
+  void RunWorker(size_t worker_id);
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  std::vector<std::unique_ptr<TaskQueue>> queues;
+
+  std::vector<std::thread> workers;
+
+  // queue the next task goes to
+  std::atomic<size_t> next_queue = ATOMIC_VAR_INIT(0);
+
+  // # of tasks sitting in the queues
+  std::atomic<size_t> queued_task_count = ATOMIC_VAR_INIT(0);
+
+  // idle workers wait here for new tasks
+  std::mutex idle_mutex;
+
+  std::condition_variable idle_cv;
+
+  bool shutdown = false;
+};
+
+//===--------------------------------------------------------------------===//
+// Task Group
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief A set of tasks submitted on behalf of one query or operator.
+ *
+ * Tracks the number of outstanding tasks and the time spent running them,
+ * and keeps the first exception thrown by a task so that Wait() can
+ * rethrow it on the submitting thread.
+ *
+ * Wait() must not be called from inside a task of the same scheduler.
+ */
+class TaskGroup {
+  friend class TaskScheduler;
+
+ public:
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+  TaskGroup(TaskGroup &&) = delete;
+  TaskGroup &operator=(TaskGroup &&) = delete;
+
+  TaskGroup(TaskScheduler &scheduler = TaskScheduler::GetInstance());
+
+  // Waits for any outstanding tasks
+  ~TaskGroup();
+
+  void Submit(std::function<void()> task);
+
+  // Run morsel_task(morsel_id) for every morsel in [0, morsel_count),
+  // e.g. one morsel per tile group of a table
+  void SubmitMorsels(oid_t morsel_count,
+                     const std::function<void(oid_t)> &morsel_task);
+
+  // Block until all the submitted tasks are done
+  void Wait();
+
+  //===--------------------------------------------------------------------===//
+  // STATS
+  //===--------------------------------------------------------------------===//
+
+  size_t GetCompletedTaskCount() const { return completed_task_count; }
+
+  // Time spent by workers running this group's tasks (in microseconds)
+  uint64_t GetBusyTime() const { return busy_time; }
+
+ private:
+  void TaskDone(uint64_t task_time, std::exception_ptr exception);
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  TaskScheduler &scheduler;
+
+  std::atomic<size_t> completed_task_count = ATOMIC_VAR_INIT(0);
+
+  std::atomic<uint64_t> busy_time = ATOMIC_VAR_INIT(0);
+
+  // guards pending_task_count and first_exception
+  std::mutex group_mutex;
+
+  std::condition_variable done_cv;
+
+  size_t pending_task_count = 0;
+
+  std::exception_ptr first_exception;
+};
+
+}  // End peloton namespace
@@ -95,6 +95,9 @@ class Value;
 
 #define DEFAULT_TUPLES_PER_TILEGROUP 1000
 
+// Memory hash-based operators may use before spilling to disk
+#define DEFAULT_OPERATOR_MEMORY_BUDGET (64 * 1024 * 1024)
+
 // Ref count starting point
 #define BASE_REF_COUNT 1
 
@@ -37,10 +37,26 @@ Varlen *Varlen::Clone(const Varlen &src, VarlenPool *data_pool) {
   return rv;
 }
 
+// Return the string and the varlen to the pool they came from
+void Varlen::Destroy(Varlen *varlen) {
+  if (varlen == NULL) return;
+
+  VarlenPool *data_pool = varlen->varlen_pool;
+  if (data_pool == NULL) {
+    delete varlen;
+    return;
+  }
+
+  data_pool->Free(varlen->varlen_string_ptr);
+  varlen->~Varlen();
+  data_pool->Free(varlen);
+}
+
 // Construct varlen in heap
 Varlen::Varlen(size_t size) {
   varlen_size = size + sizeof(Varlen *);
   varlen_temp_pool = true;
+  varlen_pool = NULL;
   varlen_string_ptr = new char[varlen_size];
   SetBackPtr();
 }
@@ -49,8 +65,10 @@ Varlen::Varlen(size_t size) {
 Varlen::Varlen(std::size_t size, VarlenPool *data_pool) {
   varlen_size = size + sizeof(Varlen *);
   varlen_temp_pool = false;
+  varlen_pool = data_pool;
+  // the string starts with the back pointer, so the pool may move it
   varlen_string_ptr =
-      reinterpret_cast<char *>(data_pool->Allocate(varlen_size));
+      reinterpret_cast<char *>(data_pool->AllocateRelocatable(varlen_size));
   SetBackPtr();
 }
 
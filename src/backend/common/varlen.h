@@ -30,6 +30,8 @@ class VarlenPool;
  * compaction.
  */
 class Varlen {
+  friend class VarlenPool;
+
  public:
   /// Create and return a new Varlen object which points to an
   /// allocated memory block of the requested size. The caller
@@ -52,6 +54,13 @@ class Varlen {
    */
   static Varlen *Clone(const Varlen &src, VarlenPool *data_pool = NULL);
 
+  /// Destroy a Varlen created by Varlen::Create(). If it came from a
+  /// Pool, the string memory and the Varlen object go back to that Pool.
+  static void Destroy(Varlen *varlen);
+
+  /// Pool the Varlen was allocated from, NULL for temporary strings
+  VarlenPool *GetPool() const { return varlen_pool; }
+
   char *Get();
   const char *Get() const;
 
@@ -69,6 +78,8 @@ class Varlen {
 
   bool varlen_temp_pool;
 
+  VarlenPool *varlen_pool;
+
   char *varlen_string_ptr;
 };
 
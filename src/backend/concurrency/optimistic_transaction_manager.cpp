@@ -0,0 +1,156 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// optimistic_transaction_manager.cpp
+//
+// Identification: src/backend/concurrency/optimistic_transaction_manager.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/concurrency/optimistic_transaction_manager.h"
+
+#include "backend/catalog/manager.h"
+#include "backend/common/logger.h"
+#include "backend/common/metrics.h"
+#include "backend/common/platform.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/storage/tile_group.h"
+#include "backend/storage/tile_group_header.h"
+
+namespace peloton {
+namespace concurrency {
+
+OptimisticTransactionManager &OptimisticTransactionManager::GetInstance() {
+  static OptimisticTransactionManager txn_manager;
+  return txn_manager;
+}
+
+Transaction *OptimisticTransactionManager::BeginTransaction() {
+  Transaction *txn = TransactionManager::BeginTransaction();
+  txn->optimistic = true;
+
+  return txn;
+}
+
+/**
+ * @brief Check that no tuple read by the transaction was deleted by a
+ * transaction that committed in the meantime.
+ * Called with the commit mutex held.
+ */
+bool OptimisticTransactionManager::ValidateReads(Transaction *txn) {
+  auto &manager = catalog::Manager::GetInstance();
+
+  for (auto &entry : txn->GetReadTuples()) {
+    auto tile_group = manager.GetTileGroup(entry.first);
+    auto tile_group_header = tile_group->GetHeader();
+
+    // The tuples were visible, so they were not deleted before we started
+    for (auto tuple_slot : entry.second) {
+      if (tile_group_header->GetEndCommitId(tuple_slot) != MAX_CID) {
+        LOG_INFO("Read validation failed : tile group %lu slot %lu",
+                 entry.first, tuple_slot);
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Latch the tuples deleted by the transaction, or none of them if one
+ * was deleted by another transaction.
+ * Called with the commit mutex held.
+ */
+bool OptimisticTransactionManager::LatchDeletes(Transaction *txn) {
+  auto &manager = catalog::Manager::GetInstance();
+  txn_id_t txn_id = txn->GetTransactionId();
+  std::vector<ItemPointer> latched_tuples;
+
+  for (auto &entry : txn->GetDeletedTuples()) {
+    auto tile_group = manager.GetTileGroup(entry.first);
+    auto tile_group_header = tile_group->GetHeader();
+
+    for (auto tuple_slot : entry.second) {
+      // Own inserts were invalidated right away
+      if (tile_group_header->GetTransactionId(tuple_slot) == INVALID_TXN_ID)
+        continue;
+
+      bool status = tile_group_header->LatchTupleSlot(tuple_slot, txn_id);
+      if (status == true) {
+        latched_tuples.push_back(ItemPointer(entry.first, tuple_slot));
+        status = tile_group_header->IsDeletable(tuple_slot, txn_id,
+                                                txn->GetLastCommitId());
+      }
+
+      if (status == false) {
+        LOG_INFO("Delete validation failed : tile group %lu slot %lu",
+                 entry.first, tuple_slot);
+
+        for (auto location : latched_tuples) {
+          manager.GetTileGroup(location.block)
+              ->GetHeader()
+              ->ReleaseTupleSlot(location.offset, txn_id);
+        }
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+Result OptimisticTransactionManager::CommitTransaction(bool sync) {
+  LOG_INFO("Committing peloton txn : %lu ", current_txn->GetTransactionId());
+  Transaction *txn = current_txn;
+
+  bool read_only = txn->GetInsertedTuples().empty() &&
+                   txn->GetDeletedTuples().empty();
+
+  // Read-only transactions serialize at their snapshot
+  if (read_only == true) {
+    CommitModifications(txn, sync);
+  } else {
+    std::unique_lock<std::mutex> lock(commit_mutex);
+
+    if (ValidateReads(txn) == false || LatchDeletes(txn) == false) {
+      lock.unlock();
+
+      LOG_INFO("Validation failed for txn : %lu ", txn->GetTransactionId());
+      AbortTransaction();
+      return Result::RESULT_ABORTED;
+    }
+
+    // Commits are serialized, so commit ids are handed out in order
+    txn->cid = last_cid + 1;
+    RecordCommitTime(txn->cid);
+    CommitModifications(txn, sync);
+
+    // Only now are the writes visible to new transactions
+    atomic_cas(&last_cid, txn->cid - 1, txn->cid);
+  }
+
+  EndTransaction(txn, sync);
+
+  // drop a reference
+  txn->DecrementRefCount();
+  commit_counter->Increment();
+
+  current_txn = nullptr;
+
+  return Result::RESULT_SUCCESS;
+}
+
+void OptimisticTransactionManager::AbortTransaction() {
+  // Deleted tuples were never latched, so there is nothing to roll back
+  current_txn->deleted_tuples.clear();
+  current_txn->own_deletes.clear();
+
+  TransactionManager::AbortTransaction();
+}
+
+}  // End concurrency namespace
+}  // End peloton namespace
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// optimistic_transaction_manager.h
+//
+// Identification: src/backend/concurrency/optimistic_transaction_manager.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>
+
+#include "backend/concurrency/transaction_manager.h"
+
+namespace peloton {
+namespace concurrency {
+
+//===--------------------------------------------------------------------===//
+// Optimistic Transaction Manager
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Transaction manager for optimistic concurrency control.
+ *
+ * Transactions run without latching any tuple: scans record the tuples they
+ * return in the read set, and deletes are only recorded in the write set
+ * (inserts are private to the transaction until commit anyway).
+ *
+ * At commit, transactions that wrote something are validated one at a time.
+ * Every tuple read must still be live, i.e. no transaction committed a
+ * delete of it since we started, and every tuple deleted gets latched. The
+ * commit id is then assigned and the writes applied, in the same order as
+ * the validations, so no commit chain is needed. Read-only transactions
+ * read a committed snapshot, and commit without validation.
+ *
+ * Inserts of new tuples into ranges that were scanned (phantoms) are not
+ * detected.
+ */
+class OptimisticTransactionManager : public TransactionManager {
+ public:
+  static OptimisticTransactionManager &GetInstance();
+
+  Transaction *BeginTransaction();
+
+  Result CommitTransaction(bool sync = true);
+
+  void AbortTransaction();
+
+ private:
+  bool ValidateReads(Transaction *txn);
+
+  bool LatchDeletes(Transaction *txn);
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  // Serializes the validation and write phases
+  std::mutex commit_mutex;
+};
+
+}  // End concurrency namespace
+}  // End peloton namespace
@@ -0,0 +1,230 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// serializable_transaction_manager.cpp
+//
+// Identification: src/backend/concurrency/serializable_transaction_manager.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/concurrency/serializable_transaction_manager.h"
+
+#include <algorithm>
+
+#include "backend/catalog/manager.h"
+#include "backend/common/logger.h"
+#include "backend/common/metrics.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/storage/tile_group.h"
+
+namespace peloton {
+namespace concurrency {
+
+SerializableTransactionManager &SerializableTransactionManager::GetInstance() {
+  static SerializableTransactionManager txn_manager;
+  return txn_manager;
+}
+
+Transaction *SerializableTransactionManager::BeginTransaction() {
+  // Take the snapshot and register under the ssi mutex, as commits are.
+  // Otherwise a commit in between would prune the committed writers we are
+  // concurrent with, not knowing about our snapshot.
+  std::lock_guard<std::mutex> lock(ssi_mutex);
+
+  Transaction *txn = TransactionManager::BeginTransaction();
+  txn->serializable = true;
+
+  // Concurrent writers check our reads from now on
+  txn->IncrementRefCount();
+  ssi_txns.push_back(txn);
+
+  return txn;
+}
+
+/**
+ * @brief Set the write footprint of the transaction from its writes.
+ */
+void SerializableTransactionManager::CollectWrites(Transaction *txn) {
+  auto &manager = catalog::Manager::GetInstance();
+
+  for (auto writes : {&txn->GetInsertedTuples(), &txn->GetDeletedTuples()}) {
+    for (auto &entry : *writes) {
+      if (txn->written_tile_groups.insert(entry.first).second == false)
+        continue;
+
+      auto tile_group = manager.GetTileGroup(entry.first);
+      txn->written_tables.insert(tile_group->GetTableId());
+    }
+  }
+}
+
+static bool Intersects(const std::set<oid_t> &lhs,
+                       const std::set<oid_t> &rhs) {
+  auto lhs_itr = lhs.begin();
+  auto rhs_itr = rhs.begin();
+
+  while (lhs_itr != lhs.end() && rhs_itr != rhs.end()) {
+    if (*lhs_itr < *rhs_itr) {
+      lhs_itr++;
+    } else if (*rhs_itr < *lhs_itr) {
+      rhs_itr++;
+    } else {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief Whether the writer wrote something in the read footprint of the
+ * reader, i.e. reader -rw-> writer if they are concurrent.
+ */
+bool SerializableTransactionManager::ReadsOverlapWrites(Transaction *reader,
+                                                        Transaction *writer) {
+  if (writer->written_tile_groups.empty()) return false;
+
+  std::lock_guard<std::mutex> lock(reader->txn_mutex);
+
+  return Intersects(reader->read_tables, writer->written_tables) ||
+         Intersects(reader->read_tile_groups, writer->written_tile_groups);
+}
+
+/**
+ * @brief Find the rw-antidependencies between the committing transaction and
+ * the concurrent ones.
+ * Called with the ssi mutex held.
+ * @return false if the transaction must abort.
+ */
+bool SerializableTransactionManager::CheckConflicts(Transaction *txn) {
+  bool in_conflict = txn->in_conflict;
+  bool out_conflict = txn->out_conflict;
+
+  // Flags are only set on others if the transaction commits
+  std::vector<Transaction *> readers;
+  std::vector<Transaction *> writers;
+
+  for (auto other_txn : ssi_txns) {
+    if (other_txn == txn) continue;
+
+    // Committed before our snapshot
+    bool committed = (other_txn->cid != INVALID_CID);
+    if (committed && other_txn->cid <= txn->last_cid) continue;
+
+    // other -rw-> txn
+    if (ReadsOverlapWrites(other_txn, txn)) {
+      // It would be a committed pivot
+      if (committed && other_txn->in_conflict) return false;
+
+      in_conflict = true;
+      readers.push_back(other_txn);
+    }
+
+    // txn -rw-> other, the writes of active transactions are checked when
+    // they commit
+    if (committed && ReadsOverlapWrites(txn, other_txn)) {
+      // It would be a committed pivot
+      if (other_txn->out_conflict) return false;
+
+      out_conflict = true;
+      writers.push_back(other_txn);
+    }
+  }
+
+  // We would be a pivot
+  if (in_conflict && out_conflict) return false;
+
+  txn->in_conflict = in_conflict;
+  txn->out_conflict = out_conflict;
+  for (auto reader : readers) reader->out_conflict = true;
+  for (auto writer : writers) writer->in_conflict = true;
+
+  return true;
+}
+
+void SerializableTransactionManager::Unregister(Transaction *txn) {
+  auto txn_itr = std::find(ssi_txns.begin(), ssi_txns.end(), txn);
+  assert(txn_itr != ssi_txns.end());
+
+  ssi_txns.erase(txn_itr);
+  txn->DecrementRefCount();
+}
+
+/**
+ * @brief Drop the committed transactions that no active transaction, or any
+ * later one, is concurrent with.
+ * Called with the ssi mutex held.
+ */
+void SerializableTransactionManager::PruneCommittedTransactions() {
+  cid_t oldest_snapshot = GetLastCommitId();
+  for (auto other_txn : ssi_txns) {
+    if (other_txn->cid == INVALID_CID) {
+      oldest_snapshot = std::min(oldest_snapshot, other_txn->last_cid);
+    }
+  }
+
+  for (auto txn_itr = ssi_txns.begin(); txn_itr != ssi_txns.end();) {
+    Transaction *other_txn = *txn_itr;
+    if (other_txn->cid != INVALID_CID && other_txn->cid <= oldest_snapshot) {
+      txn_itr = ssi_txns.erase(txn_itr);
+      other_txn->DecrementRefCount();
+    } else {
+      txn_itr++;
+    }
+  }
+}
+
+Result SerializableTransactionManager::CommitTransaction(bool sync) {
+  LOG_INFO("Committing peloton txn : %lu ", current_txn->GetTransactionId());
+  Transaction *txn = current_txn;
+
+  CollectWrites(txn);
+
+  {
+    std::unique_lock<std::mutex> lock(ssi_mutex);
+
+    if (CheckConflicts(txn) == false) {
+      lock.unlock();
+
+      LOG_INFO("Dangerous structure, aborting txn : %lu ",
+               txn->GetTransactionId());
+      AbortTransaction();
+      return Result::RESULT_ABORTED;
+    }
+
+    // begin commit phase : get cid and add to transaction list
+    // Under the ssi mutex, so that the commit is seen by later checks
+    BeginCommitPhase(txn);
+
+    PruneCommittedTransactions();
+  }
+
+  // commit all modifications
+  CommitModifications(txn, sync);
+
+  // end commit phase : increment last_cid and process pending txns if needed
+  std::vector<Transaction *> committed_txns = EndCommitPhase(txn, sync);
+
+  // process all committed txns
+  for (auto committed_txn : committed_txns) committed_txn->DecrementRefCount();
+  commit_counter->Increment();
+
+  current_txn = nullptr;
+
+  return Result::RESULT_SUCCESS;
+}
+
+void SerializableTransactionManager::AbortTransaction() {
+  {
+    std::lock_guard<std::mutex> lock(ssi_mutex);
+    Unregister(current_txn);
+  }
+
+  TransactionManager::AbortTransaction();
+}
+
+}  // End concurrency namespace
+}  // End peloton namespace
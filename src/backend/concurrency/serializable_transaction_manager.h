@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// serializable_transaction_manager.h
+//
+// Identification: src/backend/concurrency/serializable_transaction_manager.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>
+
+#include "backend/concurrency/transaction_manager.h"
+
+namespace peloton {
+namespace concurrency {
+
+//===--------------------------------------------------------------------===//
+// Serializable Transaction Manager
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Transaction manager for serializable snapshot isolation.
+ *
+ * Transactions read their snapshot and latch the tuples they delete as
+ * usual. On top of that, scans record a read footprint: the tables scanned
+ * sequentially or with an index range, and the tile groups of the tuples
+ * found by index point lookups.
+ *
+ * When a transaction commits, its write footprint (tile groups and tables
+ * written) is checked against the footprints of the concurrent transactions,
+ * i.e. the active ones and the ones that committed after its snapshot. An
+ * overlap is a rw-antidependency, recorded as an in or out conflict flag on
+ * both sides. A transaction with both flags may be the pivot of a dangerous
+ * structure, so it is aborted when it commits, and so is a transaction that
+ * would turn a committed transaction into one.
+ *
+ * Committed transactions are kept around until no active transaction is
+ * concurrent with them.
+ */
+class SerializableTransactionManager : public TransactionManager {
+ public:
+  static SerializableTransactionManager &GetInstance();
+
+  Transaction *BeginTransaction();
+
+  // Read-only transactions can still take part in a dangerous structure, so
+  // they are registered like the others
+  Transaction *BeginReadOnlyTransaction() { return BeginTransaction(); }
+
+  Result CommitTransaction(bool sync = true);
+
+  void AbortTransaction();
+
+ private:
+  void CollectWrites(Transaction *txn);
+
+  static bool ReadsOverlapWrites(Transaction *reader, Transaction *writer);
+
+  bool CheckConflicts(Transaction *txn);
+
+  void Unregister(Transaction *txn);
+
+  void PruneCommittedTransactions();
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  // Active and recently committed transactions, each holding a reference
+  // Sync access with ssi_mutex
+  std::list<Transaction *> ssi_txns;
+
+  std::mutex ssi_mutex;
+};
+
+}  // End concurrency namespace
+}  // End peloton namespace
@@ -28,6 +28,10 @@ void Transaction::RecordInsert(ItemPointer location) {
 
 void Transaction::RecordDelete(ItemPointer location) {
   deleted_tuples[location.block].push_back(location.offset);
+
+  if (optimistic) {
+    own_deletes[location.block].insert(location.offset);
+  }
 }
 
 const std::map<oid_t, std::vector<oid_t>> &Transaction::GetInsertedTuples() {
@@ -38,9 +42,41 @@ const std::map<oid_t, std::vector<oid_t>> &Transaction::GetDeletedTuples() {
   return deleted_tuples;
 }
 
+void Transaction::RecordReads(oid_t tile_group_id,
+                              const std::vector<oid_t> &tuple_ids) {
+  if (tuple_ids.empty()) return;
+
+  auto &tile_group_reads = read_tuples[tile_group_id];
+  tile_group_reads.insert(tile_group_reads.end(), tuple_ids.begin(),
+                          tuple_ids.end());
+}
+
+const std::map<oid_t, std::vector<oid_t>> &Transaction::GetReadTuples() {
+  return read_tuples;
+}
+
+bool Transaction::IsOwnDelete(ItemPointer location) const {
+  auto tile_group_deletes = own_deletes.find(location.block);
+  if (tile_group_deletes == own_deletes.end()) return false;
+
+  return tile_group_deletes->second.count(location.offset) != 0;
+}
+
+void Transaction::RecordTableRead(oid_t table_id) {
+  std::lock_guard<std::mutex> lock(txn_mutex);
+  read_tables.insert(table_id);
+}
+
+void Transaction::RecordTileGroupRead(oid_t tile_group_id) {
+  std::lock_guard<std::mutex> lock(txn_mutex);
+  read_tile_groups.insert(tile_group_id);
+}
+
 void Transaction::ResetState(void) {
   inserted_tuples.clear();
   deleted_tuples.clear();
+  own_deletes.clear();
+  read_tuples.clear();
 }
 
 std::ostream &operator<<(std::ostream &os, const Transaction &txn) {
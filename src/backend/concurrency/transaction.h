@@ -20,6 +20,8 @@
 #include <cassert>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <set>
 
 namespace peloton {
 namespace concurrency {
@@ -30,6 +32,8 @@ namespace concurrency {
 
 class Transaction {
   friend class TransactionManager;
+  friend class OptimisticTransactionManager;
+  friend class SerializableTransactionManager;
 
   Transaction(Transaction const &) = delete;
 
@@ -66,6 +70,18 @@ class Transaction {
 
   inline cid_t GetLastCommitId() const { return last_cid; }
 
+  // Optimistic transactions record their reads, and latch the tuples they
+  // delete at commit only
+  inline bool IsOptimistic() const { return optimistic; }
+
+  // Serializable transactions record their read footprint, checked against
+  // the writes of concurrent transactions at commit
+  inline bool IsSerializable() const { return serializable; }
+
+  // Read-only transactions read their snapshot without a commit id, and
+  // are never logged
+  inline bool IsReadOnly() const { return read_only; }
+
   // record inserted tuple
   void RecordInsert(ItemPointer location);
 
@@ -76,6 +92,25 @@ class Transaction {
 
   const std::map<oid_t, std::vector<oid_t>> &GetDeletedTuples();
 
+  // record read tuples of the tile group, validated at commit.
+  // Scans record every visible tuple their predicate looked at, so the
+  // validation is tuple-level : tuples a scan never looked at, like the ones
+  // inserted since or in tile groups pruned by zone maps, are not checked,
+  // and phantoms go unnoticed.
+  void RecordReads(oid_t tile_group_id, const std::vector<oid_t> &tuple_ids);
+
+  const std::map<oid_t, std::vector<oid_t>> &GetReadTuples();
+
+  // Deleted by the transaction itself. Only meant for optimistic
+  // transactions, whose deletes are visible in the tile groups after commit.
+  bool IsOwnDelete(ItemPointer location) const;
+
+  // record the read footprint of a serializable transaction, either a whole
+  // table (including the tuples inserted later) or a tile group
+  void RecordTableRead(oid_t table_id);
+
+  void RecordTileGroupRead(oid_t tile_group_id);
+
   // reset inserted tuples and deleted tuples
   // used by recovery (logging)
   void ResetState(void);
@@ -114,6 +149,9 @@ class Transaction {
   // waiting for commit ?
   std::atomic<bool> waiting_to_commit;
 
+  // when it started waiting (in microseconds)
+  uint64_t commit_wait_start = 0;
+
   // cid context
   Transaction *next __attribute__((aligned(16)));
 
@@ -123,6 +161,33 @@ class Transaction {
   // deleted tuples
   std::map<oid_t, std::vector<oid_t>> deleted_tuples;
 
+  // deleted tuples again, searchable by scans of optimistic transactions
+  std::map<oid_t, std::set<oid_t>> own_deletes;
+
+  // read tuples, tracked by optimistic transactions
+  std::map<oid_t, std::vector<oid_t>> read_tuples;
+
+  // validated at commit ?
+  bool optimistic = false;
+
+  // read footprint, tracked by serializable transactions
+  // sync access with txn_mutex
+  std::set<oid_t> read_tables;
+  std::set<oid_t> read_tile_groups;
+
+  // write footprint, set at commit by serializable transactions
+  std::set<oid_t> written_tables;
+  std::set<oid_t> written_tile_groups;
+
+  // rw-antidependencies with concurrent transactions
+  bool in_conflict = false;
+  bool out_conflict = false;
+
+  bool serializable = false;
+
+  // only reads its snapshot ?
+  bool read_only = false;
+
   // synch helpers
   std::mutex txn_mutex;
 
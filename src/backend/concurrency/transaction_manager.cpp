@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <iomanip>
@@ -21,9 +22,12 @@
 #include "backend/logging/log_manager.h"
 #include "backend/logging/records/transaction_record.h"
 #include "backend/concurrency/transaction.h"
+#include "backend/concurrency/optimistic_transaction_manager.h"
+#include "backend/concurrency/serializable_transaction_manager.h"
 #include "backend/catalog/manager.h"
 #include "backend/common/exception.h"
 #include "backend/common/logger.h"
+#include "backend/common/metrics.h"
 #include "backend/storage/tile_group.h"
 
 namespace peloton {
@@ -41,6 +45,13 @@ TransactionManager::TransactionManager() {
   last_txn = new Transaction(START_TXN_ID, START_CID);
   last_txn->cid = START_CID;
   last_cid = START_CID;
+
+  auto &metrics_registry = MetricsRegistry::GetInstance();
+  begin_counter = metrics_registry.GetCounter("txn.begin");
+  commit_counter = metrics_registry.GetCounter("txn.commit");
+  abort_counter = metrics_registry.GetCounter("txn.abort");
+  commit_wait_histogram = metrics_registry.GetHistogram("txn.commit_wait");
+  flush_wait_histogram = metrics_registry.GetHistogram("log.commit_flush_wait");
 }
 
 TransactionManager::~TransactionManager() {
@@ -60,6 +71,7 @@ txn_id_t TransactionManager::GetNextTransactionId() {
 Transaction *TransactionManager::BeginTransaction() {
   Transaction *next_txn =
       new Transaction(GetNextTransactionId(), GetLastCommitId());
+  begin_counter->Increment();
 
   // Log the BEGIN TXN record
   {
@@ -78,6 +90,47 @@ Transaction *TransactionManager::BeginTransaction() {
   return next_txn;
 }
 
+Transaction *TransactionManager::BeginReadOnlyTransaction() {
+  // Only the snapshot is needed, the txn id just has to be unique for the
+  // visibility checks
+  Transaction *next_txn =
+      new Transaction(GetNextTransactionId(), GetLastCommitId());
+  next_txn->read_only = true;
+  begin_counter->Increment();
+
+  current_txn = next_txn;
+
+  return next_txn;
+}
+
+Transaction *TransactionManager::BeginTimeTravelTransaction(cid_t as_of_cid) {
+  if (IsRetained(as_of_cid) == false) {
+    LOG_ERROR("Cannot read as of cid %lu, out of the retention window",
+              as_of_cid);
+    return nullptr;
+  }
+
+  Transaction *next_txn = new Transaction(GetNextTransactionId(), as_of_cid);
+  next_txn->read_only = true;
+  begin_counter->Increment();
+
+  current_txn = next_txn;
+
+  return next_txn;
+}
+
+void TransactionManager::EndReadOnlyTransaction() {
+  assert(current_txn->IsReadOnly());
+  LOG_TRACE("Ending read-only peloton txn : %lu ",
+            current_txn->GetTransactionId());
+
+  // Nothing to commit or roll back, and no one else refers to it
+  current_txn->DecrementRefCount();
+  commit_counter->Increment();
+
+  current_txn = nullptr;
+}
+
 bool TransactionManager::IsValid(txn_id_t txn_id) {
   return (txn_id < next_txn_id);
 }
@@ -98,6 +151,9 @@ void TransactionManager::ResetStates(void) {
     delete curr_txn;
   }
   txn_table.clear();
+
+  std::lock_guard<std::mutex> lock(commit_time_mutex);
+  commit_times.clear();
 }
 
 void TransactionManager::EndTransaction(Transaction *txn,
@@ -114,6 +170,7 @@ void TransactionManager::EndTransaction(Transaction *txn,
       // Check for sync commit
       // If true, wait for the fronted logger to flush the data
       if (log_manager.GetSyncCommit()) {
+        MetricsLatencyTimer flush_wait_timer(flush_wait_histogram);
         logger->WaitForFlushing();
       }
     }
@@ -125,6 +182,18 @@ void TransactionManager::EndTransaction(Transaction *txn,
 //===--------------------------------------------------------------------===//
 
 TransactionManager &TransactionManager::GetInstance() {
+  // The protocol is picked at startup
+  switch (peloton_concurrency_mode) {
+    case CONCURRENCY_TYPE_OPTIMISTIC:
+      return OptimisticTransactionManager::GetInstance();
+
+    case CONCURRENCY_TYPE_SERIALIZABLE:
+      return SerializableTransactionManager::GetInstance();
+
+    default:
+      break;
+  }
+
   static TransactionManager txn_manager;
   return txn_manager;
 }
@@ -144,6 +213,7 @@ void TransactionManager::BeginCommitPhase(Transaction *txn) {
 
     // assign cid to the txn
     txn->cid = last_txn->cid + 1;
+    RecordCommitTime(txn->cid);
 
     auto tmp = last_txn;
     last_txn = txn;
@@ -199,6 +269,8 @@ void TransactionManager::CommitPendingTransactions(
     // try to increment last finished cid
     if (atomic_cas(&last_cid, next_txn->cid - 1, next_txn->cid)) {
       // if that worked, add transaction to list
+      commit_wait_histogram->Record(MetricsLatencyTimer::GetMicros() -
+                                    next_txn->commit_wait_start);
       pending_txns.push_back(next_txn);
       LOG_TRACE("Pending Txn  : %lu ", next_txn->txn_id);
 
@@ -231,6 +303,7 @@ std::vector<Transaction *> TransactionManager::EndCommitPhase(Transaction *txn,
   else {
     LOG_TRACE("add to wait list : %lu ", txn->txn_id);
 
+    txn->commit_wait_start = MetricsLatencyTimer::GetMicros();
     txn->waiting_to_commit = true;
 
     // make sure that the transaction we are waiting for has not finished
@@ -250,7 +323,7 @@ std::vector<Transaction *> TransactionManager::EndCommitPhase(Transaction *txn,
   return std::move(txn_list);
 }
 
-void TransactionManager::CommitTransaction(bool sync) {
+Result TransactionManager::CommitTransaction(bool sync) {
   LOG_INFO("Committing peloton txn : %lu ", current_txn->GetTransactionId());
   // begin commit phase : get cid and add to transaction list
   BeginCommitPhase(current_txn);
@@ -263,11 +336,73 @@ void TransactionManager::CommitTransaction(bool sync) {
 
   // process all committed txns
   for (auto committed_txn : committed_txns) committed_txn->DecrementRefCount();
+  commit_counter->Increment();
 
   // XXX LOG : group commit entry
   // we already record commit entry in CommitModifications, isn't it?
 
   current_txn = nullptr;
+
+  return Result::RESULT_SUCCESS;
+}
+
+//===--------------------------------------------------------------------===//
+// Time Travel
+//===--------------------------------------------------------------------===//
+
+void TransactionManager::RecordCommitTime(cid_t cid) {
+  time_t now = time(nullptr);
+  std::lock_guard<std::mutex> lock(commit_time_mutex);
+
+  // One entry per second is enough to resolve timestamps, and the clock
+  // may have been read before a concurrent commit's
+  if (commit_times.empty() == false && commit_times.back().first >= now) {
+    commit_times.back().second = std::max(commit_times.back().second, cid);
+  } else {
+    commit_times.emplace_back(now, cid);
+  }
+
+  // Keep the last entry before the window, it resolves its start
+  time_t window_start = now - peloton_version_retention;
+  while (commit_times.size() > 1 && commit_times[1].first <= window_start) {
+    commit_times.pop_front();
+  }
+}
+
+cid_t TransactionManager::GetCommitIdAsOf(time_t timestamp) {
+  if (timestamp < time(nullptr) - peloton_version_retention) {
+    return INVALID_CID;
+  }
+
+  return LookupCommitId(timestamp);
+}
+
+cid_t TransactionManager::GetRetentionCommitId() {
+  return LookupCommitId(time(nullptr) - peloton_version_retention);
+}
+
+bool TransactionManager::IsRetained(cid_t as_of_cid) {
+  return as_of_cid <= GetLastCommitId() &&
+         as_of_cid >= GetRetentionCommitId();
+}
+
+cid_t TransactionManager::LookupCommitId(time_t timestamp) {
+  // Nothing committed since startup before that time
+  cid_t as_of_cid = START_CID;
+
+  {
+    std::lock_guard<std::mutex> lock(commit_time_mutex);
+    for (auto entry_itr = commit_times.rbegin();
+         entry_itr != commit_times.rend(); entry_itr++) {
+      if (entry_itr->first <= timestamp) {
+        as_of_cid = entry_itr->second;
+        break;
+      }
+    }
+  }
+
+  // The commit id may have been handed out without the commit being done
+  return std::min(as_of_cid, GetLastCommitId());
 }
 
 //===--------------------------------------------------------------------===//
@@ -276,6 +411,8 @@ void TransactionManager::CommitTransaction(bool sync) {
 
 void TransactionManager::AbortTransaction() {
   LOG_INFO("Aborting peloton txn : %lu ", current_txn->GetTransactionId());
+  abort_counter->Increment();
+
   // Log the ABORT TXN record
   {
     auto &log_manager = logging::LogManager::GetInstance();
@@ -14,13 +14,35 @@
 
 #include <atomic>
 #include <cassert>
+#include <ctime>
+#include <deque>
 #include <vector>
 #include <map>
 #include <mutex>
 
 #include "backend/common/types.h"
 
+//===--------------------------------------------------------------------===//
+// GUC Variables
+//===--------------------------------------------------------------------===//
+
+/* Possible values for peloton_concurrency_mode GUC */
+typedef enum ConcurrencyType {
+  CONCURRENCY_TYPE_PESSIMISTIC, /* Latch tuples when writing them */
+  CONCURRENCY_TYPE_OPTIMISTIC,  /* Validate reads and writes at commit */
+  CONCURRENCY_TYPE_SERIALIZABLE /* Serializable snapshot isolation */
+} ConcurrencyType;
+
+extern ConcurrencyType peloton_concurrency_mode;
+
+// Seconds over which old versions can be read as of a past commit
+extern int peloton_version_retention;
+
 namespace peloton {
+
+class MetricsCounter;
+class MetricsHistogram;
+
 namespace concurrency {
 
 typedef unsigned int TransactionId;
@@ -33,11 +55,19 @@ extern thread_local Transaction *current_txn;
 // Transaction Manager
 //===--------------------------------------------------------------------===//
 
+/**
+ * @brief Transaction manager latching the tuples a transaction deletes as
+ * it goes. Commits are ordered through a chain of pending transactions.
+ *
+ * GetInstance() returns the OptimisticTransactionManager or the
+ * SerializableTransactionManager instead, when the peloton_concurrency_mode
+ * GUC is set to optimistic or serializable at startup.
+ */
 class TransactionManager {
  public:
   TransactionManager();
 
-  ~TransactionManager();
+  virtual ~TransactionManager();
 
   // Get next transaction id
   txn_id_t GetNextTransactionId();
@@ -52,7 +82,17 @@ class TransactionManager {
   static TransactionManager &GetInstance();
 
   // Begin a new transaction
-  Transaction *BeginTransaction();
+  virtual Transaction *BeginTransaction();
+
+  // Begin a transaction that only reads the last committed snapshot. It gets
+  // no commit id and logs nothing, end it with EndReadOnlyTransaction().
+  virtual Transaction *BeginReadOnlyTransaction();
+
+  // Begin a read-only transaction reading the snapshot of a past commit id
+  // instead. Returns nullptr if that snapshot is out of the retention window.
+  Transaction *BeginTimeTravelTransaction(cid_t as_of_cid);
+
+  void EndReadOnlyTransaction();
 
   // Get entry in transaction table
   Transaction *GetTransaction(txn_id_t txn_id);
@@ -80,13 +120,33 @@ class TransactionManager {
 
   std::vector<Transaction *> EndCommitPhase(Transaction *txn, bool sync = true);
 
-  void CommitTransaction(bool sync = true);
+  // Returns RESULT_ABORTED if the transaction had to be aborted instead
+  virtual Result CommitTransaction(bool sync = true);
 
   // ABORT
 
-  void AbortTransaction();
+  virtual void AbortTransaction();
+
+  //===--------------------------------------------------------------------===//
+  // Time travel
+  //===--------------------------------------------------------------------===//
+
+  // Last commit id handed out at or before the given time, or INVALID_CID
+  // if the time is out of the retention window
+  cid_t GetCommitIdAsOf(time_t timestamp);
+
+  // Oldest snapshot that can still be read as of. The versions invalidated
+  // after it must not be reclaimed.
+  cid_t GetRetentionCommitId();
+
+  // Whether the snapshot of the commit id can still be read
+  bool IsRetained(cid_t as_of_cid);
+
+ protected:
+  void RecordCommitTime(cid_t cid);
+
+  cid_t LookupCommitId(time_t timestamp);
 
- private:
   //===--------------------------------------------------------------------===//
   // MEMBERS
   //===--------------------------------------------------------------------===//
@@ -105,6 +165,27 @@ class TransactionManager {
   std::map<txn_id_t, Transaction *> txn_table;
 
   std::mutex txn_table_mutex;
+
+  // Last commit id handed out in every second with commits, over the
+  // retention window, plus the last one before it
+  // Sync access with commit_time_mutex
+  std::deque<std::pair<time_t, cid_t>> commit_times;
+
+  std::mutex commit_time_mutex;
+
+  // Engine-wide metrics, kept by all the protocols
+  MetricsCounter *begin_counter;
+
+  MetricsCounter *commit_counter;
+
+  MetricsCounter *abort_counter;
+
+  // Time spent on the pending list, waiting for the commits before ours
+  // (in microseconds)
+  MetricsHistogram *commit_wait_histogram;
+
+  // Time spent waiting for the log flush on sync commits (in microseconds)
+  MetricsHistogram *flush_wait_histogram;
 };
 
 }  // End concurrency namespace
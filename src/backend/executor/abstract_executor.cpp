@@ -10,13 +10,27 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <chrono>
+#include <ctime>
+
 #include "backend/executor/abstract_executor.h"
+#include "backend/executor/executor_context.h"
 #include "backend/planner/abstract_plan.h"
 #include "backend/common/logger.h"
 
 namespace peloton {
 namespace executor {
 
+/**
+ * @brief CPU time consumed by the calling thread.
+ * @return the time in milliseconds.
+ */
+static double GetThreadCpuTime() {
+  struct timespec cpu_time;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_time);
+  return cpu_time.tv_sec * 1000.0 + cpu_time.tv_nsec / 1000000.0;
+}
+
 /**
  * @brief Constructor for AbstractExecutor.
  * @param node Abstract plan node corresponding to this executor.
@@ -50,7 +64,8 @@ const std::vector<AbstractExecutor *> &AbstractExecutor::GetChildren() const {
  *
  * This function executes any initialization code common to all executors.
  * It recursively initializes all children of this executor in the execution
- * tree. It calls SubInit() which is implemented by the subclass.
+ * tree, passing down any limit hint first. It calls SubInit() which is
+ * implemented by the subclass.
  *
  * @return true on success, false otherwise.
  */
@@ -58,6 +73,8 @@ bool AbstractExecutor::Init() {
   bool status = false;
 
   for (auto child : children_) {
+    child->SetLimitHint(GetChildLimitHint());
+
     status = child->Init();
     if (status == false) {
       LOG_ERROR("Initialization failed in child executor with plan id : %s",
@@ -88,7 +105,37 @@ bool AbstractExecutor::Execute() {
   // TODO In the future, we might want to pass some kind of executor state to
   // GetNextTile. e.g. params for prepared plans.
 
-  bool status = DExecute();
+  bool status = ExecuteTimed([this]() { return DExecute(); });
+
+  stats_.execute_count++;
+  if (status == true && output.get() != nullptr) {
+    stats_.output_tile_count++;
+    stats_.output_tuple_count += output->GetTupleCount();
+  }
+
+  return status;
+}
+
+bool AbstractExecutor::ExecuteTimed(const std::function<bool()> &body) {
+  // Reading the clocks is the only costly part, so it is opt-in
+  bool instrument =
+      (executor_context_ != nullptr && executor_context_->instrument);
+
+  std::chrono::steady_clock::time_point start;
+  double cpu_start = 0;
+  if (instrument) {
+    start = std::chrono::steady_clock::now();
+    cpu_start = GetThreadCpuTime();
+  }
+
+  bool status = body();
+
+  if (instrument) {
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    stats_.wall_time += elapsed.count();
+    stats_.cpu_time += GetThreadCpuTime() - cpu_start;
+  }
 
   return status;
 }
@@ -13,11 +13,16 @@
 #pragma once
 
 #include <cassert>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <vector>
 
 #include "backend/executor/logical_tile.h"
 
+// Limit hint of an executor whose output may be consumed in full
+#define NO_LIMIT_HINT SIZE_MAX
+
 namespace peloton {
 
 namespace planner {
@@ -30,6 +35,29 @@ class ExecutorContext;
 
 namespace executor {
 
+/**
+ * @brief Runtime statistics of an executor, collected by Execute().
+ * Times include the time spent in the children.
+ */
+struct ExecutorStats {
+  // # of calls to Execute()
+  size_t execute_count = 0;
+
+  // # of logical tiles and visible tuples handed to the parent
+  size_t output_tile_count = 0;
+
+  size_t output_tuple_count = 0;
+
+  // Only kept when the executor context asks for instrumentation
+  // (in milliseconds)
+  double wall_time = 0;
+
+  double cpu_time = 0;
+
+  // Peak bytes held by executors that build a hash table or a sort buffer
+  size_t peak_memory_usage = 0;
+};
+
 class AbstractExecutor {
  public:
   AbstractExecutor(const AbstractExecutor &) = delete;
@@ -61,6 +89,16 @@ class AbstractExecutor {
 
   const planner::AbstractPlan *GetRawNode() const { return node_; }
 
+  /**
+   * @brief Tell the executor that its parent consumes at most limit tuples.
+   * Must be set before Init(), so that it can be passed further down.
+   */
+  void SetLimitHint(size_t limit) { limit_hint_ = limit; }
+
+  size_t GetLimitHint() const { return limit_hint_; }
+
+  const ExecutorStats &GetStats() const { return stats_; }
+
  protected:
   // NOTE: The reason why we keep the plan node separate from the executor
   // context is because we might want to reuse the plan multiple times
@@ -74,8 +112,39 @@ class AbstractExecutor {
   /** @brief Workhorse function to be overriden by derived class. */
   virtual bool DExecute() = 0;
 
+  /**
+   * @brief Limit hint to pass on to the children.
+   * Only executors that never produce fewer output tuples than they consume
+   * (e.g. projection, limit) can pass on a limit. Defaults to no limit.
+   */
+  virtual size_t GetChildLimitHint() { return NO_LIMIT_HINT; }
+
   void SetOutput(LogicalTile *val);
 
+  /**
+   * @brief Run the body, timing it like Execute() when the executor context
+   * asks for instrumentation.
+   */
+  bool ExecuteTimed(const std::function<bool()> &body);
+
+  /**
+   * @brief Count a call for an executor whose parent bypasses Execute()
+   * (e.g. a scan fused with its parent), with the tuples it handed over.
+   */
+  void RecordPipelinedCall(bool has_output, size_t tuple_count) {
+    stats_.execute_count++;
+    if (has_output) {
+      stats_.output_tile_count++;
+      stats_.output_tuple_count += tuple_count;
+    }
+  }
+
+  /** @brief Record the bytes currently held, keeping the peak. */
+  void UpdatePeakMemoryUsage(size_t memory_usage) {
+    if (memory_usage > stats_.peak_memory_usage)
+      stats_.peak_memory_usage = memory_usage;
+  }
+
   /**
    * @brief Convenience method to return plan node corresponding to this
    *        executor, appropriately type-casted.
@@ -92,6 +161,12 @@ class AbstractExecutor {
   /** @brief Children nodes of this executor in the executor tree. */
   std::vector<AbstractExecutor *> children_;
 
+  /**
+   * @brief Max number of tuples the parent will consume.
+   * Producing more is wasted work, so executors may stop early.
+   */
+  size_t limit_hint_ = NO_LIMIT_HINT;
+
  private:
   // Output logical tile
   // This is where we will write the results of the plan node's execution
@@ -100,6 +175,8 @@ class AbstractExecutor {
   /** @brief Plan node corresponding to this executor. */
   const planner::AbstractPlan *node_ = nullptr;
 
+  ExecutorStats stats_;
+
  protected:
   // Executor context
   ExecutorContext *executor_context_ = nullptr;
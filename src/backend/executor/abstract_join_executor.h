@@ -136,6 +136,9 @@ class AbstractJoinExecutor : public AbstractExecutor {
   /** @brief Join predicate. */
   const expression::AbstractExpression *predicate_ = nullptr;
 
+  /** @brief Predicate compiled by the plan. */
+  const expression::ExpressionProgram *predicate_program_ = nullptr;
+
   /** @brief Projection info */
   const planner::ProjectInfo *proj_info_ = nullptr;
 
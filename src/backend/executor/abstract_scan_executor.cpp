@@ -17,6 +17,9 @@
 #include <vector>
 
 #include "backend/common/types.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/executor/executor_context.h"
 #include "backend/executor/logical_tile.h"
 #include "backend/executor/logical_tile_factory.h"
 #include "backend/expression/abstract_expression.h"
@@ -49,12 +52,41 @@ bool AbstractScanExecutor::DInit() {
   const planner::AbstractScan &node = GetPlanNode<planner::AbstractScan>();
 
   predicate_ = node.GetPredicate();
+  predicate_program_ = node.GetPredicateProgram();
   // auto column_ids = node.GetColumnIds();
 
   column_ids_ = std::move(node.GetColumnIds());
 
+  as_of_cid_ = node.GetAsOfCommitId();
+
+  // Old versions are only kept over the retention window, and the future
+  // is not known yet
+  if (IsTimeTravel()) {
+    auto &txn_manager = concurrency::TransactionManager::GetInstance();
+    cid_t last_cid = executor_context_->GetTransaction()->GetLastCommitId();
+
+    if (as_of_cid_ > last_cid || txn_manager.IsRetained(as_of_cid_) == false) {
+      LOG_ERROR("Cannot read as of cid %lu, out of the retention window",
+                as_of_cid_);
+      return false;
+    }
+  }
+
   return true;
 }
 
+void AbstractScanExecutor::GetSnapshot(txn_id_t &txn_id,
+                                       cid_t &commit_id) const {
+  if (IsTimeTravel()) {
+    // Own writes are not part of the past
+    txn_id = INVALID_TXN_ID;
+    commit_id = as_of_cid_;
+  } else {
+    auto transaction_ = executor_context_->GetTransaction();
+    txn_id = transaction_->GetTransactionId();
+    commit_id = transaction_->GetLastCommitId();
+  }
+}
+
 }  // namespace executor
 }  // namespace peloton
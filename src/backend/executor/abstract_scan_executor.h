@@ -39,6 +39,11 @@ class AbstractScanExecutor : public AbstractExecutor {
 
   bool DExecute() = 0;
 
+  // Snapshot to read, the one of the transaction unless time travelling
+  void GetSnapshot(txn_id_t &txn_id, cid_t &commit_id) const;
+
+  inline bool IsTimeTravel() const { return as_of_cid_ != INVALID_CID; }
+
  protected:
   //===--------------------------------------------------------------------===//
   // Plan Info
@@ -47,8 +52,15 @@ class AbstractScanExecutor : public AbstractExecutor {
   /** @brief Selection predicate. */
   const expression::AbstractExpression *predicate_ = nullptr;
 
+  /** @brief Predicate compiled by the plan. */
+  const expression::ExpressionProgram *predicate_program_ = nullptr;
+
   /** @brief Columns from tile group to be added to logical tile output. */
   std::vector<oid_t> column_ids_;
+
+  /** @brief Past commit id to read as of, INVALID_CID if not time travelling.
+   */
+  cid_t as_of_cid_ = INVALID_CID;
 };
 
 }  // namespace executor
@@ -18,6 +18,8 @@
 #include "backend/executor/aggregate_executor.h"
 #include "backend/executor/logical_tile_factory.h"
 #include "backend/executor/executor_context.h"
+#include "backend/executor/pipeline.h"
+#include "backend/executor/seq_scan_executor.h"
 #include "backend/expression/container_tuple.h"
 #include "backend/planner/aggregate_plan.h"
 #include "backend/storage/table_factory.h"
@@ -75,6 +77,79 @@ bool AggregateExecutor::DInit() {
   return true;
 }
 
+/**
+ * @brief Get an aggregator for the plan's strategy.
+ * @return nullptr if the strategy is invalid.
+ */
+static AbstractAggregator *CreateAggregator(
+    const planner::AggregatePlan &node, storage::DataTable *output_table,
+    ExecutorContext *executor_context, size_t input_column_count) {
+  switch (node.GetAggregateStrategy()) {
+    case AGGREGATE_TYPE_HASH:
+      LOG_INFO("Use HashAggregator");
+      return new HashAggregator(&node, output_table, executor_context,
+                                input_column_count);
+    case AGGREGATE_TYPE_SORTED:
+      LOG_INFO("Use SortedAggregator");
+      return new SortedAggregator(&node, output_table, executor_context,
+                                  input_column_count);
+    case AGGREGATE_TYPE_PLAIN:
+      LOG_INFO("Use PlainAggregator");
+      return new PlainAggregator(&node, output_table, executor_context);
+    default:
+      LOG_ERROR("Invalid aggregate type. Return.");
+      return nullptr;
+  }
+}
+
+/**
+ * @brief Aggregation fused with a sequential scan: the tuples are fed to
+ * the aggregator right off the scanned tile groups.
+ */
+class AggregatePipeline : public TileGroupConsumer {
+ public:
+  AggregatePipeline(const planner::AggregatePlan &node,
+                    storage::DataTable *output_table,
+                    ExecutorContext *executor_context,
+                    const std::vector<oid_t> &column_ids,
+                    std::unique_ptr<AbstractAggregator> &aggregator)
+      : node(node),
+        output_table(output_table),
+        executor_context(executor_context),
+        tuple(column_ids),
+        aggregator(aggregator) {}
+
+  bool Consume(storage::TileGroup *tile_group,
+               const std::vector<oid_t> &tuple_offsets) override {
+    if (aggregator.get() == nullptr) {
+      aggregator.reset(CreateAggregator(node, output_table, executor_context,
+                                        tuple.GetColumnCount()));
+      if (aggregator.get() == nullptr) return false;
+    }
+
+    tuple.SetTileGroup(tile_group);
+    for (auto tuple_offset : tuple_offsets) {
+      tuple.SetTupleId(tuple_offset);
+      if (aggregator->Advance(&tuple) == false) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+ private:
+  const planner::AggregatePlan &node;
+
+  storage::DataTable *output_table;
+
+  ExecutorContext *executor_context;
+
+  ScanTuple tuple;
+
+  std::unique_ptr<AbstractAggregator> &aggregator;
+};
+
 /**
  * @brief Creates logical tile(s) wrapping the results of aggregation.
  * @return true on success, false otherwise.
@@ -100,32 +175,28 @@ bool AggregateExecutor::DExecute() {
   // Get an aggregator
   std::unique_ptr<AbstractAggregator> aggregator(nullptr);
 
-  // Get input tiles and aggregate them
-  while (children_[0]->Execute() == true) {
+  // Aggregate a table scan in one pass over its tile groups
+  auto scan = dynamic_cast<SeqScanExecutor *>(children_[0]);
+  bool fused = (scan != nullptr && scan->IsPipelineable());
+
+  if (fused) {
+    LOG_INFO("Fusing aggregation with sequential scan");
+    AggregatePipeline pipeline(node, output_table, executor_context_,
+                               scan->GetColumnIds(), aggregator);
+    if (scan->ExecutePipeline(pipeline) == false) {
+      return false;
+    }
+  }
+
+  // Otherwise, get input tiles and aggregate them
+  while (fused == false && children_[0]->Execute() == true) {
     std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
 
     if (nullptr == aggregator.get()) {
       // Initialize the aggregator
-      switch (node.GetAggregateStrategy()) {
-        case AGGREGATE_TYPE_HASH:
-          LOG_INFO("Use HashAggregator");
-          aggregator.reset(new HashAggregator(
-              &node, output_table, executor_context_, tile->GetColumnCount()));
-          break;
-        case AGGREGATE_TYPE_SORTED:
-          LOG_INFO("Use SortedAggregator");
-          aggregator.reset(new SortedAggregator(
-              &node, output_table, executor_context_, tile->GetColumnCount()));
-          break;
-        case AGGREGATE_TYPE_PLAIN:
-          LOG_INFO("Use PlainAggregator");
-          aggregator.reset(
-              new PlainAggregator(&node, output_table, executor_context_));
-          break;
-        default:
-          LOG_ERROR("Invalid aggregate type. Return.");
-          return false;
-      }
+      aggregator.reset(CreateAggregator(node, output_table, executor_context_,
+                                        tile->GetColumnCount()));
+      if (nullptr == aggregator.get()) return false;
     }
 
     LOG_INFO("Looping over tile..");
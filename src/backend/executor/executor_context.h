@@ -46,6 +46,9 @@ class ExecutorContext {
   // num of tuple processed
   uint32_t num_processed = 0;
 
+  // whether the executors time themselves, e.g. for EXPLAIN ANALYZE
+  bool instrument = false;
+
  private:
   //===--------------------------------------------------------------------===//
   // MEMBERS
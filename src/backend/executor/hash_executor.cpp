@@ -14,11 +14,16 @@
 #include <vector>
 
 #include "backend/common/logger.h"
+#include "backend/common/pool.h"
 #include "backend/common/value.h"
 #include "backend/executor/logical_tile.h"
+#include "backend/executor/logical_tile_factory.h"
 #include "backend/executor/hash_executor.h"
+#include "backend/expression/container_tuple.h"
 #include "backend/planner/hash_plan.h"
 #include "backend/expression/tuple_value_expression.h"
+#include "backend/storage/tile.h"
+#include "backend/storage/tuple.h"
 
 namespace peloton {
 namespace executor {
@@ -37,78 +42,278 @@ HashExecutor::HashExecutor(const planner::AbstractPlan *node,
 bool HashExecutor::DInit() {
   assert(children_.size() == 1);
 
+  const planner::HashPlan &node = GetPlanNode<planner::HashPlan>();
+
+  /* *
+   * HashKeys is a vector of TupleValue expr
+   * from which we construct a vector of column ids that represent the
+   * attributes of the underlying table.
+   * The hash table is built on top of these hash key attributes
+   * */
+  column_ids_.clear();
+  for (auto &hashkey : node.GetHashKeys()) {
+    assert(hashkey->GetExpressionType() == EXPRESSION_TYPE_VALUE_TUPLE);
+    auto tuple_value =
+        reinterpret_cast<const expression::TupleValueExpression *>(
+            hashkey.get());
+    column_ids_.push_back(tuple_value->GetColumnId());
+  }
+
+  memory_budget_ = node.GetMemoryBudget();
+
   // Initialize executor state
-  done_ = false;
-  result_itr = 0;
+  schema_.reset();
+  depth_ = 0;
+  source_file_.reset();
+  tile_id_offset_ = 0;
+  spilled_partition_count_ = 0;
+  ResetPass();
 
   return true;
 }
 
+void HashExecutor::ResetPass() {
+  partitions_.clear();
+  partitions_.resize(TUPLE_HASH_TABLE_PARTITION_COUNT);
+  memory_usage_ = 0;
+
+  buckets_.clear();
+  index_entries_.clear();
+  index_tiles_.clear();
+  output_tiles_.clear();
+
+  done_ = false;
+  result_itr = 0;
+}
+
 bool HashExecutor::DExecute() {
-  LOG_INFO("Hash Executor");
+  LOG_TRACE("Hash Executor");
 
   if (done_ == false) {
-    const planner::HashPlan &node = GetPlanNode<planner::HashPlan>();
+    if (source_file_ == nullptr) {
+      // First pass, over the child
+      while (children_[0]->Execute()) {
+        std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
+        ConsumeTile(tile.get());
+      }
+    } else {
+      // Later pass, over a spilled partition
+      source_file_->Rewind();
+      while (true) {
+        std::unique_ptr<LogicalTile> tile(
+            source_file_->ReadTile(*schema_, DEFAULT_TUPLES_PER_TILEGROUP));
+        if (tile == nullptr) break;
 
-    // First, get all the input logical tiles
-    while (children_[0]->Execute()) {
-      child_tiles_.emplace_back(children_[0]->GetOutput());
+        ConsumeTile(tile.get());
+      }
+      source_file_.reset();
     }
 
-    if (child_tiles_.size() == 0) {
-      LOG_TRACE("Hash Executor : false -- no child tiles ");
-      return false;
+    BuildIndex();
+    done_ = true;
+  }
+
+  // Return logical tiles one at a time
+  if (result_itr < output_tiles_.size()) {
+    SetOutput(output_tiles_[result_itr++].release());
+    LOG_TRACE("Hash Executor : true -- return tile one at a time ");
+    return true;
+  }
+
+  LOG_TRACE("Hash Executor : false -- done ");
+  return false;
+}
+
+/**
+ * @brief Copy the tuples of a child tile into their partitions,
+ * spilling partitions as needed to stay within the memory budget.
+ */
+void HashExecutor::ConsumeTile(LogicalTile *tile) {
+  if (schema_ == nullptr) {
+    schema_.reset(tile->GetPhysicalSchema());
+  }
+
+  oid_t column_count = schema_->GetColumnCount();
+  size_t tile_size = schema_->GetLength() * DEFAULT_TUPLES_PER_TILEGROUP;
+
+  for (oid_t tuple_id : *tile) {
+    expression::ContainerTuple<LogicalTile> tuple(tile, tuple_id);
+    size_t hash = TupleHashTable::Hash(tuple, column_ids_);
+    auto &partition = partitions_[GetPartition(hash)];
+
+    if (partition.spill_file != nullptr) {
+      partition.spill_file->Append(tuple, column_count);
+      continue;
     }
 
-    /* *
-     * HashKeys is a vector of TupleValue expr
-     * from which we construct a vector of column ids that represent the
-     * attributes of the underlying table.
-     * The hash table is built on top of these hash key attributes
-     * */
-    auto &hashkeys = node.GetHashKeys();
-
-    // Construct a logical tile
-    for (auto &hashkey : hashkeys) {
-      assert(hashkey->GetExpressionType() == EXPRESSION_TYPE_VALUE_TUPLE);
-      auto tuple_value =
-          reinterpret_cast<const expression::TupleValueExpression *>(
-              hashkey.get());
-      column_ids_.push_back(tuple_value->GetColumnId());
+    // Copy the tuple into the partition's last tile
+    oid_t tuple_offset = partition.hashes.size() % DEFAULT_TUPLES_PER_TILEGROUP;
+    if (tuple_offset == 0) {
+      partition.tiles.emplace_back(storage::TileFactory::GetTempTile(
+          *schema_, DEFAULT_TUPLES_PER_TILEGROUP));
+      partition.memory_usage += tile_size;
+      memory_usage_ += tile_size;
+    }
+
+    auto &last_tile = partition.tiles.back();
+    auto pool = last_tile->GetPool();
+    int64_t pool_usage = (pool != nullptr) ? pool->GetUsedMemory() : 0;
+
+    storage::Tuple copy(schema_.get(),
+                        last_tile->GetTupleLocation(tuple_offset));
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      copy.SetValue(column_itr, tuple.GetValue(column_itr), pool);
+    }
+    partition.hashes.push_back(hash);
+
+    size_t tuple_usage = sizeof(size_t);
+    if (pool != nullptr) tuple_usage += pool->GetUsedMemory() - pool_usage;
+    partition.memory_usage += tuple_usage;
+    memory_usage_ += tuple_usage;
+    UpdatePeakMemoryUsage(memory_usage_);
+
+    // Spill the largest partitions until we are back within the budget.
+    // The deepest partitions stay in memory, whatever their size.
+    while (memory_usage_ > memory_budget_ &&
+           depth_ < TUPLE_HASH_TABLE_MAX_PARTITION_DEPTH) {
+      oid_t victim = INVALID_OID;
+      for (oid_t partition_itr = 0; partition_itr < partitions_.size();
+           partition_itr++) {
+        if (partitions_[partition_itr].spill_file != nullptr) continue;
+        if (victim == INVALID_OID ||
+            partitions_[partition_itr].memory_usage >
+                partitions_[victim].memory_usage)
+          victim = partition_itr;
+      }
+
+      if (victim == INVALID_OID) break;
+      SpillPartition(victim);
     }
+  }
+}
+
+void HashExecutor::SpillPartition(oid_t partition_id) {
+  auto &partition = partitions_[partition_id];
+  oid_t column_count = schema_->GetColumnCount();
+
+  LOG_TRACE("Spilling hash partition %lu at depth %lu : %lu tuples",
+            partition_id, depth_, partition.hashes.size());
+
+  partition.spill_file.reset(new SpillFile());
+
+  for (oid_t tuple_itr = 0; tuple_itr < partition.hashes.size(); tuple_itr++) {
+    auto &tile = partition.tiles[tuple_itr / DEFAULT_TUPLES_PER_TILEGROUP];
+    oid_t tuple_id = tuple_itr % DEFAULT_TUPLES_PER_TILEGROUP;
+
+    storage::Tuple tuple(schema_.get(), tile->GetTupleLocation(tuple_id));
+    partition.spill_file->Append(tuple, column_count);
+  }
+
+  memory_usage_ -= partition.memory_usage;
+  partition.memory_usage = 0;
+  partition.tiles.clear();
+  partition.hashes.clear();
+
+  spilled_partition_count_++;
+}
+
+/**
+ * @brief Index the tuples of the partitions left in memory, and wrap their
+ * tiles to be returned.
+ */
+void HashExecutor::BuildIndex() {
+  size_t tuple_count = 0;
+  for (auto &partition : partitions_) {
+    tuple_count += partition.hashes.size();
+  }
+
+  buckets_.assign(nexthigher(std::max<size_t>(tuple_count, 1)), INVALID_OID);
+  index_entries_.reserve(tuple_count);
+  size_t mask = buckets_.size() - 1;
+
+  for (auto &partition : partitions_) {
+    for (oid_t tuple_itr = 0; tuple_itr < partition.hashes.size();
+         tuple_itr++) {
+      oid_t tuple_id = tuple_itr % DEFAULT_TUPLES_PER_TILEGROUP;
+
+      if (tuple_id == 0) {
+        auto &tile = partition.tiles[tuple_itr / DEFAULT_TUPLES_PER_TILEGROUP];
+        index_tiles_.push_back(tile);
+
+        std::unique_ptr<LogicalTile> logical_tile(
+            LogicalTileFactory::WrapTiles({tile}));
 
-    // Construct the hash table by going over each child logical tile and
-    // hashing
-    for (size_t child_tile_itr = 0; child_tile_itr < child_tiles_.size();
-         child_tile_itr++) {
-      auto tile = child_tiles_[child_tile_itr].get();
-
-      // Go over all tuples in the logical tile
-      for (oid_t tuple_id : *tile) {
-        // Key : container tuple with a subset of tuple attributes
-        // Value : < child_tile offset, tuple offset >
-        hash_table_[HashMapType::key_type(tile, tuple_id, &column_ids_)].insert(
-            std::make_pair(child_tile_itr, tuple_id));
+        // Hide the unused slots of the last tile
+        oid_t used_count = std::min<size_t>(partition.hashes.size() - tuple_itr,
+                                            DEFAULT_TUPLES_PER_TILEGROUP);
+        for (oid_t slot_itr = used_count;
+             slot_itr < DEFAULT_TUPLES_PER_TILEGROUP; slot_itr++) {
+          logical_tile->RemoveVisibility(slot_itr);
+        }
+
+        output_tiles_.push_back(std::move(logical_tile));
       }
+
+      size_t hash = partition.hashes[tuple_itr];
+      IndexEntry entry;
+      entry.hash = hash;
+      entry.tile_id = index_tiles_.size() - 1;
+      entry.tuple_id = tuple_id;
+      entry.next = buckets_[hash & mask];
+
+      buckets_[hash & mask] = index_entries_.size();
+      index_entries_.push_back(entry);
     }
 
-    done_ = true;
+    // The tiles now belong to the index and to the logical tiles
+    partition.tiles.clear();
+    partition.hashes.clear();
   }
 
-  // Return logical tiles one at a time
-  while (result_itr < child_tiles_.size()) {
-    if (child_tiles_[result_itr]->GetTupleCount() == 0) {
-      result_itr++;
-      continue;
-    } else {
-      SetOutput(child_tiles_[result_itr++].release());
-      LOG_TRACE("Hash Executor : true -- return tile one at a time ");
-      return true;
+  UpdatePeakMemoryUsage(memory_usage_ + buckets_.size() * sizeof(oid_t) +
+                        index_entries_.size() * sizeof(IndexEntry));
+}
+
+void HashExecutor::FindMatches(
+    const AbstractTuple &tuple, size_t hash,
+    std::vector<std::pair<oid_t, oid_t>> &matches) const {
+  if (buckets_.empty()) return;
+
+  size_t mask = buckets_.size() - 1;
+  for (oid_t entry_itr = buckets_[hash & mask]; entry_itr != INVALID_OID;
+       entry_itr = index_entries_[entry_itr].next) {
+    auto &entry = index_entries_[entry_itr];
+    if (entry.hash != hash) continue;
+
+    auto &tile = index_tiles_[entry.tile_id];
+    bool equal = true;
+    for (auto column_id : column_ids_) {
+      Value value = tuple.GetValue(column_id);
+      if (value.IsNull() ||
+          value.Compare(tile->GetValue(entry.tuple_id, column_id)) !=
+              VALUE_COMPARE_EQUAL) {
+        equal = false;
+        break;
+      }
+    }
+
+    if (equal) {
+      matches.emplace_back(tile_id_offset_ + entry.tile_id, entry.tuple_id);
     }
   }
+}
 
-  LOG_TRACE("Hash Executor : false -- done ");
-  return false;
+std::unique_ptr<SpillFile> HashExecutor::ReleaseSpilledPartition(
+    oid_t partition) {
+  return std::move(partitions_[partition].spill_file);
+}
+
+void HashExecutor::Rebuild(std::unique_ptr<SpillFile> spill_file,
+                           size_t depth) {
+  tile_id_offset_ += index_tiles_.size();
+  depth_ = depth;
+  source_file_ = std::move(spill_file);
+  ResetPass();
 }
 
 } /* namespace executor */
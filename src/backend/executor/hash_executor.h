@@ -12,22 +12,37 @@
 
 #pragma once
 
-#include <unordered_map>
-#include <unordered_set>
+#include <memory>
+#include <utility>
+#include <vector>
 
+#include "backend/catalog/schema.h"
 #include "backend/common/types.h"
 #include "backend/executor/abstract_executor.h"
 #include "backend/executor/logical_tile.h"
-#include "backend/expression/container_tuple.h"
-
-#include <boost/functional/hash.hpp>
+#include "backend/executor/spill_file.h"
+#include "backend/executor/tuple_hash_table.h"
 
 namespace peloton {
+
+namespace storage {
+class Tile;
+}
+
 namespace executor {
 
 /**
- * @brief Hash executor.
+ * @brief Hash executor, the build side of a hash join.
+ *
+ * The child's tuples are copied into compact per-partition tiles, with the
+ * partition picked by the hash of the key. Whenever the copies outgrow the
+ * plan's memory budget, the largest partition in memory is written to a
+ * spill file, and so are its later tuples. The partitions left in memory
+ * are indexed by key hash, and their tiles are returned to the join.
  *
+ * The join sends the probe tuples of spilled partitions to its own spill
+ * files, and joins each pair of files in a later pass, after a Rebuild()
+ * over the build side of the partition.
  */
 class HashExecutor : public AbstractExecutor {
  public:
@@ -39,34 +54,105 @@ class HashExecutor : public AbstractExecutor {
   explicit HashExecutor(const planner::AbstractPlan *node,
                         ExecutorContext *executor_context);
 
-  /** @brief Type definitions for hash table */
-  typedef std::unordered_map<
-      expression::ContainerTuple<LogicalTile>,
-      std::unordered_set<std::pair<size_t, oid_t>,
-                         boost::hash<std::pair<size_t, oid_t>>>,
-      expression::ContainerTupleHasher<LogicalTile>,
-      expression::ContainerTupleComparator<LogicalTile>> HashMapType;
-
-  inline HashMapType &GetHashTable() { return this->hash_table_; }
-
   inline const std::vector<oid_t> &GetHashKeyIds() const {
     return this->column_ids_;
   }
 
+  // Partition of a key hash in the current pass
+  inline oid_t GetPartition(size_t hash) const {
+    return TupleHashTable::GetPartition(hash, depth_);
+  }
+
+  inline bool IsPartitionSpilled(oid_t partition) const {
+    return partitions_[partition].spill_file != nullptr;
+  }
+
+  /**
+   * @brief Collect the build tuples of the current pass whose key equals the
+   * key of the probe tuple, as (tile, tuple) pairs. Tiles are numbered in the
+   * order they are returned, over all the passes. NULL keys never match.
+   */
+  void FindMatches(const AbstractTuple &tuple, size_t hash,
+                   std::vector<std::pair<oid_t, oid_t>> &matches) const;
+
+  // Take the tuples spilled to the partition in the current pass
+  std::unique_ptr<SpillFile> ReleaseSpilledPartition(oid_t partition);
+
+  // Start a new pass over spilled tuples, one level deeper
+  void Rebuild(std::unique_ptr<SpillFile> spill_file, size_t depth);
+
+  // # of partitions spilled over all the passes
+  size_t GetSpilledPartitionCount() const { return spilled_partition_count_; }
+
  protected:
   bool DInit();
 
   bool DExecute();
 
  private:
-  /** @brief Hash table */
-  HashMapType hash_table_;
+  struct Partition {
+    // copies of the build tuples
+    std::vector<std::shared_ptr<storage::Tile>> tiles;
+
+    // key hash of each tuple
+    std::vector<size_t> hashes;
+
+    size_t memory_usage = 0;
 
-  /** @brief Input tiles from child node */
-  std::vector<std::unique_ptr<LogicalTile>> child_tiles_;
+    // set once the partition is spilled
+    std::unique_ptr<SpillFile> spill_file;
+  };
 
+  // Entry of the index over the partitions left in memory
+  struct IndexEntry {
+    size_t hash;
+    oid_t tile_id;
+    oid_t tuple_id;
+    oid_t next;
+  };
+
+  void ConsumeTile(LogicalTile *tile);
+
+  void SpillPartition(oid_t partition);
+
+  void BuildIndex();
+
+  void ResetPass();
+
+  /** @brief Column ids of the hash keys */
   std::vector<oid_t> column_ids_;
 
+  size_t memory_budget_ = 0;
+
+  /** @brief Physical schema of the child, taken from its first tile */
+  std::unique_ptr<catalog::Schema> schema_;
+
+  std::vector<Partition> partitions_;
+
+  /** @brief Bytes held by the partitions in memory */
+  size_t memory_usage_ = 0;
+
+  /** @brief Partitioning depth of the current pass */
+  size_t depth_ = 0;
+
+  /** @brief Tuples of the current pass, null for the child */
+  std::unique_ptr<SpillFile> source_file_;
+
+  /** @brief Chained index over the tuples in memory */
+  std::vector<oid_t> buckets_;
+  std::vector<IndexEntry> index_entries_;
+
+  /** @brief Tiles of the current pass */
+  std::vector<std::shared_ptr<storage::Tile>> index_tiles_;
+
+  /** @brief # of tiles returned by the previous passes */
+  oid_t tile_id_offset_ = 0;
+
+  /** @brief Tiles of the current pass waiting to be returned */
+  std::vector<std::unique_ptr<LogicalTile>> output_tiles_;
+
+  size_t spilled_partition_count_ = 0;
+
   bool done_ = false;
 
   size_t result_itr = 0;
@@ -10,12 +10,15 @@
  *-------------------------------------------------------------------------
  */
 
+#include <algorithm>
+#include <map>
 #include <vector>
 
 #include "backend/common/types.h"
 #include "backend/common/logger.h"
 #include "backend/executor/logical_tile_factory.h"
 #include "backend/executor/hash_join_executor.h"
+#include "backend/executor/tuple_hash_table.h"
 #include "backend/expression/abstract_expression.h"
 #include "backend/expression/container_tuple.h"
 
@@ -36,6 +39,17 @@ bool HashJoinExecutor::DInit() {
   if (status == false) return status;
   assert(children_[1]->GetRawNode()->GetPlanNodeType() == PLAN_NODE_TYPE_HASH);
   hash_executor_ = reinterpret_cast<HashExecutor *>(children_[1]);
+
+  buffered_output_tiles.clear();
+  left_schema_.reset();
+  probe_spill_files_.clear();
+  pending_partitions_.clear();
+  probe_file_.reset();
+  in_partition_ = false;
+  depth_ = 0;
+  pass_right_tile_itr_ = 0;
+  released_left_tile_itr_ = 1;
+
   return true;
 }
 
@@ -47,75 +61,239 @@ bool HashJoinExecutor::DInit() {
 bool HashJoinExecutor::DExecute() {
   // build hash map for right table
   if (!right_child_done_) {
-    while (hash_executor_->Execute() == true)
-      BufferRightTile(children_[1]->GetOutput());
+    BufferHashTiles();
     right_child_done_ = true;
   }
 
   for (;;) {
-    // left child & right child all done
-    if (left_child_done_ && right_child_done_) {
-      return BuildOuterJoinOutput();
-    }
-
     // if there is remaining pairs in buffer, release one at a time.
     if (!buffered_output_tiles.empty()) {
-      // just hand in one.
       SetOutput(buffered_output_tiles.front());
       buffered_output_tiles.pop_front();
       return true;
     }
 
-    // traverse every left child tile
-    if (children_[0]->Execute()) {
-      BufferLeftTile(children_[0]->GetOutput());
-      LogicalTile *left_tile = left_result_tiles_.back().get();
-
-      // traverse every tuple in curt left tile
-      for (auto left_tile_row_itr : *left_tile) {
-        auto hash = HashExecutor::HashMapType::key_type(
-            left_tile, left_tile_row_itr, &hash_executor_->GetHashKeyIds());
-        auto hash_result = hash_executor_->GetHashTable().find(hash);
-        if (hash_result != hash_executor_->GetHashTable().end()) {
-          RecordMatchedLeftRow(left_logical_tile_itr_, left_tile_row_itr);
-          // traverse right set
-          for (auto iter = hash_result->second.begin();
-               iter != hash_result->second.end(); ++iter) {
-            auto tile_index = iter->first;
-            auto tuple_index = iter->second;
-            RecordMatchedRightRow(tile_index, tuple_index);
-            LogicalTile *right_tile = right_result_tiles_[tile_index].get();
-            LogicalTile::PositionListsBuilder pos_lists_builder(left_tile,
-                                                                right_tile);
-            pos_lists_builder.AddRow(left_tile_row_itr, tuple_index);
-            auto output_tile = BuildOutputLogicalTile(left_tile, right_tile);
-            output_tile->SetPositionListsAndVisibility(
-                pos_lists_builder.Release());
-            buffered_output_tiles.emplace_back(output_tile.release());
-          }  // end of traversing right set
-        }    // end of if match
-      }      // end of traversal of curt left_tile
-
-      // Release at most one pair.
-      // PS: This should be done after traversing all the tuples in curt tile
-      left_logical_tile_itr_++;
-      if (!buffered_output_tiles.empty()) {
-        // release one at a time
-        SetOutput(buffered_output_tiles.front());
-        buffered_output_tiles.pop_front();
-        return true;
-      }
-    }  // end of still have left tile
+    // left child & all the spilled partitions are done
+    if (left_child_done_) {
+      return BuildOuterJoinOutput();
+    }
+
+    LogicalTile *left_tile = GetNextLeftTile();
+    if (left_tile != nullptr) {
+      ProbeLeftTile(left_tile);
+      continue;
+    }
 
-    // All left tiles are exhausted.
-    else {
+    // The pass is over, move on to the next spilled partition
+    FinishPass();
+    if (StartNextPartition() == false) {
       left_child_done_ = true;
-      return BuildOuterJoinOutput();
     }
-  }  // end of infinite loop
+  }
+
   // never should go here
   return false;
-}  // end of DExecute
+}
+
+/**
+ * @brief Buffer the tiles of the current pass of the hash executor.
+ */
+void HashJoinExecutor::BufferHashTiles() {
+  while (hash_executor_->Execute() == true)
+    BufferRightTile(children_[1]->GetOutput());
+}
+
+/**
+ * @brief Next tile of the left child, or of the left tuples spilled to the
+ * partition of the current pass.
+ * @return nullptr once the pass has no more left tiles.
+ */
+LogicalTile *HashJoinExecutor::GetNextLeftTile() {
+  if (in_partition_) {
+    // No left tuple fell into the partition
+    if (probe_file_ == nullptr) return nullptr;
+
+    return probe_file_->ReadTile(*left_schema_, DEFAULT_TUPLES_PER_TILEGROUP);
+  }
+
+  if (children_[0]->Execute()) return children_[0]->GetOutput();
+
+  return nullptr;
+}
+
+/**
+ * @brief Join a left tile with the build tuples in memory, and spill its
+ * tuples of the spilled partitions.
+ * Output is grouped into one logical tile per matching right tile.
+ */
+void HashJoinExecutor::ProbeLeftTile(LogicalTile *left_tile) {
+  BufferLeftTile(left_tile);
+  size_t left_tile_itr = left_result_tiles_.size() - 1;
+  auto &column_ids = hash_executor_->GetHashKeyIds();
+
+  std::map<oid_t, LogicalTile::PositionListsBuilder> pos_lists_builders;
+  std::vector<std::pair<oid_t, oid_t>> matches;
+
+  // traverse every tuple in curt left tile
+  for (auto left_tile_row_itr : *left_tile) {
+    expression::ContainerTuple<LogicalTile> left_tuple(left_tile,
+                                                       left_tile_row_itr);
+    size_t hash = TupleHashTable::Hash(left_tuple, column_ids);
+    oid_t partition = hash_executor_->GetPartition(hash);
+
+    // The tuple is joined in the pass of its partition
+    if (hash_executor_->IsPartitionSpilled(partition)) {
+      SpillLeftTuple(left_tile, left_tile_row_itr, partition);
+      RecordMatchedLeftRow(left_tile_itr, left_tile_row_itr);
+      continue;
+    }
+
+    matches.clear();
+    hash_executor_->FindMatches(left_tuple, hash, matches);
+    if (matches.empty()) continue;
+
+    RecordMatchedLeftRow(left_tile_itr, left_tile_row_itr);
+
+    // traverse right set
+    for (auto &match : matches) {
+      auto tile_index = match.first;
+      auto tuple_index = match.second;
+      RecordMatchedRightRow(tile_index, tuple_index);
+
+      auto builder_itr = pos_lists_builders.find(tile_index);
+      if (builder_itr == pos_lists_builders.end()) {
+        LogicalTile *right_tile = right_result_tiles_[tile_index].get();
+        builder_itr = pos_lists_builders.emplace(
+            tile_index, LogicalTile::PositionListsBuilder(
+                            left_tile, right_tile)).first;
+      }
+      builder_itr->second.AddRow(left_tile_row_itr, tuple_index);
+    }
+  }
+
+  for (auto &builder : pos_lists_builders) {
+    LogicalTile *right_tile = right_result_tiles_[builder.first].get();
+    auto output_tile = BuildOutputLogicalTile(left_tile, right_tile);
+    output_tile->SetPositionListsAndVisibility(builder.second.Release());
+    buffered_output_tiles.push_back(output_tile.release());
+  }
+
+  ReleaseLeftTiles();
+}
+
+void HashJoinExecutor::SpillLeftTuple(LogicalTile *left_tile, oid_t tuple_id,
+                                      oid_t partition) {
+  if (left_schema_ == nullptr) {
+    left_schema_.reset(left_tile->GetPhysicalSchema());
+  }
+
+  if (probe_spill_files_.empty()) {
+    probe_spill_files_.resize(TUPLE_HASH_TABLE_PARTITION_COUNT);
+  }
+
+  auto &spill_file = probe_spill_files_[partition];
+  if (spill_file == nullptr) {
+    spill_file.reset(new SpillFile());
+  }
+
+  expression::ContainerTuple<LogicalTile> left_tuple(left_tile, tuple_id);
+  spill_file->Append(left_tuple, left_schema_->GetColumnCount());
+}
+
+/**
+ * @brief Probed left tiles are final: produce their left join rows, and drop
+ * them. The first left tile is kept for the NULL half of right join rows.
+ */
+void HashJoinExecutor::ReleaseLeftTiles() {
+  size_t release_limit = left_result_tiles_.size();
+
+  if (join_type_ == JOIN_TYPE_LEFT || join_type_ == JOIN_TYPE_OUTER) {
+    // Rows are produced once a right tile can fill their NULL half
+    if (right_result_tiles_.empty()) return;
+
+    while (BuildLeftJoinOutput()) {
+      buffered_output_tiles.push_back(GetOutput());
+    }
+    release_limit = left_matching_idx;
+  }
+
+  for (; released_left_tile_itr_ < release_limit; released_left_tile_itr_++) {
+    left_result_tiles_[released_left_tile_itr_].reset();
+  }
+}
+
+/**
+ * @brief Right tiles of a finished pass are final: produce their right join
+ * rows, and drop them. The first right tile is kept for the NULL half of left
+ * join rows.
+ */
+void HashJoinExecutor::FinishPass() {
+  size_t release_limit = right_result_tiles_.size();
+
+  if (join_type_ == JOIN_TYPE_RIGHT || join_type_ == JOIN_TYPE_OUTER) {
+    // Rows are produced once a left tile can fill their NULL half
+    if (left_result_tiles_.empty()) return;
+
+    while (BuildRightJoinOutput()) {
+      buffered_output_tiles.push_back(GetOutput());
+    }
+    release_limit = right_matching_idx;
+  }
+
+  size_t right_tile_itr = std::max<size_t>(pass_right_tile_itr_, 1);
+  for (; right_tile_itr < release_limit; right_tile_itr++) {
+    right_result_tiles_[right_tile_itr].reset();
+  }
+}
+
+/**
+ * @brief Queue the partitions spilled by the pass that just ended, and start
+ * the pass of the next queued partition.
+ * @return false if no partition is left.
+ */
+bool HashJoinExecutor::StartNextPartition() {
+  for (oid_t partition_itr = 0;
+       partition_itr < TUPLE_HASH_TABLE_PARTITION_COUNT; partition_itr++) {
+    if (hash_executor_->IsPartitionSpilled(partition_itr) == false) continue;
+
+    Partition partition;
+    partition.build = hash_executor_->ReleaseSpilledPartition(partition_itr);
+    if (partition_itr < probe_spill_files_.size()) {
+      partition.probe = std::move(probe_spill_files_[partition_itr]);
+    }
+    partition.depth = depth_ + 1;
+
+    // Without left tuples, only right and full joins have output
+    if (partition.probe == nullptr && join_type_ != JOIN_TYPE_RIGHT &&
+        join_type_ != JOIN_TYPE_OUTER)
+      continue;
+
+    pending_partitions_.push_back(std::move(partition));
+  }
+  probe_spill_files_.clear();
+
+  if (pending_partitions_.empty()) return false;
+
+  Partition partition = std::move(pending_partitions_.front());
+  pending_partitions_.pop_front();
+
+  LOG_TRACE("Hash join pass over a partition at depth %lu",
+            partition.depth);
+
+  in_partition_ = true;
+  depth_ = partition.depth;
+  probe_file_ = std::move(partition.probe);
+  if (probe_file_ != nullptr) {
+    probe_file_->Rewind();
+  }
+
+  // Build the partition, which may spill parts of it again
+  hash_executor_->Rebuild(std::move(partition.build), depth_);
+  pass_right_tile_itr_ = right_result_tiles_.size();
+  BufferHashTiles();
+
+  return true;
+}
+
 }  // namespace executor
 }  // namespace peloton
-
@@ -13,14 +13,29 @@
 #pragma once
 
 #include <deque>
+#include <memory>
+#include <vector>
 
 #include "backend/executor/abstract_join_executor.h"
 #include "backend/planner/hash_join_plan.h"
 #include "backend/executor/hash_executor.h"
+#include "backend/executor/spill_file.h"
 
 namespace peloton {
 namespace executor {
 
+/**
+ * @brief Hybrid hash join.
+ *
+ * The build side (right child, a HashExecutor) keeps as many partitions in
+ * memory as its budget allows. Left tuples whose partition is in memory are
+ * joined right away, the other ones are spilled to a file per partition.
+ * Once the left child is exhausted, each spilled partition is joined in a
+ * pass of its own, which may partition it again.
+ *
+ * Tuples of a pass are final when the pass ends, so outer join rows are
+ * produced as soon as possible, and the tiles of finished passes dropped.
+ */
 class HashJoinExecutor : public AbstractJoinExecutor {
   HashJoinExecutor(const HashJoinExecutor &) = delete;
   HashJoinExecutor &operator=(const HashJoinExecutor &) = delete;
@@ -35,14 +50,55 @@ class HashJoinExecutor : public AbstractJoinExecutor {
   bool DExecute();
 
  private:
+  /** @brief Spilled tuples of both children with the same partition */
+  struct Partition {
+    std::unique_ptr<SpillFile> build;
+    std::unique_ptr<SpillFile> probe;
+    size_t depth;
+  };
+
+  void BufferHashTiles();
+
+  LogicalTile *GetNextLeftTile();
+
+  void ProbeLeftTile(LogicalTile *left_tile);
+
+  void SpillLeftTuple(LogicalTile *left_tile, oid_t tuple_id,
+                      oid_t partition);
+
+  void ReleaseLeftTiles();
+
+  void FinishPass();
+
+  bool StartNextPartition();
+
   HashExecutor *hash_executor_ = nullptr;
 
   std::deque<LogicalTile *> buffered_output_tiles;
 
-  // logical tile iterators
-  size_t left_logical_tile_itr_ = 0;
-  size_t right_logical_tile_itr_ = 0;
+  /** @brief Physical schema of the left child, for its spilled tuples */
+  std::unique_ptr<catalog::Schema> left_schema_;
+
+  /** @brief Left tuples spilled by the current pass, one file per partition */
+  std::vector<std::unique_ptr<SpillFile>> probe_spill_files_;
+
+  /** @brief Partitions waiting for a pass */
+  std::deque<Partition> pending_partitions_;
+
+  /** @brief Left tuples of the current pass, null for the left child */
+  std::unique_ptr<SpillFile> probe_file_;
+
+  /** @brief Current pass is over a spilled partition */
+  bool in_partition_ = false;
+
+  /** @brief Partitioning depth of the current pass */
+  size_t depth_ = 0;
+
+  /** @brief First right tile of the current pass */
+  size_t pass_right_tile_itr_ = 0;
 
+  /** @brief Left tiles before this one were released */
+  size_t released_left_tile_itr_ = 1;
 };
 
 }  // namespace executor
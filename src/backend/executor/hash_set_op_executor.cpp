@@ -17,7 +17,9 @@
 #include "backend/common/value.h"
 #include "backend/executor/logical_tile.h"
 #include "backend/executor/hash_set_op_executor.h"
+#include "backend/expression/container_tuple.h"
 
+#include "backend/planner/distinct_plan.h"
 #include "backend/planner/set_op_plan.h"
 
 namespace peloton {
@@ -35,9 +37,33 @@ HashSetOpExecutor::HashSetOpExecutor(const planner::AbstractPlan *node,
  * @return true on success, false otherwise.
  */
 bool HashSetOpExecutor::DInit() {
-  assert(children_.size() == 2);
-  assert(!hash_done_);
-  assert(set_op_ == SETOP_TYPE_INVALID);
+  // Grab data from plan node
+  if (GetRawNode()->GetPlanNodeType() == PLAN_NODE_TYPE_DISTINCT) {
+    assert(children_.size() == 1);
+    const planner::DistinctPlan &node = GetPlanNode<planner::DistinctPlan>();
+    set_op_ = SETOP_TYPE_EXCEPT;
+    memory_budget_ = node.GetMemoryBudget();
+  } else {
+    assert(children_.size() == 2);
+    const planner::SetOpPlan &node = GetPlanNode<planner::SetOpPlan>();
+    set_op_ = node.GetSetOp();
+    memory_budget_ = node.GetMemoryBudget();
+  }
+
+  if (set_op_ == SETOP_TYPE_INVALID) return false;
+
+  schema_.reset();
+  htable_.reset();
+  right_done_ = false;
+  left_done_ = false;
+  spilling_ = false;
+  right_spilled_ = false;
+  left_spill_files_.clear();
+  right_spill_files_.clear();
+  depth_ = 0;
+  current_partition_.reset();
+  pending_partitions_.clear();
+  spilled_partition_count_ = 0;
 
   return true;
 }
@@ -45,145 +71,230 @@ bool HashSetOpExecutor::DInit() {
 bool HashSetOpExecutor::DExecute() {
   LOG_TRACE("Set Op executor ");
 
-  if (!hash_done_) ExecuteHelper();
+  if (!right_done_) BuildRight();
+
+  while (true) {
+    std::unique_ptr<LogicalTile> tile(GetNextLeftTile());
+
+    // Move on to the next spilled partition
+    if (tile == nullptr) {
+      if (StartNextPartition() == false) return false;
+      continue;
+    }
 
-  assert(hash_done_);
+    ProbeLeftTile(tile.get());
 
-  // Avoid returning empty tiles
-  while (next_tile_to_return_ < left_tiles_.size()) {
-    if (left_tiles_[next_tile_to_return_]->GetTupleCount() > 0) {
-      SetOutput(left_tiles_[next_tile_to_return_].release());
-      next_tile_to_return_++;
+    // Avoid returning empty tiles
+    if (tile->GetTupleCount() > 0) {
+      SetOutput(tile.release());
       return true;
-    } else
-      next_tile_to_return_++;
+    }
   }
-  return false;
 }
 
-bool HashSetOpExecutor::ExecuteHelper() {
-  assert(children_.size() == 2);
-  assert(!hash_done_);
+bool HashSetOpExecutor::BuildRight() {
+  // DISTINCT has no right child
+  if (children_.size() == 2) {
+    while (children_[1]->Execute()) {
+      // Each right tile can be destroyed after processing
+      std::unique_ptr<LogicalTile> tile(children_[1]->GetOutput());
+      InsertRightTile(tile.get());
+    }
+  }
 
-  // Grab data from plan node
-  const planner::SetOpPlan &node = GetPlanNode<planner::SetOpPlan>();
-  set_op_ = node.GetSetOp();
-  assert(set_op_ != SETOP_TYPE_INVALID);
+  right_done_ = true;
+  return true;
+}
+
+LogicalTile *HashSetOpExecutor::GetNextLeftTile() {
+  if (current_partition_ != nullptr) {
+    return current_partition_->left->ReadTile(*schema_,
+                                              DEFAULT_TUPLES_PER_TILEGROUP);
+  }
+
+  if (left_done_) return nullptr;
 
-  // Extract all input from left child
-  while (children_[0]->Execute()) {
-    left_tiles_.emplace_back(children_[0]->GetOutput());
+  if (children_[0]->Execute()) return children_[0]->GetOutput();
+
+  left_done_ = true;
+  return nullptr;
+}
+
+void HashSetOpExecutor::InsertRightTile(LogicalTile *tile) {
+  if (htable_ == nullptr) {
+    schema_.reset(tile->GetPhysicalSchema());
+    htable_.reset(new TupleHashTable(schema_.get()));
   }
 
-  if (left_tiles_.size() == 0) return false;
+  oid_t column_count = schema_->GetColumnCount();
+
+  for (oid_t tuple_id : *tile) {
+    expression::ContainerTuple<LogicalTile> tuple(tile, tuple_id);
+    size_t hash = TupleHashTable::Hash(tuple, column_count);
+
+    auto entry = htable_->Find(tuple, hash);
+    if (entry == nullptr) {
+      // The key's copies on both sides meet again in the same partition
+      if (spilling_) {
+        SpillTuple(tile, tuple_id, hash, false);
+        right_spilled_ = true;
+        continue;
+      }
 
-  // Scan the left child's input and update the counters
-  for (auto &tile : left_tiles_) {
-    for (oid_t tuple_id : *tile) {
-      htable_[HashSetOpMapType::key_type(tile.get(), tuple_id)].left++;
+      entry = htable_->Insert(tuple, hash);
+      entry->right_count++;
+      CheckMemoryBudget();
+    } else {
+      entry->right_count++;
     }
   }
+}
+
+void HashSetOpExecutor::ProbeLeftTile(LogicalTile *tile) {
+  if (htable_ == nullptr) {
+    schema_.reset(tile->GetPhysicalSchema());
+    htable_.reset(new TupleHashTable(schema_.get()));
+  }
+
+  oid_t column_count = schema_->GetColumnCount();
+
+  for (oid_t tuple_id : *tile) {
+    expression::ContainerTuple<LogicalTile> tuple(tile, tuple_id);
+    size_t hash = TupleHashTable::Hash(tuple, column_count);
+    bool keep = false;
 
-  // Scan the right child's input and update counter when appropriate
-  while (children_[1]->Execute()) {
-    // Each right tile can be destroyed after processing
-    std::unique_ptr<LogicalTile> tile(children_[1]->GetOutput());
-
-    for (oid_t tuple_id : *tile) {
-      auto it = htable_.find(HashSetOpMapType::key_type(tile.get(), tuple_id));
-      // Do nothing if this key never appears in the left child
-      // because it shouldn't show up in the result anyway
-      if (it != htable_.end()) {
-        it->second.right++;
+    auto entry = htable_->Find(tuple, hash);
+    if (entry != nullptr) {
+      keep = KeepLeftTuple(entry);
+    } else if (right_spilled_) {
+      // The key may be in a right partition
+      SpillTuple(tile, tuple_id, hash, true);
+    } else {
+      // The key is not in the right child
+      switch (set_op_) {
+        case SETOP_TYPE_INTERSECT:
+        case SETOP_TYPE_INTERSECT_ALL:
+          break;
+        case SETOP_TYPE_EXCEPT_ALL:
+          keep = true;
+          break;
+        case SETOP_TYPE_EXCEPT:
+          // Remember the key to drop its other copies
+          if (spilling_) {
+            SpillTuple(tile, tuple_id, hash, true);
+          } else {
+            keep = KeepLeftTuple(htable_->Insert(tuple, hash));
+            CheckMemoryBudget();
+          }
+          break;
+        case SETOP_TYPE_INVALID:
+          break;
       }
     }
+
+    if (keep == false) tile->RemoveVisibility(tuple_id);
   }
+}
+
+/**
+ * Based on the set-op type and on the copies of the key seen so far,
+ * decide whether a left tuple goes to the output.
+ */
+bool HashSetOpExecutor::KeepLeftTuple(TupleHashTable::Entry *entry) {
+  size_t left_count = entry->left_count++;
 
-  // Calculate the output number for each key
   switch (set_op_) {
     case SETOP_TYPE_INTERSECT:
-      CalculateCopies<SETOP_TYPE_INTERSECT>(htable_);
-      break;
+      return (entry->right_count > 0) && (left_count == 0);
     case SETOP_TYPE_INTERSECT_ALL:
-      CalculateCopies<SETOP_TYPE_INTERSECT_ALL>(htable_);
-      break;
+      return left_count < entry->right_count;
     case SETOP_TYPE_EXCEPT:
-      CalculateCopies<SETOP_TYPE_EXCEPT>(htable_);
-      break;
+      return (entry->right_count == 0) && (left_count == 0);
     case SETOP_TYPE_EXCEPT_ALL:
-      CalculateCopies<SETOP_TYPE_EXCEPT_ALL>(htable_);
-      break;
-    case SETOP_TYPE_INVALID:
+      return left_count >= entry->right_count;
+    default:
       return false;
   }
+}
+
+void HashSetOpExecutor::SpillTuple(LogicalTile *tile, oid_t tuple_id,
+                                   size_t hash, bool left) {
+  auto &spill_files = left ? left_spill_files_ : right_spill_files_;
+  if (spill_files.empty()) {
+    spill_files.resize(TUPLE_HASH_TABLE_PARTITION_COUNT);
+  }
 
-  /*
-   * A bit cumbersome here:
-   * Since the first tuple of each group is used as the representative key
-   * in the hash table,
-   * we cannot invalidate it otherwise subsequent key comparison will fail
-   * (due to safety check in LogicalTile::GetValue()).
-   * Instead, we skip the first tuple and process it in a second round.
-   */
+  auto &spill_file = spill_files[TupleHashTable::GetPartition(hash, depth_)];
+  if (spill_file == nullptr) {
+    spill_file.reset(new SpillFile());
+  }
 
-  // 1st round
-  for (auto &tile : left_tiles_) {
-    for (oid_t tuple_id : *tile) {
-      auto it = htable_.find(HashSetOpMapType::key_type(tile.get(), tuple_id));
+  expression::ContainerTuple<LogicalTile> tuple(tile, tuple_id);
+  spill_file->Append(tuple, schema_->GetColumnCount());
+}
 
-      assert(it != htable_.end());
+void HashSetOpExecutor::CheckMemoryBudget() {
+  UpdatePeakMemoryUsage(htable_->GetMemoryUsage());
 
-      if (it->first.GetContainer() == tile.get() &&
-          it->first.GetTupleId() == tuple_id)
-        continue;
-      else if (it->second.left > 0)
-        it->second.left--;
-      else
-        tile->RemoveVisibility(tuple_id);
-    }
+  if (spilling_ || depth_ >= TUPLE_HASH_TABLE_MAX_PARTITION_DEPTH) return;
+
+  if (htable_->GetMemoryUsage() > memory_budget_) {
+    LOG_INFO("Set op hash table is over budget with %lu keys, spilling",
+             htable_->GetSize());
+    spilling_ = true;
   }
+}
 
-  // 2nd round
-  for (auto &item : htable_) {
-    // We should have at most one quota left
-    assert(item.second.left == 1 || item.second.left == 0);
-    if (item.second.left == 0) {
-      item.first.GetContainer()->RemoveVisibility(item.first.GetTupleId());
+bool HashSetOpExecutor::StartNextPartition() {
+  // Queue the partitions spilled by the pass that just ended.
+  // Only partitions with left tuples can produce anything.
+  for (oid_t partition_itr = 0; partition_itr < left_spill_files_.size();
+       partition_itr++) {
+    if (left_spill_files_[partition_itr] == nullptr) continue;
+
+    std::unique_ptr<Partition> partition(new Partition());
+    partition->left = std::move(left_spill_files_[partition_itr]);
+    if (partition_itr < right_spill_files_.size()) {
+      partition->right = std::move(right_spill_files_[partition_itr]);
     }
+    partition->depth = depth_ + 1;
+
+    pending_partitions_.push_back(std::move(partition));
+    spilled_partition_count_++;
   }
 
-  hash_done_ = true;
-  next_tile_to_return_ = 0;
-  return true;
-}
+  left_spill_files_.clear();
+  right_spill_files_.clear();
 
-/**
- * Based on the set-op type,
- * calculate the number of output copies of each tuples
- * and store it in the left counter.
- */
-template <SetOpType SETOP>
-bool HashSetOpExecutor::CalculateCopies(HashSetOpMapType &htable) {
-  for (auto &item : htable) {
-    switch (SETOP) {
-      case SETOP_TYPE_INTERSECT:
-        item.second.left = (item.second.right > 0) ? 1 : 0;
-        break;
-      case SETOP_TYPE_INTERSECT_ALL:
-        item.second.left = std::min(item.second.left, item.second.right);
-        break;
-      case SETOP_TYPE_EXCEPT:
-        item.second.left = (item.second.right > 0) ? 0 : 1;
-        break;
-      case SETOP_TYPE_EXCEPT_ALL:
-        item.second.left = (item.second.left > item.second.right)
-                               ? (item.second.left - item.second.right)
-                               : 0;
-        break;
-      default:
-        return false;
+  if (pending_partitions_.empty()) return false;
+
+  current_partition_ = std::move(pending_partitions_.front());
+  pending_partitions_.pop_front();
+
+  LOG_TRACE("Set op partition at depth %lu : %lu left tuples",
+            current_partition_->depth,
+            current_partition_->left->GetTupleCount());
+
+  // Start a new pass over the partition
+  depth_ = current_partition_->depth;
+  htable_->Clear();
+  spilling_ = false;
+  right_spilled_ = false;
+
+  current_partition_->left->Rewind();
+
+  if (current_partition_->right != nullptr) {
+    current_partition_->right->Rewind();
+
+    while (true) {
+      std::unique_ptr<LogicalTile> tile(current_partition_->right->ReadTile(
+          *schema_, DEFAULT_TUPLES_PER_TILEGROUP));
+      if (tile == nullptr) break;
+
+      InsertRightTile(tile.get());
     }
   }
+
   return true;
 }
 
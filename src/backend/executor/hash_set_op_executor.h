@@ -12,12 +12,16 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <deque>
+#include <memory>
+#include <vector>
 
+#include "backend/catalog/schema.h"
 #include "backend/common/types.h"
 #include "backend/executor/abstract_executor.h"
 #include "backend/executor/logical_tile.h"
-#include "backend/expression/container_tuple.h"
+#include "backend/executor/spill_file.h"
+#include "backend/executor/tuple_hash_table.h"
 
 namespace peloton {
 namespace executor {
@@ -25,18 +29,22 @@ namespace executor {
 /**
  * @brief Hash based set operation executor.
  *
- * @warning This is a pipeline breaker.
- *
  * IMPORTANT: Children must have the same physical schema.
  * TODO: Postgres relaxes this to "compatible schema" (e.g., int -> double).
  *
- * Currently supported: INTERSECT/INTERSECT ALL/EXCEPT/EXCEPT ALL.
- * We use a similar algorithm to Postgres but more optimized.
- * Since the result of all supported set-op must be a subset
- * of the left child,
- * we can simply massage the validation flags of the left child
- * and forward the (logical tiles) upwards.
- * This avoids materialization.
+ * Currently supported: INTERSECT/INTERSECT ALL/EXCEPT/EXCEPT ALL, and
+ * DISTINCT, which runs as an EXCEPT against an empty right child.
+ *
+ * The right child is streamed into a hash table counting the copies of
+ * each key. The left child is then streamed through the table: since the
+ * result of all supported set-op must be a subset of the left child, we
+ * simply massage the validation flags of each left tile and forward it
+ * upwards right away. This avoids materialization.
+ *
+ * Once the table outgrows the plan's memory budget, no new key goes into
+ * it: tuples of both children with an unknown key are spilled to one of a
+ * set of partition files instead, by their hash. The spilled partitions are
+ * then processed one by one in the same way, partitioning again if needed.
  */
 class HashSetOpExecutor : public AbstractExecutor {
  public:
@@ -48,44 +56,77 @@ class HashSetOpExecutor : public AbstractExecutor {
   explicit HashSetOpExecutor(const planner::AbstractPlan *node,
                              ExecutorContext *executor_context);
 
+  /** @brief # of partitions spilled so far */
+  size_t GetSpilledPartitionCount() const { return spilled_partition_count_; }
+
  protected:
   bool DInit();
   bool DExecute();
 
  private:
-  /** @brief Counter-pair type for binary set-op */
-  typedef struct {
-    size_t left = 0;
-    size_t right = 0;
-  } counter_pair_t;
-
-  /** @brief Type definitions for hash table */
-  typedef std::unordered_map<
-      expression::ContainerTuple<LogicalTile>, counter_pair_t,
-      expression::ContainerTupleHasher<LogicalTile>,
-      expression::ContainerTupleComparator<LogicalTile>> HashSetOpMapType;
+  /** @brief Spilled tuples of both children with the same partition */
+  struct Partition {
+    std::unique_ptr<SpillFile> left;
+    std::unique_ptr<SpillFile> right;
+    size_t depth;
+  };
 
   /* Helper functions */
 
-  bool ExecuteHelper();
+  bool BuildRight();
+
+  LogicalTile *GetNextLeftTile();
+
+  void InsertRightTile(LogicalTile *tile);
+
+  void ProbeLeftTile(LogicalTile *tile);
+
+  bool KeepLeftTuple(TupleHashTable::Entry *entry);
+
+  void SpillTuple(LogicalTile *tile, oid_t tuple_id, size_t hash, bool left);
 
-  template <SetOpType SETOP>
-  bool CalculateCopies(HashSetOpMapType &htable);
+  void CheckMemoryBudget();
 
-  /** @brief Hash table */
-  HashSetOpMapType htable_;
+  bool StartNextPartition();
 
-  /** @brief The specified set-op type */
+  /** @brief The specified set-op type, EXCEPT for DISTINCT */
   SetOpType set_op_ = SETOP_TYPE_INVALID;
 
-  /** @brief Hash table is built or not */
-  bool hash_done_ = false;
+  /** @brief Bytes of hash table to fill before spilling */
+  size_t memory_budget_ = 0;
+
+  /** @brief Physical schema of the children, taken from the first tile */
+  std::unique_ptr<catalog::Schema> schema_;
+
+  /** @brief Hash table of the current pass */
+  std::unique_ptr<TupleHashTable> htable_;
+
+  /** @brief Right child is in the hash table (or spilled) */
+  bool right_done_ = false;
+
+  /** @brief Left child is exhausted */
+  bool left_done_ = false;
+
+  /** @brief Hash table is full, new keys are spilled */
+  bool spilling_ = false;
+
+  /** @brief Some right tuple of the current pass was spilled */
+  bool right_spilled_ = false;
+
+  /** @brief Partition files of the current pass */
+  std::vector<std::unique_ptr<SpillFile>> left_spill_files_;
+  std::vector<std::unique_ptr<SpillFile>> right_spill_files_;
+
+  /** @brief Partitioning depth of the current pass */
+  size_t depth_ = 0;
+
+  /** @brief Partition being processed, null for the children */
+  std::unique_ptr<Partition> current_partition_;
 
-  /** @brief Input tiles from left child */
-  std::vector<std::unique_ptr<LogicalTile>> left_tiles_;
+  /** @brief Partitions waiting to be processed */
+  std::deque<std::unique_ptr<Partition>> pending_partitions_;
 
-  /** @brief Next tile Id in the vector to return */
-  size_t next_tile_to_return_ = 0;
+  size_t spilled_partition_count_ = 0;
 };
 
 } /* namespace executor */
@@ -12,19 +12,24 @@
 
 #include "backend/executor/index_scan_executor.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <vector>
 
 #include "backend/common/types.h"
+#include "backend/catalog/manager.h"
 #include "backend/executor/logical_tile.h"
 #include "backend/executor/logical_tile_factory.h"
 #include "backend/executor/executor_context.h"
 #include "backend/expression/abstract_expression.h"
 #include "backend/expression/container_tuple.h"
+#include "backend/expression/expression_program.h"
 #include "backend/index/index.h"
 #include "backend/storage/data_table.h"
+#include "backend/storage/tile.h"
 #include "backend/storage/tile_group.h"
+#include "backend/storage/tile_group_header.h"
 #include "backend/common/logger.h"
 
 namespace peloton {
@@ -68,6 +73,7 @@ bool IndexScanExecutor::DInit() {
   values_ = node.GetValues();
   runtime_keys_ = node.GetRunTimeKeys();
   predicate_ = node.GetPredicate();
+  predicate_program_ = node.GetPredicateProgram();
 
   if (runtime_keys_.size() != 0) {
     assert(runtime_keys_.size() == values_.size());
@@ -104,7 +110,13 @@ bool IndexScanExecutor::DExecute() {
 
   if (!done_) {
     auto status = ExecIndexLookup();
-    if (status == false) return false;
+    if (status == false) {
+      // Finding nothing is a read too
+      ExecReadTracking();
+      return false;
+    }
+    // Track the reads before the predicate drops any
+    ExecReadTracking();
     ExecPredication();
     ExecProjection();
   }
@@ -128,12 +140,14 @@ bool IndexScanExecutor::DExecute() {
 }
 
 void IndexScanExecutor::ExecPredication() {
-  if (nullptr == predicate_) return;
+  if (nullptr == predicate_program_) return;
   unsigned int removed_count = 0;
+  expression::ExpressionProgram::Registers registers(*predicate_program_);
   for (auto tile : result) {
     for (auto tuple_id : *tile) {
       expression::ContainerTuple<LogicalTile> tuple(tile, tuple_id);
-      if (predicate_->Evaluate(&tuple, nullptr, executor_context_).IsFalse()) {
+      predicate_program_->Run(registers, &tuple, nullptr, executor_context_);
+      if (predicate_program_->GetResult(registers, 0).IsFalse()) {
         removed_count++;
         tile->RemoveVisibility(tuple_id);
       }
@@ -142,6 +156,68 @@ void IndexScanExecutor::ExecPredication() {
   LOG_INFO("predicate removed %d row", removed_count);
 }
 
+/**
+ * @brief Optimistic transactions drop the tuples they deleted, as their
+ * deletes are only applied at commit, and record the rest as read.
+ * Serializable transactions record the tile groups of the tuples found by a
+ * point lookup, and the whole table for a range or a missed lookup, as the
+ * tuples inserted in that range could land anywhere.
+ */
+void IndexScanExecutor::ExecReadTracking() {
+  auto transaction_ = executor_context_->GetTransaction();
+
+  // The past is not validated
+  if (IsTimeTravel()) return;
+
+  if (transaction_->IsSerializable()) {
+    bool point_lookup =
+        (key_column_ids_.size() == index_->GetColumnCount()) &&
+        std::all_of(expr_types_.begin(), expr_types_.end(),
+                    [](ExpressionType expr_type) {
+                      return expr_type == EXPRESSION_TYPE_COMPARE_EQUAL;
+                    });
+
+    bool found = false;
+    for (auto tile : result) {
+      if (tile->GetTupleCount() == 0) continue;
+
+      transaction_->RecordTileGroupRead(
+          tile->GetBaseTile(0)->GetTileGroup()->GetTileGroupId());
+      found = true;
+    }
+
+    if ((point_lookup == false || found == false) && table_ != nullptr) {
+      transaction_->RecordTableRead(table_->GetOid());
+    }
+    return;
+  }
+
+  if (transaction_->IsOptimistic() == false) return;
+
+  std::vector<oid_t> read_tuples;
+  for (auto tile : result) {
+    if (tile->GetTupleCount() == 0) continue;
+
+    auto &position_list = tile->GetPositionLists()[0];
+    oid_t tile_group_id =
+        tile->GetBaseTile(0)->GetTileGroup()->GetTileGroupId();
+
+    read_tuples.clear();
+    for (auto tuple_id : *tile) {
+      oid_t physical_tuple_id = position_list[tuple_id];
+      if (transaction_->IsOwnDelete(
+              ItemPointer(tile_group_id, physical_tuple_id))) {
+        tile->RemoveVisibility(tuple_id);
+        continue;
+      }
+
+      read_tuples.push_back(physical_tuple_id);
+    }
+
+    transaction_->RecordReads(tile_group_id, read_tuples);
+  }
+}
+
 void IndexScanExecutor::ExecProjection() {
   if (column_ids_.size() == 0) return;
 
@@ -167,8 +243,34 @@ bool IndexScanExecutor::ExecIndexLookup() {
   if (tuple_locations.size() == 0) return false;
 
   auto transaction_ = executor_context_->GetTransaction();
-  txn_id_t txn_id = transaction_->GetTransactionId();
-  cid_t commit_id = transaction_->GetLastCommitId();
+  txn_id_t txn_id;
+  cid_t commit_id;
+  GetSnapshot(txn_id, commit_id);
+
+  // Without a predicate, only the first limit_hint_ visible tuples can ever
+  // be consumed. Drop the rest before building any logical tiles.
+  if (predicate_ == nullptr && tuple_locations.size() > limit_hint_) {
+    auto &manager = catalog::Manager::GetInstance();
+    std::vector<ItemPointer> visible_locations;
+
+    for (auto tuple_location : tuple_locations) {
+      if (visible_locations.size() >= limit_hint_) break;
+
+      auto tile_group = manager.GetTileGroup(tuple_location.block);
+      if (tile_group->GetHeader()->IsVisible(tuple_location.offset, txn_id,
+                                             commit_id) &&
+          (transaction_->IsOptimistic() == false || IsTimeTravel() ||
+           transaction_->IsOwnDelete(tuple_location) == false)) {
+        visible_locations.push_back(tuple_location);
+      }
+    }
+
+    LOG_TRACE("Limit hint : %lu, kept %lu tuple locations", limit_hint_,
+              visible_locations.size());
+    tuple_locations.swap(visible_locations);
+
+    if (tuple_locations.size() == 0) return false;
+  }
 
   // Get the logical tiles corresponding to the given tuple locations
   result = LogicalTileFactory::WrapTileGroups(tuple_locations, full_column_ids_,
@@ -50,6 +50,8 @@ class IndexScanExecutor : public AbstractScanExecutor {
 
   void ExecPredication();
 
+  void ExecReadTracking();
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
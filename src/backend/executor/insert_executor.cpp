@@ -62,7 +62,6 @@ bool InsertExecutor::DExecute() {
   oid_t bulk_insert_count = node.GetBulkInsertCount();
   assert(target_table_);
 
-  auto transaction_ = executor_context_->GetTransaction();
   auto executor_pool = executor_context_->GetExecutorContextPool();
 
   // Inserting a logical tile.
@@ -78,30 +77,34 @@ bool InsertExecutor::DExecute() {
     auto target_table_schema = target_table_->GetSchema();
     auto column_count = target_table_schema->GetColumnCount();
 
-    std::unique_ptr<storage::Tuple> tuple(
-        new storage::Tuple(target_table_schema, true));
+    // Materialize the logical tile tuples into one batch
+    std::vector<std::unique_ptr<storage::Tuple>> tuples;
+    std::vector<const storage::Tuple *> batch;
 
     // Go over the logical tile
     for (oid_t tuple_id : *logical_tile) {
       expression::ContainerTuple<LogicalTile> cur_tuple(logical_tile.get(),
                                                         tuple_id);
 
+      std::unique_ptr<storage::Tuple> tuple(
+          new storage::Tuple(target_table_schema, true));
+
       // Materialize the logical tile tuple
       for (oid_t column_itr = 0; column_itr < column_count; column_itr++)
         tuple->SetValue(column_itr, cur_tuple.GetValue(column_itr),
                         executor_pool);
 
-      peloton::ItemPointer location =
-          target_table_->InsertTuple(transaction_, tuple.get());
-      if (location.block == INVALID_OID) {
-        transaction_->SetResult(peloton::Result::RESULT_FAILURE);
-        return false;
-      }
-      transaction_->RecordInsert(location);
+      batch.push_back(tuple.get());
+      tuples.push_back(std::move(tuple));
+    }
 
-      executor_context_->num_processed += 1;  // insert one
+    // Carry out insertion of the whole batch
+    if (BulkInsert(target_table_, batch) == false) {
+      return false;
     }
 
+    executor_context_->num_processed += batch.size();
+
     return true;
   }
   // Inserting a collection of tuples from plan node
@@ -125,34 +128,11 @@ bool InsertExecutor::DExecute() {
     }
 
     // Bulk Insert Mode
-    for (oid_t insert_itr = 0; insert_itr < bulk_insert_count; insert_itr++) {
-      // Carry out insertion
-      ItemPointer location =
-          target_table_->InsertTuple(transaction_, tuple.get());
-      LOG_INFO("Inserted into location: %lu, %lu", location.block,
-               location.offset);
-
-      if (location.block == INVALID_OID) {
-        LOG_INFO("Failed to Insert. Set txn failure.");
-        transaction_->SetResult(peloton::Result::RESULT_FAILURE);
-        return false;
-      }
-      transaction_->RecordInsert(location);
-
-      // Logging
-      {
-        auto &log_manager = logging::LogManager::GetInstance();
+    std::vector<const storage::Tuple *> batch(bulk_insert_count, tuple.get());
 
-        if (log_manager.IsInLoggingMode()) {
-          auto logger = log_manager.GetBackendLogger();
-          auto record = logger->GetTupleRecord(
-              LOGRECORD_TYPE_TUPLE_INSERT, transaction_->GetTransactionId(),
-              target_table_->GetOid(), location, INVALID_ITEMPOINTER,
-              tuple.get());
-
-          logger->Log(record);
-        }
-      }
+    // Carry out insertion
+    if (BulkInsert(target_table_, batch) == false) {
+      return false;
     }
 
     executor_context_->num_processed += 1;  // insert one
@@ -163,5 +143,53 @@ bool InsertExecutor::DExecute() {
   return true;
 }
 
+/**
+ * @brief Insert a batch of tuples into the target table in one go and
+ * record the claimed locations in the transaction.
+ * @return true on success, false otherwise.
+ */
+bool InsertExecutor::BulkInsert(
+    storage::DataTable *target_table,
+    const std::vector<const storage::Tuple *> &batch) {
+  auto transaction_ = executor_context_->GetTransaction();
+  std::vector<ItemPointer> locations;
+
+  bool status = target_table->InsertTuples(transaction_, batch, locations);
+
+  // Record all claimed slots, so that they get rolled back on failure
+  for (auto location : locations) {
+    transaction_->RecordInsert(location);
+  }
+
+  if (status == false) {
+    LOG_INFO("Failed to Insert. Set txn failure.");
+    transaction_->SetResult(peloton::Result::RESULT_FAILURE);
+    return false;
+  }
+
+  // Logging : enqueue the records of the whole batch at once
+  {
+    auto &log_manager = logging::LogManager::GetInstance();
+
+    if (log_manager.IsInLoggingMode()) {
+      auto logger = log_manager.GetBackendLogger();
+      std::vector<logging::LogRecord *> records;
+      records.reserve(batch.size());
+
+      for (oid_t tuple_itr = 0; tuple_itr < batch.size(); tuple_itr++) {
+        auto record = logger->GetTupleRecord(
+            LOGRECORD_TYPE_TUPLE_INSERT, transaction_->GetTransactionId(),
+            target_table->GetOid(), locations[tuple_itr], INVALID_ITEMPOINTER,
+            const_cast<storage::Tuple *>(batch[tuple_itr]));
+        records.push_back(record);
+      }
+
+      logger->LogBatch(records);
+    }
+  }
+
+  return true;
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -17,6 +17,12 @@
 #include <vector>
 
 namespace peloton {
+
+namespace storage {
+class DataTable;
+class Tuple;
+}
+
 namespace executor {
 
 class InsertExecutor : public AbstractExecutor {
@@ -35,6 +41,9 @@ class InsertExecutor : public AbstractExecutor {
   bool DExecute();
 
  private:
+  bool BulkInsert(storage::DataTable *target_table,
+                  const std::vector<const storage::Tuple *> &batch);
+
   bool done_ = false;
 };
 
@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
 #include "backend/executor/limit_executor.h"
 
 #include "backend/planner/limit_plan.h"
@@ -83,5 +85,20 @@ bool LimitExecutor::DExecute() {
   return false;
 }
 
+/**
+ * @brief The child only has to produce the skipped and the returned tuples.
+ * @return offset + limit, capped by our own limit hint.
+ */
+size_t LimitExecutor::GetChildLimitHint() {
+  const planner::LimitPlan &node = GetPlanNode<planner::LimitPlan>();
+  const size_t limit = std::min(node.GetLimit(), limit_hint_);
+  const size_t offset = node.GetOffset();
+
+  // Don't overflow
+  if (limit > NO_LIMIT_HINT - offset) return NO_LIMIT_HINT;
+
+  return offset + limit;
+}
+
 } /* namespace executor */
 } /* namespace peloton */
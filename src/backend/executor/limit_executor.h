@@ -37,6 +37,8 @@ class LimitExecutor : public AbstractExecutor {
 
   bool DExecute();
 
+  size_t GetChildLimitHint();
+
  private:
   //===--------------------------------------------------------------------===//
   // Executor State
@@ -160,14 +160,12 @@ Value LogicalTile::GetValue(oid_t tuple_id, oid_t column_id) {
 
   ColumnInfo &cp = schema_[column_id];
   oid_t base_tuple_id = position_lists_[cp.position_list_idx][tuple_id];
-  storage::Tile *base_tile = cp.base_tile.get();
 
   LOG_TRACE("Tuple : %lu Column : %lu", base_tuple_id, cp.origin_column_id);
   if (base_tuple_id == NULL_OID) {
-    return ValueFactory::GetNullValueByType(
-        base_tile->GetSchema()->GetType(column_id));
+    return ValueFactory::GetNullValueByType(cp.accessor.column_type);
   } else {
-    return base_tile->GetValue(base_tuple_id, cp.origin_column_id);
+    return cp.accessor.GetValue(base_tuple_id);
   }
 }
 
@@ -350,6 +348,7 @@ void LogicalTile::AddColumn(const std::shared_ptr<storage::Tile> &base_tile,
 
   cp.origin_column_id = origin_column_id;
   cp.position_list_idx = position_list_idx;
+  cp.accessor = base_tile->GetColumnAccessor(origin_column_id);
   schema_.push_back(cp);
 }
 
@@ -17,6 +17,7 @@
 #include <memory>
 
 #include "backend/common/types.h"
+#include "backend/storage/tile.h"
 
 namespace peloton {
 
@@ -25,7 +26,6 @@ class Schema;
 }
 
 namespace storage {
-class Tile;
 class TileGroup;
 }
 
@@ -161,6 +161,10 @@ class LogicalTile {
     /** @brief Original column id of this logical tile column in its associated
      * base tile. */
     oid_t origin_column_id;
+
+    /** @brief Access path to the column in the base tile, resolved once when
+     * the column is added. */
+    storage::ColumnAccessor accessor;
   };
 
   //===--------------------------------------------------------------------===//
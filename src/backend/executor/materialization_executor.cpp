@@ -138,10 +138,7 @@ void MaterializeRowAtAtATime(
 
     // Get old column information
     std::vector<oid_t> old_column_position_idxs;
-    std::vector<size_t> old_column_offsets;
-    std::vector<ValueType> old_column_types;
-    std::vector<bool> old_is_inlineds;
-    std::vector<storage::Tile *> old_tiles;
+    std::vector<const storage::ColumnAccessor *> old_accessors;
 
     // Get new column information
     std::vector<size_t> new_column_offsets;
@@ -156,16 +153,7 @@ void MaterializeRowAtAtATime(
       old_column_position_idxs.push_back(column_info.position_list_idx);
 
       // Get old column information
-      storage::Tile *old_tile = column_info.base_tile.get();
-      old_tiles.push_back(old_tile);
-      auto old_schema = old_tile->GetSchema();
-      oid_t old_column_id = column_info.origin_column_id;
-      const size_t old_column_offset = old_schema->GetOffset(old_column_id);
-      old_column_offsets.push_back(old_column_offset);
-      const ValueType old_column_type = old_schema->GetType(old_column_id);
-      old_column_types.push_back(old_column_type);
-      const bool old_is_inlined = old_schema->IsInlined(old_column_id);
-      old_is_inlineds.push_back(old_is_inlined);
+      old_accessors.push_back(&column_info.accessor);
 
       // Old to new column mapping
       auto it = old_to_new_cols.find(old_col_id);
@@ -202,9 +190,7 @@ void MaterializeRowAtAtATime(
 
         oid_t base_tuple_id = column_position_list[old_tuple_id];
 
-        auto value = old_tiles[col_itr]->GetValueFast(
-            base_tuple_id, old_column_offsets[col_itr],
-            old_column_types[col_itr], old_is_inlineds[col_itr]);
+        auto value = old_accessors[col_itr]->GetValue(base_tuple_id);
 
         LOG_TRACE("Old Tuple : %lu Column : %lu ", old_tuple_id, old_col_id);
         LOG_TRACE("New Tuple : %lu Column : %lu ", new_tuple_id, new_column_offsets[col_itr]);
@@ -242,15 +228,8 @@ void MaterializeColumnAtATime(
     for (oid_t old_col_id : old_column_ids) {
       auto &column_info = source_tile->GetColumnInfo(old_col_id);
 
-      // Amortize schema lookups once per column
-      storage::Tile *old_tile = column_info.base_tile.get();
-      auto old_schema = old_tile->GetSchema();
-
       // Get old column information
-      oid_t old_column_id = column_info.origin_column_id;
-      const size_t old_column_offset = old_schema->GetOffset(old_column_id);
-      const ValueType old_column_type = old_schema->GetType(old_column_id);
-      const bool old_is_inlined = old_schema->IsInlined(old_column_id);
+      auto &old_accessor = column_info.accessor;
 
       // Old to new column mapping
       auto it = old_to_new_cols.find(old_col_id);
@@ -276,8 +255,7 @@ void MaterializeColumnAtATime(
       ///////////////////////////
       for (oid_t old_tuple_id : *source_tile) {
         oid_t base_tuple_id = column_position_list[old_tuple_id];
-        auto value = old_tile->GetValueFast(base_tuple_id, old_column_offset,
-                                            old_column_type, old_is_inlined);
+        auto value = old_accessor.GetValue(base_tuple_id);
 
         LOG_TRACE("Old Tuple : %lu Column : %lu ", old_tuple_id, old_col_id);
         LOG_TRACE("New Tuple : %lu Column : %lu ", new_tuple_id, new_column_id);
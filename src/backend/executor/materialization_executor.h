@@ -48,6 +48,9 @@ class MaterializationExecutor : public AbstractExecutor {
 
   bool DExecute();
 
+  // One output tuple per input tuple, so the limit carries over
+  size_t GetChildLimitHint() { return limit_hint_; }
+
  private:
   void GenerateTileToColMap(
       const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
@@ -10,6 +10,7 @@
  *-------------------------------------------------------------------------
  */
 
+#include <memory>
 #include <vector>
 
 #include "backend/common/types.h"
@@ -18,6 +19,7 @@
 #include "backend/executor/merge_join_executor.h"
 #include "backend/expression/abstract_expression.h"
 #include "backend/expression/container_tuple.h"
+#include "backend/expression/expression_program.h"
 
 namespace peloton {
 namespace executor {
@@ -125,6 +127,13 @@ bool MergeJoinExecutor::DExecute() {
   // Build position lists
   LogicalTile::PositionListsBuilder pos_lists_builder(left_tile, right_tile);
 
+  // Registers of the join predicate, reused over all pairs
+  std::unique_ptr<expression::ExpressionProgram::Registers> registers;
+  if (predicate_program_ != nullptr) {
+    registers.reset(
+        new expression::ExpressionProgram::Registers(*predicate_program_));
+  }
+
   while ((left_end_row > left_start_row) && (right_end_row > right_start_row)) {
     expression::ContainerTuple<executor::LogicalTile> left_tuple(
         left_tile, left_start_row);
@@ -172,9 +181,10 @@ bool MergeJoinExecutor::DExecute() {
     LOG_TRACE("one pair of tuples matches join clause ");
 
     // Join predicate exists
-    if (predicate_ != nullptr) {
-      if (predicate_->Evaluate(&left_tuple, &right_tuple, executor_context_)
-              .IsFalse()) {
+    if (predicate_program_ != nullptr) {
+      predicate_program_->Run(*registers, &left_tuple, &right_tuple,
+                              executor_context_);
+      if (predicate_program_->GetResult(*registers, 0).IsFalse()) {
         // Join predicate is false. Advance both.
         left_start_row = left_end_row;
         left_end_row = Advance(left_tile, left_start_row, true);
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <memory>
 #include <vector>
 #include <unordered_set>
 
@@ -18,6 +19,7 @@
 #include "backend/executor/nested_loop_join_executor.h"
 #include "backend/expression/abstract_expression.h"
 #include "backend/expression/container_tuple.h"
+#include "backend/expression/expression_program.h"
 
 namespace peloton {
 namespace executor {
@@ -147,21 +149,29 @@ bool NestedLoopJoinExecutor::DExecute() {
     // Build position lists
     LogicalTile::PositionListsBuilder pos_lists_builder(left_tile, right_tile);
 
+    // Registers of the join predicate, reused over all pairs
+    std::unique_ptr<expression::ExpressionProgram::Registers> registers;
+    if (predicate_program_ != nullptr) {
+      registers.reset(
+          new expression::ExpressionProgram::Registers(*predicate_program_));
+    }
+
     // Go over every pair of tuples in left and right logical tiles
     for (auto left_tile_row_itr : *left_tile) {
       bool has_right_match = false;
 
       for (auto right_tile_row_itr : *right_tile) {
         // Join predicate exists
-        if (predicate_ != nullptr) {
+        if (predicate_program_ != nullptr) {
           expression::ContainerTuple<executor::LogicalTile> left_tuple(
               left_tile, left_tile_row_itr);
           expression::ContainerTuple<executor::LogicalTile> right_tuple(
               right_tile, right_tile_row_itr);
 
           // Join predicate is false. Skip pair and continue.
-          if (predicate_->Evaluate(&left_tuple, &right_tuple, executor_context_)
-                  .IsFalse()) {
+          predicate_program_->Run(*registers, &left_tuple, &right_tuple,
+                                  executor_context_);
+          if (predicate_program_->GetResult(*registers, 0).IsFalse()) {
             continue;
           }
         }
@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
 #include "backend/common/logger.h"
 #include "backend/common/pool.h"
 #include "backend/executor/logical_tile.h"
@@ -123,26 +125,6 @@ bool OrderByExecutor::DoSort() {
   sort_key_tuple_schema_.reset(new catalog::Schema(sort_key_columns));
   auto executor_pool = executor_context_->GetExecutorContextPool();
 
-  // Extract all valid tuples into a single std::vector (the sort buffer)
-  sort_buffer_.reserve(count);
-  for (oid_t tile_id = 0; tile_id < input_tiles_.size(); tile_id++) {
-    for (oid_t tuple_id : *input_tiles_[tile_id]) {
-      // Extract the sort key tuple
-      std::unique_ptr<storage::Tuple> tuple(
-          new storage::Tuple(sort_key_tuple_schema_.get(), true));
-      for (oid_t id = 0; id < node.GetSortKeys().size(); id++) {
-        tuple->SetValue(id, input_tiles_[tile_id]->GetValue(
-                                tuple_id, node.GetSortKeys()[id]),
-                        executor_pool);
-      }
-      // Inert the sort key tuple into sort buffer
-      sort_buffer_.emplace_back(sort_buffer_entry_t(
-          ItemPointer(tile_id, tuple_id), std::move(tuple)));
-    }
-  }
-
-  assert(count == sort_buffer_.size());
-
   // Prepare the compare function
   // Note: This is a less-than comparer, NOT an equality comparer.
   struct TupleComparer {
@@ -177,12 +159,64 @@ bool OrderByExecutor::DoSort() {
 
   TupleComparer comp(descend_flags_);
 
-  // Finally ... sort it !
-  std::sort(
-      sort_buffer_.begin(), sort_buffer_.end(),
+  auto entry_comp =
       [&comp](const sort_buffer_entry_t &a, const sort_buffer_entry_t &b) {
         return comp(a.tuple.get(), b.tuple.get());
-      });
+      };
+
+  // If the parent consumes fewer tuples than we have, only keep the top N
+  // in a bounded max-heap instead of sorting everything
+  const bool top_n = (limit_hint_ < count);
+
+  // Extract all valid tuples into a single std::vector (the sort buffer)
+  sort_buffer_.reserve(top_n ? limit_hint_ + 1 : count);
+  for (oid_t tile_id = 0; tile_id < input_tiles_.size(); tile_id++) {
+    for (oid_t tuple_id : *input_tiles_[tile_id]) {
+      // Extract the sort key tuple
+      std::unique_ptr<storage::Tuple> tuple(
+          new storage::Tuple(sort_key_tuple_schema_.get(), true));
+      for (oid_t id = 0; id < node.GetSortKeys().size(); id++) {
+        tuple->SetValue(id, input_tiles_[tile_id]->GetValue(
+                                tuple_id, node.GetSortKeys()[id]),
+                        executor_pool);
+      }
+
+      // Skip tuples that can't make it into a full top N heap
+      if (top_n && sort_buffer_.size() == limit_hint_) {
+        if (limit_hint_ == 0 ||
+            !comp(tuple.get(), sort_buffer_.front().tuple.get())) {
+          continue;
+        }
+      }
+
+      // Inert the sort key tuple into sort buffer
+      sort_buffer_.emplace_back(sort_buffer_entry_t(
+          ItemPointer(tile_id, tuple_id), std::move(tuple)));
+
+      if (top_n) {
+        std::push_heap(sort_buffer_.begin(), sort_buffer_.end(), entry_comp);
+
+        // Evict the largest one
+        if (sort_buffer_.size() > limit_hint_) {
+          std::pop_heap(sort_buffer_.begin(), sort_buffer_.end(), entry_comp);
+          sort_buffer_.pop_back();
+        }
+      }
+    }
+  }
+
+  assert(sort_buffer_.size() == std::min(count, limit_hint_));
+
+  UpdatePeakMemoryUsage(sort_buffer_.capacity() * sizeof(sort_buffer_entry_t) +
+                        sort_buffer_.size() *
+                            sort_key_tuple_schema_->GetLength());
+
+  // Finally ... sort it !
+  if (top_n) {
+    std::sort_heap(sort_buffer_.begin(), sort_buffer_.end(), entry_comp);
+  } else {
+    std::sort(sort_buffer_.begin(), sort_buffer_.end(), entry_comp);
+  }
 
   sort_done_ = true;
 
@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// pipeline.h
+//
+// Identification: src/backend/executor/pipeline.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "backend/common/abstract_tuple.h"
+#include "backend/common/exception.h"
+#include "backend/common/types.h"
+#include "backend/storage/tile.h"
+#include "backend/storage/tile_group.h"
+
+namespace peloton {
+namespace executor {
+
+//===--------------------------------------------------------------------===//
+// Pipeline
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Operator fused on top of a scan.
+ *
+ * Instead of pulling logical tiles out of its child, a consumer is pushed
+ * every scanned tile group along with the offsets of its qualifying tuples,
+ * so nothing is materialized between the scan and the consumer.
+ */
+class TileGroupConsumer {
+ public:
+  virtual ~TileGroupConsumer() {}
+
+  // Returns false to stop the scan
+  virtual bool Consume(storage::TileGroup *tile_group,
+                       const std::vector<oid_t> &tuple_offsets) = 0;
+};
+
+/**
+ * @brief A tuple of a tile group, seen through the columns picked by a scan.
+ *
+ * Column i of the tuple is the scan's i-th column, as it would be in the
+ * logical tile built by the scan. Values are read straight off the tile
+ * group's column accessors. The same tuple is moved along the tile group.
+ */
+class ScanTuple : public AbstractTuple {
+ public:
+  ScanTuple(const std::vector<oid_t> &column_ids)
+      : column_ids_(column_ids), accessors_(column_ids.size(), nullptr) {}
+
+  // Point the tuple to another tile group
+  void SetTileGroup(storage::TileGroup *tile_group) {
+    for (oid_t column_itr = 0; column_itr < column_ids_.size(); column_itr++) {
+      accessors_[column_itr] =
+          &tile_group->GetColumnAccessor(column_ids_[column_itr]);
+    }
+  }
+
+  void SetTupleId(oid_t tuple_id) { tuple_id_ = tuple_id; }
+
+  Value GetValue(oid_t column_id) const override {
+    return accessors_[column_id]->GetValue(tuple_id_);
+  }
+
+  char *GetData() const override {
+    throw NotImplementedException("GetData() not supported for scan tuples.");
+    return nullptr;
+  }
+
+  size_t GetColumnCount() const { return column_ids_.size(); }
+
+ private:
+  const std::vector<oid_t> column_ids_;
+
+  std::vector<const storage::ColumnAccessor *> accessors_;
+
+  oid_t tuple_id_ = INVALID_OID;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -12,12 +12,15 @@
 
 #include "backend/executor/projection_executor.h"
 
+#include <numeric>
+
 #include "backend/planner/projection_plan.h"
 #include "backend/common/logger.h"
 #include "backend/common/types.h"
 #include "backend/executor/logical_tile.h"
 #include "backend/executor/logical_tile_factory.h"
 #include "backend/expression/container_tuple.h"
+#include "backend/expression/expression_program.h"
 #include "backend/storage/tile.h"
 #include "backend/storage/data_table.h"
 
@@ -44,12 +47,50 @@ bool ProjectionExecutor::DInit() {
   this->project_info_ = node.GetProjectInfo();
   this->schema_ = node.GetSchema();
 
+  // Directly mapped columns are passed through from the child
+  source_column_ids_.assign(schema_->GetColumnCount(), INVALID_OID);
+  for (auto &direct_map : project_info_->GetDirectMapList()) {
+    assert(direct_map.second.first == 0);
+    source_column_ids_[direct_map.first] = direct_map.second.second;
+  }
+
+  // The other ones are computed into a new physical tile
+  std::vector<oid_t> computed_column_ids;
+  std::vector<oid_t> computed_column_offsets(schema_->GetColumnCount(),
+                                            INVALID_OID);
+  for (oid_t column_itr = 0; column_itr < source_column_ids_.size();
+       column_itr++) {
+    if (source_column_ids_[column_itr] == INVALID_OID) {
+      computed_column_offsets[column_itr] = computed_column_ids.size();
+      computed_column_ids.push_back(column_itr);
+    }
+  }
+
+  computed_schema_.reset();
+  target_slots_.clear();
+  if (computed_column_ids.empty()) return true;
+
+  computed_schema_.reset(
+      catalog::Schema::CopySchema(schema_, computed_column_ids));
+
+  for (auto &target : project_info_->GetTargetList()) {
+    TargetSlot slot;
+    slot.column_id = computed_column_offsets[target.first];
+    assert(slot.column_id != INVALID_OID);
+    slot.column_type = computed_schema_->GetType(slot.column_id);
+    slot.column_offset = computed_schema_->GetOffset(slot.column_id);
+    slot.column_length = computed_schema_->GetAppropriateLength(slot.column_id);
+    slot.is_inlined = computed_schema_->IsInlined(slot.column_id);
+    target_slots_.push_back(slot);
+  }
+
   return true;
 }
 
 /**
  * @brief Create projected tuples based on one or two input.
- * Newly-created physical tiles are needed.
+ * Directly mapped columns keep pointing to the child's base tiles, only the
+ * computed columns go to a new physical tile.
  *
  * @return true on success, false otherwise.
  */
@@ -68,29 +109,65 @@ bool ProjectionExecutor::DExecute() {
 
     // Get input from child
     std::unique_ptr<LogicalTile> source_tile(children_[0]->GetOutput());
-    auto num_tuples = source_tile->GetTupleCount();
-
-    // Create new physical tile where we store projected tuples
-    std::shared_ptr<storage::Tile> dest_tile(
-        storage::TileFactory::GetTempTile(*schema_, num_tuples));
 
-    // Create projections tuple-at-a-time from original tile
-    oid_t new_tuple_id = 0;
+    // Output rows are the visible rows of the source tile
+    std::vector<oid_t> source_rows;
+    source_rows.reserve(source_tile->GetTupleCount());
     for (oid_t old_tuple_id : *source_tile) {
-      storage::Tuple *buffer = new storage::Tuple(schema_, true);
-      expression::ContainerTuple<LogicalTile> tuple(source_tile.get(),
-                                                    old_tuple_id);
-      project_info_->Evaluate(buffer, &tuple, nullptr, executor_context_);
-
-      // Insert projected tuple into the new tile
-      dest_tile.get()->InsertTuple(new_tuple_id, buffer);
+      source_rows.push_back(old_tuple_id);
+    }
+    auto num_tuples = source_rows.size();
+
+    std::unique_ptr<LogicalTile> output_tile(LogicalTileFactory::GetTile());
+
+    // Create new physical tile where we store computed columns
+    std::shared_ptr<storage::Tile> computed_tile;
+    oid_t computed_position_list_idx = INVALID_OID;
+    if (computed_schema_ != nullptr) {
+      computed_tile.reset(
+          storage::TileFactory::GetTempTile(*computed_schema_, num_tuples));
+      EvaluateTargets(source_tile.get(), source_rows, computed_tile.get());
+
+      LogicalTile::PositionList position_list(num_tuples);
+      std::iota(position_list.begin(), position_list.end(), 0);
+      computed_position_list_idx =
+          output_tile->AddPositionList(std::move(position_list));
+    }
 
-      delete buffer;
-      new_tuple_id++;
+    // Source position lists, restricted to the visible rows, are added as
+    // the direct maps need them
+    std::vector<oid_t> position_list_idxs(
+        source_tile->GetPositionLists().size(), INVALID_OID);
+    oid_t computed_column_id = 0;
+
+    for (auto source_column_id : source_column_ids_) {
+      if (source_column_id == INVALID_OID) {
+        output_tile->AddColumn(computed_tile, computed_column_id++,
+                               computed_position_list_idx);
+        continue;
+      }
+
+      auto &column_info = source_tile->GetColumnInfo(source_column_id);
+      auto &position_list_idx =
+          position_list_idxs[column_info.position_list_idx];
+
+      if (position_list_idx == INVALID_OID) {
+        auto &source_list =
+            source_tile->GetPositionList(column_info.position_list_idx);
+        LogicalTile::PositionList position_list;
+        position_list.reserve(num_tuples);
+        for (auto source_row : source_rows) {
+          position_list.push_back(source_list[source_row]);
+        }
+        position_list_idx =
+            output_tile->AddPositionList(std::move(position_list));
+      }
+
+      output_tile->AddColumn(column_info.base_tile,
+                             column_info.origin_column_id, position_list_idx);
     }
 
-    // Wrap physical tile in logical tile and return it
-    SetOutput(LogicalTileFactory::WrapTiles({dest_tile}));
+    SetOutput(output_tile.release());
 
     return true;
   }
@@ -98,5 +175,42 @@ bool ProjectionExecutor::DExecute() {
   return false;
 }
 
+/**
+ * @brief Evaluate the target list over the given rows of the source tile,
+ * writing the values straight into the tile of computed columns.
+ */
+void ProjectionExecutor::EvaluateTargets(LogicalTile *source_tile,
+                                         const std::vector<oid_t> &source_rows,
+                                         storage::Tile *dest_tile) {
+  auto program = project_info_->GetTargetProgram();
+  if (program == nullptr) return;
+
+  // The registers are set up once for the whole tile
+  expression::ExpressionProgram::Registers registers(*program);
+
+  for (oid_t new_tuple_id = 0; new_tuple_id < source_rows.size();
+       new_tuple_id++) {
+    expression::ContainerTuple<LogicalTile> tuple(source_tile,
+                                                  source_rows[new_tuple_id]);
+    program->Run(registers, &tuple, nullptr, executor_context_);
+
+    for (oid_t target_itr = 0; target_itr < target_slots_.size();
+         target_itr++) {
+      auto &slot = target_slots_[target_itr];
+      auto &value = program->GetResult(registers, target_itr);
+
+      // Arithmetic may promote the value past the column's type
+      if (value.GetValueType() == slot.column_type) {
+        dest_tile->SetValueFast(value, new_tuple_id, slot.column_offset,
+                                slot.is_inlined, slot.column_length);
+      } else {
+        dest_tile->SetValueFast(value.CastAs(slot.column_type), new_tuple_id,
+                                slot.column_offset, slot.is_inlined,
+                                slot.column_length);
+      }
+    }
+  }
+}
+
 } /* namespace executor */
 } /* namespace peloton */
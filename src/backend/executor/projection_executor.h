@@ -12,10 +12,18 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "backend/executor/abstract_executor.h"
 #include "backend/planner/project_info.h"
 
 namespace peloton {
+
+namespace storage {
+class Tile;
+}
+
 namespace executor {
 
 class ProjectionExecutor : public AbstractExecutor {
@@ -33,7 +41,23 @@ class ProjectionExecutor : public AbstractExecutor {
 
   bool DExecute();
 
+  // One output tuple per input tuple, so the limit carries over
+  size_t GetChildLimitHint() { return limit_hint_; }
+
  private:
+  // Where a target is written in the tile of computed columns
+  struct TargetSlot {
+    oid_t column_id;
+    ValueType column_type;
+    size_t column_offset;
+    size_t column_length;
+    bool is_inlined;
+  };
+
+  void EvaluateTargets(LogicalTile *source_tile,
+                       const std::vector<oid_t> &source_rows,
+                       storage::Tile *dest_tile);
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -43,6 +67,16 @@ class ProjectionExecutor : public AbstractExecutor {
 
   /** @brief Schema of projected tuples. */
   const catalog::Schema *schema_ = nullptr;
+
+  /** @brief Source column of each output column, INVALID_OID unless it is
+   * directly mapped. */
+  std::vector<oid_t> source_column_ids_;
+
+  /** @brief Schema of the output columns that are not directly mapped. */
+  std::unique_ptr<catalog::Schema> computed_schema_;
+
+  /** @brief Slot of each target in the tile of computed columns. */
+  std::vector<TargetSlot> target_slots_;
 };
 
 } /* namespace executor */
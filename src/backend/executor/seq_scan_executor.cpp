@@ -22,9 +22,13 @@
 #include "backend/executor/executor_context.h"
 #include "backend/expression/abstract_expression.h"
 #include "backend/expression/container_tuple.h"
+#include "backend/expression/expression_program.h"
+#include "backend/expression/tuple_value_expression.h"
 #include "backend/storage/data_table.h"
+#include "backend/storage/eviction_manager.h"
 #include "backend/storage/tile_group_header.h"
 #include "backend/storage/tile.h"
+#include "backend/storage/zone_map.h"
 #include "backend/common/logger.h"
 
 namespace peloton {
@@ -53,6 +57,7 @@ bool SeqScanExecutor::DInit() {
   target_table_ = node.GetTable();
 
   current_tile_group_offset_ = START_OID;
+  num_tuples_returned_ = 0;
 
   if (target_table_ != nullptr) {
     table_tile_group_count_ = target_table_->GetTileGroupCount();
@@ -79,15 +84,18 @@ bool SeqScanExecutor::DExecute() {
     assert(target_table_ == nullptr);
     assert(column_ids_.size() == 0);
 
-    while (children_[0]->Execute()) {
+    while (num_tuples_returned_ < limit_hint_ && children_[0]->Execute()) {
       std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
 
-      if (predicate_ != nullptr) {
+      if (predicate_program_ != nullptr) {
         // Invalidate tuples that don't satisfy the predicate.
+        expression::ExpressionProgram::Registers registers(
+            *predicate_program_);
         for (oid_t tuple_id : *tile) {
           expression::ContainerTuple<LogicalTile> tuple(tile.get(), tuple_id);
-          if (predicate_->Evaluate(&tuple, nullptr, executor_context_)
-                  .IsFalse()) {
+          predicate_program_->Run(registers, &tuple, nullptr,
+                                  executor_context_);
+          if (predicate_program_->GetResult(registers, 0).IsFalse()) {
             tile->RemoveVisibility(tuple_id);
           }
         }
@@ -97,6 +105,8 @@ bool SeqScanExecutor::DExecute() {
         continue;
       }
 
+      num_tuples_returned_ += tile->GetTupleCount();
+
       /* Hopefully we needn't do projections here */
       SetOutput(tile.release());
       return true;
@@ -111,53 +121,146 @@ bool SeqScanExecutor::DExecute() {
     assert(target_table_ != nullptr);
     assert(column_ids_.size() > 0);
 
-    // Retrieve next tile group.
-    while (current_tile_group_offset_ < table_tile_group_count_) {
-      auto tile_group =
-          target_table_->GetTileGroup(current_tile_group_offset_++);
+    // Retrieve next tile group, unless the parent has all it needs
+    std::shared_ptr<storage::TileGroup> tile_group;
+    std::vector<oid_t> position_list;
+    while (num_tuples_returned_ < limit_hint_ &&
+           ScanNextTileGroup(tile_group, position_list,
+                             limit_hint_ - num_tuples_returned_)) {
+      // Construct logical tile.
+      std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
+      logical_tile->AddColumns(tile_group, column_ids_);
+      logical_tile->AddPositionList(std::move(position_list));
 
-      storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
+      num_tuples_returned_ += logical_tile->GetTupleCount();
 
-      auto transaction_ = executor_context_->GetTransaction();
-      txn_id_t txn_id = transaction_->GetTransactionId();
-      cid_t commit_id = transaction_->GetLastCommitId();
-      oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+      SetOutput(logical_tile.release());
+      return true;
+    }
+  }
 
-      // Print tile group visibility
-      // tile_group_header->PrintVisibility(txn_id, commit_id);
+  return false;
+}
 
-      // Construct logical tile.
-      std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
-      logical_tile->AddColumns(tile_group, column_ids_);
+/**
+ * @brief Push the rest of the table scan into the consumer, one tile group
+ * at a time, without building logical tiles.
+ * @return false if the consumer stopped the scan, true otherwise.
+ */
+bool SeqScanExecutor::ExecutePipeline(TileGroupConsumer &consumer) {
+  assert(IsPipelineable());
+
+  // The parent never calls Execute(), so keep the stats here, one call per
+  // tile group as if it had pulled them as logical tiles. The times include
+  // the consumer's work, like the parent's times include its children's.
+  return ExecuteTimed([this, &consumer]() {
+    std::shared_ptr<storage::TileGroup> tile_group;
+    std::vector<oid_t> position_list;
+    while (ScanNextTileGroup(tile_group, position_list, NO_LIMIT_HINT)) {
+      num_tuples_returned_ += position_list.size();
+      RecordPipelinedCall(true, position_list.size());
+
+      if (consumer.Consume(tile_group.get(), position_list) == false) {
+        return false;
+      }
+    }
 
-      // Construct position list by looping through tile group
-      // and applying the predicate.
-      std::vector<oid_t> position_list;
-      for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
-        if (tile_group_header->IsVisible(tuple_id, txn_id, commit_id) ==
-            false) {
-          continue;
-        }
+    // The call that finds the table exhausted
+    RecordPipelinedCall(false, 0);
+    return true;
+  });
+}
 
-        expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
-                                                             tuple_id);
-        if (predicate_ == nullptr) {
-          position_list.push_back(tuple_id);
-        } else {
-          auto eval =
-              predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
-          if (eval == true) position_list.push_back(tuple_id);
-        }
+/**
+ * @brief Find the next tile group with qualifying tuples.
+ * Zone maps, tuple visibility and the predicate are checked here.
+ * @param max_tuple_count Upper bound on the # of positions to return.
+ * @return false once the table is exhausted.
+ */
+bool SeqScanExecutor::ScanNextTileGroup(
+    std::shared_ptr<storage::TileGroup> &tile_group,
+    std::vector<oid_t> &position_list, size_t max_tuple_count) {
+  auto transaction_ = executor_context_->GetTransaction();
+  txn_id_t txn_id;
+  cid_t commit_id;
+  GetSnapshot(txn_id, commit_id);
+
+  // The past is not validated
+  bool optimistic = transaction_->IsOptimistic() && IsTimeTravel() == false;
+
+  // Serializable transactions read the whole table, including the tuples
+  // inserted later in the tile groups skipped here
+  if (current_tile_group_offset_ == START_OID &&
+      transaction_->IsSerializable() && IsTimeTravel() == false) {
+    transaction_->RecordTableRead(target_table_->GetOid());
+  }
+
+  while (current_tile_group_offset_ < table_tile_group_count_) {
+    // Start fetching the next tile group if it was evicted,
+    // while we work on this one
+    if (storage::EvictionManager::HasEvictedTileGroups() &&
+        current_tile_group_offset_ + 1 < table_tile_group_count_) {
+      storage::EvictionManager::GetInstance().Prefetch(
+          target_table_->GetTileGroupId(current_tile_group_offset_ + 1));
+    }
+
+    tile_group = target_table_->GetTileGroup(current_tile_group_offset_++);
+
+    // Skip the tile group if its zone map rules out the predicate
+    if (predicate_ != nullptr &&
+        CanSkipTileGroup(predicate_, tile_group->GetZoneMap())) {
+      LOG_TRACE("Skipping tile group %lu", tile_group->GetTileGroupId());
+      continue;
+    }
+
+    storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
+    oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+    oid_t tile_group_id = tile_group->GetTileGroupId();
+
+    // Print tile group visibility
+    // tile_group_header->PrintVisibility(txn_id, commit_id);
+
+    // Construct position list by looping through tile group,
+    // and apply the predicate over the visible tuples at once.
+    position_list.clear();
+    for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+      // Stop early once the limit is met
+      if (predicate_program_ == nullptr &&
+          position_list.size() >= max_tuple_count) {
+        break;
       }
 
-      logical_tile->AddPositionList(std::move(position_list));
+      if (tile_group_header->IsVisible(tuple_id, txn_id, commit_id) ==
+          false) {
+        continue;
+      }
 
-      // Don't return empty tiles
-      if (0 == logical_tile->GetTupleCount()) {
+      // Optimistic transactions only apply their deletes at commit
+      if (optimistic &&
+          transaction_->IsOwnDelete(ItemPointer(tile_group_id, tuple_id))) {
         continue;
       }
 
-      SetOutput(logical_tile.release());
+      position_list.push_back(tuple_id);
+    }
+
+    // and validate every tuple the predicate looked at, as an update could
+    // make one it rejected match
+    if (optimistic) {
+      transaction_->RecordReads(tile_group_id, position_list);
+    }
+
+    if (predicate_program_ != nullptr) {
+      predicate_program_->Filter(tile_group.get(), position_list,
+                                 executor_context_);
+
+      if (position_list.size() > max_tuple_count) {
+        position_list.resize(max_tuple_count);
+      }
+    }
+
+    // Don't return empty tile groups
+    if (position_list.empty() == false) {
       return true;
     }
   }
@@ -165,5 +268,89 @@ bool SeqScanExecutor::DExecute() {
   return false;
 }
 
+/**
+ * @brief Swap the sides of a comparison, e.g. (c < x) -> (x > c).
+ */
+static ExpressionType CommuteComparison(ExpressionType comparison_type) {
+  switch (comparison_type) {
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+      return EXPRESSION_TYPE_COMPARE_GREATERTHAN;
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+      return EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+      return EXPRESSION_TYPE_COMPARE_LESSTHAN;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      return EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO;
+    default:
+      return comparison_type;
+  }
+}
+
+static bool IsColumnReference(const expression::AbstractExpression *expr) {
+  return (expr != nullptr &&
+          expr->GetExpressionType() == EXPRESSION_TYPE_VALUE_TUPLE &&
+          static_cast<const expression::TupleValueExpression *>(expr)
+                  ->GetTupleIdx() == 0);
+}
+
+static bool IsScanConstant(const expression::AbstractExpression *expr) {
+  return (expr != nullptr &&
+          (expr->GetExpressionType() == EXPRESSION_TYPE_VALUE_CONSTANT ||
+           expr->GetExpressionType() == EXPRESSION_TYPE_VALUE_PARAMETER));
+}
+
+/**
+ * @brief Checks the predicate against the tile group's zone map.
+ * Only conjunctions/disjunctions of comparisons between a column and a
+ * constant (or parameter) are considered.
+ * @return true if no tuple in the tile group can satisfy the predicate.
+ */
+bool SeqScanExecutor::CanSkipTileGroup(
+    const expression::AbstractExpression *expression,
+    storage::ZoneMap *zone_map) {
+  if (expression == nullptr || zone_map == nullptr) return false;
+
+  auto expression_type = expression->GetExpressionType();
+
+  switch (expression_type) {
+    case EXPRESSION_TYPE_CONJUNCTION_AND:
+      return CanSkipTileGroup(expression->GetLeft(), zone_map) ||
+             CanSkipTileGroup(expression->GetRight(), zone_map);
+
+    case EXPRESSION_TYPE_CONJUNCTION_OR:
+      return CanSkipTileGroup(expression->GetLeft(), zone_map) &&
+             CanSkipTileGroup(expression->GetRight(), zone_map);
+
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO: {
+      auto column_side = expression->GetLeft();
+      auto constant_side = expression->GetRight();
+
+      // Normalize to (column <op> constant)
+      if (IsColumnReference(constant_side) && IsScanConstant(column_side)) {
+        std::swap(column_side, constant_side);
+        expression_type = CommuteComparison(expression_type);
+      }
+
+      if (!IsColumnReference(column_side) || !IsScanConstant(constant_side)) {
+        return false;
+      }
+
+      auto column_id =
+          static_cast<const expression::TupleValueExpression *>(column_side)
+              ->GetColumnId();
+      auto value = constant_side->Evaluate(nullptr, nullptr, executor_context_);
+
+      return zone_map->CanSkip(column_id, expression_type, value);
+    }
+
+    default:
+      return false;
+  }
+}
+
 }  // namespace executor
 }  // namespace peloton
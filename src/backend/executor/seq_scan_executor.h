@@ -14,8 +14,14 @@
 
 #include "backend/planner/seq_scan_plan.h"
 #include "backend/executor/abstract_scan_executor.h"
+#include "backend/executor/pipeline.h"
 
 namespace peloton {
+
+namespace storage {
+class ZoneMap;
+}
+
 namespace executor {
 
 class SeqScanExecutor : public AbstractScanExecutor {
@@ -28,12 +34,29 @@ class SeqScanExecutor : public AbstractScanExecutor {
   explicit SeqScanExecutor(const planner::AbstractPlan *node,
                            ExecutorContext *executor_context);
 
+  // Can the scan be fused with its parent ? Only table scans are.
+  bool IsPipelineable() const {
+    return children_.size() == 0 && target_table_ != nullptr;
+  }
+
+  bool ExecutePipeline(TileGroupConsumer &consumer);
+
+  // Table columns that make up the scan's output
+  const std::vector<oid_t> &GetColumnIds() const { return column_ids_; }
+
  protected:
   bool DInit();
 
   bool DExecute();
 
  private:
+  bool ScanNextTileGroup(std::shared_ptr<storage::TileGroup> &tile_group,
+                         std::vector<oid_t> &position_list,
+                         size_t max_tuple_count);
+
+  bool CanSkipTileGroup(const expression::AbstractExpression *expression,
+                        storage::ZoneMap *zone_map);
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -44,6 +67,9 @@ class SeqScanExecutor : public AbstractScanExecutor {
   /** @brief Keeps track of the number of tile groups to scan. */
   oid_t table_tile_group_count_ = INVALID_OID;
 
+  /** @brief Number of tuples returned so far, checked against limit hint. */
+  size_t num_tuples_returned_ = 0;
+
   //===--------------------------------------------------------------------===//
   // Plan Info
   //===--------------------------------------------------------------------===//
@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// spill_file.cpp
+//
+// Identification: src/backend/executor/spill_file.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <memory>
+
+#include "backend/common/exception.h"
+#include "backend/common/logger.h"
+#include "backend/executor/logical_tile.h"
+#include "backend/executor/logical_tile_factory.h"
+#include "backend/executor/spill_file.h"
+#include "backend/storage/tile.h"
+#include "backend/storage/tuple.h"
+
+namespace peloton {
+namespace executor {
+
+SpillFile::~SpillFile() {
+  if (file != nullptr) {
+    fclose(file);
+  }
+}
+
+void SpillFile::Append(const AbstractTuple &tuple, oid_t column_count) {
+  assert(rewound == false);
+
+  // Same layout as storage::Tuple::SerializeTo()
+  size_t start = output.ReserveBytes(sizeof(int32_t));
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    tuple.GetValue(column_itr).SerializeTo(output);
+  }
+  output.WriteIntAt(start, static_cast<int32_t>(output.Position() - start -
+                                                sizeof(int32_t)));
+
+  tuple_count++;
+
+  if (output.Size() >= SPILL_FILE_BUFFER_SIZE) {
+    Flush();
+  }
+}
+
+void SpillFile::Flush() {
+  if (output.Size() == 0) return;
+
+  if (file == nullptr) {
+    file = tmpfile();
+    if (file == nullptr) {
+      throw ExecutorException("Could not create spill file : " +
+                              std::string(strerror(errno)));
+    }
+  }
+
+  size_t ret = fwrite(output.Data(), 1, output.Size(), file);
+  if (ret != output.Size()) {
+    throw ExecutorException("Could not write spill file : " +
+                            std::string(strerror(errno)));
+  }
+
+  size += output.Size();
+  output.Reset();
+}
+
+void SpillFile::Rewind() {
+  // Tuples that never left the buffer are read from there
+  if (file != nullptr) {
+    Flush();
+    if (fseek(file, 0, SEEK_SET) != 0) {
+      throw ExecutorException("Could not rewind spill file : " +
+                              std::string(strerror(errno)));
+    }
+  }
+
+  rewound = true;
+  read_tuple_count = 0;
+  read_offset = 0;
+}
+
+LogicalTile *SpillFile::ReadTile(const catalog::Schema &schema,
+                                 size_t max_tuple_count) {
+  assert(rewound == true);
+
+  size_t remaining_count = tuple_count - read_tuple_count;
+  if (remaining_count == 0) return nullptr;
+
+  size_t batch_count = std::min(remaining_count, max_tuple_count);
+  std::shared_ptr<storage::Tile> tile(
+      storage::TileFactory::GetTempTile(schema, batch_count));
+
+  for (oid_t tuple_itr = 0; tuple_itr < batch_count; tuple_itr++) {
+    const char *record_data;
+    size_t record_length;
+
+    if (file == nullptr) {
+      ReferenceSerializeInputBE length_input(output.Data() + read_offset,
+                                             sizeof(int32_t));
+      record_data = output.Data() + read_offset;
+      record_length = sizeof(int32_t) + length_input.ReadInt();
+      read_offset += record_length;
+    } else {
+      char length_data[sizeof(int32_t)];
+      if (fread(length_data, 1, sizeof(length_data), file) !=
+          sizeof(length_data)) {
+        throw ExecutorException("Could not read spill file");
+      }
+
+      ReferenceSerializeInputBE length_input(length_data, sizeof(int32_t));
+      record_length = sizeof(int32_t) + length_input.ReadInt();
+      record.resize(record_length);
+      std::memcpy(record.data(), length_data, sizeof(length_data));
+
+      size_t body_length = record_length - sizeof(int32_t);
+      if (fread(record.data() + sizeof(int32_t), 1, body_length, file) !=
+          body_length) {
+        throw ExecutorException("Could not read spill file");
+      }
+      record_data = record.data();
+    }
+
+    // Deserialize straight into the tile
+    ReferenceSerializeInputBE input(record_data, record_length);
+    storage::Tuple tuple(&schema, tile->GetTupleLocation(tuple_itr));
+    tuple.DeserializeFrom(input, tile->GetPool());
+  }
+
+  read_tuple_count += batch_count;
+
+  return LogicalTileFactory::WrapTiles({tile});
+}
+
+}  // namespace executor
+}  // namespace peloton
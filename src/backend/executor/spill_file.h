@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// spill_file.h
+//
+// Identification: src/backend/executor/spill_file.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdio>
+#include <vector>
+
+#include "backend/catalog/schema.h"
+#include "backend/common/abstract_tuple.h"
+#include "backend/common/serializer.h"
+#include "backend/common/types.h"
+
+namespace peloton {
+namespace executor {
+
+class LogicalTile;
+
+// Tuples are buffered in memory up to this size before hitting the file
+#define SPILL_FILE_BUFFER_SIZE (64 * 1024)
+
+//===--------------------------------------------------------------------===//
+// Spill File
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Temporary file of tuples, for operators running over their memory
+ * budget.
+ *
+ * Tuples are appended in the format of storage::Tuple::SerializeTo(), and
+ * read back in order once the file is rewound, a batch of them at a time
+ * as a logical tile over a new physical tile. The file is removed when the
+ * spill file is destroyed.
+ */
+class SpillFile {
+  SpillFile(SpillFile const &) = delete;
+  SpillFile &operator=(SpillFile const &) = delete;
+
+ public:
+  SpillFile() {}
+
+  ~SpillFile();
+
+  // Append the first column_count values of the tuple
+  void Append(const AbstractTuple &tuple, oid_t column_count);
+
+  // Start reading from the first tuple, no more tuples can be appended
+  void Rewind();
+
+  /**
+   * @brief Read the next tuples into a logical tile with the given schema,
+   * which must be the one of the appended tuples.
+   * @return nullptr once all the tuples were read.
+   */
+  LogicalTile *ReadTile(const catalog::Schema &schema, size_t max_tuple_count);
+
+  size_t GetTupleCount() const { return tuple_count; }
+
+  // # of bytes of serialized tuples
+  size_t GetSize() const { return size + output.Size(); }
+
+ private:
+  void Flush();
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  // created on the first flush
+  FILE *file = nullptr;
+
+  CopySerializeOutput output;
+
+  // holds the tuple being read
+  std::vector<char> record;
+
+  size_t tuple_count = 0;
+
+  size_t read_tuple_count = 0;
+
+  // next tuple in the buffer, when not using the file
+  size_t read_offset = 0;
+
+  size_t size = 0;
+
+  bool rewound = false;
+};
+
+}  // namespace executor
+}  // namespace peloton
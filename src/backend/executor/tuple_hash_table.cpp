@@ -0,0 +1,177 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// tuple_hash_table.cpp
+//
+// Identification: src/backend/executor/tuple_hash_table.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+
+#include "backend/common/value.h"
+#include "backend/executor/tuple_hash_table.h"
+#include "backend/storage/tuple.h"
+
+namespace peloton {
+namespace executor {
+
+TupleHashTable::TupleHashTable(const catalog::Schema *key_schema)
+    : key_schema(key_schema),
+      slots(TUPLE_HASH_TABLE_INITIAL_CAPACITY, Entry()) {
+  assert(key_schema != nullptr);
+
+  key_chunk_size = std::max<size_t>(TUPLE_HASH_TABLE_KEY_CHUNK_SIZE,
+                                    key_schema->GetLength());
+
+  if (key_schema->IsInlined() == false) {
+    key_pool.reset(new VarlenPool(BACKEND_TYPE_MM));
+  }
+}
+
+size_t TupleHashTable::Hash(const AbstractTuple &tuple, oid_t column_count) {
+  size_t hash = 0;
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    tuple.GetValue(column_itr).HashCombine(hash);
+  }
+
+  return MixHash(hash);
+}
+
+size_t TupleHashTable::Hash(const AbstractTuple &tuple,
+                            const std::vector<oid_t> &column_ids) {
+  size_t hash = 0;
+  for (auto column_id : column_ids) {
+    tuple.GetValue(column_id).HashCombine(hash);
+  }
+
+  return MixHash(hash);
+}
+
+size_t TupleHashTable::MixHash(size_t hash) {
+  // Mix the bits, as both the low and the high bits are used
+  uint64_t mixed = static_cast<uint64_t>(hash);
+  mixed ^= mixed >> 33;
+  mixed *= 0xff51afd7ed558ccdULL;
+  mixed ^= mixed >> 33;
+  mixed *= 0xc4ceb9fe1a85ec53ULL;
+  mixed ^= mixed >> 33;
+
+  return static_cast<size_t>(mixed);
+}
+
+bool TupleHashTable::KeyEquals(const char *key,
+                               const AbstractTuple &tuple) const {
+  storage::Tuple key_tuple(key_schema, const_cast<char *>(key));
+  oid_t column_count = key_schema->GetColumnCount();
+
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    // NULLs are not distinct from each other
+    if (key_tuple.GetValue(column_itr)
+            .Compare(tuple.GetValue(column_itr)) != VALUE_COMPARE_EQUAL)
+      return false;
+  }
+
+  return true;
+}
+
+TupleHashTable::Entry *TupleHashTable::Find(const AbstractTuple &tuple,
+                                            size_t hash) {
+  size_t mask = slots.size() - 1;
+
+  for (size_t slot_itr = hash & mask;; slot_itr = (slot_itr + 1) & mask) {
+    Entry &entry = slots[slot_itr];
+    if (entry.key == nullptr) return nullptr;
+
+    if (entry.hash == hash && KeyEquals(entry.key, tuple)) return &entry;
+  }
+}
+
+TupleHashTable::Entry *TupleHashTable::Insert(const AbstractTuple &tuple,
+                                              size_t hash) {
+  // Keep the load factor under 3/4
+  if ((size + 1) * 4 > slots.size() * 3) Grow();
+
+  // Copy the key
+  char *key = AllocateKey();
+  storage::Tuple key_tuple(key_schema, key);
+  oid_t column_count = key_schema->GetColumnCount();
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    key_tuple.SetValue(column_itr, tuple.GetValue(column_itr), key_pool.get());
+  }
+
+  size_t mask = slots.size() - 1;
+  size_t slot_itr = hash & mask;
+  while (slots[slot_itr].key != nullptr) {
+    slot_itr = (slot_itr + 1) & mask;
+  }
+
+  Entry &entry = slots[slot_itr];
+  entry.hash = hash;
+  entry.key = key;
+  entry.left_count = 0;
+  entry.right_count = 0;
+  size++;
+
+  return &entry;
+}
+
+char *TupleHashTable::AllocateKey() {
+  size_t key_length = key_schema->GetLength();
+
+  if (key_chunks.empty() || key_chunk_offset + key_length > key_chunk_size) {
+    key_chunks.emplace_back(new char[key_chunk_size]);
+    key_chunk_offset = 0;
+  }
+
+  char *key = key_chunks.back().get() + key_chunk_offset;
+  key_chunk_offset += key_length;
+
+  return key;
+}
+
+void TupleHashTable::Grow() {
+  std::vector<Entry> old_slots(slots.size() * 2, Entry());
+  old_slots.swap(slots);
+
+  // Rehashing only needs the stored hashes
+  size_t mask = slots.size() - 1;
+  for (auto &old_entry : old_slots) {
+    if (old_entry.key == nullptr) continue;
+
+    size_t slot_itr = old_entry.hash & mask;
+    while (slots[slot_itr].key != nullptr) {
+      slot_itr = (slot_itr + 1) & mask;
+    }
+    slots[slot_itr] = old_entry;
+  }
+}
+
+void TupleHashTable::Clear() {
+  std::vector<Entry>(TUPLE_HASH_TABLE_INITIAL_CAPACITY, Entry()).swap(slots);
+  size = 0;
+
+  key_chunks.clear();
+  key_chunk_offset = 0;
+
+  if (key_pool != nullptr) {
+    key_pool.reset(new VarlenPool(BACKEND_TYPE_MM));
+  }
+}
+
+size_t TupleHashTable::GetMemoryUsage() const {
+  size_t memory_usage = slots.size() * sizeof(Entry);
+  memory_usage += key_chunks.size() * key_chunk_size;
+
+  if (key_pool != nullptr) {
+    memory_usage += key_pool->GetAllocatedMemory();
+  }
+
+  return memory_usage;
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// tuple_hash_table.h
+//
+// Identification: src/backend/executor/tuple_hash_table.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "backend/catalog/schema.h"
+#include "backend/common/abstract_tuple.h"
+#include "backend/common/pool.h"
+#include "backend/common/types.h"
+
+namespace peloton {
+namespace executor {
+
+// Keys are copied into chunks of this size
+#define TUPLE_HASH_TABLE_KEY_CHUNK_SIZE (64 * 1024)
+
+#define TUPLE_HASH_TABLE_INITIAL_CAPACITY 1024
+
+// Spilled tuples are spread over 2^bits partitions at every level
+#define TUPLE_HASH_TABLE_PARTITION_BITS 4
+#define TUPLE_HASH_TABLE_PARTITION_COUNT (1 << TUPLE_HASH_TABLE_PARTITION_BITS)
+
+// Partitions deeper than this are processed in memory, whatever the budget
+#define TUPLE_HASH_TABLE_MAX_PARTITION_DEPTH 3
+
+//===--------------------------------------------------------------------===//
+// Tuple Hash Table
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Flat hash table of tuples, with a pair of counters per key.
+ *
+ * Entries live in a single open-addressing array probed linearly, and keep
+ * the hash of their key, so most mismatches are ruled out without looking
+ * at the key. Keys are copied into chunks owned by the table, so they don't
+ * pin the tiles they come from. Lookups take the hash computed by Hash(),
+ * which the caller computes once per tuple and reuses to pick a spill
+ * partition with GetPartition().
+ */
+class TupleHashTable {
+  TupleHashTable(TupleHashTable const &) = delete;
+  TupleHashTable &operator=(TupleHashTable const &) = delete;
+
+ public:
+  struct Entry {
+    size_t hash;
+
+    // key tuple, null in empty slots
+    char *key;
+
+    size_t left_count;
+
+    size_t right_count;
+  };
+
+  // The schema of the keys is not owned
+  TupleHashTable(const catalog::Schema *key_schema);
+
+  // Hash of the first column_count values of the tuple
+  static size_t Hash(const AbstractTuple &tuple, oid_t column_count);
+
+  // Hash of the values of the given columns of the tuple
+  static size_t Hash(const AbstractTuple &tuple,
+                     const std::vector<oid_t> &column_ids);
+
+  // Spill partition of a hash at the given partitioning depth
+  static inline oid_t GetPartition(size_t hash, size_t depth) {
+    // Partitions take the high bits, slots the low bits
+    size_t shift = (sizeof(size_t) * 8) -
+                   (depth + 1) * TUPLE_HASH_TABLE_PARTITION_BITS;
+    return (hash >> shift) & (TUPLE_HASH_TABLE_PARTITION_COUNT - 1);
+  }
+
+  // Returns null if the key is not in the table
+  Entry *Find(const AbstractTuple &tuple, size_t hash);
+
+  /**
+   * @brief Add a copy of the key, which must not be in the table yet,
+   * with both counters set to zero.
+   * The entry is valid until the next insertion.
+   */
+  Entry *Insert(const AbstractTuple &tuple, size_t hash);
+
+  void Clear();
+
+  size_t GetSize() const { return size; }
+
+  // # of bytes held by the slots and the keys
+  size_t GetMemoryUsage() const;
+
+ private:
+  static size_t MixHash(size_t hash);
+
+  bool KeyEquals(const char *key, const AbstractTuple &tuple) const;
+
+  char *AllocateKey();
+
+  void Grow();
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  const catalog::Schema *key_schema;
+
+  std::vector<Entry> slots;
+
+  size_t size = 0;
+
+  std::vector<std::unique_ptr<char[]>> key_chunks;
+
+  // next free byte in the last key chunk
+  size_t key_chunk_offset = 0;
+
+  size_t key_chunk_size;
+
+  // uninlined key values
+  std::unique_ptr<VarlenPool> key_pool;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,630 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// expression_program.cpp
+//
+// Identification: src/backend/expression/expression_program.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cassert>
+#include <new>
+#include <sstream>
+#include <unordered_map>
+
+#include "backend/common/exception.h"
+#include "backend/common/logger.h"
+#include "backend/common/value_peeker.h"
+#include "backend/expression/comparison_expression.h"
+#include "backend/expression/constant_value_expression.h"
+#include "backend/expression/expression_program.h"
+#include "backend/expression/parameter_value_expression.h"
+#include "backend/expression/tuple_value_expression.h"
+
+namespace peloton {
+namespace expression {
+
+//===--------------------------------------------------------------------===//
+// Compiler
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Builds the instructions of a program, one expression at a time.
+ *
+ * Every compiled subtree gets a key describing what it computes, and the
+ * key maps to the operand holding its value. The right side of AND and OR
+ * may not run, so it gets its own scope of keys, dropped once compiled.
+ */
+class ProgramCompiler {
+ public:
+  ProgramCompiler(ExpressionProgram &program) : program(program) {
+    scopes.emplace_back();
+  }
+
+  // Compile the subtree, returning the operand that holds its value
+  uint32_t Compile(const AbstractExpression *expression, std::string &key);
+
+ private:
+  static inline bool IsConstant(uint32_t operand) {
+    return (operand & PROGRAM_CONSTANT_OPERAND) != 0;
+  }
+
+  inline const Value &GetConstant(uint32_t operand) const {
+    return program.constants[operand & ~PROGRAM_CONSTANT_OPERAND];
+  }
+
+  uint32_t AddConstant(const Value &value, std::string &key);
+
+  // Append an instruction writing a new register
+  uint32_t Emit(ProgramOpcode opcode, const AbstractExpression *expression,
+                uint32_t left, uint32_t right = 0, oid_t argument = 0);
+
+  size_t Append(ProgramOpcode opcode, uint32_t destination, uint32_t left,
+                uint32_t right = 0, oid_t argument = 0);
+
+  // Evaluate a subtree over constants right away
+  bool Fold(const AbstractExpression *expression, uint32_t &operand,
+            std::string &key);
+
+  bool Lookup(const std::string &key, uint32_t &operand) const;
+
+  void Remember(const std::string &key, uint32_t operand) {
+    scopes.back()[key] = operand;
+  }
+
+  uint32_t CompileUnary(const AbstractExpression *expression,
+                        ProgramOpcode opcode, std::string &key);
+
+  uint32_t CompileBinary(const AbstractExpression *expression,
+                         ProgramOpcode opcode, std::string &key);
+
+  uint32_t CompileConjunction(const AbstractExpression *expression,
+                              std::string &key);
+
+  uint32_t CompileFallback(const AbstractExpression *expression,
+                           std::string &key);
+
+  ExpressionProgram &program;
+
+  std::vector<std::unordered_map<std::string, uint32_t>> scopes;
+};
+
+uint32_t ProgramCompiler::AddConstant(const Value &value, std::string &key) {
+  key = "K" + ValueTypeToString(value.GetValueType()) + ":" + value.Debug();
+
+  uint32_t operand;
+  if (Lookup(key, operand)) return operand;
+
+  operand = program.constants.size() | PROGRAM_CONSTANT_OPERAND;
+  program.constants.push_back(value);
+
+  // Constants hold on any branch
+  scopes.front()[key] = operand;
+  return operand;
+}
+
+uint32_t ProgramCompiler::Emit(ProgramOpcode opcode,
+                               const AbstractExpression *expression,
+                               uint32_t left, uint32_t right, oid_t argument) {
+  uint32_t destination = program.register_count++;
+  auto instruction_id = Append(opcode, destination, left, right, argument);
+
+  program.instructions[instruction_id].expression_type =
+      expression->GetExpressionType();
+  program.instructions[instruction_id].expression = expression;
+  return destination;
+}
+
+size_t ProgramCompiler::Append(ProgramOpcode opcode, uint32_t destination,
+                               uint32_t left, uint32_t right, oid_t argument) {
+  ProgramInstruction instruction;
+  instruction.opcode = opcode;
+  instruction.expression_type = EXPRESSION_TYPE_INVALID;
+  instruction.destination = destination;
+  instruction.left = left;
+  instruction.right = right;
+  instruction.argument = argument;
+  instruction.expression = nullptr;
+
+  program.instructions.push_back(instruction);
+  return program.instructions.size() - 1;
+}
+
+bool ProgramCompiler::Fold(const AbstractExpression *expression,
+                           uint32_t &operand, std::string &key) {
+  try {
+    Value value = expression->Evaluate(nullptr, nullptr, nullptr);
+    operand = AddConstant(value, key);
+    return true;
+  } catch (Exception &exception) {
+    // e.g. a division by zero, left to fail at run time
+    LOG_TRACE("Not folding expression : %s", exception.what());
+    return false;
+  }
+}
+
+bool ProgramCompiler::Lookup(const std::string &key, uint32_t &operand) const {
+  for (auto scope_itr = scopes.rbegin(); scope_itr != scopes.rend();
+       ++scope_itr) {
+    auto entry = scope_itr->find(key);
+    if (entry != scope_itr->end()) {
+      operand = entry->second;
+      return true;
+    }
+  }
+  return false;
+}
+
+uint32_t ProgramCompiler::Compile(const AbstractExpression *expression,
+                                  std::string &key) {
+  assert(expression != nullptr);
+  auto left = expression->GetLeft();
+  auto right = expression->GetRight();
+
+  switch (expression->GetExpressionType()) {
+    case EXPRESSION_TYPE_VALUE_CONSTANT:
+      if (dynamic_cast<const ConstantValueExpression *>(expression) == nullptr)
+        break;
+      return AddConstant(expression->Evaluate(nullptr, nullptr, nullptr), key);
+
+    case EXPRESSION_TYPE_VALUE_TUPLE: {
+      auto tuple_value = dynamic_cast<const TupleValueExpression *>(expression);
+      if (tuple_value == nullptr) break;
+
+      uint32_t tuple_idx = (tuple_value->GetTupleIdx() == 0) ? 0 : 1;
+      oid_t column_id = tuple_value->GetColumnId();
+      key = "T" + std::to_string(tuple_idx) + "." + std::to_string(column_id);
+
+      uint32_t operand;
+      if (Lookup(key, operand)) return operand;
+
+      operand = Emit(PROGRAM_OPCODE_LOAD_COLUMN, expression, tuple_idx, 0,
+                     column_id);
+      Remember(key, operand);
+      return operand;
+    }
+
+    case EXPRESSION_TYPE_VALUE_PARAMETER: {
+      auto parameter =
+          dynamic_cast<const ParameterValueExpression *>(expression);
+      if (parameter == nullptr) break;
+
+      key = "P" + std::to_string(parameter->GetParameterId());
+
+      uint32_t operand;
+      if (Lookup(key, operand)) return operand;
+
+      operand = Emit(PROGRAM_OPCODE_EVALUATE, expression, 0);
+      Remember(key, operand);
+      return operand;
+    }
+
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+    case EXPRESSION_TYPE_COMPARE_LIKE:
+      if (left == nullptr || right == nullptr) break;
+      return CompileBinary(expression, PROGRAM_OPCODE_COMPARE, key);
+
+    case EXPRESSION_TYPE_OPERATOR_PLUS:
+    case EXPRESSION_TYPE_OPERATOR_MINUS:
+    case EXPRESSION_TYPE_OPERATOR_MULTIPLY:
+    case EXPRESSION_TYPE_OPERATOR_DIVIDE:
+      if (left == nullptr || right == nullptr) break;
+      return CompileBinary(expression, PROGRAM_OPCODE_ARITHMETIC, key);
+
+    case EXPRESSION_TYPE_OPERATOR_NOT:
+      if (left == nullptr) break;
+      return CompileUnary(expression, PROGRAM_OPCODE_NOT, key);
+
+    case EXPRESSION_TYPE_OPERATOR_IS_NULL:
+      if (left == nullptr) break;
+      return CompileUnary(expression, PROGRAM_OPCODE_IS_NULL, key);
+
+    case EXPRESSION_TYPE_CONJUNCTION_AND:
+    case EXPRESSION_TYPE_CONJUNCTION_OR:
+      if (left == nullptr || right == nullptr) break;
+      return CompileConjunction(expression, key);
+
+    default:
+      break;
+  }
+
+  return CompileFallback(expression, key);
+}
+
+uint32_t ProgramCompiler::CompileUnary(const AbstractExpression *expression,
+                                       ProgramOpcode opcode,
+                                       std::string &key) {
+  std::string left_key;
+  uint32_t left = Compile(expression->GetLeft(), left_key);
+  key = std::to_string(expression->GetExpressionType()) + "(" + left_key + ")";
+
+  uint32_t operand;
+  if (IsConstant(left) && Fold(expression, operand, key)) return operand;
+  if (Lookup(key, operand)) return operand;
+
+  operand = Emit(opcode, expression, left);
+  Remember(key, operand);
+  return operand;
+}
+
+uint32_t ProgramCompiler::CompileBinary(const AbstractExpression *expression,
+                                        ProgramOpcode opcode,
+                                        std::string &key) {
+  std::string left_key, right_key;
+  uint32_t left = Compile(expression->GetLeft(), left_key);
+  uint32_t right = Compile(expression->GetRight(), right_key);
+  key = std::to_string(expression->GetExpressionType()) + "(" + left_key +
+        "," + right_key + ")";
+
+  uint32_t operand;
+  if (IsConstant(left) && IsConstant(right) &&
+      Fold(expression, operand, key))
+    return operand;
+  if (Lookup(key, operand)) return operand;
+
+  operand = Emit(opcode, expression, left, right);
+  Remember(key, operand);
+  return operand;
+}
+
+/**
+ * AND compiles to
+ *    dst = left
+ *    if dst is FALSE goto end
+ *    right
+ *    dst = dst AND right
+ *  end:
+ * and OR likewise, jumping when dst is TRUE.
+ */
+uint32_t ProgramCompiler::CompileConjunction(
+    const AbstractExpression *expression, std::string &key) {
+  bool is_and =
+      (expression->GetExpressionType() == EXPRESSION_TYPE_CONJUNCTION_AND);
+  std::string left_key, right_key;
+  uint32_t left = Compile(expression->GetLeft(), left_key);
+
+  // A constant left side either settles the conjunction, or leaves it to
+  // the right side
+  if (IsConstant(left) &&
+      GetConstant(left).GetValueType() == VALUE_TYPE_BOOLEAN) {
+    const Value &left_value = GetConstant(left);
+    if (is_and ? left_value.IsFalse() : left_value.IsTrue()) {
+      key = left_key;
+      return left;
+    }
+    if (is_and ? left_value.IsTrue() : left_value.IsFalse()) {
+      return Compile(expression->GetRight(), key);
+    }
+  }
+
+  auto instruction_count = program.instructions.size();
+  auto register_count = program.register_count;
+
+  uint32_t destination = program.register_count++;
+  Append(PROGRAM_OPCODE_MOVE, destination, left);
+  auto jump_opcode =
+      is_and ? PROGRAM_OPCODE_JUMP_IF_FALSE : PROGRAM_OPCODE_JUMP_IF_TRUE;
+  auto jump_id = Append(jump_opcode, 0, destination);
+
+  scopes.emplace_back();
+  uint32_t right = Compile(expression->GetRight(), right_key);
+  scopes.pop_back();
+
+  Append(is_and ? PROGRAM_OPCODE_AND : PROGRAM_OPCODE_OR, destination,
+         destination, right);
+  program.instructions[jump_id].argument = program.instructions.size();
+
+  key = std::to_string(expression->GetExpressionType()) + "(" + left_key +
+        "," + right_key + ")";
+
+  // Computed before: drop what was just emitted
+  uint32_t operand;
+  if (Lookup(key, operand)) {
+    program.instructions.resize(instruction_count);
+    program.register_count = register_count;
+    return operand;
+  }
+
+  Remember(key, destination);
+  return destination;
+}
+
+uint32_t ProgramCompiler::CompileFallback(const AbstractExpression *expression,
+                                          std::string &key) {
+  // Only the very same node is known to compute the same value
+  std::ostringstream os;
+  os << "E" << expression;
+  key = os.str();
+
+  return Emit(PROGRAM_OPCODE_EVALUATE, expression, 0);
+}
+
+//===--------------------------------------------------------------------===//
+// Program
+//===--------------------------------------------------------------------===//
+
+ExpressionProgram::Registers::Registers(const ExpressionProgram &program) {
+  if (program.register_count > PROGRAM_INLINE_REGISTER_COUNT) {
+    overflow_values.resize(program.register_count);
+    values = overflow_values.data();
+  } else {
+    values = inline_values;
+  }
+}
+
+ExpressionProgram::ExpressionProgram(
+    const std::vector<const AbstractExpression *> &expressions) {
+  ProgramCompiler compiler(*this);
+
+  for (auto expression : expressions) {
+    std::string key;
+    results.push_back(compiler.Compile(expression, key));
+  }
+
+  LOG_TRACE("Compiled %lu expressions : %s", expressions.size(),
+            GetInfo().c_str());
+}
+
+ExpressionProgram::ExpressionProgram(const AbstractExpression *expression)
+    : ExpressionProgram(std::vector<const AbstractExpression *>{expression}) {}
+
+// Overwrite a register in place : the old value is released, and the new
+// one is built right in the register file
+#define PROGRAM_SET_REGISTER(target, value_expression) \
+  do {                                                 \
+    Value &register_value = (target);                  \
+    register_value.~Value();                           \
+    try {                                              \
+      new (&register_value) Value(value_expression);   \
+    } catch (...) {                                    \
+      new (&register_value) Value();                   \
+      throw;                                           \
+    }                                                  \
+  } while (0)
+
+template <typename T>
+static inline Value CompareNative(ExpressionType expression_type, T left,
+                                  T right) {
+  bool result;
+  switch (expression_type) {
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+      result = (left == right);
+      break;
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+      result = (left != right);
+      break;
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+      result = (left < right);
+      break;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+      result = (left > right);
+      break;
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+      result = (left <= right);
+      break;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      result = (left >= right);
+      break;
+    default:
+      throw Exception("ExpressionProgram: invalid comparison " +
+                      ExpressionTypeToString(expression_type));
+  }
+  return result ? Value::GetTrue() : Value::GetFalse();
+}
+
+static inline Value Compare(ExpressionType expression_type, const Value &left,
+                            const Value &right) {
+  if (left.IsNull() || right.IsNull()) {
+    return Value::GetNullValue(VALUE_TYPE_BOOLEAN);
+  }
+
+  // Same-typed integers are compared without going through Value
+  auto value_type = left.GetValueType();
+  if (value_type == right.GetValueType() &&
+      expression_type != EXPRESSION_TYPE_COMPARE_LIKE) {
+    if (value_type == VALUE_TYPE_INTEGER) {
+      return CompareNative(expression_type, ValuePeeker::PeekInteger(left),
+                           ValuePeeker::PeekInteger(right));
+    }
+    if (value_type == VALUE_TYPE_BIGINT) {
+      return CompareNative(expression_type, ValuePeeker::PeekBigInt(left),
+                           ValuePeeker::PeekBigInt(right));
+    }
+  }
+
+  switch (expression_type) {
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+      return CmpEq::compare_withoutNull(left, right);
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+      return CmpNe::compare_withoutNull(left, right);
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+      return CmpLt::compare_withoutNull(left, right);
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+      return CmpGt::compare_withoutNull(left, right);
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+      return CmpLte::compare_withoutNull(left, right);
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      return CmpGte::compare_withoutNull(left, right);
+    case EXPRESSION_TYPE_COMPARE_LIKE:
+      return CmpLike::compare_withoutNull(left, right);
+    default:
+      throw Exception("ExpressionProgram: invalid comparison " +
+                      ExpressionTypeToString(expression_type));
+  }
+}
+
+static inline Value Compute(ExpressionType expression_type, const Value &left,
+                            const Value &right) {
+  switch (expression_type) {
+    case EXPRESSION_TYPE_OPERATOR_PLUS:
+      return left.OpAdd(right);
+    case EXPRESSION_TYPE_OPERATOR_MINUS:
+      return left.OpSubtract(right);
+    case EXPRESSION_TYPE_OPERATOR_MULTIPLY:
+      return left.OpMultiply(right);
+    case EXPRESSION_TYPE_OPERATOR_DIVIDE:
+      return left.OpDivide(right);
+    default:
+      throw Exception("ExpressionProgram: invalid operator " +
+                      ExpressionTypeToString(expression_type));
+  }
+}
+
+void ExpressionProgram::Run(Registers &registers, const AbstractTuple *tuple1,
+                            const AbstractTuple *tuple2,
+                            executor::ExecutorContext *context) const {
+  const AbstractTuple *tuples[2] = {tuple1, tuple2};
+  const size_t instruction_count = instructions.size();
+  size_t instruction_id = 0;
+
+  while (instruction_id < instruction_count) {
+    const ProgramInstruction &instruction = instructions[instruction_id++];
+    Value &destination = registers[instruction.destination];
+
+    switch (instruction.opcode) {
+      case PROGRAM_OPCODE_LOAD_COLUMN: {
+        const AbstractTuple *tuple = tuples[instruction.left];
+        if (tuple == nullptr) {
+          throw Exception(
+              "ExpressionProgram::Run: Couldn't find tuple " +
+              std::to_string(instruction.left + 1) +
+              " (possible index scan planning error)");
+        }
+        PROGRAM_SET_REGISTER(destination,
+                             tuple->GetValue(instruction.argument));
+      } break;
+
+      case PROGRAM_OPCODE_EVALUATE:
+        PROGRAM_SET_REGISTER(destination, instruction.expression->Evaluate(
+                                              tuple1, tuple2, context));
+        break;
+
+      case PROGRAM_OPCODE_COMPARE:
+        PROGRAM_SET_REGISTER(
+            destination, Compare(instruction.expression_type,
+                                 GetOperand(registers, instruction.left),
+                                 GetOperand(registers, instruction.right)));
+        break;
+
+      case PROGRAM_OPCODE_ARITHMETIC:
+        PROGRAM_SET_REGISTER(
+            destination, Compute(instruction.expression_type,
+                                 GetOperand(registers, instruction.left),
+                                 GetOperand(registers, instruction.right)));
+        break;
+
+      case PROGRAM_OPCODE_NOT: {
+        const Value &operand = GetOperand(registers, instruction.left);
+        // NOT NULL is NULL
+        if (operand.IsTrue())
+          PROGRAM_SET_REGISTER(destination, Value::GetFalse());
+        else if (operand.IsFalse())
+          PROGRAM_SET_REGISTER(destination, Value::GetTrue());
+        else
+          PROGRAM_SET_REGISTER(destination, operand);
+      } break;
+
+      case PROGRAM_OPCODE_IS_NULL:
+        if (GetOperand(registers, instruction.left).IsNull())
+          PROGRAM_SET_REGISTER(destination, Value::GetTrue());
+        else
+          PROGRAM_SET_REGISTER(destination, Value::GetFalse());
+        break;
+
+      case PROGRAM_OPCODE_MOVE:
+        PROGRAM_SET_REGISTER(destination,
+                             GetOperand(registers, instruction.left));
+        break;
+
+      // Left is TRUE or NULL here
+      case PROGRAM_OPCODE_AND: {
+        const Value &right = GetOperand(registers, instruction.right);
+        if (destination.IsTrue() || right.IsFalse())
+          PROGRAM_SET_REGISTER(destination, right);
+        else
+          PROGRAM_SET_REGISTER(destination,
+                               Value::GetNullValue(VALUE_TYPE_BOOLEAN));
+      } break;
+
+      // Left is FALSE or NULL here
+      case PROGRAM_OPCODE_OR: {
+        const Value &right = GetOperand(registers, instruction.right);
+        if (destination.IsFalse() || right.IsTrue())
+          PROGRAM_SET_REGISTER(destination, right);
+        else
+          PROGRAM_SET_REGISTER(destination,
+                               Value::GetNullValue(VALUE_TYPE_BOOLEAN));
+      } break;
+
+      case PROGRAM_OPCODE_JUMP_IF_FALSE:
+        if (GetOperand(registers, instruction.left).IsFalse())
+          instruction_id = instruction.argument;
+        break;
+
+      case PROGRAM_OPCODE_JUMP_IF_TRUE:
+        if (GetOperand(registers, instruction.left).IsTrue())
+          instruction_id = instruction.argument;
+        break;
+    }
+  }
+}
+
+Value ExpressionProgram::Evaluate(const AbstractTuple *tuple1,
+                                  const AbstractTuple *tuple2,
+                                  executor::ExecutorContext *context) const {
+  Registers registers(*this);
+  Run(registers, tuple1, tuple2, context);
+  return GetResult(registers, 0);
+}
+
+static std::string GetOperandInfo(uint32_t operand) {
+  if (operand & PROGRAM_CONSTANT_OPERAND)
+    return "k" + std::to_string(operand & ~PROGRAM_CONSTANT_OPERAND);
+  return "r" + std::to_string(operand);
+}
+
+std::string ExpressionProgram::GetInfo() const {
+  static const char *opcode_names[] = {
+      "LOAD_COLUMN", "EVALUATE", "COMPARE", "ARITHMETIC",    "NOT",
+      "IS_NULL",     "MOVE",     "AND",     "OR", "JUMP_IF_FALSE",
+      "JUMP_IF_TRUE"};
+  std::ostringstream os;
+
+  os << "ExpressionProgram : " << instructions.size() << " instructions, "
+     << register_count << " registers\n";
+
+  for (oid_t constant_id = 0; constant_id < constants.size(); constant_id++) {
+    os << "\tk" << constant_id << " = " << constants[constant_id].Debug()
+       << "\n";
+  }
+
+  for (oid_t instruction_id = 0; instruction_id < instructions.size();
+       instruction_id++) {
+    auto &instruction = instructions[instruction_id];
+    os << "\t" << instruction_id << " : " << opcode_names[instruction.opcode]
+       << " r" << instruction.destination << " "
+       << GetOperandInfo(instruction.left) << " "
+       << GetOperandInfo(instruction.right) << " " << instruction.argument;
+    if (instruction.expression_type != EXPRESSION_TYPE_INVALID)
+      os << " " << ExpressionTypeToString(instruction.expression_type);
+    os << "\n";
+  }
+
+  for (oid_t result_id = 0; result_id < results.size(); result_id++) {
+    os << "\tresult " << result_id << " : "
+       << GetOperandInfo(results[result_id]) << "\n";
+  }
+
+  return os.str();
+}
+
+}  // End expression namespace
+}  // End peloton namespace
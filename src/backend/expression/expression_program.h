@@ -0,0 +1,207 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// expression_program.h
+//
+// Identification: src/backend/expression/expression_program.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "backend/common/abstract_tuple.h"
+#include "backend/common/types.h"
+#include "backend/common/value.h"
+#include "backend/expression/container_tuple.h"
+
+namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+}
+
+namespace expression {
+
+class AbstractExpression;
+
+// Operands with this bit set refer to the constant pool, not to a register
+#define PROGRAM_CONSTANT_OPERAND 0x80000000u
+
+// Register files up to this size don't touch the heap
+#define PROGRAM_INLINE_REGISTER_COUNT 8
+
+//===--------------------------------------------------------------------===//
+// Expression Program
+//===--------------------------------------------------------------------===//
+
+enum ProgramOpcode : uint8_t {
+  PROGRAM_OPCODE_LOAD_COLUMN,  // dst = tuples[left]->GetValue(argument)
+  PROGRAM_OPCODE_EVALUATE,     // dst = expression->Evaluate(...)
+  PROGRAM_OPCODE_COMPARE,      // dst = left <expression_type> right
+  PROGRAM_OPCODE_ARITHMETIC,   // dst = left <expression_type> right
+  PROGRAM_OPCODE_NOT,          // dst = NOT left
+  PROGRAM_OPCODE_IS_NULL,      // dst = left IS NULL
+  PROGRAM_OPCODE_MOVE,         // dst = left
+  PROGRAM_OPCODE_AND,          // dst = left AND right, left is not FALSE
+  PROGRAM_OPCODE_OR,           // dst = left OR right, left is not TRUE
+  PROGRAM_OPCODE_JUMP_IF_FALSE,  // if left is FALSE, continue at argument
+  PROGRAM_OPCODE_JUMP_IF_TRUE    // if left is TRUE, continue at argument
+};
+
+struct ProgramInstruction {
+  ProgramOpcode opcode;
+
+  // comparison or arithmetic operator
+  ExpressionType expression_type;
+
+  uint32_t destination;
+
+  uint32_t left;
+
+  uint32_t right;
+
+  // column id or jump target
+  oid_t argument;
+
+  // subtree evaluated by PROGRAM_OPCODE_EVALUATE
+  const AbstractExpression *expression;
+};
+
+/**
+ * @brief An expression tree compiled to a flat, register-based program.
+ *
+ * Compilation folds the subtrees that only depend on constants and computes
+ * every repeated subtree once, also across the expressions compiled into the
+ * same program (e.g. all the targets of a projection). AND and OR still
+ * short-circuit, so a subtree under their right side is only shared within
+ * that side. Nodes without an opcode (parameters, IN lists, functions, ...)
+ * are evaluated through the tree.
+ *
+ * The program is immutable once built and, like the tree it comes from, is
+ * shared by concurrent executions: all the per-execution state lives in a
+ * Registers object, which a caller sets up once and reuses over many rows.
+ */
+class ExpressionProgram {
+  ExpressionProgram(ExpressionProgram const &) = delete;
+  ExpressionProgram &operator=(ExpressionProgram const &) = delete;
+
+  friend class ProgramCompiler;
+
+ public:
+  /**
+   * @brief Scratch space for running a program.
+   */
+  class Registers {
+    Registers(Registers const &) = delete;
+    Registers &operator=(Registers const &) = delete;
+
+   public:
+    Registers(const ExpressionProgram &program);
+
+    inline Value &operator[](uint32_t register_id) {
+      return values[register_id];
+    }
+
+    inline const Value &operator[](uint32_t register_id) const {
+      return values[register_id];
+    }
+
+   private:
+    Value inline_values[PROGRAM_INLINE_REGISTER_COUNT];
+
+    std::vector<Value> overflow_values;
+
+    Value *values;
+  };
+
+  // The expressions are not owned, and must outlive the program
+  ExpressionProgram(const std::vector<const AbstractExpression *> &expressions);
+
+  ExpressionProgram(const AbstractExpression *expression);
+
+  // Run the program over a row
+  void Run(Registers &registers, const AbstractTuple *tuple1,
+           const AbstractTuple *tuple2,
+           executor::ExecutorContext *context) const;
+
+  // Value of the result_id-th expression, after a run
+  inline const Value &GetResult(const Registers &registers,
+                                oid_t result_id) const {
+    return GetOperand(registers, results[result_id]);
+  }
+
+  // One-off evaluation of the first expression
+  Value Evaluate(const AbstractTuple *tuple1, const AbstractTuple *tuple2,
+                 executor::ExecutorContext *context) const;
+
+  /**
+   * @brief Apply the first expression as a predicate over a batch of tuples
+   * of the container, keeping the offsets of the tuples it holds for.
+   */
+  template <class Container>
+  void Filter(Container *container, std::vector<oid_t> &tuple_offsets,
+              executor::ExecutorContext *context) const {
+    Registers registers(*this);
+    size_t kept_count = 0;
+
+    for (auto tuple_offset : tuple_offsets) {
+      ContainerTuple<Container> tuple(container, tuple_offset);
+      Run(registers, &tuple, nullptr, context);
+
+      if (GetResult(registers, 0).IsTrue()) {
+        tuple_offsets[kept_count++] = tuple_offset;
+      }
+    }
+
+    tuple_offsets.resize(kept_count);
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Accessors
+  //===--------------------------------------------------------------------===//
+
+  size_t GetInstructionCount() const { return instructions.size(); }
+
+  size_t GetRegisterCount() const { return register_count; }
+
+  size_t GetConstantCount() const { return constants.size(); }
+
+  size_t GetResultCount() const { return results.size(); }
+
+  // Is the result_id-th expression folded to a constant ?
+  bool IsConstant(oid_t result_id) const {
+    return (results[result_id] & PROGRAM_CONSTANT_OPERAND) != 0;
+  }
+
+  std::string GetInfo() const;
+
+ private:
+  inline const Value &GetOperand(const Registers &registers,
+                                 uint32_t operand) const {
+    if (operand & PROGRAM_CONSTANT_OPERAND)
+      return constants[operand & ~PROGRAM_CONSTANT_OPERAND];
+    return registers[operand];
+  }
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  std::vector<ProgramInstruction> instructions;
+
+  std::vector<Value> constants;
+
+  // operand holding the value of each expression
+  std::vector<uint32_t> results;
+
+  uint32_t register_count = 0;
+};
+
+}  // End expression namespace
+}  // End peloton namespace
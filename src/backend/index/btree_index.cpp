@@ -13,6 +13,7 @@
 #include "backend/index/btree_index.h"
 #include "backend/index/index_key.h"
 #include "backend/common/logger.h"
+#include "backend/common/metrics.h"
 #include "backend/storage/tuple.h"
 
 namespace peloton {
@@ -34,6 +35,7 @@ bool BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::InsertEn
     const storage::Tuple *key, const ItemPointer location) {
   KeyType index_key;
   index_key.SetFromKey(key);
+  insert_counter->Increment();
 
   {
     index_lock.WriteLock();
@@ -52,6 +54,7 @@ bool BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::DeleteEn
     const storage::Tuple *key, const ItemPointer location) {
   KeyType index_key;
   index_key.SetFromKey(key);
+  delete_counter->Increment();
 
   {
     index_lock.WriteLock();
@@ -93,6 +96,7 @@ BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
     const ScanDirectionType& scan_direction) {
   std::vector<ItemPointer> result;
   KeyType index_key;
+  lookup_counter->Increment();
 
   {
     index_lock.ReadLock();
@@ -123,13 +127,15 @@ BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
     if (special_case == true) {
 
       start_key.reset(new storage::Tuple(metadata->GetKeySchema(), true));
-      index_key.SetFromKey(start_key.get());
 
       // Construct the lower bound key tuple
       all_constraints_are_equal =
           ConstructLowerBoundTuple(start_key.get(), values, key_column_ids, expr_types);
       LOG_TRACE("All constraints are equal : %d ", all_constraints_are_equal);
 
+      // The index key must be built from the filled in lower bound
+      index_key.SetFromKey(start_key.get());
+
       // Set scan begin iterator
       scan_begin_itr = container.equal_range(index_key).first;
     }
@@ -176,6 +182,7 @@ template <typename KeyType, typename ValueType, class KeyComparator, class KeyEq
 std::vector<ItemPointer>
 BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::ScanAllKeys() {
   std::vector<ItemPointer> result;
+  lookup_counter->Increment();
 
   {
     index_lock.ReadLock();
@@ -205,6 +212,7 @@ BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::ScanKey(
   std::vector<ItemPointer> result;
   KeyType index_key;
   index_key.SetFromKey(key);
+  lookup_counter->Increment();
 
   {
     index_lock.ReadLock();
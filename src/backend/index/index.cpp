@@ -13,6 +13,7 @@
 #include "backend/index/index.h"
 #include "backend/common/exception.h"
 #include "backend/common/logger.h"
+#include "backend/common/metrics.h"
 #include "backend/common/pool.h"
 #include "backend/catalog/schema.h"
 #include "backend/catalog/manager.h"
@@ -185,7 +186,11 @@ bool Index::ConstructLowerBoundTuple(storage::Tuple *index_key,
 Index::Index(IndexMetadata *metadata) : metadata(metadata) {
   index_oid = metadata->GetOid();
   // initialize counters
-  lookup_counter = insert_counter = delete_counter = update_counter = 0;
+  auto &metrics_registry = MetricsRegistry::GetInstance();
+  std::string prefix = "index." + metadata->GetName() + ".";
+  lookup_counter = metrics_registry.GetCounter(prefix + "lookup");
+  insert_counter = metrics_registry.GetCounter(prefix + "insert");
+  delete_counter = metrics_registry.GetCounter(prefix + "delete");
 
   // initialize pool
   pool = new VarlenPool(BACKEND_TYPE_MM);
@@ -211,10 +216,9 @@ void Index::GetInfo() const {
 
   os << this->GetName() << ",";
   os << GetTypeName() << ",";
-  os << lookup_counter << ",";
-  os << insert_counter << ",";
-  os << delete_counter << ",";
-  os << update_counter << std::endl;
+  os << lookup_counter->GetValue() << ",";
+  os << insert_counter->GetValue() << ",";
+  os << delete_counter->GetValue() << std::endl;
 
   LOG_INFO("Info :: %s", os.str().c_str());
 }
@@ -20,6 +20,7 @@
 namespace peloton {
 
 class AbstractTuple;
+class MetricsCounter;
 class VarlenPool;
 
 namespace catalog {
@@ -215,11 +216,10 @@ class Index {
 
   oid_t index_oid = INVALID_OID;
 
-  // access counters
-  int lookup_counter;
-  int insert_counter;
-  int delete_counter;
-  int update_counter;
+  // access counters, shared with the metrics registry
+  MetricsCounter *lookup_counter;
+  MetricsCounter *insert_counter;
+  MetricsCounter *delete_counter;
 
   // number of tuples
   float number_of_tuples = 0.0;
@@ -65,6 +65,9 @@ class BackendLogger : public Logger {
   // Log the given record
   virtual void Log(LogRecord *record) = 0;
 
+  // Log a batch of records with a single enqueue
+  virtual void LogBatch(const std::vector<LogRecord *> &records) = 0;
+
   // Construct a log record with tuple information
   virtual LogRecord *GetTupleRecord(LogRecordType log_record_type,
                                     txn_id_t txn_id, oid_t table_oid,
@@ -13,10 +13,12 @@
 #include <thread>
 
 #include "backend/common/logger.h"
+#include "backend/common/metrics.h"
 #include "backend/logging/log_manager.h"
 #include "backend/logging/frontend_logger.h"
 #include "backend/logging/loggers/aries_frontend_logger.h"
 #include "backend/logging/loggers/peloton_frontend_logger.h"
+#include "backend/storage/storage_manager.h"
 
 // configuration for testing
 int64_t peloton_wait_timeout = 0;
@@ -30,6 +32,11 @@ FrontendLogger::FrontendLogger() {
   if (peloton_wait_timeout != 0) {
     wait_timeout = peloton_wait_timeout;
   }
+
+  auto &metrics_registry = MetricsRegistry::GetInstance();
+  flush_record_histogram = metrics_registry.GetHistogram("log.flush_records");
+  flush_size_histogram = metrics_registry.GetHistogram("log.flush_bytes");
+  flush_latency_histogram = metrics_registry.GetHistogram("log.flush_latency");
 }
 
 FrontendLogger::~FrontendLogger() {
@@ -96,6 +103,10 @@ void FrontendLogger::MainLoop(void) {
       break;
   }
 
+  // The tables are rebuilt by now, in new tile groups,
+  // so the blocks of the last run are garbage
+  storage::StorageManager::GetInstance().ReleaseRecoveredBlocks();
+
   /////////////////////////////////////////////////////////////////////
   // LOGGING MODE
   /////////////////////////////////////////////////////////////////////
@@ -106,7 +117,7 @@ void FrontendLogger::MainLoop(void) {
     CollectLogRecordsFromBackendLoggers();
 
     // Flush the data to the file
-    FlushLogRecords();
+    FlushAndRecordLogRecords();
   }
 
   /////////////////////////////////////////////////////////////////////
@@ -118,7 +129,7 @@ void FrontendLogger::MainLoop(void) {
 
   // flush any remaining log records
   CollectLogRecordsFromBackendLoggers();
-  FlushLogRecords();
+  FlushAndRecordLogRecords();
 
   /////////////////////////////////////////////////////////////////////
   // SLEEP MODE
@@ -130,6 +141,31 @@ void FrontendLogger::MainLoop(void) {
   log_manager.SetLoggingStatus(LOGGING_STATUS_TYPE_SLEEP);
 }
 
+/**
+ * @brief Flush the collected log records, keeping the flush metrics
+ */
+void FrontendLogger::FlushAndRecordLogRecords(void) {
+  // Most wake ups find nothing to flush, they would drown the others
+  if (global_queue.empty()) {
+    FlushLogRecords();
+    return;
+  }
+
+  size_t record_count = global_queue.size();
+  size_t flush_size = 0;
+  for (auto record : global_queue) {
+    flush_size += record->GetMessageLength();
+  }
+
+  {
+    MetricsLatencyTimer flush_timer(flush_latency_histogram);
+    FlushLogRecords();
+  }
+
+  flush_record_histogram->Record(record_count);
+  flush_size_histogram->Record(flush_size);
+}
+
 /**
  * @brief Collect the log records from BackendLoggers
  */
@@ -23,6 +23,9 @@
 #include "backend/logging/backend_logger.h"
 
 namespace peloton {
+
+class MetricsHistogram;
+
 namespace logging {
 
 //===--------------------------------------------------------------------===//
@@ -41,6 +44,9 @@ class FrontendLogger : public Logger {
 
   void CollectLogRecordsFromBackendLoggers(void);
 
+  // Flush collected LogRecords, and record the size and latency of the flush
+  void FlushAndRecordLogRecords(void);
+
   void AddBackendLogger(BackendLogger *backend_logger);
 
   bool RemoveBackendLogger(BackendLogger *backend_logger);
@@ -55,6 +61,9 @@ class FrontendLogger : public Logger {
   // Restore database
   virtual void DoRecovery(void) = 0;
 
+  // # of times the log file was synced to its storage
+  size_t GetFsyncCount(void) const { return fsync_count; }
+
  protected:
   // Associated backend loggers
   std::vector<BackendLogger *> backend_loggers;
@@ -72,6 +81,15 @@ class FrontendLogger : public Logger {
 
   // used to indicate if backend has new logs
   bool need_to_collect_new_log_records = false;
+
+  size_t fsync_count = 0;
+
+  // Engine-wide flush metrics (records, bytes and microseconds per flush)
+  MetricsHistogram *flush_record_histogram;
+
+  MetricsHistogram *flush_size_histogram;
+
+  MetricsHistogram *flush_latency_histogram;
 };
 
 }  // namespace logging
@@ -164,6 +164,11 @@ bool LogManager::RemoveBackendLogger(BackendLogger *backend_logger) {
 FrontendLogger *LogManager::GetFrontendLogger() { return frontend_logger; }
 
 bool LogManager::RemoveFrontendLogger() {
+  // Keep its stats around
+  if (frontend_logger != nullptr) {
+    fsync_count += frontend_logger->GetFsyncCount();
+  }
+
   // Erase frontend logger
   delete frontend_logger;
 
@@ -98,6 +98,9 @@ class LogManager {
 
   std::string GetLogFileName(void);
 
+  // # of log file syncs done by the frontend loggers that already ended
+  size_t GetFsyncCount(void) const { return fsync_count; }
+
   bool HasPelotonFrontendLogger() const {
     return (peloton_logging_mode == LOGGING_TYPE_NVM_NVM);
   }
@@ -130,6 +133,8 @@ class LogManager {
   bool syncronization_commit = false;
 
   std::string log_file_name;
+
+  size_t fsync_count = 0;
 };
 
 }  // namespace logging
@@ -39,6 +39,22 @@ void AriesBackendLogger::Log(LogRecord *record) {
   }
 }
 
+/**
+ * @brief log a batch of LogRecords
+ * @param log records
+ */
+void AriesBackendLogger::LogBatch(const std::vector<LogRecord *> &records) {
+  // Serialize all the log records before taking the queue lock once
+  for (auto record : records) {
+    record->Serialize(output_buffer);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(local_queue_mutex);
+    local_queue.insert(local_queue.end(), records.begin(), records.end());
+  }
+}
+
 LogRecord *AriesBackendLogger::GetTupleRecord(LogRecordType log_record_type,
                                               txn_id_t txn_id, oid_t table_oid,
                                               ItemPointer insert_location,
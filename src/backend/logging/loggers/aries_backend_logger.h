@@ -32,6 +32,8 @@ class AriesBackendLogger : public BackendLogger {
 
   void Log(LogRecord *record);
 
+  void LogBatch(const std::vector<LogRecord *> &records);
+
   void TruncateLocalQueue(oid_t offset);
 
   LogRecord *GetTupleRecord(LogRecordType log_record_type, txn_id_t txn_id,
@@ -119,6 +119,7 @@ void AriesFrontendLogger::FlushLogRecords(void) {
   if (ret != 0) {
     LOG_ERROR("Error occured in fsync(%d)", ret);
   }
+  fsync_count++;
 
   // Clean up the frontend logger's queue
   for (auto record : global_queue) {
@@ -247,6 +247,7 @@ void PelotonFrontendLogger::WriteTransactionLogRecord(
   if (ret != 0) {
     LOG_ERROR("Error occured in fsync(%d)", ret);
   }
+  fsync_count++;
 }
 
 std::set<storage::TileGroupHeader *> PelotonFrontendLogger::ToggleCommitMarks(
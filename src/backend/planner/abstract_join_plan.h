@@ -20,6 +20,7 @@
 #include "abstract_plan.h"
 #include "backend/common/types.h"
 #include "backend/expression/abstract_expression.h"
+#include "backend/expression/expression_program.h"
 #include "backend/planner/project_info.h"
 
 namespace peloton {
@@ -43,7 +44,9 @@ class AbstractJoinPlan : public AbstractPlan {
         join_type_(joinType),
         predicate_(predicate),
         proj_info_(proj_info) {
-    // Fuck off!
+    if (predicate_ != nullptr)
+      predicate_program_.reset(
+          new expression::ExpressionProgram(predicate_.get()));
   }
 
   //===--------------------------------------------------------------------===//
@@ -56,6 +59,10 @@ class AbstractJoinPlan : public AbstractPlan {
     return predicate_.get();
   }
 
+  const expression::ExpressionProgram *GetPredicateProgram() const {
+    return predicate_program_.get();
+  }
+
   const ProjectInfo *GetProjInfo() const { return proj_info_.get(); }
 
  private:
@@ -67,6 +74,9 @@ class AbstractJoinPlan : public AbstractPlan {
 
   /** @brief Projection info */
   std::unique_ptr<const ProjectInfo> proj_info_;
+
+  /** @brief Compiled join predicate. */
+  std::unique_ptr<const expression::ExpressionProgram> predicate_program_;
 };
 
 }  // namespace planner
@@ -19,6 +19,7 @@
 #include "abstract_plan.h"
 #include "backend/common/types.h"
 #include "backend/expression/abstract_expression.h"
+#include "backend/expression/expression_program.h"
 
 namespace peloton {
 
@@ -38,12 +39,20 @@ class AbstractScan : public AbstractPlan {
   AbstractScan(storage::DataTable *table,
                expression::AbstractExpression *predicate,
                const std::vector<oid_t> &column_ids)
-      : target_table_(table), predicate_(predicate), column_ids_(column_ids) {}
+      : target_table_(table), predicate_(predicate), column_ids_(column_ids) {
+    if (predicate_ != nullptr)
+      predicate_program_.reset(
+          new expression::ExpressionProgram(predicate_.get()));
+  }
 
   const expression::AbstractExpression *GetPredicate() const {
     return predicate_.get();
   }
 
+  const expression::ExpressionProgram *GetPredicateProgram() const {
+    return predicate_program_.get();
+  }
+
   const std::vector<oid_t> &GetColumnIds() const { return column_ids_; }
 
   inline PlanNodeType GetPlanNodeType() const {
@@ -54,6 +63,12 @@ class AbstractScan : public AbstractPlan {
 
   storage::DataTable *GetTable() const { return target_table_; }
 
+  // Read the versions visible at a past commit id instead of the snapshot of
+  // the transaction
+  void SetAsOfCommitId(cid_t as_of_cid) { as_of_cid_ = as_of_cid; }
+
+  cid_t GetAsOfCommitId() const { return as_of_cid_; }
+
  private:
   /** @brief Pointer to table to scan from. */
   storage::DataTable *target_table_ = nullptr;
@@ -63,6 +78,13 @@ class AbstractScan : public AbstractPlan {
 
   /** @brief Columns from tile group to be added to logical tile output. */
   std::vector<oid_t> column_ids_;
+
+  /** @brief Compiled selection predicate. */
+  std::unique_ptr<const expression::ExpressionProgram> predicate_program_;
+
+  /** @brief Past commit id to read as of, INVALID_CID if not time travelling.
+   */
+  cid_t as_of_cid_ = INVALID_CID;
 };
 
 }  // namespace planner
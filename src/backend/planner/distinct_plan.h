@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// distinct_plan.h
+//
+// Identification: src/backend/planner/distinct_plan.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "abstract_plan.h"
+#include "backend/common/types.h"
+
+namespace peloton {
+namespace planner {
+
+/**
+ * @brief Plan node for DISTINCT over all the columns of its child.
+ * Executed by the hash set-op executor.
+ */
+class DistinctPlan : public AbstractPlan {
+ public:
+  DistinctPlan(const DistinctPlan &) = delete;
+  DistinctPlan &operator=(const DistinctPlan &) = delete;
+  DistinctPlan(const DistinctPlan &&) = delete;
+  DistinctPlan &operator=(const DistinctPlan &&) = delete;
+
+  DistinctPlan(size_t memory_budget = DEFAULT_OPERATOR_MEMORY_BUDGET)
+      : memory_budget_(memory_budget) {}
+
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
+  inline PlanNodeType GetPlanNodeType() const {
+    return PLAN_NODE_TYPE_DISTINCT;
+  }
+
+  inline std::string GetInfo() const { return "Distinct"; }
+
+ private:
+  /** @brief Bytes of hash table to fill before spilling */
+  size_t memory_budget_;
+};
+}
+}
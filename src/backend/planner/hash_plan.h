@@ -33,8 +33,9 @@ class HashPlan : public AbstractPlan {
   typedef const expression::AbstractExpression HashKeyType;
   typedef std::unique_ptr<HashKeyType> HashKeyPtrType;
 
-  HashPlan(std::vector<HashKeyPtrType> &hashkeys)
-      : hash_keys_(std::move(hashkeys)) {}
+  HashPlan(std::vector<HashKeyPtrType> &hashkeys,
+           size_t memory_budget = DEFAULT_OPERATOR_MEMORY_BUDGET)
+      : hash_keys_(std::move(hashkeys)), memory_budget_(memory_budget) {}
 
   inline PlanNodeType GetPlanNodeType() const { return PLAN_NODE_TYPE_HASH; }
 
@@ -44,8 +45,13 @@ class HashPlan : public AbstractPlan {
     return this->hash_keys_;
   }
 
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
  private:
   std::vector<HashKeyPtrType> hash_keys_;
+
+  /** @brief Bytes of build tuples to hold before spilling */
+  size_t memory_budget_;
 };
 }
 }
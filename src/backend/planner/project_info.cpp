@@ -16,6 +16,18 @@
 namespace peloton {
 namespace planner {
 
+ProjectInfo::ProjectInfo(TargetList &&tl, DirectMapList &&dml)
+    : target_list_(tl), direct_map_list_(dml) {
+  if (target_list_.empty()) return;
+
+  std::vector<const expression::AbstractExpression *> target_expressions;
+  for (auto &target : target_list_) {
+    target_expressions.push_back(target.second);
+  }
+
+  target_program_.reset(new expression::ExpressionProgram(target_expressions));
+}
+
 /**
  * @brief Mainly release the expression in target list.
  */
@@ -50,12 +62,15 @@ bool ProjectInfo::Evaluate(storage::Tuple *dest, const AbstractTuple *tuple1,
   if (econtext != nullptr) pool = econtext->GetExecutorContextPool();
 
   // (A) Execute target list
-  for (auto target : target_list_) {
-    auto col_id = target.first;
-    auto expr = target.second;
-    auto value = expr->Evaluate(tuple1, tuple2, econtext);
+  if (target_program_ != nullptr) {
+    expression::ExpressionProgram::Registers registers(*target_program_);
+    target_program_->Run(registers, tuple1, tuple2, econtext);
 
-    dest->SetValue(col_id, value, pool);
+    for (oid_t target_id = 0; target_id < target_list_.size(); target_id++) {
+      auto col_id = target_list_[target_id].first;
+      dest->SetValue(col_id, target_program_->GetResult(registers, target_id),
+                     pool);
+    }
   }
 
   // (B) Execute direct map
@@ -12,10 +12,12 @@
 
 #pragma once
 
+#include <memory>
 #include <utility>
 #include <vector>
 
 #include "backend/expression/abstract_expression.h"
+#include "backend/expression/expression_program.h"
 #include "backend/storage/tuple.h"
 
 namespace peloton {
@@ -64,13 +66,17 @@ class ProjectInfo {
   /* Force explicit move to emphasize the transfer of ownership */
   ProjectInfo(TargetList &tl, DirectMapList &dml) = delete;
 
-  ProjectInfo(TargetList &&tl, DirectMapList &&dml)
-      : target_list_(tl), direct_map_list_(dml) {}
+  ProjectInfo(TargetList &&tl, DirectMapList &&dml);
 
   const TargetList &GetTargetList() const { return target_list_; }
 
   const DirectMapList &GetDirectMapList() const { return direct_map_list_; }
 
+  // Target list compiled in order, null if the target list is empty
+  const expression::ExpressionProgram *GetTargetProgram() const {
+    return target_program_.get();
+  }
+
   bool isNonTrivial() const { return target_list_.size() > 0; };
 
   bool Evaluate(storage::Tuple *dest, const AbstractTuple *tuple1,
@@ -85,6 +91,9 @@ class ProjectInfo {
   TargetList target_list_;
 
   DirectMapList direct_map_list_;
+
+  /** @brief All target expressions, compiled together */
+  std::unique_ptr<const expression::ExpressionProgram> target_program_;
 };
 
 } /* namespace planner */
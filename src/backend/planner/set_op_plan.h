@@ -32,10 +32,14 @@ class SetOpPlan : public AbstractPlan {
   SetOpPlan(const SetOpPlan &&) = delete;
   SetOpPlan &operator=(const SetOpPlan &&) = delete;
 
-  SetOpPlan(SetOpType set_op) : set_op_(set_op) {}
+  SetOpPlan(SetOpType set_op,
+            size_t memory_budget = DEFAULT_OPERATOR_MEMORY_BUDGET)
+      : set_op_(set_op), memory_budget_(memory_budget) {}
 
   SetOpType GetSetOp() const { return set_op_; }
 
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
   inline PlanNodeType GetPlanNodeType() const { return PLAN_NODE_TYPE_SETOP; }
 
   inline std::string GetInfo() const { return "SetOp"; }
@@ -43,6 +47,9 @@ class SetOpPlan : public AbstractPlan {
  private:
   /** @brief Set Operation of this node */
   SetOpType set_op_;
+
+  /** @brief Bytes of hash table to fill before spilling */
+  size_t memory_budget_;
 };
 }
 }
@@ -10,12 +10,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <mutex>
 #include <utility>
 
 #include "backend/brain/clusterer.h"
 #include "backend/storage/data_table.h"
 #include "backend/storage/database.h"
+#include "backend/storage/eviction_manager.h"
 #include "backend/common/exception.h"
 #include "backend/common/logger.h"
 #include "backend/index/index.h"
@@ -25,6 +27,7 @@
 #include "backend/storage/tile.h"
 #include "backend/storage/tile_group_header.h"
 #include "backend/storage/tile_group_factory.h"
+#include "backend/storage/table_stats.h"
 
 //===--------------------------------------------------------------------===//
 // Configuration Variables
@@ -57,6 +60,8 @@ DataTable::DataTable(catalog::Schema *schema, std::string table_name,
     default_partition[col_itr] = std::make_pair(0, col_itr);
   }
 
+  table_stats.reset(new TableStats(this));
+
   // Create a tile group.
   AddDefaultTileGroup();
 }
@@ -102,6 +107,11 @@ bool ContainsVisibleEntry(std::vector<ItemPointer> &locations,
     bool visible =
         header->IsVisible(tuple_offset, transaction_id, last_commit_id);
 
+    // Own deletes of optimistic transactions are still in place
+    if (visible && transaction->IsOptimistic()) {
+      visible = (transaction->IsOwnDelete(loc) == false);
+    }
+
     if (visible) return true;
   }
 
@@ -213,6 +223,75 @@ ItemPointer DataTable::InsertTuple(const concurrency::Transaction *transaction,
   return location;
 }
 
+/**
+ * @brief Insert a batch of tuples into the table.
+ * Slots are claimed a contiguous range at a time from the tail tile group,
+ * and the indexes are only updated once the whole batch has been placed.
+ *
+ * @param locations Filled with the locations of all claimed slots, even on
+ * failure, so that the caller can record them for rollback.
+ * @returns True on success, false if an index constraint was violated.
+ */
+bool DataTable::InsertTuples(const concurrency::Transaction *transaction,
+                             const std::vector<const Tuple *> &tuples,
+                             std::vector<ItemPointer> &locations) {
+  // First, do integrity checks for the whole batch
+  for (auto tuple : tuples) {
+    assert(tuple);
+    if (CheckConstraints(tuple) == false) return false;
+  }
+
+  const oid_t tuple_count = tuples.size();
+  auto transaction_id = transaction->GetTransactionId();
+  oid_t tuple_itr = 0;
+
+  locations.reserve(locations.size() + tuple_count);
+
+  // Then, claim slot ranges and fill them in
+  while (tuple_itr < tuple_count) {
+    oid_t tile_group_offset = INVALID_OID;
+    {
+      std::lock_guard<std::mutex> lock(table_mutex);
+      assert(GetTileGroupCount() > 0);
+      tile_group_offset = GetTileGroupCount() - 1;
+    }
+
+    auto tile_group = GetTileGroup(tile_group_offset);
+    oid_t inserted_count = 0;
+    oid_t start_slot = tile_group->InsertTuples(transaction_id, tuples,
+                                                tuple_itr, inserted_count);
+
+    if (start_slot == INVALID_OID) {
+      AddDefaultTileGroup();
+      continue;
+    }
+
+    oid_t tile_group_id = tile_group->GetTileGroupId();
+    for (oid_t slot_itr = 0; slot_itr < inserted_count; slot_itr++) {
+      locations.push_back(ItemPointer(tile_group_id, start_slot + slot_itr));
+    }
+
+    tuple_itr += inserted_count;
+  }
+
+  LOG_INFO("Bulk loaded %lu tuples", tuple_count);
+
+  // Deferred index checks and updates
+  std::vector<ItemPointer> batch_locations(locations.end() - tuple_count,
+                                           locations.end());
+  if (InsertInIndexes(transaction, tuples, batch_locations) == false) {
+    LOG_WARN("Index constraint violated");
+    return false;
+  }
+
+  // Increase the table's number of tuples by the batch size
+  IncreaseNumberOfTuplesBy(tuple_count);
+  // Increase the indexes' number of tuples as well
+  for (auto index : indexes) index->IncreaseNumberOfTuplesBy(tuple_count);
+
+  return true;
+}
+
 /**
  * @brief Insert a tuple into all indexes. If index is primary/unique,
  * check visibility of existing
@@ -270,6 +349,103 @@ bool DataTable::InsertInIndexes(const concurrency::Transaction *transaction,
   return true;
 }
 
+/**
+ * @brief Insert a batch of tuples into all indexes. Keys are built and
+ * sorted once per index, so that each index sees its inserts in key order.
+ * If index is primary/unique, check for duplicates within the batch and
+ * visibility of existing index entries.
+ *
+ * @returns True on success, false if a duplicate or a visible entry exists
+ * (in case of primary/unique).
+ */
+bool DataTable::InsertInIndexes(
+    const concurrency::Transaction *transaction,
+    const std::vector<const storage::Tuple *> &tuples,
+    const std::vector<ItemPointer> &locations) {
+  assert(tuples.size() == locations.size());
+  int index_count = GetIndexCount();
+  oid_t tuple_count = tuples.size();
+
+  // Build the sorted keys for every index
+  std::vector<std::vector<std::unique_ptr<storage::Tuple>>> index_keys(
+      index_count);
+  std::vector<std::vector<oid_t>> index_orders(index_count);
+
+  for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
+    auto index = GetIndex(index_itr);
+    auto index_schema = index->GetKeySchema();
+    auto indexed_columns = index_schema->GetIndexedColumns();
+
+    auto &keys = index_keys[index_itr];
+    auto &order = index_orders[index_itr];
+    keys.reserve(tuple_count);
+    order.reserve(tuple_count);
+
+    for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+      std::unique_ptr<storage::Tuple> key(
+          new storage::Tuple(index_schema, true));
+      key->SetFromTuple(tuples[tuple_itr], indexed_columns, index->GetPool());
+      keys.push_back(std::move(key));
+      order.push_back(tuple_itr);
+    }
+
+    std::stable_sort(order.begin(), order.end(),
+                     [&keys](const oid_t &lhs, const oid_t &rhs) {
+                       return keys[lhs]->Compare(*keys[rhs]) < 0;
+                     });
+  }
+
+  // (A) Check existence for primary/unique indexes
+  for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
+    auto index = GetIndex(index_itr);
+
+    switch (index->GetIndexType()) {
+      case INDEX_CONSTRAINT_TYPE_PRIMARY_KEY:
+      case INDEX_CONSTRAINT_TYPE_UNIQUE: {
+        auto &keys = index_keys[index_itr];
+        auto &order = index_orders[index_itr];
+
+        for (oid_t order_itr = 0; order_itr < tuple_count; order_itr++) {
+          auto key = keys[order[order_itr]].get();
+
+          // duplicates within the batch are adjacent after sorting
+          if (order_itr > 0 &&
+              keys[order[order_itr - 1]]->Compare(*key) == 0) {
+            LOG_WARN("A duplicate key exists within the batch.");
+            return false;
+          }
+
+          auto existing_locations = index->ScanKey(key);
+          if (ContainsVisibleEntry(existing_locations, transaction)) {
+            LOG_WARN("A visible index entry exists.");
+            return false;
+          }
+        }
+      } break;
+
+      case INDEX_CONSTRAINT_TYPE_DEFAULT:
+      default:
+        break;
+    }
+    LOG_INFO("Index constraint check on %s passed.", index->GetName().c_str());
+  }
+
+  // (B) Insert into index in key order
+  for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
+    auto index = GetIndex(index_itr);
+    auto &keys = index_keys[index_itr];
+
+    for (auto tuple_itr : index_orders[index_itr]) {
+      auto status =
+          index->InsertEntry(keys[tuple_itr].get(), locations[tuple_itr]);
+      (void)status;
+      assert(status);
+    }
+  }
+
+  return true;
+}
+
 //===--------------------------------------------------------------------===//
 // DELETE
 //===--------------------------------------------------------------------===//
@@ -294,7 +470,13 @@ bool DataTable::DeleteTuple(const concurrency::Transaction *transaction,
   cid_t last_cid = transaction->GetLastCommitId();
 
   // Delete slot in underlying tile group
-  auto status = tile_group->DeleteTuple(transaction_id, tuple_id, last_cid);
+  // Optimistic transactions only latch it at commit
+  bool status;
+  if (transaction->IsOptimistic()) {
+    status = tile_group->PrepareDeleteTuple(transaction_id, tuple_id);
+  } else {
+    status = tile_group->DeleteTuple(transaction_id, tuple_id, last_cid);
+  }
   if (status == false) {
     LOG_WARN("Failed to delete tuple from the tile group : %lu , Txn_id : %lu ",
              tile_group_id, transaction_id);
@@ -439,6 +621,9 @@ oid_t DataTable::AddDefaultTileGroup() {
   assert(tile_group.get());
   tile_group_id = tile_group.get()->GetTileGroupId();
 
+  // The tile group that just filled up, if any
+  std::shared_ptr<TileGroup> full_tile_group;
+
   LOG_TRACE("Trying to add a tile group ");
   {
     std::lock_guard<std::mutex> lock(table_mutex);
@@ -473,8 +658,18 @@ oid_t DataTable::AddDefaultTileGroup() {
     // add tile group metadata in locator
     catalog::Manager::GetInstance().AddTileGroup(tile_group_id, tile_group);
     LOG_TRACE("Recording tile group : %lu ", tile_group_id);
+
+    full_tile_group = last_tile_group;
   }
 
+  // No more inserts will land in the full tile group,
+  // tighten its zone map (drops aborted inserts)
+  full_tile_group->RebuildZoneMap();
+  full_tile_group.reset();
+
+  // Make room for the new tile group if memory is tight
+  EvictionManager::GetInstance().EnforceBudget(this);
+
   return tile_group_id;
 }
 
@@ -528,10 +723,14 @@ size_t DataTable::GetTileGroupCount() const {
   return size;
 }
 
+oid_t DataTable::GetTileGroupId(oid_t tile_group_offset) const {
+  assert(tile_group_offset < GetTileGroupCount());
+  return tile_groups[tile_group_offset];
+}
+
 std::shared_ptr<storage::TileGroup> DataTable::GetTileGroup(
     oid_t tile_group_offset) const {
-  assert(tile_group_offset < GetTileGroupCount());
-  auto tile_group_id = tile_groups[tile_group_offset];
+  auto tile_group_id = GetTileGroupId(tile_group_offset);
   return GetTileGroupById(tile_group_id);
 }
 
@@ -763,6 +962,7 @@ storage::TileGroup *DataTable::TransformTileGroup(oid_t tile_group_offset,
 
   // Set the transformed tile group column-at-a-time
   SetTransformedTileGroup(tile_group.get(), new_tile_group.get());
+  new_tile_group->RebuildZoneMap();
 
   // Set the location of the new tile group
   // and clean up the orig tile group
@@ -60,6 +60,7 @@ namespace storage {
 
 class Tuple;
 class TileGroup;
+class TableStats;
 
 //===--------------------------------------------------------------------===//
 // DataTable
@@ -98,6 +99,12 @@ class DataTable : public AbstractTable {
   ItemPointer InsertTuple(const concurrency::Transaction *transaction,
                           const Tuple *tuple);
 
+  // insert a batch of tuples in table, claiming slots a range at a time
+  // and deferring index maintenance until the whole batch is in place
+  bool InsertTuples(const concurrency::Transaction *transaction,
+                    const std::vector<const Tuple *> &tuples,
+                    std::vector<ItemPointer> &locations);
+
   // delete the tuple at given location
   bool DeleteTuple(const concurrency::Transaction *transaction,
                    ItemPointer location);
@@ -120,6 +127,9 @@ class DataTable : public AbstractTable {
   std::shared_ptr<storage::TileGroup> GetTileGroupById(
       oid_t tile_group_id) const;
 
+  // Global identifier of the tile group at the offset
+  oid_t GetTileGroupId(oid_t tile_group_offset) const;
+
   size_t GetTileGroupCount() const;
 
   // Get a tile group with given layout
@@ -173,6 +183,9 @@ class DataTable : public AbstractTable {
 
   void ResetDirty();
 
+  // Column statistics for the planner
+  TableStats *GetTableStats() const { return table_stats.get(); }
+
   const column_map_type &GetDefaultPartition();
 
   //===--------------------------------------------------------------------===//
@@ -228,6 +241,11 @@ class DataTable : public AbstractTable {
   bool InsertInIndexes(const concurrency::Transaction *transaction,
                        const storage::Tuple *tuple, ItemPointer location);
 
+  // try to insert a batch into the indices, index at a time in key order
+  bool InsertInIndexes(const concurrency::Transaction *transaction,
+                       const std::vector<const storage::Tuple *> &tuples,
+                       const std::vector<ItemPointer> &locations);
+
   /** @return True if it's a same-key update and it's successful */
   bool UpdateInIndexes(const storage::Tuple *tuple, ItemPointer location);
 
@@ -264,6 +282,9 @@ class DataTable : public AbstractTable {
   // dirty flag
   bool dirty = false;
 
+  // column statistics
+  std::unique_ptr<TableStats> table_stats;
+
   // clustering mutex
   std::mutex clustering_mutex;
 
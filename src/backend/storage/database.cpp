@@ -15,6 +15,7 @@
 #include "postmaster/peloton.h"
 #include "backend/storage/database.h"
 #include "backend/storage/table_factory.h"
+#include "backend/storage/table_stats.h"
 #include "backend/common/logger.h"
 #include "backend/index/index.h"
 
@@ -87,15 +88,8 @@ void Database::UpdateStats() const {
   LOG_INFO("Update All Stats in Database(%lu)", database_oid);
   for (oid_t table_offset = 0; table_offset < GetTableCount(); table_offset++) {
     auto table = GetTable(table_offset);
-    bridge::Bridge::SetNumberOfTuples(table->GetOid(),
-                                      table->GetNumberOfTuples());
-
-    for (oid_t index_offset = 0; index_offset < table->GetIndexCount();
-         index_offset++) {
-      auto index = table->GetIndex(index_offset);
-      bridge::Bridge::SetNumberOfTuples(index->GetOid(),
-                                        index->GetNumberOfTuples());
-    }
+    table->GetTableStats()->Rebuild();
+    PushStats(table);
   }
 }
 
@@ -104,7 +98,33 @@ void Database::UpdateStatsWithOid(const oid_t table_oid) const {
            database_oid);
 
   auto table = GetTableWithOid(table_oid);
-  bridge::Bridge::SetNumberOfTuples(table_oid, table->GetNumberOfTuples());
+  table->GetTableStats()->Rebuild();
+  PushStats(table);
+}
+
+bool Database::RefreshStatsWithOid(const oid_t table_oid) const {
+  auto table = GetTableWithOid(table_oid);
+  if (table == nullptr) return false;
+
+  auto table_stats = table->GetTableStats();
+  if (table_stats->IsStale() == false) return false;
+
+  LOG_TRACE("Refresh table(%lu)'s stats in Database(%lu)", table_oid,
+            database_oid);
+  table_stats->Refresh();
+  PushStats(table);
+
+  return true;
+}
+
+void Database::PushStats(DataTable *table) const {
+  bridge::Bridge::SetNumberOfTuples(table->GetOid(),
+                                    table->GetNumberOfTuples());
+
+  auto stats = table->GetTableStats()->GetSnapshot();
+  if (stats != nullptr) {
+    bridge::Bridge::SetColumnStats(table->GetOid(), *stats);
+  }
 
   for (oid_t index_offset = 0; index_offset < table->GetIndexCount();
        index_offset++) {
@@ -61,10 +61,15 @@ class Database {
   // STATS
   //===--------------------------------------------------------------------===//
 
+  // Rebuild the statistics of every table and hand them to Postgres
   void UpdateStats(void) const;
 
   void UpdateStatsWithOid(const oid_t table_oid) const;
 
+  // Refresh the table's statistics incrementally if they went stale,
+  // and hand them to Postgres. Returns false if they were fresh.
+  bool RefreshStatsWithOid(const oid_t table_oid) const;
+
   //===--------------------------------------------------------------------===//
   // UTILITIES
   //===--------------------------------------------------------------------===//
@@ -73,6 +78,9 @@ class Database {
   friend std::ostream &operator<<(std::ostream &os, const Database &database);
 
  protected:
+  // Copy the table's (and its indexes') statistics into the Postgres catalog
+  void PushStats(DataTable *table) const;
+
   //===--------------------------------------------------------------------===//
   // MEMBERS
   //===--------------------------------------------------------------------===//
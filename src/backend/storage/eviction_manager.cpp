@@ -0,0 +1,417 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// eviction_manager.cpp
+//
+// Identification: src/backend/storage/eviction_manager.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <cassert>
+
+#include "backend/catalog/manager.h"
+#include "backend/common/logger.h"
+#include "backend/common/task_scheduler.h"
+#include "backend/storage/data_table.h"
+#include "backend/storage/eviction_manager.h"
+#include "backend/storage/storage_manager.h"
+#include "backend/storage/tile_group_factory.h"
+#include "backend/storage/tile_group_header.h"
+
+namespace peloton {
+namespace storage {
+
+std::atomic<uint64_t> EvictionManager::access_epoch(0);
+
+std::atomic<size_t> EvictionManager::evicted_tile_group_count(0);
+
+EvictionManager &EvictionManager::GetInstance() {
+  static EvictionManager eviction_manager([] {
+    // Keep the evicted data on the SSD if there is one
+    struct stat data_stat;
+    int status = stat(SSD_DIR, &data_stat);
+    if (status == 0 && S_ISDIR(data_stat.st_mode)) {
+      return std::string(SSD_DIR) + std::string(EVICTION_FILE_NAME);
+    }
+    return std::string(TMP_DIR) + std::string(EVICTION_FILE_NAME);
+  }());
+
+  return eviction_manager;
+}
+
+EvictionManager::EvictionManager(const std::string &file_name)
+    : file_name(file_name) {}
+
+EvictionManager::~EvictionManager() {
+  // Let the prefetches in flight finish first
+  prefetch_group.reset();
+
+  Clear();
+
+  if (file_fd != -1) {
+    close(file_fd);
+    unlink(file_name.c_str());
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Eviction
+//===--------------------------------------------------------------------===//
+
+size_t EvictionManager::EvictColdTileGroups(DataTable *table,
+                                            uint64_t cold_epoch_count) {
+  uint64_t current_epoch = ++access_epoch;
+  auto &manager = catalog::Manager::GetInstance();
+  size_t evicted_count = 0;
+
+  // The last tile group still takes inserts
+  oid_t tile_group_count = table->GetTileGroupCount();
+  for (oid_t tile_group_itr = 0; tile_group_itr + 1 < tile_group_count;
+       tile_group_itr++) {
+    oid_t tile_group_id = table->GetTileGroupId(tile_group_itr);
+
+    {
+      auto tile_group = manager.GetResidentTileGroup(tile_group_id);
+      if (tile_group == nullptr) continue;
+
+      // Was it looked up recently ?
+      if (current_epoch - tile_group->GetLastAccessEpoch() <=
+          cold_epoch_count) {
+        continue;
+      }
+    }
+
+    if (EvictTileGroup(tile_group_id) == true) evicted_count++;
+  }
+
+  LOG_TRACE("Evicted %lu tile groups of table %lu", evicted_count,
+            table->GetOid());
+
+  return evicted_count;
+}
+
+size_t EvictionManager::EnforceBudget(DataTable *table) {
+  if (peloton_eviction_budget <= 0) return 0;
+
+  size_t budget = static_cast<size_t>(peloton_eviction_budget) * 1024;
+  if (TileGroup::GetResidentSize() <= budget) return 0;
+
+  std::unique_lock<std::mutex> lock(budget_mutex, std::try_to_lock);
+  if (lock.owns_lock() == false) return 0;
+
+  size_t evicted_count = EvictColdTileGroups(table);
+
+  LOG_TRACE("Over the eviction budget : %lu bytes resident after the pass",
+            TileGroup::GetResidentSize());
+
+  return evicted_count;
+}
+
+bool EvictionManager::EvictTileGroup(const oid_t tile_group_id) {
+  std::lock_guard<std::mutex> lock(eviction_mutex);
+  auto &manager = catalog::Manager::GetInstance();
+
+  auto tile_group = manager.GetResidentTileGroup(tile_group_id);
+  if (tile_group == nullptr || IsImmutable(tile_group.get()) == false) {
+    return false;
+  }
+
+  // Lookups that miss the catalog from now on fault in, and so wait for
+  // the eviction lock
+  evicted_tile_group_count++;
+
+  auto location = manager.ExchangeTileGroup(tile_group_id, nullptr);
+  if (location != tile_group) {
+    manager.AddTileGroup(tile_group_id, location);
+    evicted_tile_group_count--;
+    return false;
+  }
+  location.reset();
+
+  // Anyone still holding the tile group or one of its tiles got it before
+  // the catalog entry went away, so we can't evict it
+  bool is_referenced = (tile_group.use_count() > 1);
+
+  for (oid_t tile_itr = 0; tile_itr < tile_group->NumTiles(); tile_itr++) {
+    if (is_referenced == true) break;
+    // the tile group's reference and ours
+    is_referenced = (tile_group->GetTileReference(tile_itr).use_count() > 2);
+  }
+
+  if (is_referenced == true || OpenBlockFile() == false) {
+    manager.AddTileGroup(tile_group_id, tile_group);
+    evicted_tile_group_count--;
+    return false;
+  }
+
+  // Serialize the header and the tuples of every tile
+  output.Reset();
+  auto tile_group_header = tile_group->GetHeader();
+  tile_group_header->SerializeTo(output);
+
+  oid_t tuple_count = tile_group_header->GetNextTupleSlot();
+  for (oid_t tile_itr = 0; tile_itr < tile_group->NumTiles(); tile_itr++) {
+    tile_group->GetTile(tile_itr)
+        ->SerializeTuplesWithoutHeaderTo(output, tuple_count);
+  }
+
+  // Write it out to the block file
+  size_t length = output.Size();
+  off_t offset = AllocateExtent(length);
+
+  size_t written = 0;
+  while (written < length) {
+    ssize_t status =
+        pwrite(file_fd, output.Data() + written, length - written,
+               offset + written);
+    if (status < 0) {
+      if (errno == EINTR) continue;
+      LOG_ERROR("Could not evict tile group %lu : %s", tile_group_id,
+                strerror(errno));
+      ReleaseExtent(offset, length);
+      manager.AddTileGroup(tile_group_id, tile_group);
+      evicted_tile_group_count--;
+      return false;
+    }
+    written += status;
+  }
+
+  // Keep a stub to rebuild the tile group
+  TileGroupStub stub;
+  stub.database_id = tile_group->GetDatabaseId();
+  stub.table_id = tile_group->GetTableId();
+  stub.table = tile_group->GetAbstractTable();
+  stub.schemas = tile_group->GetTileSchemas();
+  stub.column_map = tile_group->GetColumnMap();
+  stub.tuple_count = tile_group->GetAllocatedTupleCount();
+  stub.offset = offset;
+  stub.length = length;
+
+  stubs.emplace(tile_group_id, std::move(stub));
+  evicted_size += length;
+
+  LOG_TRACE("Evicted tile group %lu : %lu bytes at offset %lu", tile_group_id,
+            length, offset);
+
+  // Dropping the last reference frees the tile group
+  return true;
+}
+
+bool EvictionManager::IsImmutable(TileGroup *tile_group) {
+  auto tile_group_header = tile_group->GetHeader();
+  oid_t tuple_slot_count = tile_group->GetAllocatedTupleCount();
+
+  if (tile_group_header->GetNextTupleSlot() < tuple_slot_count) return false;
+
+  // Committed and aborted versions are released,
+  // others are owned by a running transaction
+  for (oid_t tuple_slot_itr = 0; tuple_slot_itr < tuple_slot_count;
+       tuple_slot_itr++) {
+    txn_id_t txn_id = tile_group_header->GetTransactionId(tuple_slot_itr);
+    if (txn_id != INITIAL_TXN_ID && txn_id != INVALID_TXN_ID) return false;
+  }
+
+  return true;
+}
+
+//===--------------------------------------------------------------------===//
+// Fault In
+//===--------------------------------------------------------------------===//
+
+std::shared_ptr<TileGroup> EvictionManager::FetchTileGroup(
+    const oid_t tile_group_id) {
+  std::lock_guard<std::mutex> lock(eviction_mutex);
+  auto &manager = catalog::Manager::GetInstance();
+
+  // Someone else might have fetched it already
+  auto tile_group = manager.GetResidentTileGroup(tile_group_id);
+  if (tile_group != nullptr) return tile_group;
+
+  auto stub_itr = stubs.find(tile_group_id);
+  if (stub_itr == stubs.end()) return tile_group;
+  auto &stub = stub_itr->second;
+
+  std::unique_ptr<char[]> buffer(new char[stub.length]);
+  size_t read_count = 0;
+  while (read_count < stub.length) {
+    ssize_t status = pread(file_fd, buffer.get() + read_count,
+                           stub.length - read_count, stub.offset + read_count);
+    if (status < 0 && errno == EINTR) continue;
+    if (status <= 0) {
+      LOG_ERROR("Could not fault in tile group %lu : %s", tile_group_id,
+                strerror(errno));
+      return tile_group;
+    }
+    read_count += status;
+  }
+
+  // Rebuild the tile group under its old oid
+  tile_group.reset(TileGroupFactory::GetTileGroup(
+      stub.database_id, stub.table_id, tile_group_id, stub.table, stub.schemas,
+      stub.column_map, stub.tuple_count));
+
+  ReferenceSerializeInputBE input(buffer.get(), stub.length);
+  tile_group->GetHeader()->DeserializeFrom(input);
+
+  for (oid_t tile_itr = 0; tile_itr < tile_group->NumTiles(); tile_itr++) {
+    auto tile = tile_group->GetTile(tile_itr);
+    tile->DeserializeTuplesFromWithoutHeader(input, tile->GetPool());
+  }
+
+  tile_group->RebuildZoneMap();
+
+  manager.AddTileGroup(tile_group_id, tile_group);
+  DropStubLocked(stub_itr);
+
+  LOG_TRACE("Fetched tile group %lu", tile_group_id);
+
+  return tile_group;
+}
+
+void EvictionManager::Prefetch(const oid_t tile_group_id) {
+  {
+    std::lock_guard<std::mutex> lock(eviction_mutex);
+
+    if (stubs.count(tile_group_id) == 0) return;
+    if (pending_prefetches.insert(tile_group_id).second == false) return;
+
+    if (prefetch_group == nullptr) {
+      prefetch_group.reset(new TaskGroup());
+    }
+  }
+
+  prefetch_group->Submit([this, tile_group_id] {
+    FetchTileGroup(tile_group_id);
+
+    std::lock_guard<std::mutex> lock(eviction_mutex);
+    pending_prefetches.erase(tile_group_id);
+  });
+}
+
+void EvictionManager::WaitForPrefetches() {
+  TaskGroup *group;
+  {
+    std::lock_guard<std::mutex> lock(eviction_mutex);
+    group = prefetch_group.get();
+  }
+
+  if (group != nullptr) group->Wait();
+}
+
+//===--------------------------------------------------------------------===//
+// Maintenance
+//===--------------------------------------------------------------------===//
+
+bool EvictionManager::IsEvicted(const oid_t tile_group_id) {
+  std::lock_guard<std::mutex> lock(eviction_mutex);
+  return stubs.count(tile_group_id) != 0;
+}
+
+void EvictionManager::DropTileGroup(const oid_t tile_group_id) {
+  std::lock_guard<std::mutex> lock(eviction_mutex);
+
+  auto stub_itr = stubs.find(tile_group_id);
+  if (stub_itr != stubs.end()) DropStubLocked(stub_itr);
+}
+
+void EvictionManager::Clear() {
+  std::lock_guard<std::mutex> lock(eviction_mutex);
+
+  while (stubs.empty() == false) {
+    DropStubLocked(stubs.begin());
+  }
+}
+
+void EvictionManager::DropStubLocked(
+    std::unordered_map<oid_t, TileGroupStub>::iterator stub_itr) {
+  ReleaseExtent(stub_itr->second.offset, stub_itr->second.length);
+  evicted_size -= stub_itr->second.length;
+
+  stubs.erase(stub_itr);
+  evicted_tile_group_count--;
+}
+
+//===--------------------------------------------------------------------===//
+// Block File
+//===--------------------------------------------------------------------===//
+
+bool EvictionManager::OpenBlockFile() {
+  if (file_fd != -1) return true;
+
+  // The evicted data does not outlive the process
+  file_fd = open(file_name.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0666);
+  if (file_fd < 0) {
+    LOG_ERROR("Could not open block file %s : %s", file_name.c_str(),
+              strerror(errno));
+    file_fd = -1;
+    return false;
+  }
+
+  LOG_INFO("EVICTION FILE :: %s ", file_name.c_str());
+  return true;
+}
+
+off_t EvictionManager::AllocateExtent(size_t length) {
+  for (auto extent_itr = free_extents.begin(); extent_itr != free_extents.end();
+       ++extent_itr) {
+    if (extent_itr->second < length) continue;
+
+    off_t offset = extent_itr->first;
+    size_t remaining_length = extent_itr->second - length;
+    free_extents.erase(extent_itr);
+
+    if (remaining_length != 0) {
+      free_extents.emplace(offset + length, remaining_length);
+    }
+    return offset;
+  }
+
+  // Append to the file
+  off_t offset = file_size;
+  file_size += length;
+  return offset;
+}
+
+void EvictionManager::ReleaseExtent(off_t offset, size_t length) {
+  auto next_itr = free_extents.lower_bound(offset);
+
+  // Merge with the following extent
+  if (next_itr != free_extents.end() &&
+      next_itr->first == static_cast<off_t>(offset + length)) {
+    length += next_itr->second;
+    next_itr = free_extents.erase(next_itr);
+  }
+
+  // Merge with the preceding extent
+  if (next_itr != free_extents.begin()) {
+    auto prev_itr = std::prev(next_itr);
+    if (prev_itr->first + static_cast<off_t>(prev_itr->second) == offset) {
+      offset = prev_itr->first;
+      length += prev_itr->second;
+      free_extents.erase(prev_itr);
+    }
+  }
+
+  // Give the tail of the file back
+  if (static_cast<off_t>(offset + length) == file_size) {
+    file_size = offset;
+    if (file_fd != -1 && ftruncate(file_fd, file_size) != 0) {
+      LOG_ERROR("Could not truncate block file %s", file_name.c_str());
+    }
+    return;
+  }
+
+  free_extents.emplace(offset, length);
+}
+
+}  // End storage namespace
+}  // End peloton namespace
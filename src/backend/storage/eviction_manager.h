@@ -0,0 +1,211 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// eviction_manager.h
+//
+// Identification: src/backend/storage/eviction_manager.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "backend/catalog/schema.h"
+#include "backend/common/serializer.h"
+#include "backend/common/types.h"
+#include "backend/storage/tile_group.h"
+
+//===--------------------------------------------------------------------===//
+// GUC Variables
+//===--------------------------------------------------------------------===//
+
+// Kilobytes of tuple storage the tile groups may take in memory before cold
+// ones get evicted, zero turns eviction off
+extern int peloton_eviction_budget;
+
+namespace peloton {
+
+class TaskGroup;
+
+namespace storage {
+
+class DataTable;
+
+#define EVICTION_FILE_NAME "peloton.anticache"
+
+//===--------------------------------------------------------------------===//
+// Eviction Manager
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Anti-caching of cold tile groups.
+ *
+ * Every lookup through the catalog stamps the tile group with the current
+ * access epoch, and every eviction pass starts a new epoch. A pass writes
+ * the tile groups that went untouched for a few epochs to a block file and
+ * drops them from the catalog, keeping only a small stub to rebuild them.
+ *
+ * Only immutable tile groups are evicted: full, with no slot owned by a
+ * running transaction, and not referenced by anyone but the catalog.
+ * Item pointers stay valid, since an evicted tile group comes back under
+ * the same oid. A catalog lookup of an evicted tile group faults it back
+ * in synchronously; scans call Prefetch() to fetch the tile groups ahead
+ * of them on the task scheduler.
+ *
+ * Tables call EnforceBudget() whenever they add a tile group, which runs an
+ * eviction pass over the table once the tile groups in memory outgrow the
+ * peloton_eviction_budget. An epoch thus lasts about one tile group
+ * allocation while over budget.
+ */
+class EvictionManager {
+  EvictionManager(EvictionManager const &) = delete;
+  EvictionManager &operator=(EvictionManager const &) = delete;
+
+ public:
+  // The block file is created on the first eviction
+  EvictionManager(const std::string &file_name);
+
+  ~EvictionManager();
+
+  // Singleton
+  static EvictionManager &GetInstance();
+
+  static uint64_t GetAccessEpoch() {
+    return access_epoch.load(std::memory_order_relaxed);
+  }
+
+  // Cheap check done by the catalog before looking for a stub
+  static bool HasEvictedTileGroups() {
+    return evicted_tile_group_count.load(std::memory_order_acquire) != 0;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Eviction
+  //===--------------------------------------------------------------------===//
+
+  /**
+   * @brief Start a new access epoch and evict the table's tile groups that
+   * were not looked up during the last cold_epoch_count epochs.
+   * The last tile group of the table is never evicted.
+   * @return # of evicted tile groups.
+   */
+  size_t EvictColdTileGroups(DataTable *table, uint64_t cold_epoch_count = 1);
+
+  // Evict the tile group if it is immutable and nobody else holds it
+  bool EvictTileGroup(const oid_t tile_group_id);
+
+  // Evict the table's cold tile groups if the tile groups in memory take
+  // more than the budget. Only one pass runs at a time, the others skip.
+  size_t EnforceBudget(DataTable *table);
+
+  //===--------------------------------------------------------------------===//
+  // Fault In
+  //===--------------------------------------------------------------------===//
+
+  // Bring the tile group back into the catalog.
+  // Returns null if the tile group was never evicted.
+  std::shared_ptr<TileGroup> FetchTileGroup(const oid_t tile_group_id);
+
+  // Fetch the tile group in the background if it is evicted
+  void Prefetch(const oid_t tile_group_id);
+
+  // Wait for the prefetches issued so far
+  void WaitForPrefetches();
+
+  //===--------------------------------------------------------------------===//
+  // Maintenance
+  //===--------------------------------------------------------------------===//
+
+  bool IsEvicted(const oid_t tile_group_id);
+
+  // Forget the evicted tile group, e.g. when its table is dropped
+  void DropTileGroup(const oid_t tile_group_id);
+
+  // Forget all evicted tile groups
+  void Clear();
+
+  size_t GetEvictedTileGroupCount() const {
+    return evicted_tile_group_count.load(std::memory_order_relaxed);
+  }
+
+  // # of bytes of the block file holding evicted tile groups
+  size_t GetEvictedSize() const { return evicted_size; }
+
+ private:
+  // What is needed to rebuild an evicted tile group
+  struct TileGroupStub {
+    oid_t database_id;
+    oid_t table_id;
+    AbstractTable *table;
+    std::vector<catalog::Schema> schemas;
+    column_map_type column_map;
+    oid_t tuple_count;
+
+    // location in the block file
+    off_t offset;
+    size_t length;
+  };
+
+  // Is every slot allocated and settled ?
+  static bool IsImmutable(TileGroup *tile_group);
+
+  bool OpenBlockFile();
+
+  // First fit over the free extents, growing the file if needed
+  off_t AllocateExtent(size_t length);
+
+  void ReleaseExtent(off_t offset, size_t length);
+
+  void DropStubLocked(
+      std::unordered_map<oid_t, TileGroupStub>::iterator stub_itr);
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  // bumped by every eviction pass
+  static std::atomic<uint64_t> access_epoch;
+
+  static std::atomic<size_t> evicted_tile_group_count;
+
+  std::string file_name;
+
+  int file_fd = -1;
+
+  off_t file_size = 0;
+
+  // free extents of the block file : offset -> length
+  std::map<off_t, size_t> free_extents;
+
+  std::unordered_map<oid_t, TileGroupStub> stubs;
+
+  size_t evicted_size = 0;
+
+  // reused to serialize tile groups
+  CopySerializeOutput output;
+
+  // tile groups with a prefetch in flight
+  std::unordered_set<oid_t> pending_prefetches;
+
+  std::unique_ptr<TaskGroup> prefetch_group;
+
+  // held by the pass enforcing the budget
+  std::mutex budget_mutex;
+
+  // guards everything above, and serializes evictions and fault-ins
+  std::mutex eviction_mutex;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,586 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// slab_allocator.cpp
+//
+// Identification: src/backend/storage/slab_allocator.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/common/logger.h"
+#include "backend/storage/slab_allocator.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <libpmem.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace peloton {
+namespace storage {
+
+#define SLAB_SEGMENT_MAGIC UINT64_C(0x50454c4f544f4e31)
+
+SlabAllocator::SlabAllocator(const std::string &file_name, size_t initial_size)
+    : file_name(file_name),
+      file_fd(-1),
+      is_pmem(false),
+      segment_count(0),
+      slab_infos(SLAB_MAX_SEGMENT_COUNT * SLABS_PER_SEGMENT),
+      allocated_size(0),
+      has_dirty_bitmaps(false),
+      has_recovered_blocks(false) {
+  static_assert(sizeof(SegmentHeader) <= SLAB_SIZE,
+                "segment metadata must fit in a slab");
+
+  // Open the data file
+  if ((file_fd = open(file_name.c_str(), O_CREAT | O_RDWR, 0666)) < 0) {
+    perror(file_name.c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  struct stat file_stat;
+  if (fstat(file_fd, &file_stat) != 0) {
+    perror("fstat");
+    exit(EXIT_FAILURE);
+  }
+
+  for (auto &dirty_bitmap : dirty_bitmaps) {
+    dirty_bitmap.store(false, std::memory_order_relaxed);
+  }
+
+  // Existing segments get recovered
+  size_t existing_segment_count = file_stat.st_size / SLAB_SEGMENT_SIZE;
+  size_t initial_segment_count =
+      (initial_size + SLAB_SEGMENT_SIZE - 1) / SLAB_SEGMENT_SIZE;
+  initial_segment_count = std::max<size_t>(
+      {initial_segment_count, existing_segment_count, 1});
+  initial_segment_count =
+      std::min<size_t>(initial_segment_count, SLAB_MAX_SEGMENT_COUNT);
+
+  // Allocate the data file
+  if ((errno = posix_fallocate(file_fd, 0, initial_segment_count *
+                                               SLAB_SEGMENT_SIZE)) != 0) {
+    perror("posix_fallocate");
+    exit(EXIT_FAILURE);
+  }
+
+  for (oid_t segment_itr = 0; segment_itr < initial_segment_count;
+       segment_itr++) {
+    bool recover = (segment_itr < existing_segment_count);
+    if (MapSegment(segment_itr, recover) == false) {
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  has_recovered_blocks =
+      !recovered_bitmaps.empty() || !recovered_large_heads.empty();
+
+  LOG_INFO("Data file %s : %lu segments (%lu recovered), %lu bytes in use",
+           file_name.c_str(), initial_segment_count, existing_segment_count,
+           allocated_size.load());
+}
+
+SlabAllocator::~SlabAllocator() {
+  SyncBitmaps();
+
+  for (oid_t segment_itr = 0; segment_itr < segment_count; segment_itr++) {
+    munmap(segments[segment_itr], SLAB_SEGMENT_SIZE);
+  }
+
+  close(file_fd);
+}
+
+//===--------------------------------------------------------------------===//
+// Allocation
+//===--------------------------------------------------------------------===//
+
+void *SlabAllocator::Allocate(size_t size) {
+  if (size > GetBlockSize(SLAB_SIZE_CLASS_COUNT - 1)) {
+    return AllocateLarge(size);
+  }
+
+  uint32_t size_class = 0;
+  while (GetBlockSize(size_class) < size) size_class++;
+
+  return AllocateSmall(size_class);
+}
+
+SlabAllocator::Arena &SlabAllocator::GetArena(oid_t &arena_id) {
+  // Threads are spread over the arenas on first use
+  static std::atomic<oid_t> next_arena_id(0);
+  static thread_local oid_t thread_arena_id =
+      next_arena_id++ % SLAB_ARENA_COUNT;
+
+  arena_id = thread_arena_id;
+  return arenas[arena_id];
+}
+
+void *SlabAllocator::AllocateSmall(uint32_t size_class) {
+  oid_t arena_id;
+  auto &arena = GetArena(arena_id);
+  std::lock_guard<std::mutex> arena_lock(arena.arena_mutex);
+
+  // Get a slab with free blocks
+  auto &partial_slabs = arena.partial_slabs[size_class];
+  if (partial_slabs.empty()) {
+    std::lock_guard<std::mutex> allocator_lock(allocator_mutex);
+
+    oid_t slab_id = FindFreeSlabs(1);
+    if (slab_id == INVALID_OID) return nullptr;
+
+    slab_infos[slab_id] = SlabInfo();
+    slab_infos[slab_id].arena_id = arena_id;
+
+    // The cleared bits of the slab's last use may not have been flushed
+    // before a crash
+    memset(GetSlabBitmap(slab_id), 0, sizeof(uint64_t) * SLAB_BITMAP_WORDS);
+    SetSlabDescriptor(slab_id, SLAB_STATE_SMALL, size_class);
+
+    partial_slabs.push_back(slab_id);
+  }
+
+  oid_t slab_id = partial_slabs.back();
+  auto &slab_info = slab_infos[slab_id];
+  uint64_t *bitmap = GetSlabBitmap(slab_id);
+  const size_t block_count = GetBlockCount(size_class);
+
+  // Find a free block
+  oid_t word_itr = slab_info.search_hint;
+  uint64_t free_bits;
+  for (;; word_itr++) {
+    assert(word_itr * 64 < block_count);
+    free_bits = ~bitmap[word_itr];
+
+    // Ignore the bits past the last block
+    size_t remaining_blocks = block_count - word_itr * 64;
+    if (remaining_blocks < 64) {
+      free_bits &= (UINT64_C(1) << remaining_blocks) - 1;
+    }
+
+    if (free_bits != 0) break;
+  }
+
+  size_t block_id = word_itr * 64 + __builtin_ctzll(free_bits);
+
+  bitmap[word_itr] |= UINT64_C(1) << (block_id % 64);
+  PersistBitmapWord(slab_id, &bitmap[word_itr]);
+
+  slab_info.search_hint = word_itr;
+  if (++slab_info.used_blocks == block_count) {
+    partial_slabs.pop_back();
+  }
+
+  allocated_size += GetBlockSize(size_class);
+
+  return GetSlabAddress(slab_id) + block_id * GetBlockSize(size_class);
+}
+
+void *SlabAllocator::AllocateLarge(size_t size) {
+  oid_t slab_count = (size + SLAB_SIZE - 1) / SLAB_SIZE;
+  if (slab_count >= SLABS_PER_SEGMENT) {
+    LOG_ERROR("Allocation of %lu bytes does not fit in a segment", size);
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> allocator_lock(allocator_mutex);
+
+  oid_t slab_id = FindFreeSlabs(slab_count);
+  if (slab_id == INVALID_OID) return nullptr;
+
+  // The run is allocated once its head is durable
+  for (oid_t slab_itr = 1; slab_itr < slab_count; slab_itr++) {
+    SetSlabDescriptor(slab_id + slab_itr, SLAB_STATE_LARGE_BODY, 0);
+  }
+  SetSlabDescriptor(slab_id, SLAB_STATE_LARGE_HEAD, slab_count);
+
+  allocated_size += slab_count * SLAB_SIZE;
+
+  return GetSlabAddress(slab_id);
+}
+
+oid_t SlabAllocator::FindFreeSlabs(oid_t slab_count) {
+  for (oid_t segment_itr = 0;; segment_itr++) {
+    // Grow the data file by a segment
+    if (segment_itr == segment_count) {
+      if (segment_itr == SLAB_MAX_SEGMENT_COUNT) {
+        LOG_ERROR("Data file %s is full", file_name.c_str());
+        return INVALID_OID;
+      }
+
+      if ((errno = posix_fallocate(file_fd, 0, (segment_itr + 1) *
+                                                   SLAB_SEGMENT_SIZE)) != 0) {
+        perror("posix_fallocate");
+        return INVALID_OID;
+      }
+
+      if (MapSegment(segment_itr, false) == false) {
+        return INVALID_OID;
+      }
+    }
+
+    auto header = GetSegmentHeader(segment_itr);
+    oid_t run_length = 0;
+
+    for (oid_t slab_itr = 1; slab_itr < SLABS_PER_SEGMENT; slab_itr++) {
+      if (header->slabs[slab_itr].state != SLAB_STATE_FREE) {
+        run_length = 0;
+        continue;
+      }
+
+      if (++run_length == slab_count) {
+        return segment_itr * SLABS_PER_SEGMENT + slab_itr - slab_count + 1;
+      }
+    }
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Release
+//===--------------------------------------------------------------------===//
+
+void SlabAllocator::Release(void *address) {
+  if (address == nullptr) return;
+
+  oid_t slab_id = GetSlabId(address);
+  if (slab_id == INVALID_OID) {
+    LOG_ERROR("Address %p is not in data file %s", address, file_name.c_str());
+    return;
+  }
+
+  // A released block of the last run must not be swept again
+  if (has_recovered_blocks) {
+    ForgetRecovered(slab_id, address);
+  }
+
+  // A slab doesn't change its state while it has live blocks
+  switch (GetSlabDescriptor(slab_id).state) {
+    case SLAB_STATE_SMALL:
+      ReleaseSmall(slab_id, reinterpret_cast<const char *>(address));
+      break;
+
+    case SLAB_STATE_LARGE_HEAD:
+      ReleaseLarge(slab_id);
+      break;
+
+    default:
+      LOG_ERROR("Address %p was not allocated", address);
+      break;
+  }
+}
+
+void SlabAllocator::ReleaseSmall(oid_t slab_id, const char *address) {
+  auto &slab_info = slab_infos[slab_id];
+  auto &arena = arenas[slab_info.arena_id];
+  std::lock_guard<std::mutex> arena_lock(arena.arena_mutex);
+
+  uint32_t size_class = GetSlabDescriptor(slab_id).size;
+  const size_t block_size = GetBlockSize(size_class);
+  const size_t block_count = GetBlockCount(size_class);
+
+  size_t block_id = (address - GetSlabAddress(slab_id)) / block_size;
+  oid_t word_itr = block_id / 64;
+  uint64_t block_bit = UINT64_C(1) << (block_id % 64);
+
+  uint64_t *bitmap = GetSlabBitmap(slab_id);
+  assert(bitmap[word_itr] & block_bit);
+
+  bitmap[word_itr] &= ~block_bit;
+  PersistBitmapWord(slab_id, &bitmap[word_itr]);
+
+  allocated_size -= block_size;
+
+  auto &partial_slabs = arena.partial_slabs[size_class];
+  if (slab_info.used_blocks-- == block_count) {
+    partial_slabs.push_back(slab_id);
+  }
+
+  if (word_itr < slab_info.search_hint) {
+    slab_info.search_hint = word_itr;
+  }
+
+  // Give empty slabs back, but keep one around for the arena
+  if (slab_info.used_blocks == 0 && partial_slabs.size() > 1) {
+    partial_slabs.erase(
+        std::find(partial_slabs.begin(), partial_slabs.end(), slab_id));
+
+    std::lock_guard<std::mutex> allocator_lock(allocator_mutex);
+    SetSlabDescriptor(slab_id, SLAB_STATE_FREE, 0);
+  }
+}
+
+void SlabAllocator::ReleaseLarge(oid_t slab_id) {
+  std::lock_guard<std::mutex> allocator_lock(allocator_mutex);
+
+  oid_t slab_count = GetSlabDescriptor(slab_id).size;
+
+  // Drop the head first, recovery frees bodies without a head
+  SetSlabDescriptor(slab_id, SLAB_STATE_FREE, 0);
+  for (oid_t slab_itr = 1; slab_itr < slab_count; slab_itr++) {
+    SetSlabDescriptor(slab_id + slab_itr, SLAB_STATE_FREE, 0);
+  }
+
+  allocated_size -= slab_count * SLAB_SIZE;
+}
+
+//===--------------------------------------------------------------------===//
+// Recovered Blocks
+//===--------------------------------------------------------------------===//
+
+size_t SlabAllocator::ReleaseRecovered() {
+  std::lock_guard<std::mutex> recovery_lock(recovery_mutex);
+  size_t released_size = 0;
+
+  for (auto &entry : recovered_bitmaps) {
+    oid_t slab_id = entry.first;
+    auto &bitmap = entry.second;
+
+    // The slab is freed along with its last block
+    const size_t block_size = GetBlockSize(GetSlabDescriptor(slab_id).size);
+    const char *slab_address = GetSlabAddress(slab_id);
+
+    for (oid_t word_itr = 0; word_itr < bitmap.size(); word_itr++) {
+      for (uint64_t bits = bitmap[word_itr]; bits != 0; bits &= bits - 1) {
+        size_t block_id = word_itr * 64 + __builtin_ctzll(bits);
+        ReleaseSmall(slab_id, slab_address + block_id * block_size);
+        released_size += block_size;
+      }
+    }
+  }
+
+  for (auto slab_id : recovered_large_heads) {
+    released_size += GetSlabDescriptor(slab_id).size * SLAB_SIZE;
+    ReleaseLarge(slab_id);
+  }
+
+  recovered_bitmaps.clear();
+  recovered_large_heads.clear();
+  has_recovered_blocks = false;
+
+  SyncBitmaps();
+
+  LOG_INFO("Data file %s : released %lu recovered bytes", file_name.c_str(),
+           released_size);
+
+  return released_size;
+}
+
+void SlabAllocator::ForgetRecovered(oid_t slab_id, const void *address) {
+  std::lock_guard<std::mutex> recovery_lock(recovery_mutex);
+  auto &descriptor = GetSlabDescriptor(slab_id);
+
+  switch (descriptor.state) {
+    case SLAB_STATE_SMALL: {
+      auto entry = recovered_bitmaps.find(slab_id);
+      if (entry == recovered_bitmaps.end()) break;
+
+      size_t block_id = (reinterpret_cast<const char *>(address) -
+                         GetSlabAddress(slab_id)) /
+                        GetBlockSize(descriptor.size);
+      entry->second[block_id / 64] &= ~(UINT64_C(1) << (block_id % 64));
+    } break;
+
+    case SLAB_STATE_LARGE_HEAD:
+      recovered_large_heads.erase(slab_id);
+      break;
+
+    default:
+      break;
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Segments
+//===--------------------------------------------------------------------===//
+
+oid_t SlabAllocator::GetSlabId(const void *address) const {
+  const char *location = reinterpret_cast<const char *>(address);
+
+  size_t mapped_segment_count = segment_count;
+  for (oid_t segment_itr = 0; segment_itr < mapped_segment_count;
+       segment_itr++) {
+    const char *segment = segments[segment_itr];
+    if (location >= segment && location < segment + SLAB_SEGMENT_SIZE) {
+      return segment_itr * SLABS_PER_SEGMENT + (location - segment) / SLAB_SIZE;
+    }
+  }
+
+  return INVALID_OID;
+}
+
+void SlabAllocator::SetSlabDescriptor(oid_t slab_id, SlabState state,
+                                      uint32_t size) {
+  auto &descriptor = GetSlabDescriptor(slab_id);
+  descriptor = {state, size};
+  Persist(&descriptor, sizeof(SlabDescriptor));
+}
+
+bool SlabAllocator::MapSegment(oid_t segment_id, bool recover) {
+  // Every segment gets its own mapping, so that growing the file
+  // never moves the existing ones
+  void *address = mmap(nullptr, SLAB_SEGMENT_SIZE, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, file_fd, segment_id * SLAB_SEGMENT_SIZE);
+  if (address == MAP_FAILED) {
+    perror("mmap");
+    return false;
+  }
+
+  segments[segment_id] = reinterpret_cast<char *>(address);
+
+  // true only if the entire range consists of persistent memory
+  if (segment_id == 0) {
+    is_pmem = pmem_is_pmem(address, SLAB_SEGMENT_SIZE);
+  }
+
+  auto header = GetSegmentHeader(segment_id);
+  if (recover == true && header->magic == SLAB_SEGMENT_MAGIC &&
+      header->segment_id == segment_id) {
+    RecoverSegment(segment_id);
+  } else {
+    FormatSegment(segment_id);
+  }
+
+  // Publish the segment
+  segment_count++;
+
+  return true;
+}
+
+void SlabAllocator::FormatSegment(oid_t segment_id) {
+  auto header = GetSegmentHeader(segment_id);
+
+  // Invalidate the segment first, a torn format gets redone on recovery
+  header->magic = 0;
+  Persist(&header->magic, sizeof(header->magic));
+
+  memset(header, 0, sizeof(SegmentHeader));
+  header->segment_id = segment_id;
+  header->slabs[0] = {SLAB_STATE_METADATA, 0};
+  Persist(header, sizeof(SegmentHeader));
+
+  header->magic = SLAB_SEGMENT_MAGIC;
+  Persist(&header->magic, sizeof(header->magic));
+}
+
+/**
+ * Rebuild the volatile state of a segment from its metadata.
+ * Empty small slabs and large runs that lost their head become free,
+ * the allocated blocks are left for ReleaseRecovered().
+ */
+void SlabAllocator::RecoverSegment(oid_t segment_id) {
+  auto header = GetSegmentHeader(segment_id);
+  oid_t first_slab_id = segment_id * SLABS_PER_SEGMENT;
+  std::vector<bool> in_large_run(SLABS_PER_SEGMENT, false);
+
+  for (oid_t slab_itr = 1; slab_itr < SLABS_PER_SEGMENT; slab_itr++) {
+    oid_t slab_id = first_slab_id + slab_itr;
+    auto &descriptor = header->slabs[slab_itr];
+
+    switch (descriptor.state) {
+      case SLAB_STATE_SMALL: {
+        uint32_t size_class = descriptor.size;
+        size_t used_blocks = 0;
+
+        if (size_class < SLAB_SIZE_CLASS_COUNT) {
+          for (auto bitmap_word : header->bitmaps[slab_itr]) {
+            used_blocks += __builtin_popcountll(bitmap_word);
+          }
+        }
+
+        if (used_blocks == 0) {
+          memset(header->bitmaps[slab_itr], 0, sizeof(header->bitmaps[0]));
+          Persist(header->bitmaps[slab_itr], sizeof(header->bitmaps[0]));
+          SetSlabDescriptor(slab_id, SLAB_STATE_FREE, 0);
+          break;
+        }
+
+        auto &slab_info = slab_infos[slab_id];
+        slab_info = SlabInfo();
+        slab_info.arena_id = slab_id % SLAB_ARENA_COUNT;
+        slab_info.used_blocks = used_blocks;
+
+        if (used_blocks < GetBlockCount(size_class)) {
+          arenas[slab_info.arena_id].partial_slabs[size_class].push_back(
+              slab_id);
+        }
+
+        allocated_size += used_blocks * GetBlockSize(size_class);
+        recovered_bitmaps[slab_id].assign(
+            header->bitmaps[slab_itr],
+            header->bitmaps[slab_itr] + SLAB_BITMAP_WORDS);
+      } break;
+
+      case SLAB_STATE_LARGE_HEAD: {
+        oid_t slab_count = descriptor.size;
+        if (slab_count == 0 || slab_itr + slab_count > SLABS_PER_SEGMENT) {
+          SetSlabDescriptor(slab_id, SLAB_STATE_FREE, 0);
+          break;
+        }
+
+        std::fill(in_large_run.begin() + slab_itr,
+                  in_large_run.begin() + slab_itr + slab_count, true);
+        allocated_size += slab_count * SLAB_SIZE;
+        recovered_large_heads.insert(slab_id);
+      } break;
+
+      default:
+        break;
+    }
+  }
+
+  // Free the bodies of large runs whose head never made it
+  for (oid_t slab_itr = 1; slab_itr < SLABS_PER_SEGMENT; slab_itr++) {
+    if (header->slabs[slab_itr].state == SLAB_STATE_LARGE_BODY &&
+        in_large_run[slab_itr] == false) {
+      SetSlabDescriptor(first_slab_id + slab_itr, SLAB_STATE_FREE, 0);
+    }
+  }
+}
+
+void SlabAllocator::Persist(const void *address, size_t length) {
+  // flush writes for persistence
+  if (is_pmem)
+    pmem_persist(const_cast<void *>(address), length);
+  else
+    pmem_msync(const_cast<void *>(address), length);
+}
+
+void SlabAllocator::PersistBitmapWord(oid_t slab_id, uint64_t *bitmap_word) {
+  // Flushing a cache line is cheap, an msync is not
+  if (is_pmem) {
+    pmem_persist(bitmap_word, sizeof(uint64_t));
+    return;
+  }
+
+  dirty_bitmaps[slab_id / SLABS_PER_SEGMENT].store(true,
+                                                   std::memory_order_release);
+  has_dirty_bitmaps.store(true, std::memory_order_release);
+}
+
+void SlabAllocator::SyncBitmaps() {
+  if (has_dirty_bitmaps.exchange(false) == false) return;
+
+  // Bits changed from here on mark their segment dirty again
+  size_t mapped_segment_count = segment_count;
+  for (oid_t segment_itr = 0; segment_itr < mapped_segment_count;
+       segment_itr++) {
+    if (dirty_bitmaps[segment_itr].exchange(false) == false) continue;
+
+    auto header = GetSegmentHeader(segment_itr);
+    Persist(header->bitmaps, sizeof(header->bitmaps));
+  }
+}
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,247 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// slab_allocator.h
+//
+// Identification: src/backend/storage/slab_allocator.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "backend/common/types.h"
+
+namespace peloton {
+namespace storage {
+
+// The data file grows a segment at a time
+#define SLAB_SEGMENT_SIZE (64 * 1024 * 1024)  // 64 MB
+#define SLAB_SIZE (1024 * 1024)               // 1 MB
+#define SLABS_PER_SEGMENT (SLAB_SEGMENT_SIZE / SLAB_SIZE)
+#define SLAB_MAX_SEGMENT_COUNT 1024  // 64 GB
+
+// Small blocks come in power-of-two size classes, from 64 B up to 512 KB.
+// Larger requests get a run of whole slabs.
+#define SLAB_MIN_BLOCK_SIZE 64
+#define SLAB_SIZE_CLASS_COUNT 14
+#define SLAB_BITMAP_WORDS (SLAB_SIZE / SLAB_MIN_BLOCK_SIZE / 64)
+
+// # of arenas, threads are spread over them
+#define SLAB_ARENA_COUNT 8
+
+//===--------------------------------------------------------------------===//
+// Slab Allocator
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Persistent allocator over a memory-mapped data file.
+ *
+ * The file is a sequence of fixed-size segments, each mapped on its own so
+ * that growing the file never moves memory that was handed out. The first
+ * slab of every segment holds its metadata: the state of every slab, and
+ * an allocation bitmap for every slab of small blocks.
+ *
+ * The metadata is the persistent free list. Slab states are persisted as
+ * they change, the head of a large run last on allocation and first on
+ * release. Bitmap words are persisted right away on persistent memory;
+ * elsewhere that would be an msync per allocation, so the changed bitmaps
+ * are only flushed by SyncBitmaps(), which runs before data is synced.
+ * A bit lost in a crash is harmless: see below. On restart the volatile
+ * free lists are rebuilt from the bitmaps, and a half-written large run
+ * is dropped.
+ *
+ * The blocks found allocated on restart belong to the last run. Recovery
+ * rebuilds the tables in new tile groups, so nothing refers to them
+ * anymore, and ReleaseRecovered() gives them all back once recovery is
+ * done, so that the data file doesn't grow on every restart.
+ *
+ * Threads are spread over arenas. Every small slab belongs to one arena,
+ * whose lock guards its bitmap; slab-level changes take the global lock.
+ */
+class SlabAllocator {
+  SlabAllocator(SlabAllocator const &) = delete;
+  SlabAllocator &operator=(SlabAllocator const &) = delete;
+
+ public:
+  /**
+   * @brief Open or create the data file.
+   * The metadata of an existing data file is recovered, a new one is
+   * formatted with enough segments to cover initial_size.
+   */
+  SlabAllocator(const std::string &file_name, size_t initial_size);
+
+  ~SlabAllocator();
+
+  // nullptr if the file can't grow anymore
+  void *Allocate(size_t size);
+
+  void Release(void *address);
+
+  // Flush writes to the data file
+  void Persist(const void *address, size_t length);
+
+  // Flush the bitmaps changed since the last flush
+  void SyncBitmaps();
+
+  // Release the blocks still allocated from the last run,
+  // returns the # of bytes released
+  size_t ReleaseRecovered();
+
+  size_t GetSegmentCount() const { return segment_count; }
+
+  // # of bytes in blocks that are currently allocated
+  size_t GetAllocatedSize() const { return allocated_size; }
+
+ private:
+  enum SlabState : uint32_t {
+    SLAB_STATE_FREE = 0,
+    SLAB_STATE_METADATA = 1,
+    SLAB_STATE_SMALL = 2,
+    SLAB_STATE_LARGE_HEAD = 3,
+    SLAB_STATE_LARGE_BODY = 4
+  };
+
+  struct SlabDescriptor {
+    SlabState state;
+
+    // size class for small slabs, # of slabs in the run for large heads
+    uint32_t size;
+  };
+
+  // Persistent segment metadata, at the start of every segment
+  struct SegmentHeader {
+    uint64_t magic;
+    uint64_t segment_id;
+    SlabDescriptor slabs[SLABS_PER_SEGMENT];
+    uint64_t bitmaps[SLABS_PER_SEGMENT][SLAB_BITMAP_WORDS];
+  };
+
+  // Volatile slab state
+  struct SlabInfo {
+    uint32_t arena_id = 0;
+    uint32_t used_blocks = 0;
+    // first bitmap word that may have a free block
+    uint32_t search_hint = 0;
+  };
+
+  struct Arena {
+    std::mutex arena_mutex;
+
+    // small slabs with free blocks, per size class
+    std::vector<oid_t> partial_slabs[SLAB_SIZE_CLASS_COUNT];
+  };
+
+  static inline size_t GetBlockSize(uint32_t size_class) {
+    return SLAB_MIN_BLOCK_SIZE << size_class;
+  }
+
+  static inline size_t GetBlockCount(uint32_t size_class) {
+    return SLAB_SIZE / GetBlockSize(size_class);
+  }
+
+  inline SegmentHeader *GetSegmentHeader(oid_t segment_id) const {
+    return reinterpret_cast<SegmentHeader *>(segments[segment_id]);
+  }
+
+  inline SlabDescriptor &GetSlabDescriptor(oid_t slab_id) const {
+    return GetSegmentHeader(slab_id / SLABS_PER_SEGMENT)
+        ->slabs[slab_id % SLABS_PER_SEGMENT];
+  }
+
+  inline uint64_t *GetSlabBitmap(oid_t slab_id) const {
+    return GetSegmentHeader(slab_id / SLABS_PER_SEGMENT)
+        ->bitmaps[slab_id % SLABS_PER_SEGMENT];
+  }
+
+  inline char *GetSlabAddress(oid_t slab_id) const {
+    return segments[slab_id / SLABS_PER_SEGMENT] +
+           (slab_id % SLABS_PER_SEGMENT) * SLAB_SIZE;
+  }
+
+  // Slab containing the address, INVALID_OID if not in the data file
+  oid_t GetSlabId(const void *address) const;
+
+  Arena &GetArena(oid_t &arena_id);
+
+  void *AllocateSmall(uint32_t size_class);
+
+  void *AllocateLarge(size_t size);
+
+  void ReleaseSmall(oid_t slab_id, const char *address);
+
+  void ReleaseLarge(oid_t slab_id);
+
+  // Find a run of free slabs, growing the file if needed.
+  // Must hold the allocator lock.
+  oid_t FindFreeSlabs(oid_t slab_count);
+
+  void SetSlabDescriptor(oid_t slab_id, SlabState state, uint32_t size);
+
+  // Map a segment of the data file, formatting it unless recovering
+  bool MapSegment(oid_t segment_id, bool recover);
+
+  void FormatSegment(oid_t segment_id);
+
+  void RecoverSegment(oid_t segment_id);
+
+  // Persist a changed bitmap word, or leave it to SyncBitmaps()
+  void PersistBitmapWord(oid_t slab_id, uint64_t *bitmap_word);
+
+  // Forget a recovered block, it was released
+  void ForgetRecovered(oid_t slab_id, const void *address);
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  std::string file_name;
+
+  int file_fd;
+
+  // is the data file on persistent memory ?
+  bool is_pmem;
+
+  // segment mappings, only ever appended to
+  char *segments[SLAB_MAX_SEGMENT_COUNT];
+
+  std::atomic<size_t> segment_count;
+
+  std::vector<SlabInfo> slab_infos;
+
+  Arena arenas[SLAB_ARENA_COUNT];
+
+  std::atomic<size_t> allocated_size;
+
+  // guards slab states and file growth
+  // (taken after any arena lock)
+  std::mutex allocator_mutex;
+
+  // segments whose bitmaps changed since the last flush
+  std::atomic<bool> dirty_bitmaps[SLAB_MAX_SEGMENT_COUNT];
+
+  std::atomic<bool> has_dirty_bitmaps;
+
+  // recovered blocks that are not released yet,
+  // per small slab, and the heads of such large runs
+  std::map<oid_t, std::vector<uint64_t>> recovered_bitmaps;
+
+  std::set<oid_t> recovered_large_heads;
+
+  std::atomic<bool> has_recovered_blocks;
+
+  // guards the recovered blocks (taken before any other lock)
+  std::mutex recovery_mutex;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -12,6 +12,7 @@
 
 #include "backend/common/logger.h"
 #include "backend/storage/storage_manager.h"
+#include "backend/storage/slab_allocator.h"
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -21,7 +22,6 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
-#include <libpmem.h>
 
 #include <string>
 #include <iostream>
@@ -47,18 +47,14 @@ StorageManager &StorageManager::GetInstance(void) {
   return storage_manager;
 }
 
-StorageManager::StorageManager()
-    : data_file_address(nullptr),
-      is_pmem(false),
-      data_file_len(0),
-      data_file_offset(0) {
+StorageManager::StorageManager() {
   // Check if we need a data pool
   if (IsSimilarToARIES(peloton_logging_mode) == true ||
       peloton_logging_mode == LOGGING_TYPE_INVALID) {
     return;
   }
 
-  int data_fd;
+  size_t data_file_len;
   std::string data_file_name;
   struct stat data_stat;
 
@@ -117,40 +113,12 @@ StorageManager::StorageManager()
 
   LOG_INFO("DATA DIR :: %s ", data_file_name.c_str());
 
-  // Create a data file
-  if ((data_fd = open(data_file_name.c_str(), O_CREAT | O_RDWR, 0666)) < 0) {
-    perror(data_file_name.c_str());
-    exit(EXIT_FAILURE);
-  }
-
-  // Allocate the data file
-  if ((errno = posix_fallocate(data_fd, 0, data_file_len)) != 0) {
-    perror("posix_fallocate");
-    exit(EXIT_FAILURE);
-  }
-
-  // memory map the data file
-  if ((data_file_address = reinterpret_cast<char *>(pmem_map(data_fd))) ==
-      NULL) {
-    perror("pmem_map");
-    exit(EXIT_FAILURE);
-  }
-
-  // true only if the entire range [addr, addr+len) consists of persistent
-  // memory
-  is_pmem = pmem_is_pmem(data_file_address, data_file_len);
-
-  // close the pmem file -- it will remain mapped
-  close(data_fd);
+  // Open the data file, recovering the allocator state of the last run.
+  // The file grows in segments once the initial size is used up.
+  data_file_allocator.reset(new SlabAllocator(data_file_name, data_file_len));
 }
 
-StorageManager::~StorageManager() {
-  // Check if we need a PMEM pool
-  if (peloton_logging_mode != LOGGING_TYPE_NVM_NVM) return;
-
-  // unmap the pmem file
-  pmem_unmap(data_file_address, data_file_len);
-}
+StorageManager::~StorageManager() {}
 
 void *StorageManager::Allocate(BackendType type, size_t size) {
   switch (type) {
@@ -159,16 +127,9 @@ void *StorageManager::Allocate(BackendType type, size_t size) {
     } break;
 
     case BACKEND_TYPE_FILE: {
-      {
-        std::lock_guard<std::mutex> pmem_lock(pmem_mutex);
+      if (data_file_allocator == nullptr) return nullptr;
 
-        if (data_file_offset >= data_file_len) return nullptr;
-
-        void *address = data_file_address + data_file_offset;
-        // offset by requested size
-        data_file_offset += size;
-        return address;
-      }
+      return data_file_allocator->Allocate(size);
     } break;
 
     case BACKEND_TYPE_INVALID:
@@ -183,7 +144,9 @@ void StorageManager::Release(BackendType type, void *address) {
     } break;
 
     case BACKEND_TYPE_FILE: {
-      // Nothing to do here
+      if (data_file_allocator != nullptr) {
+        data_file_allocator->Release(address);
+      }
     } break;
 
     case BACKEND_TYPE_INVALID:
@@ -201,11 +164,12 @@ void StorageManager::Sync(BackendType type, void *address, size_t length) {
     } break;
 
     case BACKEND_TYPE_FILE: {
-      // flush writes for persistence
-      if (is_pmem)
-        pmem_persist(address, length);
-      else
-        pmem_msync(address, length);
+      // flush writes for persistence,
+      // along with the allocation of the blocks they went to
+      if (data_file_allocator != nullptr) {
+        data_file_allocator->SyncBitmaps();
+        data_file_allocator->Persist(address, length);
+      }
     } break;
 
     case BACKEND_TYPE_INVALID:
@@ -215,5 +179,11 @@ void StorageManager::Sync(BackendType type, void *address, size_t length) {
   }
 }
 
+void StorageManager::ReleaseRecoveredBlocks() {
+  if (data_file_allocator != nullptr) {
+    data_file_allocator->ReleaseRecovered();
+  }
+}
+
 }  // End storage namespace
 }  // End peloton namespace
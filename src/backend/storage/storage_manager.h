@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <memory>
 #include <mutex>
 
 #include "backend/common/types.h"
@@ -18,6 +19,8 @@
 namespace peloton {
 namespace storage {
 
+class SlabAllocator;
+
 //===--------------------------------------------------------------------===//
 // Filesystem directories
 //===--------------------------------------------------------------------===//
@@ -47,21 +50,12 @@ class StorageManager {
 
   void Sync(BackendType type, void *address, size_t length);
 
- private:
-  // pmem file address
-  char *data_file_address;
-
-  // pmem file synch mutex
-  std::mutex pmem_mutex;
+  // Give back the blocks of the last run, recovery doesn't refer to them
+  void ReleaseRecoveredBlocks();
 
-  // is it actually pmem ?
-  int is_pmem;
-
-  // pmem file len
-  size_t data_file_len;
-
-  // pmem offset
-  size_t data_file_offset;
+ private:
+  // allocator over the data file, only set up for the file backend
+  std::unique_ptr<SlabAllocator> data_file_allocator;
 };
 
 }  // End storage namespace
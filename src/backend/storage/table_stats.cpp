@@ -0,0 +1,354 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// table_stats.cpp
+//
+// Identification: src/backend/storage/table_stats.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cmath>
+
+#include "backend/storage/table_stats.h"
+#include "backend/common/logger.h"
+#include "backend/common/task_scheduler.h"
+#include "backend/common/value_factory.h"
+#include "backend/common/value_peeker.h"
+#include "backend/storage/data_table.h"
+#include "backend/storage/tile_group.h"
+#include "backend/storage/tile_group_header.h"
+
+namespace peloton {
+namespace storage {
+
+// Deep copy of the value, uninlined data goes to the pool
+static Value CopyValue(const Value &value, VarlenPool *pool) {
+  if (value.IsNull()) return value;
+
+  switch (value.GetValueType()) {
+    case VALUE_TYPE_VARCHAR: {
+      auto data =
+          static_cast<const char *>(ValuePeeker::PeekObjectValue(value));
+      auto length = ValuePeeker::PeekObjectLengthWithoutNull(value);
+      return ValueFactory::GetStringValue(std::string(data, length), pool);
+    }
+    case VALUE_TYPE_VARBINARY: {
+      auto data = static_cast<const unsigned char *>(
+          ValuePeeker::PeekObjectValue(value));
+      auto length = ValuePeeker::PeekObjectLengthWithoutNull(value);
+      return ValueFactory::GetBinaryValue(data, length, pool);
+    }
+    default:
+      return value;
+  }
+}
+
+// Size of a non-null value (in bytes)
+static double GetValueWidth(const Value &value) {
+  switch (value.GetValueType()) {
+    case VALUE_TYPE_VARCHAR:
+    case VALUE_TYPE_VARBINARY:
+      return ValuePeeker::PeekObjectLengthWithoutNull(value);
+    default:
+      return Value::GetTupleStorageSize(value.GetValueType());
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Summary
+//===--------------------------------------------------------------------===//
+
+TableStats::Summary::Summary(oid_t column_count)
+    : sketches(column_count),
+      null_counts(column_count, 0),
+      width_sums(column_count, 0) {}
+
+void TableStats::Summary::Merge(const Summary &other) {
+  tuple_count += other.tuple_count;
+
+  for (size_t column_itr = 0; column_itr < sketches.size(); column_itr++) {
+    sketches[column_itr].Merge(other.sketches[column_itr]);
+    null_counts[column_itr] += other.null_counts[column_itr];
+    width_sums[column_itr] += other.width_sums[column_itr];
+  }
+
+  sample_hashes.insert(sample_hashes.end(), other.sample_hashes.begin(),
+                       other.sample_hashes.end());
+  sample_tuples.insert(sample_tuples.end(), other.sample_tuples.begin(),
+                       other.sample_tuples.end());
+}
+
+void TableStats::Summary::DropSamplesAbove(uint64_t threshold) {
+  size_t kept_count = 0;
+  for (size_t sample_itr = 0; sample_itr < sample_hashes.size();
+       sample_itr++) {
+    if (sample_hashes[sample_itr] > threshold) continue;
+
+    sample_hashes[kept_count] = sample_hashes[sample_itr];
+    sample_tuples[kept_count].swap(sample_tuples[sample_itr]);
+    kept_count++;
+  }
+
+  sample_hashes.resize(kept_count);
+  sample_tuples.resize(kept_count);
+}
+
+//===--------------------------------------------------------------------===//
+// Table Stats
+//===--------------------------------------------------------------------===//
+
+TableStats::TableStats(DataTable *table)
+    : table(table), column_count(table->GetSchema()->GetColumnCount()) {}
+
+bool TableStats::IsStale() const {
+  auto stats = GetSnapshot();
+  if (stats == nullptr) return true;
+
+  // Every statement that modifies the table asks, so new tile groups alone
+  // don't count, or one insert per tile group would pay for a refresh
+  double tuple_count = table->GetNumberOfTuples();
+  return std::fabs(tuple_count - stats->tuple_count) >
+         TABLE_STATS_STALE_THRESHOLD +
+             TABLE_STATS_STALE_FRACTION * stats->tuple_count;
+}
+
+void TableStats::Refresh() {
+  std::lock_guard<std::mutex> lock(refresh_mutex);
+  RefreshLocked(false);
+}
+
+void TableStats::Rebuild() {
+  std::lock_guard<std::mutex> lock(refresh_mutex);
+  RefreshLocked(true);
+}
+
+std::shared_ptr<const TableStatsSnapshot> TableStats::GetSnapshot() const {
+  std::lock_guard<std::mutex> lock(snapshot_mutex);
+  return snapshot;
+}
+
+void TableStats::RefreshLocked(bool rebuild) {
+  if (rebuild == true || folded_summary == nullptr) {
+    folded_tile_group_count = 0;
+    folded_summary.reset(new Summary(column_count));
+    sample_pool.reset(new VarlenPool(BACKEND_TYPE_MM));
+    sample_threshold = UINT64_MAX;
+  }
+
+  // Every tile group but the last one is full
+  oid_t tile_group_count = table->GetTileGroupCount();
+  oid_t full_tile_group_count =
+      (tile_group_count > 0) ? tile_group_count - 1 : 0;
+
+  if (full_tile_group_count > folded_tile_group_count) {
+    ScanTileGroups(folded_tile_group_count, full_tile_group_count,
+                   *folded_summary, sample_pool.get());
+    folded_tile_group_count = full_tile_group_count;
+    CompactSample();
+  }
+
+  // The last tile group is still filling up, scan it on top of the rest
+  std::unique_ptr<VarlenPool> tail_pool(new VarlenPool(BACKEND_TYPE_MM));
+  Summary summary(column_count);
+  summary.Merge(*folded_summary);
+  summary.DropSamplesAbove(sample_threshold);
+  ScanTileGroups(folded_tile_group_count, tile_group_count, summary,
+                 tail_pool.get());
+
+  std::shared_ptr<TableStatsSnapshot> new_snapshot(new TableStatsSnapshot());
+  new_snapshot->tuple_count = summary.tuple_count;
+  new_snapshot->tile_group_count = tile_group_count;
+  new_snapshot->columns.resize(column_count);
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    ComputeColumnStats(summary, column_itr, *new_snapshot);
+  }
+
+  LOG_TRACE("Refreshed stats of table %s :: %lu tuples, %lu sampled",
+            table->GetName().c_str(), (size_t)summary.tuple_count,
+            summary.sample_tuples.size());
+
+  std::lock_guard<std::mutex> lock(snapshot_mutex);
+  snapshot = new_snapshot;
+}
+
+void TableStats::ScanTileGroups(oid_t begin, oid_t end, Summary &summary,
+                                VarlenPool *pool) {
+  if (begin >= end) return;
+
+  std::mutex summary_mutex;
+
+  TaskGroup task_group;
+  task_group.SubmitMorsels(end - begin, [&](oid_t morsel_id) {
+    Summary tile_group_summary(column_count);
+    ScanTileGroup(begin + morsel_id, tile_group_summary, pool);
+
+    std::lock_guard<std::mutex> lock(summary_mutex);
+    summary.Merge(tile_group_summary);
+    summary.DropSamplesAbove(sample_threshold);
+
+    while (summary.sample_hashes.size() > 2 * TABLE_STATS_SAMPLE_SIZE) {
+      sample_threshold = sample_threshold / 2;
+      summary.DropSamplesAbove(sample_threshold);
+    }
+  });
+  task_group.Wait();
+}
+
+void TableStats::ScanTileGroup(oid_t tile_group_offset, Summary &summary,
+                               VarlenPool *pool) {
+  auto tile_group = table->GetTileGroup(tile_group_offset);
+  if (tile_group == nullptr) return;
+
+  auto tile_group_header = tile_group->GetHeader();
+  oid_t next_tuple_slot = tile_group->GetNextTupleSlot();
+  uint64_t threshold = sample_threshold;
+
+  for (oid_t tuple_itr = 0; tuple_itr < next_tuple_slot; tuple_itr++) {
+    // Skip aborted inserts and versions that are gone
+    if (tile_group_header->GetTransactionId(tuple_itr) == INVALID_TXN_ID ||
+        tile_group_header->GetEndCommitId(tuple_itr) != MAX_CID) {
+      continue;
+    }
+
+    summary.tuple_count++;
+
+    // Sample on the location, so that a tuple stays in (or out of) the
+    // sample across refreshes
+    uint64_t hash = HyperLogLog::MixHash(
+        (static_cast<uint64_t>(tile_group_offset) << 32) | tuple_itr);
+    bool sampled = (hash <= threshold);
+    std::vector<Value> sample_tuple;
+
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      Value value = tile_group->GetValue(tuple_itr, column_itr);
+
+      if (value.IsNull()) {
+        summary.null_counts[column_itr]++;
+      } else {
+        summary.sketches[column_itr].AddValue(value);
+        summary.width_sums[column_itr] += GetValueWidth(value);
+      }
+
+      if (sampled) sample_tuple.push_back(CopyValue(value, pool));
+    }
+
+    if (sampled) {
+      summary.sample_hashes.push_back(hash);
+      summary.sample_tuples.push_back(std::move(sample_tuple));
+    }
+  }
+}
+
+void TableStats::CompactSample() {
+  std::unique_ptr<VarlenPool> pool(new VarlenPool(BACKEND_TYPE_MM));
+
+  for (auto &sample_tuple : folded_summary->sample_tuples) {
+    for (auto &value : sample_tuple) {
+      value = CopyValue(value, pool.get());
+    }
+  }
+
+  sample_pool.swap(pool);
+}
+
+void TableStats::ComputeColumnStats(const Summary &summary, oid_t column_id,
+                                    TableStatsSnapshot &snapshot) const {
+  auto &column_stats = snapshot.columns[column_id];
+  if (summary.tuple_count == 0) return;
+
+  double null_count = summary.null_counts[column_id];
+  double non_null_count = summary.tuple_count - null_count;
+  column_stats.null_fraction = null_count / summary.tuple_count;
+  if (non_null_count == 0) return;
+
+  column_stats.average_width = summary.width_sums[column_id] / non_null_count;
+  column_stats.distinct_count = std::max(
+      1.0, std::min(summary.sketches[column_id].Estimate(), non_null_count));
+
+  // Sort the sampled values, and count the occurrences of each of them
+  std::vector<Value> values;
+  for (auto &sample_tuple : summary.sample_tuples) {
+    if (sample_tuple[column_id].IsNull() == false) {
+      values.push_back(sample_tuple[column_id]);
+    }
+  }
+  if (values.empty()) return;
+
+  std::sort(values.begin(), values.end(), Value::ltValue());
+
+  // first value and # of occurrences of every distinct value
+  std::vector<std::pair<size_t, size_t>> runs;
+  for (size_t value_itr = 0; value_itr < values.size(); value_itr++) {
+    if (runs.empty() ||
+        values[runs.back().first].Compare(values[value_itr]) != 0) {
+      runs.push_back(std::make_pair(value_itr, 0));
+    }
+    runs.back().second++;
+  }
+
+  // A value is most common if it shows up more than the average one.
+  // If every sampled value showed up again, there are probably no others,
+  // so keep them all.
+  bool all_repeated = (runs.size() <= TABLE_STATS_MCV_COUNT);
+  for (auto &run : runs) {
+    if (run.second < 2) all_repeated = false;
+  }
+
+  double average_count = values.size() / column_stats.distinct_count;
+  double min_count = all_repeated ? 2 : std::max(2.0, 1.25 * average_count);
+
+  std::vector<size_t> common_runs;
+  for (size_t run_itr = 0; run_itr < runs.size(); run_itr++) {
+    if (runs[run_itr].second >= min_count) common_runs.push_back(run_itr);
+  }
+  std::stable_sort(common_runs.begin(), common_runs.end(),
+                   [&runs](size_t a, size_t b) {
+                     return runs[a].second > runs[b].second;
+                   });
+  if (common_runs.size() > TABLE_STATS_MCV_COUNT) {
+    common_runs.resize(TABLE_STATS_MCV_COUNT);
+  }
+
+  std::vector<bool> is_common(runs.size(), false);
+  double sample_size = summary.sample_tuples.size();
+  for (auto run_itr : common_runs) {
+    is_common[run_itr] = true;
+    column_stats.most_common_values.push_back(
+        CopyValue(values[runs[run_itr].first], snapshot.pool.get()));
+    column_stats.most_common_frequencies.push_back(runs[run_itr].second /
+                                                   sample_size);
+  }
+
+  // Equi-depth buckets over the rest of the values
+  std::vector<size_t> rest;
+  size_t rest_run_count = 0;
+  for (size_t run_itr = 0; run_itr < runs.size(); run_itr++) {
+    if (is_common[run_itr]) continue;
+    for (size_t value_itr = 0; value_itr < runs[run_itr].second; value_itr++) {
+      rest.push_back(runs[run_itr].first);
+    }
+    rest_run_count++;
+  }
+  if (rest_run_count < 2) return;
+
+  size_t bound_count =
+      std::min(TABLE_STATS_HISTOGRAM_BUCKET_COUNT + 1, rest_run_count);
+  size_t previous_position = rest.size();
+  for (size_t bound_itr = 0; bound_itr < bound_count; bound_itr++) {
+    size_t position = rest[bound_itr * (rest.size() - 1) / (bound_count - 1)];
+
+    // Skip bounds that land on the same value
+    if (position == previous_position) continue;
+    previous_position = position;
+
+    column_stats.histogram_bounds.push_back(
+        CopyValue(values[position], snapshot.pool.get()));
+  }
+}
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,195 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// table_stats.h
+//
+// Identification: src/backend/storage/table_stats.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "backend/common/hyperloglog.h"
+#include "backend/common/pool.h"
+#include "backend/common/types.h"
+#include "backend/common/value.h"
+
+namespace peloton {
+namespace storage {
+
+class DataTable;
+
+// # of sampled rows the statistics are computed from
+// (the sample grows up to twice as large before it is thinned out)
+static const size_t TABLE_STATS_SAMPLE_SIZE = 30000;
+
+// Most common values kept per column
+static const size_t TABLE_STATS_MCV_COUNT = 100;
+
+// Buckets of the equi-depth histograms
+static const size_t TABLE_STATS_HISTOGRAM_BUCKET_COUNT = 100;
+
+// Statistics go stale once the # of tuples changed by more than the
+// threshold plus the fraction of the table (see autovacuum_analyze_*)
+static const double TABLE_STATS_STALE_THRESHOLD = 50;
+
+static const double TABLE_STATS_STALE_FRACTION = 0.1;
+
+//===--------------------------------------------------------------------===//
+// Column Stats
+//===--------------------------------------------------------------------===//
+
+// What the planner wants to know about a column
+struct ColumnStats {
+  // Fraction of the rows that are null
+  double null_fraction = 0;
+
+  // Estimated # of distinct non-null values
+  double distinct_count = 0;
+
+  // Average size of the non-null values (in bytes)
+  double average_width = 0;
+
+  // Most common values, most common first,
+  // with the fraction of the rows holding each of them
+  std::vector<Value> most_common_values;
+
+  std::vector<double> most_common_frequencies;
+
+  // Bounds of equi-depth buckets over the values that are not most common,
+  // in ascending order
+  std::vector<Value> histogram_bounds;
+};
+
+// Statistics of the whole table, as of a refresh
+struct TableStatsSnapshot {
+  TableStatsSnapshot() : pool(new VarlenPool(BACKEND_TYPE_MM)) {}
+
+  // # of live tuples
+  double tuple_count = 0;
+
+  // # of tile groups scanned
+  oid_t tile_group_count = 0;
+
+  std::vector<ColumnStats> columns;
+
+  // Backs the uninlined values of the columns
+  std::unique_ptr<VarlenPool> pool;
+};
+
+//===--------------------------------------------------------------------===//
+// Table Stats
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief ANALYZE-style statistics collector of a table.
+ *
+ * Distinct counts come from per-column HyperLogLog sketches over every
+ * tuple; the most common values and the histograms come from a sample.
+ * A tuple is sampled when the hash of its location falls below a
+ * threshold, and the threshold is halved whenever the sample gets too big,
+ * so the sample stays uniform as the table grows.
+ *
+ * Tile groups are scanned in parallel. Once a tile group is full it is
+ * folded into the sketches and the sample for good, and later refreshes
+ * only scan the tile groups added since then. Deletes and updates of
+ * folded tuples, and inserts still in flight when their tile group got
+ * folded, are only picked up by Rebuild().
+ */
+class TableStats {
+  TableStats() = delete;
+  TableStats(TableStats const &) = delete;
+
+ public:
+  TableStats(DataTable *table);
+
+  // Did the # of tuples change enough since the last refresh ?
+  bool IsStale() const;
+
+  // Fold in the tile groups that filled up and rescan the last one
+  void Refresh();
+
+  // Forget everything and scan the whole table again
+  void Rebuild();
+
+  // Statistics as of the last refresh, null before the first one
+  std::shared_ptr<const TableStatsSnapshot> GetSnapshot() const;
+
+ private:
+  // What a scan of some tile groups found
+  struct Summary {
+    Summary(oid_t column_count);
+
+    double tuple_count = 0;
+
+    std::vector<HyperLogLog> sketches;
+
+    std::vector<double> null_counts;
+
+    std::vector<double> width_sums;
+
+    // sampled tuples and the hash that got them sampled
+    std::vector<uint64_t> sample_hashes;
+
+    std::vector<std::vector<Value>> sample_tuples;
+
+    void Merge(const Summary &other);
+
+    void DropSamplesAbove(uint64_t threshold);
+  };
+
+  void RefreshLocked(bool rebuild);
+
+  // Scan the tile groups in [begin, end) into the summary, copying the
+  // sampled values into the pool. The sampling rate is halved whenever the
+  // sample grows beyond twice its size.
+  void ScanTileGroups(oid_t begin, oid_t end, Summary &summary,
+                      VarlenPool *pool);
+
+  void ScanTileGroup(oid_t tile_group_offset, Summary &summary,
+                     VarlenPool *pool);
+
+  // Copy the folded sample into a fresh pool,
+  // leaving the values of the dropped tuples behind
+  void CompactSample();
+
+  void ComputeColumnStats(const Summary &summary, oid_t column_id,
+                          TableStatsSnapshot &snapshot) const;
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  DataTable *table;
+
+  oid_t column_count;
+
+  // serializes refreshes
+  std::mutex refresh_mutex;
+
+  // # of leading tile groups folded into the summary
+  oid_t folded_tile_group_count = 0;
+
+  std::unique_ptr<Summary> folded_summary;
+
+  // backs the folded sample
+  std::unique_ptr<VarlenPool> sample_pool;
+
+  // tuples whose hash is at most the threshold are sampled
+  std::atomic<uint64_t> sample_threshold = ATOMIC_VAR_INIT(UINT64_MAX);
+
+  mutable std::mutex snapshot_mutex;
+
+  std::shared_ptr<const TableStatsSnapshot> snapshot;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -19,6 +19,7 @@
 #include "backend/common/pool.h"
 #include "backend/common/serializer.h"
 #include "backend/common/types.h"
+#include "backend/common/varlen.h"
 #include "backend/storage/tuple_iterator.h"
 #include "backend/storage/tuple.h"
 #include "backend/storage/storage_manager.h"
@@ -130,6 +131,47 @@ Value Tile::GetValueFast(const oid_t tuple_offset, const size_t column_offset,
   return Value::InitFromTupleStorage(field_location, column_type, is_inlined);
 }
 
+/**
+ * Give the uninlined data of a tuple slot back to the pool.
+ * The slot then reads as NULL in the uninlined columns.
+ */
+void Tile::FreeUninlinedData(const oid_t tuple_offset) {
+  assert(tuple_offset < num_tuple_slots);
+  if (schema.IsInlined() == true) return;
+
+  char *tuple_location = GetTupleLocation(tuple_offset);
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    if (schema.IsInlined(column_itr) == true) continue;
+
+    Varlen **field_location = reinterpret_cast<Varlen **>(
+        tuple_location + schema.GetOffset(column_itr));
+    ReleaseVarlen(*field_location);
+    *field_location = nullptr;
+  }
+}
+
+// Objects of other pools are left alone, e.g. the ones
+// still shared with the source tile during CopyTile()
+void Tile::ReleaseVarlen(Varlen *varlen) {
+  if (varlen == nullptr || varlen->GetPool() != pool) return;
+
+  Varlen::Destroy(varlen);
+}
+
+ColumnAccessor Tile::GetColumnAccessor(const oid_t column_id) {
+  assert(column_id < schema.GetColumnCount());
+
+  ColumnAccessor accessor;
+  accessor.tile = this;
+  accessor.data = data;
+  accessor.column_offset = schema.GetOffset(column_id);
+  accessor.stride = tuple_length;
+  accessor.column_type = schema.GetType(column_id);
+  accessor.is_inlined = schema.IsInlined(column_id);
+
+  return accessor;
+}
+
 /**
  * Sets value at tuple slot.
  */
@@ -144,9 +186,15 @@ void Tile::SetValue(const Value &value, const oid_t tuple_offset,
   const bool is_inlined = schema.IsInlined(column_id);
   size_t column_length = schema.GetAppropriateLength(column_id);
 
+  // Object being overwritten, if any
+  Varlen *old_varlen =
+      is_inlined ? nullptr : *reinterpret_cast<Varlen **>(field_location);
+
   const bool is_in_bytes = false;
   value.SerializeToTupleStorageAllocateForObjects(
       field_location, is_inlined, column_length, is_in_bytes, pool);
+
+  ReleaseVarlen(old_varlen);
 }
 
 /*
@@ -163,9 +211,15 @@ void Tile::SetValueFast(const Value &value, const oid_t tuple_offset,
   char *tuple_location = GetTupleLocation(tuple_offset);
   char *field_location = tuple_location + column_offset;
 
+  // Object being overwritten, if any
+  Varlen *old_varlen =
+      is_inlined ? nullptr : *reinterpret_cast<Varlen **>(field_location);
+
   const bool is_in_bytes = false;
   value.SerializeToTupleStorageAllocateForObjects(
       field_location, is_inlined, column_length, is_in_bytes, pool);
+
+  ReleaseVarlen(old_varlen);
 }
 
 Tile *Tile::CopyTile(BackendType backend_type) {
@@ -370,6 +424,22 @@ bool Tile::SerializeTuplesTo(SerializeOutput &output, Tuple *tuples,
   return true;
 }
 
+/**
+ * Serializes the tuple count and the tuples in the first num_tuples slots,
+ * without the column header.
+ */
+void Tile::SerializeTuplesWithoutHeaderTo(SerializeOutput &output,
+                                          oid_t num_tuples) {
+  assert(num_tuples <= num_tuple_slots);
+  output.WriteInt(static_cast<int32_t>(num_tuples));
+
+  storage::Tuple tuple(&schema);
+  for (oid_t tuple_itr = 0; tuple_itr < num_tuples; ++tuple_itr) {
+    tuple.Move(GetTupleLocation(tuple_itr));
+    tuple.SerializeTo(output);
+  }
+}
+
 /**
  * Loads only tuple data, not schema, from the serialized tile.
  * Used for initial data loading.
@@ -447,11 +517,11 @@ void Tile::DeserializeTuplesFromWithoutHeader(SerializeInputBE &input,
 
   // First, check if we have required space
   assert(tuple_count <= num_tuple_slots);
-  storage::Tuple *temp_tuple = new storage::Tuple(&schema, true);
+  storage::Tuple temp_tuple(&schema);
 
   for (oid_t tuple_itr = 0; tuple_itr < tuple_count; ++tuple_itr) {
-    temp_tuple->Move(GetTupleLocation(tuple_itr));
-    temp_tuple->DeserializeFrom(input, pool);
+    temp_tuple.Move(GetTupleLocation(tuple_itr));
+    temp_tuple.DeserializeFrom(input, pool);
     // TRACE("Loaded new tuple #%02d\n%s", tuple_itr,
     // temp_target1.debug(Name()).c_str());
   }
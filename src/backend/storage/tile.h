@@ -16,6 +16,7 @@
 #include "backend/catalog/schema.h"
 #include "backend/common/serializer.h"
 #include "backend/common/pool.h"
+#include "backend/common/value.h"
 
 #include <mutex>
 
@@ -26,11 +27,55 @@ namespace storage {
 // Tile
 //===--------------------------------------------------------------------===//
 
+class Tile;
 class Tuple;
 class TileGroup;
 class TileGroupHeader;
 class TupleIterator;
 
+/**
+ * Precomputed access path to a column of a tile.
+ *
+ * Resolved once from the tile schema, so that loops over many tuples
+ * don't go back to the schema (or the tile group's column map) per value.
+ */
+struct ColumnAccessor {
+  // tile holding the column
+  Tile *tile = nullptr;
+
+  // start of the tile's tuple slots
+  const char *data = nullptr;
+
+  // offset of the column within a tuple slot
+  size_t column_offset = 0;
+
+  // length of a tuple slot
+  size_t stride = 0;
+
+  ValueType column_type = VALUE_TYPE_INVALID;
+
+  bool is_inlined = true;
+
+  inline const char *GetFieldLocation(const oid_t tuple_offset) const {
+    return data + tuple_offset * stride + column_offset;
+  }
+
+  inline Value GetValue(const oid_t tuple_offset) const {
+    return Value::InitFromTupleStorage(GetFieldLocation(tuple_offset),
+                                       column_type, is_inlined);
+  }
+
+  /**
+   * Read a fixed-length column value without constructing a Value.
+   * The caller must pick T to match the column type,
+   * e.g. int32_t for VALUE_TYPE_INTEGER.
+   */
+  template <typename T>
+  inline T GetFixedLengthValue(const oid_t tuple_offset) const {
+    return *reinterpret_cast<const T *>(GetFieldLocation(tuple_offset));
+  }
+};
+
 /**
  * Represents a Tile.
  *
@@ -86,6 +131,9 @@ class Tile {
   Value GetValueFast(const oid_t tuple_offset, const size_t column_offset,
                      const ValueType column_type, const bool is_inlined);
 
+  // Get the precomputed access path to a column
+  ColumnAccessor GetColumnAccessor(const oid_t column_id);
+
   /**
    * Sets value at tuple slot.
    */
@@ -100,6 +148,9 @@ class Tile {
                     const size_t column_offset, const bool is_inlined,
                     const size_t column_length);
 
+  // Free the uninlined data of the tuple slot, e.g. after an aborted insert
+  void FreeUninlinedData(const oid_t tuple_offset);
+
   // Get tuple at location
   static Tuple *GetTuple(catalog::Manager *catalog,
                          const ItemPointer *tuple_location);
@@ -154,6 +205,10 @@ class Tile {
   bool SerializeHeaderTo(SerializeOutput &output);
   bool SerializeTuplesTo(SerializeOutput &output, Tuple *tuples,
                          int num_tuples);
+  // Counterpart of DeserializeTuplesFromWithoutHeader for the first
+  // num_tuples slots
+  void SerializeTuplesWithoutHeaderTo(SerializeOutput &output,
+                                      oid_t num_tuples);
 
   void DeserializeTuplesFrom(SerializeInputBE &serialize_in,
                              VarlenPool *pool = nullptr);
@@ -168,6 +223,9 @@ class Tile {
   void Sync();
 
  protected:
+  // Give an uninlined object back to the tile's pool
+  void ReleaseVarlen(Varlen *varlen);
+
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
@@ -22,10 +22,13 @@
 #include "backend/storage/tile.h"
 #include "backend/storage/tuple.h"
 #include "backend/storage/tile_group_header.h"
+#include "backend/storage/zone_map.h"
 
 namespace peloton {
 namespace storage {
 
+std::atomic<size_t> TileGroup::resident_size(0);
+
 TileGroup::TileGroup(BackendType backend_type,
                      TileGroupHeader *tile_group_header, AbstractTable *table,
                      const std::vector<catalog::Schema> &schemas,
@@ -51,10 +54,37 @@ TileGroup::TileGroup(BackendType backend_type,
 
     // Add a reference to the tile in the tile group
     tiles.push_back(tile);
+    tuple_storage_size += tile->GetInlinedSize();
+  }
+
+  resident_size += tuple_storage_size;
+
+  // Flatten the column map into per-column access paths
+  oid_t column_count = column_map.size();
+  column_locations.resize(column_count);
+  column_accessors.resize(column_count);
+
+  for (auto column_map_entry : column_map) {
+    oid_t column_id = column_map_entry.first;
+    assert(column_id < column_count);
+
+    column_locations[column_id] = column_map_entry.second;
+    column_accessors[column_id] =
+        tiles[column_map_entry.second.first]->GetColumnAccessor(
+            column_map_entry.second.second);
+  }
+
+  // Set up the zone map
+  std::vector<ValueType> column_types(column_count);
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    column_types[column_itr] = column_accessors[column_itr].column_type;
   }
+  zone_map.reset(new ZoneMap(column_types));
 }
 
 TileGroup::~TileGroup() {
+  resident_size -= tuple_storage_size;
+
   // Drop references on all tiles
 
   // clean up tile group header
@@ -139,6 +169,9 @@ oid_t TileGroup::InsertTuple(txn_id_t transaction_id, const Tuple *tuple) {
   tile_group_header->SetInsertCommit(tuple_slot_id, false);
   tile_group_header->SetDeleteCommit(tuple_slot_id, false);
 
+  // Only after the MVCC info is set, see RebuildZoneMap()
+  zone_map->Update(tuple);
+
   return tuple_slot_id;
 }
 
@@ -188,9 +221,77 @@ oid_t TileGroup::InsertTuple(txn_id_t transaction_id, oid_t tuple_slot_id,
   tile_group_header->SetDeleteCommit(tuple_slot_id, false);
   tile_group_header->SetPrevItemPointer(tuple_slot_id, INVALID_ITEMPOINTER);
 
+  zone_map->Update(tuple);
+
   return tuple_slot_id;
 }
 
+/**
+ * Grab a contiguous range of slots (thread-safe) and fill in the tuples
+ * column at a time. Used by bulk load
+ *
+ * Returns the first slot where inserted (INVALID_OID if not inserted)
+ */
+oid_t TileGroup::InsertTuples(txn_id_t transaction_id,
+                              const std::vector<const Tuple *> &tuples,
+                              oid_t tuple_offset, oid_t &inserted_count) {
+  assert(tuple_offset < tuples.size());
+  oid_t tuple_count = tuples.size() - tuple_offset;
+
+  oid_t start_slot_id =
+      tile_group_header->GetNextEmptyTupleSlots(tuple_count, inserted_count);
+
+  // No more slots
+  if (start_slot_id == INVALID_OID) {
+    LOG_INFO("Failed to get empty tuple slots within tile group.");
+    return INVALID_OID;
+  }
+
+  LOG_TRACE("Tile Group Id :: %lu claimed slots %lu to %lu out of %lu slots ",
+            tile_group_id, start_slot_id, start_slot_id + inserted_count,
+            num_tuple_slots);
+
+  // Go over the columns, amortizing the schema lookups over the batch
+  for (auto column_map_entry : column_map) {
+    oid_t column_itr = column_map_entry.first;
+    oid_t tile_itr = column_map_entry.second.first;
+    oid_t tile_column_itr = column_map_entry.second.second;
+
+    const catalog::Schema &schema = tile_schemas[tile_itr];
+    storage::Tile *tile = GetTile(tile_itr);
+    assert(tile);
+
+    const size_t column_offset = schema.GetOffset(tile_column_itr);
+    const bool is_inlined = schema.IsInlined(tile_column_itr);
+    const size_t column_length = schema.GetAppropriateLength(tile_column_itr);
+
+    for (oid_t slot_itr = 0; slot_itr < inserted_count; slot_itr++) {
+      const Tuple *tuple = tuples[tuple_offset + slot_itr];
+      tile->SetValueFast(tuple->GetValue(column_itr), start_slot_id + slot_itr,
+                         column_offset, is_inlined, column_length);
+    }
+  }
+
+  // Set MVCC info
+  for (oid_t slot_itr = 0; slot_itr < inserted_count; slot_itr++) {
+    oid_t tuple_slot_id = start_slot_id + slot_itr;
+    assert(tile_group_header->GetTransactionId(tuple_slot_id) ==
+           INVALID_TXN_ID);
+
+    tile_group_header->SetTransactionId(tuple_slot_id, transaction_id);
+    tile_group_header->SetBeginCommitId(tuple_slot_id, MAX_CID);
+    tile_group_header->SetEndCommitId(tuple_slot_id, MAX_CID);
+    tile_group_header->SetInsertCommit(tuple_slot_id, false);
+    tile_group_header->SetDeleteCommit(tuple_slot_id, false);
+  }
+
+  for (oid_t slot_itr = 0; slot_itr < inserted_count; slot_itr++) {
+    zone_map->Update(tuples[tuple_offset + slot_itr]);
+  }
+
+  return start_slot_id;
+}
+
 // delete tuple at given slot if it is neither already locked nor deleted in
 // future.
 bool TileGroup::DeleteTuple(txn_id_t transaction_id, oid_t tuple_slot_id,
@@ -224,6 +325,24 @@ bool TileGroup::DeleteTuple(txn_id_t transaction_id, oid_t tuple_slot_id,
   }
 }
 
+bool TileGroup::PrepareDeleteTuple(txn_id_t transaction_id,
+                                   oid_t tuple_slot_id) {
+  if (tile_group_header->GetTransactionId(tuple_slot_id) == transaction_id) {
+    // is a own insert, nobody else can see it
+    assert(tile_group_header->GetBeginCommitId(tuple_slot_id) == MAX_CID);
+    tile_group_header->SetTransactionId(tuple_slot_id, INVALID_TXN_ID);
+    return true;
+  }
+
+  // deleted by a committed transaction, validation would fail anyway
+  if (tile_group_header->GetEndCommitId(tuple_slot_id) != MAX_CID) {
+    LOG_INFO("Delete failed: not deletable");
+    return false;
+  }
+
+  return true;
+}
+
 void TileGroup::CommitInsertedTuple(oid_t tuple_slot_id,
                                     txn_id_t transaction_id, cid_t commit_id) {
   // set the begin commit id to persist insert
@@ -246,8 +365,10 @@ void TileGroup::AbortInsertedTuple(oid_t tuple_slot_id) {
   tile_group_header->SetTransactionId(tuple_slot_id, INVALID_TXN_ID);
 
   // undo insert (we don't reset MVCC info currently)
-  // TODO: can reclaim tuple here ?
-  // ReclaimTuple(tuple_slot_id);
+  // the slot is not reused, but its uninlined data can go back to the pools
+  for (auto &tile : tiles) {
+    tile->FreeUninlinedData(tuple_slot_id);
+  }
 }
 
 void TileGroup::AbortDeletedTuple(oid_t tuple_slot_id,
@@ -260,10 +381,10 @@ void TileGroup::AbortDeletedTuple(oid_t tuple_slot_id,
 // the specified tile group column id.
 void TileGroup::LocateTileAndColumn(oid_t column_offset, oid_t &tile_offset,
                                     oid_t &tile_column_offset) {
-  assert(column_map.count(column_offset) != 0);
+  assert(column_offset < column_locations.size());
 
-  // get the entry in the column map
-  auto entry = column_map.at(column_offset);
+  // get the entry in the flattened column map
+  auto &entry = column_locations[column_offset];
   tile_offset = entry.first;
   tile_column_offset = entry.second;
 }
@@ -282,9 +403,32 @@ oid_t TileGroup::GetTileColumnId(oid_t column_id) {
 
 Value TileGroup::GetValue(oid_t tuple_id, oid_t column_id) {
   assert(tuple_id < GetNextTupleSlot());
-  oid_t tile_column_id, tile_offset;
-  LocateTileAndColumn(column_id, tile_offset, tile_column_id);
-  return GetTile(tile_offset)->GetValue(tuple_id, tile_column_id);
+  assert(column_id < column_accessors.size());
+  return column_accessors[column_id].GetValue(tuple_id);
+}
+
+/**
+ * Rebuild the zone map from all slots handed out so far, skipping aborted
+ * inserts. The zone map stays locked throughout, so an insert racing with us
+ * either gets its slot scanned here (its MVCC info is set before the zone map
+ * update) or updates the zone map after we are done.
+ */
+void TileGroup::RebuildZoneMap() {
+  auto lock = zone_map->Reset();
+
+  oid_t next_tuple_slot = GetNextTupleSlot();
+  oid_t column_count = column_map.size();
+
+  for (oid_t tuple_itr = 0; tuple_itr < next_tuple_slot; tuple_itr++) {
+    if (tile_group_header->GetTransactionId(tuple_itr) == INVALID_TXN_ID) {
+      continue;
+    }
+
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      if (zone_map->IsTracked(column_itr) == false) continue;
+      zone_map->UpdateLocked(column_itr, GetValue(tuple_itr, column_itr));
+    }
+  }
 }
 
 Tile *TileGroup::GetTile(const oid_t tile_offset) const {
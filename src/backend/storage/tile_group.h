@@ -20,6 +20,7 @@
 #include <memory>
 
 #include "backend/common/types.h"
+#include "backend/storage/tile.h"
 
 namespace peloton {
 
@@ -41,6 +42,7 @@ class Tile;
 class TileGroupHeader;
 class AbstractTable;
 class TileGroupIterator;
+class ZoneMap;
 
 typedef std::map<oid_t, std::pair<oid_t, oid_t>> column_map_type;
 
@@ -80,10 +82,20 @@ class TileGroup {
   oid_t InsertTuple(txn_id_t transaction_id, oid_t tuple_slot_id,
                     const Tuple *tuple);
 
+  // insert a batch of tuples starting at tuples[tuple_offset] into a
+  // contiguous range of slots, column at a time. used by bulk load
+  oid_t InsertTuples(txn_id_t transaction_id,
+                     const std::vector<const Tuple *> &tuples,
+                     oid_t tuple_offset, oid_t &inserted_count);
+
   // delete tuple at given slot if it is not already locked
   bool DeleteTuple(txn_id_t transaction_id, oid_t tuple_slot_id,
                    cid_t last_cid);
 
+  // check that an optimistic transaction can delete the tuple at given slot,
+  // which it latches at commit
+  bool PrepareDeleteTuple(txn_id_t transaction_id, oid_t tuple_slot_id);
+
   //===--------------------------------------------------------------------===//
   // Transaction Processing
   //===--------------------------------------------------------------------===//
@@ -160,11 +172,44 @@ class TileGroup {
 
   Value GetValue(oid_t tuple_id, oid_t column_id);
 
+  // Get the precomputed access path to a tile group column
+  const ColumnAccessor &GetColumnAccessor(oid_t column_id) const {
+    return column_accessors[column_id];
+  }
+
   double GetSchemaDifference(const storage::column_map_type &new_column_map);
 
+  // Per-column min/max synopsis, used by scans to skip the tile group
+  ZoneMap *GetZoneMap() const { return zone_map.get(); }
+
+  // Recompute the zone map from the stored tuples,
+  // e.g. once the tile group is full
+  void RebuildZoneMap();
+
   // Sync the contents
   void Sync();
 
+  //===--------------------------------------------------------------------===//
+  // Access Recency
+  //===--------------------------------------------------------------------===//
+
+  // Stamp the tile group with the current access epoch
+  void RecordAccess(uint64_t access_epoch) {
+    // skip the store if the epoch is unchanged to keep the line shared
+    if (last_access_epoch.load(std::memory_order_relaxed) != access_epoch) {
+      last_access_epoch.store(access_epoch, std::memory_order_relaxed);
+    }
+  }
+
+  uint64_t GetLastAccessEpoch() const {
+    return last_access_epoch.load(std::memory_order_relaxed);
+  }
+
+  // # of bytes of tuple storage taken by all the tile groups in memory
+  static size_t GetResidentSize() {
+    return resident_size.load(std::memory_order_relaxed);
+  }
+
  protected:
   //===--------------------------------------------------------------------===//
   // Data members
@@ -201,6 +246,22 @@ class TileGroup {
   // column to tile mapping :
   // <column offset> to <tile offset, tile column offset>
   column_map_type column_map;
+
+  // column map flattened into arrays indexed by column offset
+  std::vector<std::pair<oid_t, oid_t>> column_locations;
+
+  std::vector<ColumnAccessor> column_accessors;
+
+  // synopsis of the stored tuples
+  std::unique_ptr<ZoneMap> zone_map;
+
+  // eviction epoch of the last lookup, see EvictionManager
+  std::atomic<uint64_t> last_access_epoch = ATOMIC_VAR_INIT(0);
+
+  // # of bytes of tuple storage of the tiles
+  size_t tuple_storage_size = 0;
+
+  static std::atomic<size_t> resident_size;
 };
 
 }  // End storage namespace
@@ -12,6 +12,7 @@
 
 #include "backend/storage/tile_group_factory.h"
 #include "backend/storage/tile_group_header.h"
+#include "backend/common/metrics.h"
 
 //===--------------------------------------------------------------------===//
 // GUC Variables
@@ -47,6 +48,10 @@ TileGroup *TileGroupFactory::GetTileGroup(
   tile_group->tile_group_id = tile_group_id;
   tile_group->table_id = table_id;
 
+  static auto tile_group_counter =
+      MetricsRegistry::GetInstance().GetCounter("storage.tile_groups");
+  tile_group_counter->Increment();
+
   return tile_group;
 }
 
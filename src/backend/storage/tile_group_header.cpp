@@ -123,6 +123,24 @@ void TileGroupHeader::Sync() {
   storage_manager.Sync(backend_type, data, header_size);
 }
 
+void TileGroupHeader::SerializeTo(SerializeOutput &output) const {
+  output.WriteInt(static_cast<int32_t>(num_tuple_slots));
+  output.WriteInt(static_cast<int32_t>(GetNextTupleSlot()));
+
+  // The header is only restored on this machine, so the slots are copied
+  // as they are laid out in memory
+  output.WriteBytes(data, header_size);
+}
+
+void TileGroupHeader::DeserializeFrom(SerializeInputBE &input) {
+  oid_t tuple_slot_count = input.ReadInt();
+  assert(tuple_slot_count == num_tuple_slots);
+  (void)tuple_slot_count;
+
+  next_tuple_slot = input.ReadInt();
+  input.ReadBytes(data, header_size);
+}
+
 void TileGroupHeader::PrintVisibility(txn_id_t txn_id, cid_t at_cid) {
   oid_t active_tuple_slots = GetNextTupleSlot();
   std::stringstream os;
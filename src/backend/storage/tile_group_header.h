@@ -14,8 +14,10 @@
 
 #include "backend/common/logger.h"
 #include "backend/common/platform.h"
+#include "backend/common/serializer.h"
 #include "backend/logging/log_manager.h"
 
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 #include <iostream>
@@ -86,6 +88,30 @@ class TileGroupHeader {
     return tuple_slot_id;
   }
 
+  /**
+   * Claim a contiguous range of up to tuple_count slots in one go.
+   * Used by bulk load
+   * Returns the first claimed slot (INVALID_OID if the tile group is full)
+   */
+  oid_t GetNextEmptyTupleSlots(const oid_t tuple_count, oid_t &claimed_count) {
+    oid_t tuple_slot_id = INVALID_OID;
+    claimed_count = 0;
+
+    {
+      std::lock_guard<std::mutex> tile_header_lock(tile_header_mutex);
+
+      // check tile group capacity
+      if (next_tuple_slot < num_tuple_slots) {
+        tuple_slot_id = next_tuple_slot;
+        claimed_count =
+            std::min(tuple_count, num_tuple_slots - next_tuple_slot);
+        next_tuple_slot += claimed_count;
+      }
+    }
+
+    return tuple_slot_id;
+  }
+
   /**
    * Used by logging
    */
@@ -289,6 +315,11 @@ class TileGroupHeader {
   // Sync the contents
   void Sync();
 
+  // Raw copy of the slot metadata, used to evict and restore the tile group
+  void SerializeTo(SerializeOutput &output) const;
+
+  void DeserializeFrom(SerializeInputBE &input);
+
   //===--------------------------------------------------------------------===//
   // Utilities
   //===--------------------------------------------------------------------===//
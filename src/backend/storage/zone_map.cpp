@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// zone_map.cpp
+//
+// Identification: src/backend/storage/zone_map.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cassert>
+
+#include "backend/storage/zone_map.h"
+#include "backend/storage/tuple.h"
+#include "backend/common/logger.h"
+
+namespace peloton {
+namespace storage {
+
+ZoneMap::ZoneMap(const std::vector<ValueType> &column_types)
+    : columns(column_types.size()) {
+  for (oid_t column_itr = 0; column_itr < column_types.size(); column_itr++) {
+    columns[column_itr].tracked = IsTrackedType(column_types[column_itr]);
+  }
+}
+
+bool ZoneMap::IsTrackedType(ValueType value_type) {
+  switch (value_type) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_DOUBLE:
+    case VALUE_TYPE_TIMESTAMP:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+void ZoneMap::Update(const Tuple *tuple) {
+  std::lock_guard<std::mutex> lock(zone_map_mutex);
+
+  for (oid_t column_itr = 0; column_itr < columns.size(); column_itr++) {
+    if (columns[column_itr].tracked == false) continue;
+
+    UpdateLocked(column_itr, tuple->GetValue(column_itr));
+  }
+}
+
+std::unique_lock<std::mutex> ZoneMap::Reset() {
+  std::unique_lock<std::mutex> lock(zone_map_mutex);
+
+  for (auto &column : columns) {
+    column.has_range = false;
+    column.null_count = 0;
+  }
+
+  return lock;
+}
+
+void ZoneMap::UpdateLocked(oid_t column_id, const Value &value) {
+  assert(column_id < columns.size());
+  auto &column = columns[column_id];
+
+  if (column.tracked == false) return;
+
+  if (value.IsNull()) {
+    column.null_count++;
+    return;
+  }
+
+  if (column.has_range == false) {
+    column.min = value;
+    column.max = value;
+    column.has_range = true;
+    return;
+  }
+
+  if (value.CompareWithoutNull(column.min) < 0) {
+    column.min = value;
+  } else if (value.CompareWithoutNull(column.max) > 0) {
+    column.max = value;
+  }
+}
+
+bool ZoneMap::CanSkip(oid_t column_id, ExpressionType comparison_type,
+                      const Value &value) {
+  if (column_id >= columns.size()) return false;
+  if (value.IsNull() || IsTrackedType(value.GetValueType()) == false) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(zone_map_mutex);
+  auto &column = columns[column_id];
+
+  // Nothing known about the column
+  if (column.tracked == false || column.has_range == false) return false;
+
+  int min_cmp = column.min.CompareWithoutNull(value);
+  int max_cmp = column.max.CompareWithoutNull(value);
+
+  switch (comparison_type) {
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+      return (min_cmp > 0 || max_cmp < 0);
+
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+      return (min_cmp >= 0);
+
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+      return (min_cmp > 0);
+
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+      return (max_cmp <= 0);
+
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      return (max_cmp < 0);
+
+    default:
+      return false;
+  }
+}
+
+bool ZoneMap::HasRange(oid_t column_id) {
+  std::lock_guard<std::mutex> lock(zone_map_mutex);
+  return columns.at(column_id).has_range;
+}
+
+Value ZoneMap::GetMin(oid_t column_id) {
+  std::lock_guard<std::mutex> lock(zone_map_mutex);
+  return columns.at(column_id).min;
+}
+
+Value ZoneMap::GetMax(oid_t column_id) {
+  std::lock_guard<std::mutex> lock(zone_map_mutex);
+  return columns.at(column_id).max;
+}
+
+oid_t ZoneMap::GetNullCount(oid_t column_id) {
+  std::lock_guard<std::mutex> lock(zone_map_mutex);
+  return columns.at(column_id).null_count;
+}
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// zone_map.h
+//
+// Identification: src/backend/storage/zone_map.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "backend/common/types.h"
+#include "backend/common/value.h"
+
+namespace peloton {
+namespace storage {
+
+class Tuple;
+
+//===--------------------------------------------------------------------===//
+// Zone Map
+//===--------------------------------------------------------------------===//
+
+/**
+ * Per-column synopsis of the tuples stored in a tile group:
+ * min and max of the non-null values, and the number of nulls.
+ *
+ * Only fixed-length numeric and timestamp columns are tracked.
+ * The synopsis only ever widens while tuples are inserted; deleted versions
+ * stay covered since older snapshots may still see them.
+ */
+class ZoneMap {
+  ZoneMap() = delete;
+  ZoneMap(ZoneMap const &) = delete;
+
+ public:
+  ZoneMap(const std::vector<ValueType> &column_types);
+
+  // Is the column type tracked by zone maps ?
+  static bool IsTrackedType(ValueType value_type);
+
+  bool IsTracked(oid_t column_id) const { return columns[column_id].tracked; }
+
+  //===--------------------------------------------------------------------===//
+  // Maintenance
+  //===--------------------------------------------------------------------===//
+
+  // Widen the synopsis to cover the tuple
+  void Update(const Tuple *tuple);
+
+  // Reset the synopsis, then let the caller add back tuples with
+  // UpdateLocked() while holding the returned lock
+  std::unique_lock<std::mutex> Reset();
+
+  void UpdateLocked(oid_t column_id, const Value &value);
+
+  //===--------------------------------------------------------------------===//
+  // Pruning
+  //===--------------------------------------------------------------------===//
+
+  /**
+   * @brief Checks if "column <comparison_type> value" can't hold for any
+   * non-null value in the tile group.
+   * @return true if the tile group can be skipped.
+   */
+  bool CanSkip(oid_t column_id, ExpressionType comparison_type,
+               const Value &value);
+
+  //===--------------------------------------------------------------------===//
+  // Accessors
+  //===--------------------------------------------------------------------===//
+
+  // Has the column seen any non-null value ?
+  bool HasRange(oid_t column_id);
+
+  Value GetMin(oid_t column_id);
+
+  Value GetMax(oid_t column_id);
+
+  oid_t GetNullCount(oid_t column_id);
+
+ private:
+  struct ColumnSynopsis {
+    bool tracked = false;
+    bool has_range = false;
+    Value min;
+    Value max;
+    oid_t null_count = 0;
+  };
+
+  std::vector<ColumnSynopsis> columns;
+
+  std::mutex zone_map_mutex;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -510,6 +510,17 @@ ExplainOnePlan(PlannedStmt *plannedstmt, IntoClause *into, ExplainState *es,
 	/* Create textual dump of plan tree */
 	ExplainPrintPlan(es, queryDesc);
 
+	/* Peloton runs its own executor tree, print what it measured */
+	if (es->analyze && queryDesc->estate->es_peloton_stats != NULL)
+	{
+		if (es->format == EXPLAIN_FORMAT_TEXT)
+			appendStringInfo(es->str, "Peloton executor:\n%s",
+							 queryDesc->estate->es_peloton_stats);
+		else
+			ExplainPropertyText("Peloton Executor",
+								queryDesc->estate->es_peloton_stats, es);
+	}
+
 	if (es->summary && planduration)
 	{
 		double		plantime = INSTR_TIME_GET_DOUBLE(*planduration);
@@ -131,6 +131,8 @@ CreateExecutorState(void)
 	estate->es_instrument = 0;
 	estate->es_finished = false;
 
+	estate->es_peloton_stats = NULL;
+
 	estate->es_exprcontexts = NIL;
 
 	estate->es_subplanstates = NIL;
@@ -25,12 +25,15 @@
 #include <map>
 
 #include "backend/common/logger.h"
+#include "backend/common/metrics.h"
 #include "backend/bridge/ddl/configuration.h"
 #include "backend/bridge/ddl/ddl.h"
+#include "backend/bridge/ddl/ddl_database.h"
 #include "backend/bridge/ddl/ddl_utils.h"
 #include "backend/bridge/ddl/tests/bridge_test.h"
 #include "backend/bridge/dml/executor/plan_executor.h"
 #include "backend/bridge/dml/mapper/mapper.h"
+#include "backend/bridge/dml/tuple/tuple_buffer.h"
 #include "backend/logging/log_manager.h"
 
 #include "postgres.h"
@@ -40,6 +43,7 @@
 #include "access/tupdesc.h"
 #include "catalog/pg_namespace.h"
 #include "executor/tuptable.h"
+#include "funcapi.h"
 #include "libpq/ip.h"
 #include "libpq/pqsignal.h"
 #include "miscadmin.h"
@@ -52,6 +56,7 @@
 #include "utils/timeout.h"
 #include "utils/memutils.h"
 #include "utils/resowner.h"
+#include "utils/builtins.h"
 #include "utils/rel.h"
 #include "postmaster/fork_process.h"
 #include "postmaster/postmaster.h"
@@ -91,6 +96,13 @@ peloton_bootstrap() {
     // Process the utility statement
     peloton::bridge::Bootstrap::BootstrapPeloton();
 
+    // Start dumping the metrics, once per process
+    if (peloton_metrics_interval > 0) {
+      auto& metrics_registry = peloton::MetricsRegistry::GetInstance();
+      metrics_registry.StartDumping(peloton_metrics_file,
+                                    peloton_metrics_interval);
+    }
+
     // Sart logging
     if(logging_module_check == false){
       elog(DEBUG2, "....................................................................................................");
@@ -207,9 +219,13 @@ peloton_dml(PlanState *planstate,
 
   // Execute the plantree
   try {
+    // EXPLAIN ANALYZE asks for the instrumentation
+    bool instrument = (planstate->state->es_instrument != 0);
+
     status = peloton::bridge::PlanExecutor::ExecutePlan(mapped_plan_ptr.get(),
                                                         param_list,
-                                                        tuple_desc);
+                                                        tuple_desc,
+                                                        instrument);
 
     // Clean up the plantree
     // Not clean up now ! This is cached !
@@ -222,6 +238,13 @@ peloton_dml(PlanState *planstate,
   // Wait for the response and process it
   peloton_process_status(status, planstate);
 
+  // Keep the executor stats around for EXPLAIN ANALYZE
+  if (status.m_executor_stats.empty() == false) {
+    planstate->state->es_peloton_stats =
+        MemoryContextStrdup(planstate->state->es_query_cxt,
+                            status.m_executor_stats.c_str());
+  }
+
   // Send output to dest
   peloton_send_output(status, sendTuples, dest);
 
@@ -241,14 +264,22 @@ peloton_process_status(const peloton_status& status, PlanState *planstate) {
   code = status.m_result;
   switch(code) {
     case peloton::RESULT_SUCCESS: {
-      // TODO: Update stats ?
       planstate->state->es_processed = status.m_processed;
+
+      // Let the planner know about the modified tables
+      if (status.m_processed > 0) {
+        peloton::bridge::DDLDatabase::RefreshStats(
+            planstate->state->es_plannedstmt);
+      }
     }
     break;
 
     case peloton::RESULT_INVALID:
     case peloton::RESULT_FAILURE:
     default: {
+      // Drop any result tuples before bailing out
+      delete status.m_result_buffer;
+
       ereport(ERROR, (errcode(status.m_result),
           errmsg("transaction failed")));
     }
@@ -267,39 +298,28 @@ void
 peloton_send_output(const peloton_status& status,
                     bool sendTuples,
                     DestReceiver *dest) {
-  TupleTableSlot *slot;
-
-  // Go over any result slots
-  if(status.m_result_slots != NULL)  {
-    ListCell   *lc;
-
-    foreach(lc, status.m_result_slots)
-    {
-      slot = (TupleTableSlot *) lfirst(lc);
-
-      /*
-       * if the tuple is null, then we assume there is nothing more to
-       * process so we just end the loop...
-       */
-      if (TupIsNull(slot))
-        break;
-
-      /*
-       * If we are supposed to send the tuple somewhere, do so. (In
-       * practice, this is probably always the case at this point.)
-       */
-      if (sendTuples)
+  auto tuple_buffer = status.m_result_buffer;
+
+  // Go over any result tuples
+  if(tuple_buffer != nullptr)  {
+    auto tuple_count = tuple_buffer->GetTupleCount();
+
+    /*
+     * If we are supposed to send the tuples somewhere, do so. (In
+     * practice, this is probably always the case at this point.)
+     * The same slot is reused for all the tuples.
+     */
+    if (sendTuples) {
+      for (size_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+        TupleTableSlot *slot = tuple_buffer->GetSlot(tuple_itr);
         (*dest->receiveSlot) (slot, dest);
-
-      /*
-       * Free the underlying heap_tuple
-       * and the TupleTableSlot itself.
-       */
-      ExecDropSingleTupleTableSlot(slot);
+      }
     }
 
-    // Clean up list
-    list_free(status.m_result_slots);
+    /*
+     * Free the datums and the shared TupleTableSlot.
+     */
+    delete tuple_buffer;
   }
 }
 
@@ -357,3 +377,70 @@ bool IsPelotonQuery(List *relationOids) {
   return peloton_query;
 }
 
+/* ----------
+ * peloton_metrics -
+ *
+ *  Return the counters and histograms of the metrics registry,
+ *  one row per metric.
+ * ----------
+ */
+Datum
+peloton_metrics(PG_FUNCTION_ARGS) {
+#define PELOTON_METRICS_COLS 8
+  ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+  TupleDesc tupdesc;
+  Tuplestorestate *tupstore;
+  MemoryContext oldcontext;
+
+  // Check to see if caller supports us returning a tuplestore
+  if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo))
+    ereport(ERROR,
+            (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+             errmsg("set-valued function called in context that cannot accept a set")));
+  if (!(rsinfo->allowedModes & SFRM_Materialize))
+    ereport(ERROR,
+            (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+             errmsg("materialize mode required, but it is not allowed in this context")));
+
+  // Build a tuple descriptor for our result type
+  if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+    elog(ERROR, "return type must be a row type");
+
+  oldcontext = MemoryContextSwitchTo(rsinfo->econtext->ecxt_per_query_memory);
+
+  tupstore = tuplestore_begin_heap(true, false, work_mem);
+  rsinfo->returnMode = SFRM_Materialize;
+  rsinfo->setResult = tupstore;
+  rsinfo->setDesc = tupdesc;
+
+  MemoryContextSwitchTo(oldcontext);
+
+  auto samples = peloton::MetricsRegistry::GetInstance().GetSamples();
+  for (auto &sample : samples) {
+    Datum values[PELOTON_METRICS_COLS];
+    bool nulls[PELOTON_METRICS_COLS];
+
+    values[0] = CStringGetTextDatum(sample.name.c_str());
+    values[1] = CStringGetTextDatum(sample.kind.c_str());
+    values[2] = Int64GetDatum(sample.count);
+    values[3] = Float8GetDatum(sample.mean);
+    values[4] = Int64GetDatum(sample.p50);
+    values[5] = Int64GetDatum(sample.p95);
+    values[6] = Int64GetDatum(sample.p99);
+    values[7] = Int64GetDatum(sample.max);
+
+    // Counters have no distribution
+    bool is_counter = (sample.kind == "counter");
+    nulls[0] = nulls[1] = nulls[2] = false;
+    for (int col_itr = 3; col_itr < PELOTON_METRICS_COLS; col_itr++) {
+      nulls[col_itr] = is_counter;
+    }
+
+    tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+  }
+
+  // clean up and return the tuplestore
+  tuplestore_donestoring(tupstore);
+
+  return (Datum) 0;
+}
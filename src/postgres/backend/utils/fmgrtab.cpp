@@ -2437,6 +2437,7 @@ extern Datum pg_replication_origin_xact_reset (PG_FUNCTION_ARGS);
 extern Datum pg_replication_origin_advance (PG_FUNCTION_ARGS);
 extern Datum pg_replication_origin_progress (PG_FUNCTION_ARGS);
 extern Datum pg_show_replication_origin_status (PG_FUNCTION_ARGS);
+extern Datum peloton_metrics (PG_FUNCTION_ARGS);
 
 const FmgrBuiltin fmgr_builtins[] = {
   { 31, "byteaout", 1, true, false, byteaout },
@@ -4603,6 +4604,7 @@ const FmgrBuiltin fmgr_builtins[] = {
   { 3304, "jsonb_delete_path", 2, true, false, jsonb_delete_path },
   { 3305, "jsonb_replace", 3, true, false, jsonb_replace },
   { 3306, "jsonb_pretty", 1, true, false, jsonb_pretty },
+  { 3307, "peloton_metrics", 0, false, true, peloton_metrics },
   { 3329, "show_all_file_settings", 0, true, true, show_all_file_settings },
   { 3335, "tsm_system_init", 3, true, false, tsm_system_init },
   { 3336, "tsm_system_nextblock", 2, true, false, tsm_system_nextblock },
@@ -426,6 +426,21 @@ static const struct config_enum_entry peloton_logging_mode_options[] = {
   {NULL, 0, false}
 };
 
+/* Possible values for peloton_concurrency_mode GUC */
+typedef enum ConcurrencyType
+{
+  CONCURRENCY_TYPE_PESSIMISTIC, /* Latch tuples when writing them */
+  CONCURRENCY_TYPE_OPTIMISTIC,  /* Validate reads and writes at commit */
+  CONCURRENCY_TYPE_SERIALIZABLE /* Serializable snapshot isolation */
+} ConcurrencyType;
+
+static const struct config_enum_entry peloton_concurrency_mode_options[] = {
+  {"pessimistic", CONCURRENCY_TYPE_PESSIMISTIC, false},
+  {"optimistic", CONCURRENCY_TYPE_OPTIMISTIC, false},
+  {"serializable", CONCURRENCY_TYPE_SERIALIZABLE, false},
+  {NULL, 0, false}
+};
+
 /*
  * Options for enum values stored in other modules
  */
@@ -497,9 +512,26 @@ int     peloton_layout_mode;
 // Logging mode
 LoggingType     peloton_logging_mode;
 
+// Concurrency control mode
+ConcurrencyType peloton_concurrency_mode;
+
+// Seconds of old versions kept for time travel
+int     peloton_version_retention;
+
+// Commit id or unix time the session reads as of
+int     peloton_as_of_cid;
+int     peloton_as_of_time;
+
 // Directory for peloton logs
 char    *peloton_log_directory;
 
+// Seconds between dumps of the peloton metrics, and where they go
+int     peloton_metrics_interval;
+char    *peloton_metrics_file;
+
+// Kilobytes of tile groups kept in memory before cold ones get evicted
+int     peloton_eviction_budget;
+
 /*
  * This really belongs in pg_shmem.c, but is defined here so that it doesn't
  * need to be duplicated in all the different implementations of pg_shmem.c.
@@ -2719,6 +2751,62 @@ struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+  {
+    {"peloton_version_retention", PGC_SIGHUP, PELOTON_CONCURRENCY_OPTIONS,
+      gettext_noop("Sets how long old versions can be read as of."),
+      gettext_noop("Statements can only run as of the commits within "
+                   "this window."),
+      GUC_UNIT_S
+    },
+    &peloton_version_retention,
+    300, 0, INT_MAX,
+    NULL, NULL, NULL
+  },
+
+  {
+    {"peloton_as_of_cid", PGC_USERSET, PELOTON_CONCURRENCY_OPTIONS,
+      gettext_noop("Runs the reads of the session as of this commit id."),
+      gettext_noop("Zero reads the current snapshot.")
+    },
+    &peloton_as_of_cid,
+    0, 0, INT_MAX,
+    NULL, NULL, NULL
+  },
+
+  {
+    {"peloton_as_of_time", PGC_USERSET, PELOTON_CONCURRENCY_OPTIONS,
+      gettext_noop("Runs the reads of the session as of this unix time."),
+      gettext_noop("Zero reads the current snapshot. Ignored if "
+                   "peloton_as_of_cid is set.")
+    },
+    &peloton_as_of_time,
+    0, 0, INT_MAX,
+    NULL, NULL, NULL
+  },
+
+  {
+    {"peloton_metrics_interval", PGC_POSTMASTER, STATS_MONITORING,
+      gettext_noop("Sets how often the Peloton metrics are dumped."),
+      gettext_noop("Zero turns off the dumps."),
+      GUC_UNIT_S
+    },
+    &peloton_metrics_interval,
+    0, 0, INT_MAX,
+    NULL, NULL, NULL
+  },
+
+  {
+    {"peloton_eviction_budget", PGC_SIGHUP, RESOURCES_MEM,
+      gettext_noop("Sets the memory the Peloton tile groups may take before "
+                   "cold ones are evicted."),
+      gettext_noop("Zero turns off the eviction."),
+      GUC_UNIT_KB
+    },
+    &peloton_eviction_budget,
+    0, 0, MAX_KILOBYTES,
+    NULL, NULL, NULL
+  },
+
 	/* End-of-list marker */
 	{
 		{NULL, static_cast<GucContext>(0), static_cast<config_group>(0), NULL, NULL}, NULL, 0, 0, 0, NULL, NULL, NULL
@@ -3454,6 +3542,17 @@ struct config_string ConfigureNamesString[] =
     check_canonical_path, NULL, NULL
   },
 
+  {
+    {"peloton_metrics_file", PGC_POSTMASTER, STATS_MONITORING,
+      gettext_noop("Sets the file the Peloton metrics are dumped to."),
+      gettext_noop("Relative paths are under the data directory."),
+      GUC_SUPERUSER_ONLY
+    },
+    &peloton_metrics_file,
+    "peloton_metrics.log",
+    check_canonical_path, NULL, NULL
+  },
+
 	/* End-of-list marker */
 	{
 		{NULL, static_cast<GucContext>(0), static_cast<config_group>(0), NULL, NULL}, NULL, NULL, NULL, NULL, NULL
@@ -3731,6 +3830,16 @@ struct config_enum ConfigureNamesEnum[] =
     NULL, NULL, NULL
   },
 
+  {
+    {"peloton_concurrency_mode", PGC_POSTMASTER, PELOTON_CONCURRENCY_OPTIONS,
+      gettext_noop("Change peloton concurrency control mode"),
+      gettext_noop("This determines the concurrency control protocol.")
+    },
+    reinterpret_cast<int *>(&peloton_concurrency_mode),
+    CONCURRENCY_TYPE_PESSIMISTIC, peloton_concurrency_mode_options,
+    NULL, NULL, NULL
+  },
+
 	/* End-of-list marker */
 	{
 		{NULL, static_cast<GucContext>(0), static_cast<config_group>(0), NULL, NULL}, NULL, 0, NULL, NULL, NULL, NULL
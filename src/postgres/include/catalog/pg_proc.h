@@ -5334,6 +5334,10 @@ DESCR("tsm_bernoulli_reset(internal)");
 DATA(insert OID = 3346 (  tsm_bernoulli_cost		PGNSP PGUID 12 1 0 0 0 f f f f t f v 7 0 2278 "2281 2281 2281 2281 2281 2281 2281" _null_ _null_ _null_ _null_ _null_ tsm_bernoulli_cost _null_ _null_ _null_ ));
 DESCR("tsm_bernoulli_cost(internal)");
 
+/* Peloton */
+DATA(insert OID = 3307 (  peloton_metrics		PGNSP PGUID 12 1 100 0 0 f f f f f t v 0 0 2249 "" "{25,25,20,701,20,20,20,20}" "{o,o,o,o,o,o,o,o}" "{name,kind,count,mean,p50,p95,p99,max}" _null_ _null_ peloton_metrics _null_ _null_ _null_ ));
+DESCR("statistics: counters and latency histograms of the Peloton engine");
+
 /*
  * Symbolic values for provolatile column: these indicate whether the result
  * of a function is dependent *only* on the values of its explicit arguments,
@@ -394,6 +394,8 @@ typedef struct EState
 	int			es_instrument;	/* OR of InstrumentOption flags */
 	bool		es_finished;	/* true when ExecutorFinish is done */
 
+	char	   *es_peloton_stats;	/* executor stats of a peloton query */
+
 	List	   *es_exprcontexts;	/* List of ExprContexts within EState */
 
 	List	   *es_subplanstates;		/* List of PlanState for SubPlans */
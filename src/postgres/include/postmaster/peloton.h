@@ -29,21 +29,34 @@
 
 extern LoggingType peloton_logging_mode;
 
+extern int peloton_metrics_interval;
+
+extern char *peloton_metrics_file;
+
+namespace peloton {
+namespace bridge {
+class TupleBuffer;
+}
+}
+
 //===--------------------------------------------------------------------===//
 // Peloton_Status     Sent by the peloton to share the status with backend.
 //===--------------------------------------------------------------------===//
 
 typedef struct peloton_status {
   peloton::Result m_result;
-  List *m_result_slots;
+  peloton::bridge::TupleBuffer *m_result_buffer;
 
   // number of tuples processed
   uint32_t m_processed;
 
+  // runtime stats of the executors, if they were instrumented
+  std::string m_executor_stats;
+
   peloton_status(){
     m_processed = 0;
     m_result = peloton::RESULT_SUCCESS;
-    m_result_slots = nullptr;
+    m_result_buffer = nullptr;
   }
 
 } peloton_status;
@@ -70,5 +83,11 @@ extern void peloton_dml(PlanState *planstate,
                         TupleDesc tuple_desc,
                         const char *prepStmtName);
 
+//===--------------------------------------------------------------------===//
+// SQL-callable functions
+//===--------------------------------------------------------------------===//
+
+extern Datum peloton_metrics(PG_FUNCTION_ARGS);
+
 #endif   /* PELOTON_H */
 
@@ -102,7 +102,8 @@ enum config_group
 	// TODO: Peloton Changes
 	PELOTON_LAYOUT_OPTIONS,
 	PELOTON_LOGGING_OPTIONS,
-  PELOTON_CACHING_OPTIONS
+  PELOTON_CACHING_OPTIONS,
+  PELOTON_CONCURRENCY_OPTIONS
 };
 
 /*
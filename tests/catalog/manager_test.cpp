@@ -15,6 +15,7 @@
 #include "harness.h"
 #include "backend/catalog/manager.h"
 #include "backend/catalog/schema.h"
+#include "backend/common/exception.h"
 #include "backend/storage/tile_group.h"
 #include "backend/storage/tile_group_factory.h"
 
@@ -66,5 +67,58 @@ TEST(ManagerTests, TransactionTest) {
   EXPECT_EQ(catalog::Manager::GetInstance().GetCurrentOid(), 800);
 }
 
+void LookupTileGroup() {
+  auto &manager = catalog::Manager::GetInstance();
+
+  std::vector<catalog::Column> columns;
+  catalog::Column column1(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                          "A", true);
+  columns.push_back(column1);
+
+  std::vector<catalog::Schema> schemas;
+  schemas.push_back(catalog::Schema(columns));
+
+  std::map<oid_t, std::pair<oid_t, oid_t>> column_map;
+  column_map[0] = std::make_pair(0, 0);
+
+  for (oid_t tile_group_itr = 0; tile_group_itr < 100; tile_group_itr++) {
+    auto tile_group_id = manager.GetNextOid();
+    std::shared_ptr<storage::TileGroup> tile_group(
+        storage::TileGroupFactory::GetTileGroup(INVALID_OID, INVALID_OID,
+                                                tile_group_id, nullptr, schemas,
+                                                column_map, 3));
+
+    manager.AddTileGroup(tile_group_id, tile_group);
+    EXPECT_EQ(manager.GetTileGroup(tile_group_id).get(), tile_group.get());
+
+    manager.DropTileGroup(tile_group_id);
+    EXPECT_EQ(manager.GetTileGroup(tile_group_id).get(), nullptr);
+  }
+}
+
+TEST(ManagerTests, LocatorTest) {
+  auto &manager = catalog::Manager::GetInstance();
+
+  // Unknown oids, including ones in segments never touched
+  // and ones beyond the directory
+  const oid_t first_oid_out_of_range = (oid_t)1 << 32;
+  for (auto unknown_oid :
+       {INVALID_OID - 1, first_oid_out_of_range, INVALID_OID}) {
+    EXPECT_EQ(manager.GetTileGroup(unknown_oid).get(), nullptr);
+    EXPECT_EQ(manager.GetResidentTileGroup(unknown_oid).get(), nullptr);
+    manager.DropTileGroup(unknown_oid);
+  }
+
+  // The last oid the directory covers
+  EXPECT_EQ(manager.GetTileGroup(first_oid_out_of_range - 1).get(), nullptr);
+
+  // Tile groups beyond the directory are refused
+  std::shared_ptr<storage::TileGroup> tile_group;
+  EXPECT_THROW(manager.AddTileGroup(first_oid_out_of_range, tile_group),
+               CatalogException);
+
+  LaunchParallelTest(8, LookupTileGroup);
+}
+
 }  // End test namespace
 }  // End peloton namespace
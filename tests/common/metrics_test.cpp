@@ -0,0 +1,169 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// metrics_test.cpp
+//
+// Identification: tests/common/metrics_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "harness.h"
+
+#include "backend/common/metrics.h"
+#include "backend/concurrency/transaction_manager.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Metrics Tests
+//===--------------------------------------------------------------------===//
+
+TEST(MetricsTests, CounterTest) {
+  MetricsCounter counter;
+
+  const int thread_count = 8;
+  const int increment_count = 10000;
+
+  std::vector<std::thread> threads;
+  for (int thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+    threads.push_back(std::thread([&counter] {
+      for (int increment_itr = 0; increment_itr < increment_count;
+           increment_itr++) {
+        counter.Increment();
+      }
+      counter.Decrement(10);
+    }));
+  }
+  for (auto &thread : threads) thread.join();
+
+  // Every thread's slot is summed up on read
+  EXPECT_EQ(counter.GetValue(), thread_count * (increment_count - 10));
+
+  counter.Reset();
+  EXPECT_EQ(counter.GetValue(), 0);
+}
+
+TEST(MetricsTests, BucketTest) {
+  // Every value falls into the bucket whose range covers it
+  uint64_t previous_upper_bound = 0;
+  for (size_t bucket_itr = 1; bucket_itr < METRICS_HISTOGRAM_BUCKET_COUNT;
+       bucket_itr++) {
+    uint64_t upper_bound = MetricsHistogram::GetBucketUpperBound(bucket_itr);
+    EXPECT_GT(upper_bound, previous_upper_bound);
+    EXPECT_EQ(MetricsHistogram::GetBucketIndex(previous_upper_bound + 1),
+              bucket_itr);
+    EXPECT_EQ(MetricsHistogram::GetBucketIndex(upper_bound), bucket_itr);
+    previous_upper_bound = upper_bound;
+  }
+
+  // The last bucket ends at the largest value
+  EXPECT_EQ(previous_upper_bound, UINT64_MAX);
+}
+
+TEST(MetricsTests, HistogramTest) {
+  MetricsHistogram histogram;
+
+  for (uint64_t value = 1; value <= 1000; value++) {
+    histogram.Record(value);
+  }
+
+  auto snapshot = histogram.GetSnapshot();
+  EXPECT_EQ((int)snapshot.count, 1000);
+  EXPECT_EQ((int)snapshot.max, 1000);
+  EXPECT_DOUBLE_EQ(snapshot.GetMean(), 500.5);
+
+  // Percentiles are within the relative error of the buckets
+  auto p50 = snapshot.GetValueAtPercentile(50);
+  EXPECT_GE((int)p50, 500);
+  EXPECT_LE((int)p50, 500 + 500 / (int)METRICS_HISTOGRAM_SUB_BUCKET_COUNT);
+
+  auto p99 = snapshot.GetValueAtPercentile(99);
+  EXPECT_GE((int)p99, 990);
+  EXPECT_LE((int)p99, 1000);
+
+  EXPECT_EQ((int)snapshot.GetValueAtPercentile(100), 1000);
+
+  histogram.Reset();
+  EXPECT_EQ((int)histogram.GetSnapshot().count, 0);
+  EXPECT_EQ((int)histogram.GetSnapshot().GetValueAtPercentile(50), 0);
+}
+
+TEST(MetricsTests, RegistryTest) {
+  auto &metrics_registry = MetricsRegistry::GetInstance();
+
+  // Metrics are created once, on first lookup
+  auto counter = metrics_registry.GetCounter("test.counter");
+  EXPECT_EQ(counter, metrics_registry.GetCounter("test.counter"));
+
+  // Heap counters keep their slots on cache line boundaries
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(counter) % METRICS_CACHE_LINE_SIZE,
+            0u);
+
+  auto histogram = metrics_registry.GetHistogram("test.latency");
+  EXPECT_EQ(histogram, metrics_registry.GetHistogram("test.latency"));
+
+  counter->Increment(42);
+  histogram->Record(7);
+
+  bool found_counter = false, found_histogram = false;
+  for (auto &sample : metrics_registry.GetSamples()) {
+    if (sample.name == "test.counter") {
+      EXPECT_EQ(sample.kind, "counter");
+      EXPECT_EQ(sample.count, 42);
+      found_counter = true;
+    } else if (sample.name == "test.latency") {
+      EXPECT_EQ(sample.kind, "histogram");
+      EXPECT_EQ(sample.count, 1);
+      EXPECT_EQ((int)sample.p99, 7);
+      found_histogram = true;
+    }
+  }
+  EXPECT_TRUE(found_counter);
+  EXPECT_TRUE(found_histogram);
+
+  // Dumps are appended to the file
+  std::string file_name = "metrics_test.log";
+  std::remove(file_name.c_str());
+  EXPECT_TRUE(metrics_registry.DumpToFile(file_name));
+
+  std::ifstream file(file_name);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  EXPECT_NE(contents.str().find("test.counter 42"), std::string::npos);
+  EXPECT_NE(contents.str().find("test.latency 1"), std::string::npos);
+  std::remove(file_name.c_str());
+}
+
+TEST(MetricsTests, TransactionTest) {
+  auto &metrics_registry = MetricsRegistry::GetInstance();
+  auto begin_counter = metrics_registry.GetCounter("txn.begin");
+  auto commit_counter = metrics_registry.GetCounter("txn.commit");
+  auto abort_counter = metrics_registry.GetCounter("txn.abort");
+
+  auto begin_count = begin_counter->GetValue();
+  auto commit_count = commit_counter->GetValue();
+  auto abort_count = abort_counter->GetValue();
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  txn_manager.BeginTransaction();
+  txn_manager.CommitTransaction();
+  txn_manager.BeginTransaction();
+  txn_manager.AbortTransaction();
+
+  EXPECT_EQ(begin_counter->GetValue(), begin_count + 2);
+  EXPECT_EQ(commit_counter->GetValue(), commit_count + 1);
+  EXPECT_EQ(abort_counter->GetValue(), abort_count + 1);
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// pool_test.cpp
+//
+// Identification: tests/common/pool_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "harness.h"
+
+#include "backend/common/pool.h"
+#include "backend/common/varlen.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Varlen Pool Tests
+//===--------------------------------------------------------------------===//
+
+TEST(PoolTests, FreeListTest) {
+  VarlenPool pool(BACKEND_TYPE_MM);
+
+  void *block = pool.Allocate(100);
+  EXPECT_GT(pool.GetUsedMemory(), 100);
+
+  // Freed blocks get reused for the same size class
+  pool.Free(block);
+  EXPECT_EQ(0, pool.GetUsedMemory());
+  EXPECT_EQ(block, pool.Allocate(90));
+
+  // Oversize blocks go back right away
+  auto allocated_memory = pool.GetAllocatedMemory();
+  void *oversize_block = pool.Allocate(4 * TEMP_POOL_CHUNK_SIZE);
+  EXPECT_GT(pool.GetAllocatedMemory(), allocated_memory);
+
+  pool.Free(oversize_block);
+  EXPECT_EQ(allocated_memory, pool.GetAllocatedMemory());
+}
+
+TEST(PoolTests, VarlenTest) {
+  VarlenPool pool(BACKEND_TYPE_MM);
+
+  // Overwrite strings many times, the pool should not keep growing
+  const int update_count = 100000;
+  Varlen *varlen = Varlen::Create(256, &pool);
+
+  for (int update_itr = 0; update_itr < update_count; update_itr++) {
+    Varlen *new_varlen = Varlen::Create(256, &pool);
+    ::memset(new_varlen->Get(), update_itr % 128, 256);
+
+    Varlen::Destroy(varlen);
+    varlen = new_varlen;
+  }
+
+  EXPECT_LE(pool.GetAllocatedMemory(), (int64_t)(2 * TEMP_POOL_CHUNK_SIZE));
+
+  Varlen::Destroy(varlen);
+  EXPECT_EQ(0, pool.GetUsedMemory());
+}
+
+TEST(PoolTests, CompactionTest) {
+  VarlenPool pool(BACKEND_TYPE_MM);
+
+  // Fill a few chunks, then free most of the strings
+  const size_t string_length = 1000;
+  std::vector<Varlen *> varlens;
+
+  for (size_t varlen_itr = 0; varlen_itr < 5000; varlen_itr++) {
+    Varlen *varlen = Varlen::Create(string_length, &pool);
+    ::memset(varlen->Get(), varlen_itr % 128, string_length);
+    varlens.push_back(varlen);
+  }
+
+  std::vector<Varlen *> live_varlens;
+  for (size_t varlen_itr = 0; varlen_itr < varlens.size(); varlen_itr++) {
+    if (varlen_itr % 10 == 0) {
+      live_varlens.push_back(varlens[varlen_itr]);
+    } else {
+      Varlen::Destroy(varlens[varlen_itr]);
+    }
+  }
+
+  auto allocated_memory = pool.GetAllocatedMemory();
+  auto used_memory = pool.GetUsedMemory();
+
+  EXPECT_GT(pool.Compact(), 0u);
+  EXPECT_LT(pool.GetAllocatedMemory(), allocated_memory);
+  EXPECT_EQ(used_memory, pool.GetUsedMemory());
+
+  // The surviving strings moved along with their contents
+  for (size_t varlen_itr = 0; varlen_itr < live_varlens.size(); varlen_itr++) {
+    const char *string = live_varlens[varlen_itr]->Get();
+    char expected = (varlen_itr * 10) % 128;
+    EXPECT_EQ(expected, string[0]);
+    EXPECT_EQ(expected, string[string_length - 1]);
+  }
+
+  for (auto varlen : live_varlens) {
+    Varlen::Destroy(varlen);
+  }
+}
+
+TEST(PoolTests, ConcurrentTest) {
+  VarlenPool pool(BACKEND_TYPE_MM);
+
+  const int thread_count = 8;
+  std::vector<std::thread> threads;
+
+  for (int thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+    threads.emplace_back([&pool, thread_itr] {
+      std::vector<Varlen *> varlens;
+      for (int varlen_itr = 0; varlen_itr < 10000; varlen_itr++) {
+        Varlen *varlen = Varlen::Create(16 + varlen_itr % 200, &pool);
+        varlen->Get()[0] = thread_itr;
+        varlens.push_back(varlen);
+      }
+
+      for (auto varlen : varlens) {
+        EXPECT_EQ(thread_itr, varlen->Get()[0]);
+        Varlen::Destroy(varlen);
+      }
+    });
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(0, pool.GetUsedMemory());
+}
+
+}  // End test namespace
+}  // End peloton namespace
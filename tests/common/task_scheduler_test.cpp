@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// task_scheduler_test.cpp
+//
+// Identification: tests/common/task_scheduler_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+#include "harness.h"
+
+#include "backend/common/exception.h"
+#include "backend/common/task_scheduler.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Task Scheduler Tests
+//===--------------------------------------------------------------------===//
+
+TEST(TaskSchedulerTests, MorselTest) {
+  TaskScheduler scheduler(4);
+  EXPECT_EQ((int)scheduler.GetWorkerCount(), 4);
+
+  const oid_t morsel_count = 1000;
+  std::vector<std::atomic<int>> morsel_runs(morsel_count);
+  for (auto &runs : morsel_runs) runs = 0;
+
+  TaskGroup group(scheduler);
+  group.SubmitMorsels(morsel_count, [&](oid_t morsel_id) {
+    morsel_runs[morsel_id]++;
+  });
+  group.Wait();
+
+  // Every morsel ran exactly once
+  for (auto &runs : morsel_runs) {
+    EXPECT_EQ(runs.load(), 1);
+  }
+  EXPECT_EQ((oid_t)group.GetCompletedTaskCount(), morsel_count);
+}
+
+TEST(TaskSchedulerTests, ExceptionTest) {
+  TaskScheduler scheduler(2);
+  std::atomic<int> task_count(0);
+
+  TaskGroup group(scheduler);
+  for (int task_itr = 0; task_itr < 10; task_itr++) {
+    group.Submit([&task_count, task_itr] {
+      task_count++;
+      if (task_itr == 5) throw Exception("task failed");
+    });
+  }
+
+  // The other tasks still run, the failure surfaces in Wait()
+  EXPECT_THROW(group.Wait(), Exception);
+  EXPECT_EQ(task_count.load(), 10);
+
+  // The exception is only reported once
+  group.Wait();
+}
+
+TEST(TaskSchedulerTests, ConcurrentGroupsTest) {
+  TaskScheduler scheduler(4);
+  std::atomic<int> total(0);
+
+  // Several "queries" sharing the same workers
+  auto query = [&scheduler, &total] {
+    std::atomic<int> sum(0);
+
+    TaskGroup group(scheduler);
+    group.SubmitMorsels(100, [&sum](oid_t morsel_id) { sum += morsel_id; });
+    group.Wait();
+
+    EXPECT_EQ(sum.load(), 4950);
+    EXPECT_EQ((int)group.GetCompletedTaskCount(), 100);
+    total += sum;
+  };
+
+  LaunchParallelTest(8, query);
+
+  EXPECT_EQ(total.load(), 8 * 4950);
+}
+
+}  // End test namespace
+}  // End peloton namespace
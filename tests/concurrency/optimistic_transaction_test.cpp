@@ -0,0 +1,188 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// optimistic_transaction_test.cpp
+//
+// Identification: tests/concurrency/optimistic_transaction_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+#include "harness.h"
+#include "backend/common/value_factory.h"
+#include "backend/concurrency/optimistic_transaction_manager.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/executor/executor_context.h"
+#include "backend/executor/logical_tile.h"
+#include "backend/executor/seq_scan_executor.h"
+#include "backend/expression/expression_util.h"
+#include "backend/planner/seq_scan_plan.h"
+#include "backend/storage/data_table.h"
+#include "backend/storage/tile_group.h"
+#include "backend/storage/tile_group_header.h"
+#include "executor/executor_tests_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Optimistic Transaction Tests
+//===--------------------------------------------------------------------===//
+
+void OptimisticTransactionTest(concurrency::TransactionManager *txn_manager) {
+  for (oid_t txn_itr = 1; txn_itr <= 1000; txn_itr++) {
+    txn_manager->BeginTransaction();
+
+    if (txn_itr % 50 != 0) {
+      EXPECT_EQ(txn_manager->CommitTransaction(), Result::RESULT_SUCCESS);
+    } else {
+      txn_manager->AbortTransaction();
+    }
+  }
+}
+
+TEST(OptimisticTransactionTests, TransactionTest) {
+  peloton_concurrency_mode = CONCURRENCY_TYPE_OPTIMISTIC;
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  EXPECT_EQ(&txn_manager,
+            &concurrency::OptimisticTransactionManager::GetInstance());
+
+  LaunchParallelTest(8, OptimisticTransactionTest, &txn_manager);
+
+  peloton_concurrency_mode = CONCURRENCY_TYPE_PESSIMISTIC;
+}
+
+TEST(OptimisticTransactionTests, ValidationTest) {
+  peloton_concurrency_mode = CONCURRENCY_TYPE_OPTIMISTIC;
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  auto tile_group = table->GetTileGroup(0);
+  oid_t tile_group_id = tile_group->GetTileGroupId();
+  auto tile_group_header = tile_group->GetHeader();
+
+  // txn 1 reads tuple 0, and deletes tuple 1
+  auto txn1 = txn_manager.BeginTransaction();
+  EXPECT_TRUE(txn1->IsOptimistic());
+  txn1->RecordReads(tile_group_id, {0});
+  ItemPointer location1(tile_group_id, 1);
+  EXPECT_TRUE(table->DeleteTuple(txn1, location1));
+  txn1->RecordDelete(location1);
+
+  // The delete is not applied before commit
+  EXPECT_EQ(tile_group_header->GetTransactionId(1), INITIAL_TXN_ID);
+
+  // txn 2 deletes tuple 0, and commits first
+  auto txn2 = txn_manager.BeginTransaction();
+  ItemPointer location0(tile_group_id, 0);
+  EXPECT_TRUE(table->DeleteTuple(txn2, location0));
+  txn2->RecordDelete(location0);
+  EXPECT_EQ(txn_manager.CommitTransaction(), Result::RESULT_SUCCESS);
+
+  // txn 1 read a stale tuple
+  concurrency::current_txn = txn1;
+  EXPECT_EQ(txn_manager.CommitTransaction(), Result::RESULT_ABORTED);
+
+  auto txn3 = txn_manager.BeginTransaction();
+  txn_id_t txn_id = txn3->GetTransactionId();
+  cid_t last_cid = txn3->GetLastCommitId();
+  EXPECT_FALSE(tile_group_header->IsVisible(0, txn_id, last_cid));
+  EXPECT_TRUE(tile_group_header->IsVisible(1, txn_id, last_cid));
+
+  // A read-only transaction commits whatever it read
+  txn3->RecordReads(tile_group_id, {0, 1});
+  EXPECT_EQ(txn_manager.CommitTransaction(), Result::RESULT_SUCCESS);
+
+  peloton_concurrency_mode = CONCURRENCY_TYPE_PESSIMISTIC;
+}
+
+TEST(OptimisticTransactionTests, WriteConflictTest) {
+  peloton_concurrency_mode = CONCURRENCY_TYPE_OPTIMISTIC;
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  auto tile_group = table->GetTileGroup(0);
+  oid_t tile_group_id = tile_group->GetTileGroupId();
+  ItemPointer location(tile_group_id, 2);
+
+  // Both transactions delete tuple 2, without latching it
+  auto txn1 = txn_manager.BeginTransaction();
+  EXPECT_TRUE(table->DeleteTuple(txn1, location));
+  txn1->RecordDelete(location);
+
+  auto txn2 = txn_manager.BeginTransaction();
+  EXPECT_TRUE(table->DeleteTuple(txn2, location));
+  txn2->RecordDelete(location);
+
+  // The first one to commit wins
+  EXPECT_EQ(txn_manager.CommitTransaction(), Result::RESULT_SUCCESS);
+
+  concurrency::current_txn = txn1;
+  EXPECT_EQ(txn_manager.CommitTransaction(), Result::RESULT_ABORTED);
+
+  // Later transactions can't delete it either
+  auto txn3 = txn_manager.BeginTransaction();
+  EXPECT_FALSE(table->DeleteTuple(txn3, location));
+  txn_manager.AbortTransaction();
+
+  peloton_concurrency_mode = CONCURRENCY_TYPE_PESSIMISTIC;
+}
+
+TEST(OptimisticTransactionTests, ScanValidationTest) {
+  peloton_concurrency_mode = CONCURRENCY_TYPE_OPTIMISTIC;
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  auto tile_group = table->GetTileGroup(0);
+  oid_t tile_group_id = tile_group->GetTileGroupId();
+
+  // txn 1 deletes tuple 1, then looks for tuple 0 with a scan
+  auto txn1 = txn_manager.BeginTransaction();
+  ItemPointer location1(tile_group_id, 1);
+  EXPECT_TRUE(table->DeleteTuple(txn1, location1));
+  txn1->RecordDelete(location1);
+
+  auto predicate = expression::ComparisonFactory(
+      EXPRESSION_TYPE_COMPARE_EQUAL, expression::TupleValueFactory(0, 0),
+      expression::ConstantValueFactory(ValueFactory::GetIntegerValue(
+          ExecutorTestsUtil::PopulatedValue(0, 0))));
+  planner::SeqScanPlan node(table.get(), predicate, {0});
+  executor::ExecutorContext context(txn1);
+  executor::SeqScanExecutor executor(&node, &context);
+
+  EXPECT_TRUE(executor.Init());
+  EXPECT_TRUE(executor.Execute());
+  std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+  EXPECT_EQ(1u, result_tile->GetTupleCount());
+
+  // The tuples the predicate rejected are read too, but not its own delete
+  auto &read_tuples = txn1->GetReadTuples().at(tile_group_id);
+  EXPECT_EQ(tile_group->GetNextTupleSlot() - 1, read_tuples.size());
+  EXPECT_EQ(read_tuples.end(),
+            std::find(read_tuples.begin(), read_tuples.end(), 1));
+
+  // txn 2 deletes tuple 2, which txn 1 did not select, and commits first
+  auto txn2 = txn_manager.BeginTransaction();
+  ItemPointer location2(tile_group_id, 2);
+  EXPECT_TRUE(table->DeleteTuple(txn2, location2));
+  txn2->RecordDelete(location2);
+  EXPECT_EQ(txn_manager.CommitTransaction(), Result::RESULT_SUCCESS);
+
+  concurrency::current_txn = txn1;
+  EXPECT_EQ(txn_manager.CommitTransaction(), Result::RESULT_ABORTED);
+
+  peloton_concurrency_mode = CONCURRENCY_TYPE_PESSIMISTIC;
+}
+
+}  // End test namespace
+}  // End peloton namespace
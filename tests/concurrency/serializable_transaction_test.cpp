@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// serializable_transaction_test.cpp
+//
+// Identification: tests/concurrency/serializable_transaction_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+#include "harness.h"
+#include "backend/concurrency/serializable_transaction_manager.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/storage/data_table.h"
+#include "backend/storage/tile_group.h"
+#include "backend/storage/tile_group_header.h"
+#include "executor/executor_tests_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Serializable Transaction Tests
+//===--------------------------------------------------------------------===//
+
+void SerializableTransactionTest(concurrency::TransactionManager *txn_manager) {
+  for (oid_t txn_itr = 1; txn_itr <= 1000; txn_itr++) {
+    txn_manager->BeginTransaction();
+
+    if (txn_itr % 50 != 0) {
+      EXPECT_EQ(txn_manager->CommitTransaction(), Result::RESULT_SUCCESS);
+    } else {
+      txn_manager->AbortTransaction();
+    }
+  }
+}
+
+TEST(SerializableTransactionTests, TransactionTest) {
+  peloton_concurrency_mode = CONCURRENCY_TYPE_SERIALIZABLE;
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  EXPECT_EQ(&txn_manager,
+            &concurrency::SerializableTransactionManager::GetInstance());
+
+  LaunchParallelTest(8, SerializableTransactionTest, &txn_manager);
+
+  peloton_concurrency_mode = CONCURRENCY_TYPE_PESSIMISTIC;
+}
+
+TEST(SerializableTransactionTests, WriteSkewTest) {
+  peloton_concurrency_mode = CONCURRENCY_TYPE_SERIALIZABLE;
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  oid_t table_id = table->GetOid();
+  oid_t tile_group_id = table->GetTileGroup(0)->GetTileGroupId();
+  ItemPointer location0(tile_group_id, 0);
+  ItemPointer location1(tile_group_id, 1);
+
+  // Both transactions scan the table, and delete a different tuple
+  auto txn1 = txn_manager.BeginTransaction();
+  EXPECT_TRUE(txn1->IsSerializable());
+  txn1->RecordTableRead(table_id);
+  EXPECT_TRUE(table->DeleteTuple(txn1, location0));
+  txn1->RecordDelete(location0);
+
+  auto txn2 = txn_manager.BeginTransaction();
+  txn2->RecordTableRead(table_id);
+  EXPECT_TRUE(table->DeleteTuple(txn2, location1));
+  txn2->RecordDelete(location1);
+
+  // A read-only transaction overlapping both commits
+  auto txn3 = txn_manager.BeginTransaction();
+  txn3->RecordTileGroupRead(tile_group_id);
+  EXPECT_EQ(txn_manager.CommitTransaction(), Result::RESULT_SUCCESS);
+
+  // txn 2 commits first, it only has an incoming conflict
+  concurrency::current_txn = txn2;
+  EXPECT_EQ(txn_manager.CommitTransaction(), Result::RESULT_SUCCESS);
+
+  // txn 1 would have both
+  concurrency::current_txn = txn1;
+  EXPECT_EQ(txn_manager.CommitTransaction(), Result::RESULT_ABORTED);
+
+  // Its delete was undone
+  auto txn4 = txn_manager.BeginTransaction();
+  auto tile_group_header = table->GetTileGroup(0)->GetHeader();
+  txn_id_t txn_id = txn4->GetTransactionId();
+  cid_t last_cid = txn4->GetLastCommitId();
+  EXPECT_TRUE(tile_group_header->IsVisible(0, txn_id, last_cid));
+  EXPECT_FALSE(tile_group_header->IsVisible(1, txn_id, last_cid));
+  EXPECT_EQ(txn_manager.CommitTransaction(), Result::RESULT_SUCCESS);
+
+  peloton_concurrency_mode = CONCURRENCY_TYPE_PESSIMISTIC;
+}
+
+TEST(SerializableTransactionTests, DisjointFootprintTest) {
+  peloton_concurrency_mode = CONCURRENCY_TYPE_SERIALIZABLE;
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+
+  std::unique_ptr<storage::DataTable> table1(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  std::unique_ptr<storage::DataTable> table2(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  ItemPointer location1(table1->GetTileGroup(0)->GetTileGroupId(), 0);
+  ItemPointer location2(table2->GetTileGroup(0)->GetTileGroupId(), 0);
+
+  // Each transaction reads and writes its own table
+  auto txn1 = txn_manager.BeginTransaction();
+  txn1->RecordTileGroupRead(location1.block);
+  EXPECT_TRUE(table1->DeleteTuple(txn1, location1));
+  txn1->RecordDelete(location1);
+
+  auto txn2 = txn_manager.BeginTransaction();
+  txn2->RecordTileGroupRead(location2.block);
+  EXPECT_TRUE(table2->DeleteTuple(txn2, location2));
+  txn2->RecordDelete(location2);
+
+  EXPECT_EQ(txn_manager.CommitTransaction(), Result::RESULT_SUCCESS);
+
+  concurrency::current_txn = txn1;
+  EXPECT_EQ(txn_manager.CommitTransaction(), Result::RESULT_SUCCESS);
+
+  peloton_concurrency_mode = CONCURRENCY_TYPE_PESSIMISTIC;
+}
+
+}  // End test namespace
+}  // End peloton namespace
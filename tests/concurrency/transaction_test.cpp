@@ -50,5 +50,30 @@ TEST(TransactionTests, TransactionTest) {
   std::cout << "Last Commit Id :: " << txn_manager.GetLastCommitId() << "\n";
 }
 
+TEST(TransactionTests, ReadOnlyTransactionTest) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+
+  txn_manager.BeginTransaction();
+  txn_manager.CommitTransaction();
+  cid_t last_cid = txn_manager.GetLastCommitId();
+
+  // Read-only transactions see the last commit, but don't commit anything
+  auto txn = txn_manager.BeginReadOnlyTransaction();
+  EXPECT_TRUE(txn->IsReadOnly());
+  EXPECT_EQ(txn->GetLastCommitId(), last_cid);
+  EXPECT_EQ(txn->GetCommitId(), INVALID_CID);
+  EXPECT_EQ(concurrency::current_txn, txn);
+
+  txn_manager.EndReadOnlyTransaction();
+  EXPECT_EQ(concurrency::current_txn, nullptr);
+  EXPECT_EQ(txn_manager.GetLastCommitId(), last_cid);
+
+  // Writers don't wait for them
+  auto write_txn = txn_manager.BeginTransaction();
+  EXPECT_FALSE(write_txn->IsReadOnly());
+  txn_manager.CommitTransaction();
+  EXPECT_EQ(txn_manager.GetLastCommitId(), last_cid + 1);
+}
+
 }  // End test namespace
 }  // End peloton namespace
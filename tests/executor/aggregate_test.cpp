@@ -27,9 +27,11 @@
 #include "backend/executor/logical_tile.h"
 #include "backend/executor/aggregate_executor.h"
 #include "backend/executor/logical_tile_factory.h"
+#include "backend/executor/seq_scan_executor.h"
 #include "backend/expression/expression_util.h"
 #include "backend/planner/abstract_plan.h"
 #include "backend/planner/aggregate_plan.h"
+#include "backend/planner/seq_scan_plan.h"
 #include "backend/storage/data_table.h"
 
 #include "executor/executor_tests_util.h"
@@ -762,5 +764,104 @@ TEST(AggregateTests, PlainSumCountDistinctTest) {
                   .IsTrue());
 }
 
+TEST(AggregateTests, PlainSumCountScanPipelineTest) {
+  /*
+   * SELECT SUM(a), COUNT(b) from table WHERE a >= 20
+   * The aggregation runs fused with the scan of the table.
+   */
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuple_count, false));
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(), 3 * tuple_count,
+                                   false, false, false);
+  txn_manager.CommitTransaction();
+
+  // Compute the expected result off the table
+  int64_t expected_sum = 0;
+  int64_t expected_count = 0;
+  for (oid_t tile_group_itr = 0;
+       tile_group_itr < data_table->GetTileGroupCount(); tile_group_itr++) {
+    auto tile_group = data_table->GetTileGroup(tile_group_itr);
+    for (oid_t tuple_itr = 0; tuple_itr < tile_group->GetNextTupleSlot();
+         tuple_itr++) {
+      auto a = ValuePeeker::PeekAsBigInt(tile_group->GetValue(tuple_itr, 0));
+      if (a >= 20) {
+        expected_sum += a;
+        expected_count++;
+      }
+    }
+  }
+
+  // Scan a and b
+  std::vector<oid_t> column_ids = {0, 1};
+  auto scan_predicate = expression::ComparisonFactory(
+      EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+      expression::TupleValueFactory(0, 0),
+      expression::ConstantValueFactory(ValueFactory::GetIntegerValue(20)));
+  planner::SeqScanPlan scan_node(data_table.get(), scan_predicate,
+                                 column_ids);
+
+  // Aggregate
+  std::vector<oid_t> group_by_columns;
+  planner::ProjectInfo::DirectMapList direct_map_list = {{0, {1, 0}},
+                                                         {1, {1, 1}}};
+  auto proj_info = new planner::ProjectInfo(planner::ProjectInfo::TargetList(),
+                                            std::move(direct_map_list));
+
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  planner::AggregatePlan::AggTerm sumA(EXPRESSION_TYPE_AGGREGATE_SUM,
+                                       expression::TupleValueFactory(0, 0),
+                                       false);
+  planner::AggregatePlan::AggTerm countB(EXPRESSION_TYPE_AGGREGATE_COUNT,
+                                         expression::TupleValueFactory(0, 1),
+                                         false);
+  agg_terms.push_back(sumA);
+  agg_terms.push_back(countB);
+
+  auto data_table_schema = data_table.get()->GetSchema();
+  std::vector<catalog::Column> columns;
+  for (auto column_index : column_ids) {
+    columns.push_back(data_table_schema->GetColumn(column_index));
+  }
+  auto output_table_schema = new catalog::Schema(columns);
+
+  planner::AggregatePlan node(proj_info, nullptr, std::move(agg_terms),
+                              std::move(group_by_columns), output_table_schema,
+                              AGGREGATE_TYPE_PLAIN);
+
+  auto txn2 = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn2));
+  context->instrument = true;
+
+  executor::AggregateExecutor executor(&node, context.get());
+  executor::SeqScanExecutor scan_executor(&scan_node, context.get());
+  executor.AddChild(&scan_executor);
+
+  EXPECT_TRUE(executor.Init());
+  EXPECT_TRUE(executor.Execute());
+
+  txn_manager.CommitTransaction();
+
+  std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+  EXPECT_TRUE(result_tile.get() != nullptr);
+  EXPECT_EQ(ValuePeeker::PeekAsBigInt(result_tile->GetValue(0, 0)),
+            expected_sum);
+  EXPECT_EQ(ValuePeeker::PeekAsBigInt(result_tile->GetValue(0, 1)),
+            expected_count);
+
+  // The fused scan keeps its stats although it is never executed,
+  // and the last call finds the table exhausted
+  auto &scan_stats = scan_executor.GetStats();
+  EXPECT_EQ(expected_count, (int64_t)scan_stats.output_tuple_count);
+  EXPECT_GT(scan_stats.output_tile_count, 0u);
+  EXPECT_EQ(scan_stats.output_tile_count + 1, scan_stats.execute_count);
+  EXPECT_GT(scan_stats.wall_time, 0);
+}
+
 }  // namespace test
 }  // namespace peloton
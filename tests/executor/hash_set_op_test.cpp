@@ -15,6 +15,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include "backend/planner/distinct_plan.h"
 #include "backend/planner/set_op_plan.h"
 
 #include "backend/common/types.h"
@@ -385,6 +386,149 @@ TEST(HashSetOptTests, IntersectAllTest) {
 
   RunTest(executor, 2 * (tile_size - 2 * (tile_size * 2 / 5)));
 }
+
+void RunDistinctTest(size_t memory_budget) {
+  // Create the plan node
+  planner::DistinctPlan node(memory_budget);
+
+  // Create and set up executor
+  executor::HashSetOpExecutor executor(&node, nullptr);
+
+  MockExecutor child_executor;
+
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  // Create two tables populated with the same data
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto txn_id = txn->GetTransactionId();
+  size_t tile_size = 10;
+
+  std::unique_ptr<storage::DataTable> data_table1(
+      ExecutorTestsUtil::CreateTable(tile_size));
+  ExecutorTestsUtil::PopulateTable(txn, data_table1.get(), tile_size * 5,
+                                   false, false, false);
+  std::unique_ptr<storage::DataTable> data_table2(
+      ExecutorTestsUtil::CreateTable(tile_size));
+  ExecutorTestsUtil::PopulateTable(txn, data_table2.get(), tile_size * 5,
+                                   false, false, false);
+
+  txn_manager.CommitTransaction();
+
+  // Both tiles hold every tuple, but the second tile misses the first 2/5
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(
+          data_table1->GetTileGroup(0), txn_id));
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile2(
+      executor::LogicalTileFactory::WrapTileGroup(
+          data_table2->GetTileGroup(0), txn_id));
+
+  for (oid_t id = 0; id < tile_size * 2 / 5; id++) {
+    source_logical_tile2->RemoveVisibility(id);
+  }
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()))
+      .WillOnce(Return(source_logical_tile2.release()));
+
+  RunTest(executor, tile_size);
+
+  // Every key but the first one went through a partition
+  if (memory_budget < DEFAULT_OPERATOR_MEMORY_BUDGET) {
+    EXPECT_GT(executor.GetSpilledPartitionCount(), 0u);
+  } else {
+    EXPECT_EQ(executor.GetSpilledPartitionCount(), 0u);
+  }
+}
+
+TEST(HashSetOptTests, DistinctTest) {
+  RunDistinctTest(DEFAULT_OPERATOR_MEMORY_BUDGET);
+}
+
+TEST(HashSetOptTests, DistinctSpillTest) {
+  // Spill right after the first key
+  RunDistinctTest(1);
+}
+
+TEST(HashSetOptTests, IntersectAllSpillTest) {
+  // Create the plan node, spilling right after the first key
+  planner::SetOpPlan node(SETOP_TYPE_INTERSECT_ALL, 1);
+
+  // Create and set up executor
+  executor::HashSetOpExecutor executor(&node, nullptr);
+
+  MockExecutor child_executor1;
+  MockExecutor child_executor2;
+
+  executor.AddChild(&child_executor1);
+  executor.AddChild(&child_executor2);
+
+  EXPECT_CALL(child_executor1, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor2, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor1, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  EXPECT_CALL(child_executor2, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  // Create three tables populated with the same data
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto txn_id = txn->GetTransactionId();
+  size_t tile_size = 10;
+
+  std::vector<std::unique_ptr<storage::DataTable>> data_tables;
+  for (int table_itr = 0; table_itr < 3; table_itr++) {
+    data_tables.emplace_back(ExecutorTestsUtil::CreateTable(tile_size));
+    ExecutorTestsUtil::PopulateTable(txn, data_tables.back().get(),
+                                     tile_size * 5, false, false, false);
+  }
+
+  txn_manager.CommitTransaction();
+
+  // The left child has every tuple twice, minus the first 2/5 once.
+  // The right child has every tuple once, minus the last 2/5.
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(
+          data_tables[0]->GetTileGroup(0), txn_id));
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile2(
+      executor::LogicalTileFactory::WrapTileGroup(
+          data_tables[1]->GetTileGroup(0), txn_id));
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile3(
+      executor::LogicalTileFactory::WrapTileGroup(
+          data_tables[2]->GetTileGroup(0), txn_id));
+
+  for (oid_t id = 0; id < tile_size * 2 / 5; id++) {
+    source_logical_tile1->RemoveVisibility(id);
+    source_logical_tile3->RemoveVisibility(tile_size - 1 - id);
+  }
+
+  EXPECT_CALL(child_executor1, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()))
+      .WillOnce(Return(source_logical_tile2.release()));
+
+  EXPECT_CALL(child_executor2, GetOutput())
+      .WillOnce(Return(source_logical_tile3.release()));
+
+  // Each key of the right child comes out once
+  RunTest(executor, tile_size - tile_size * 2 / 5);
+  EXPECT_GT(executor.GetSpilledPartitionCount(), 0u);
+}
 }
 
 }  // namespace test
@@ -17,6 +17,8 @@
 
 #include "backend/planner/index_scan_plan.h"
 #include "backend/common/types.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/concurrency/transaction_manager.h"
 #include "backend/executor/executor_context.h"
 #include "backend/executor/logical_tile.h"
 #include "backend/executor/logical_tile_factory.h"
@@ -160,5 +162,77 @@ TEST(IndexScanTests, MultiColumnPredicateTest) {
   txn_manager.CommitTransaction();
 }
 
+// Count the tuples returned by an index scan, -1 if it fails to initialize
+int GetIndexScanTupleCount(planner::IndexScanPlan &node) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::IndexScanExecutor executor(&node, context.get());
+  int tuple_count = -1;
+
+  if (executor.Init()) {
+    tuple_count = 0;
+    while (executor.Execute()) {
+      std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+      tuple_count += result_tile->GetTupleCount();
+    }
+  }
+
+  txn_manager.CommitTransaction();
+  return tuple_count;
+}
+
+// Index scan as of the commit before a delete
+TEST(IndexScanTests, TimeTravelTest) {
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  cid_t before_delete_cid = txn_manager.GetLastCommitId();
+
+  // Delete the first two tuples
+  auto txn = txn_manager.BeginTransaction();
+  oid_t tile_group_id = data_table->GetTileGroup(0)->GetTileGroupId();
+  for (oid_t tuple_id = 0; tuple_id < 2; tuple_id++) {
+    ItemPointer location(tile_group_id, tuple_id);
+    EXPECT_TRUE(data_table->DeleteTuple(txn, location));
+    txn->RecordDelete(location);
+  }
+  txn_manager.CommitTransaction();
+
+  //===--------------------------------------------------------------------===//
+  // ATTR 0 <= 110
+  //===--------------------------------------------------------------------===//
+
+  std::vector<oid_t> column_ids({0, 1, 3});
+  std::vector<expression::AbstractExpression *> runtime_keys;
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      data_table->GetIndex(0), {0},
+      {ExpressionType::EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO},
+      {ValueFactory::GetIntegerValue(110)}, runtime_keys);
+
+  planner::IndexScanPlan node(data_table.get(), nullptr, column_ids,
+                              index_scan_desc);
+
+  EXPECT_EQ(GetIndexScanTupleCount(node), 10);
+
+  // The deleted versions are still there
+  node.SetAsOfCommitId(before_delete_cid);
+  EXPECT_EQ(GetIndexScanTupleCount(node), 12);
+
+  // Nothing was committed that late
+  node.SetAsOfCommitId(txn_manager.GetLastCommitId() + 1);
+  EXPECT_EQ(GetIndexScanTupleCount(node), -1);
+
+  // Nor retained that early
+  int version_retention = peloton_version_retention;
+  peloton_version_retention = 0;
+  node.SetAsOfCommitId(before_delete_cid);
+  EXPECT_EQ(GetIndexScanTupleCount(node), -1);
+  peloton_version_retention = version_retention;
+}
+
 }  // namespace test
 }  // namespace peloton
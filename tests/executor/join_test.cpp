@@ -75,7 +75,10 @@ void ExecuteJoinTest(PlanNodeType join_algorithm, PelotonJoinType join_type, oid
 oid_t CountTuplesWithNullFields(executor::LogicalTile *logical_tile);
 
 enum JOIN_TEST_TYPE {
-  BASIC_TEST = 0
+  BASIC_TEST = 0,
+
+  // Same as BASIC_TEST, with the build side of hash joins spilled
+  SPILL_TEST = 1
 };
 
 TEST(JoinTests, JoinPredicateTest) {
@@ -106,6 +109,18 @@ TEST(JoinTests, JoinPredicateTest) {
 
 }
 
+TEST(JoinTests, HashJoinSpillTest) {
+
+  // Go over all join types
+  for (auto join_type : join_types) {
+    std::cout << "JOIN TYPE :: " << join_type << "\n";
+
+    // Execute the join test
+    ExecuteJoinTest(PLAN_NODE_TYPE_HASHJOIN, join_type, SPILL_TEST);
+  }
+
+}
+
 void ExecuteJoinTest(PlanNodeType join_algorithm, PelotonJoinType join_type, oid_t join_test_type) {
   //===--------------------------------------------------------------------===//
   // Mock table scan executors
@@ -173,7 +188,7 @@ void ExecuteJoinTest(PlanNodeType join_algorithm, PelotonJoinType join_type, oid
   // Setup left table
   //===--------------------------------------------------------------------===//
 
-  if(join_test_type == BASIC_TEST) {
+  if(join_test_type == BASIC_TEST || join_test_type == SPILL_TEST) {
 
     EXPECT_CALL(left_table_scan_executor, DExecute())
         .WillOnce(Return(true))
@@ -196,7 +211,7 @@ void ExecuteJoinTest(PlanNodeType join_algorithm, PelotonJoinType join_type, oid
   // Setup right table
   //===--------------------------------------------------------------------===//
 
-  if(join_test_type == BASIC_TEST) {
+  if(join_test_type == BASIC_TEST || join_test_type == SPILL_TEST) {
 
     EXPECT_CALL(right_table_scan_executor, DExecute())
          .WillOnce(Return(true))
@@ -294,8 +309,10 @@ void ExecuteJoinTest(PlanNodeType join_algorithm, PelotonJoinType join_type, oid
           hash_keys;
       hash_keys.emplace_back(right_table_attr_1);
 
-      // Create hash plan node
-      planner::HashPlan hash_plan_node(hash_keys);
+      // Create hash plan node, with no memory to spare when spilling
+      size_t memory_budget = DEFAULT_OPERATOR_MEMORY_BUDGET;
+      if (join_test_type == SPILL_TEST) memory_budget = 1;
+      planner::HashPlan hash_plan_node(hash_keys, memory_budget);
 
       // Construct the hash executor
       executor::HashExecutor hash_executor(&hash_plan_node, nullptr);
@@ -328,6 +345,10 @@ void ExecuteJoinTest(PlanNodeType join_algorithm, PelotonJoinType join_type, oid
         }
       }
 
+      if (join_test_type == SPILL_TEST) {
+        EXPECT_GT(hash_executor.GetSpilledPartitionCount(), 0u);
+      }
+
     } break;
 
     default:
@@ -340,7 +361,7 @@ void ExecuteJoinTest(PlanNodeType join_algorithm, PelotonJoinType join_type, oid
   // Execute test
   //===--------------------------------------------------------------------===//
 
-  if(join_test_type == BASIC_TEST) {
+  if(join_test_type == BASIC_TEST || join_test_type == SPILL_TEST) {
 
     // Check output
     switch (join_type) {
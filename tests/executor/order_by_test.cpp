@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <memory>
 #include <set>
 #include <string>
@@ -21,6 +22,7 @@
 #include "backend/planner/order_by_plan.h"
 #include "backend/common/types.h"
 #include "backend/common/value.h"
+#include "backend/common/value_peeker.h"
 #include "backend/executor/executor_context.h"
 #include "backend/executor/logical_tile.h"
 #include "backend/executor/order_by_executor.h"
@@ -325,6 +327,143 @@ TEST(OrderByTests, StringDescIntAscTest) {
 
   RunTest(executor, tile_size * 2, sort_keys, descend_flags);
 }
+
+TEST(OrderByTests, IntAscTopNTest) {
+  // Create the plan node
+  std::vector<oid_t> sort_keys({1});
+  std::vector<bool> descend_flags({false});
+  std::vector<oid_t> output_columns({0, 1, 2, 3});
+  planner::OrderByPlan node(sort_keys, descend_flags, output_columns);
+
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(nullptr));
+
+  // Create and set up executor, the parent only wants the first few tuples
+  const size_t limit = 5;
+  executor::OrderByExecutor executor(&node, context.get());
+  executor.SetLimitHint(limit);
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  // Create a table and wrap it in logical tile
+  size_t tile_size = 20;
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto txn_id = txn->GetTransactionId();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tile_size));
+  bool random = true;
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(), tile_size * 2, false,
+                                   random, false);
+  txn_manager.CommitTransaction();
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0),
+                                                  txn_id));
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile2(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(1),
+                                                  txn_id));
+
+  // Smallest sort keys, computed the slow way
+  std::vector<int32_t> expected_keys;
+  for (auto tile : {source_logical_tile1.get(), source_logical_tile2.get()}) {
+    for (oid_t tuple_id : *tile) {
+      expected_keys.push_back(
+          ValuePeeker::PeekAsInteger(tile->GetValue(tuple_id, 1)));
+    }
+  }
+  std::sort(expected_keys.begin(), expected_keys.end());
+  expected_keys.resize(limit);
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()))
+      .WillOnce(Return(source_logical_tile2.release()));
+
+  EXPECT_TRUE(executor.Init());
+
+  std::vector<int32_t> result_keys;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    for (oid_t tuple_id : *result_tile) {
+      result_keys.push_back(
+          ValuePeeker::PeekAsInteger(result_tile->GetValue(tuple_id, 1)));
+    }
+  }
+
+  EXPECT_EQ(expected_keys, result_keys);
+}
+
+TEST(OrderByTests, InstrumentedTest) {
+  // Create the plan node
+  std::vector<oid_t> sort_keys({1});
+  std::vector<bool> descend_flags({false});
+  std::vector<oid_t> output_columns({0, 1, 2, 3});
+  planner::OrderByPlan node(sort_keys, descend_flags, output_columns);
+
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(nullptr));
+  context->instrument = true;
+
+  // Create and set up executor
+  executor::OrderByExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  // Create a table and wrap it in logical tile
+  size_t tile_size = 20;
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto txn_id = txn->GetTransactionId();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tile_size));
+  bool random = true;
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(), tile_size * 2, false,
+                                   random, false);
+  txn_manager.CommitTransaction();
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0),
+                                                  txn_id));
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile2(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(1),
+                                                  txn_id));
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()))
+      .WillOnce(Return(source_logical_tile2.release()));
+
+  EXPECT_TRUE(executor.Init());
+
+  size_t tile_count = 0;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    tile_count++;
+  }
+
+  // The last call returns nothing
+  auto &stats = executor.GetStats();
+  EXPECT_EQ(tile_count + 1, stats.execute_count);
+  EXPECT_EQ(tile_count, stats.output_tile_count);
+  EXPECT_EQ(tile_size * 2, stats.output_tuple_count);
+  EXPECT_GT(stats.wall_time, 0);
+  EXPECT_GT(stats.peak_memory_usage, 0u);
+}
 }
 
 }  // namespace test
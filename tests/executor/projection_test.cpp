@@ -245,5 +245,85 @@ TEST(ProjectionTests, BasicTargetTest) {
   RunTest(executor, 1);
 }
 
+TEST(ProjectionTests, PassThroughTest) {
+  MockExecutor child_executor;
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  size_t tile_size = 5;
+
+  // Create a table and wrap it in logical tile
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto txn_id = txn->GetTransactionId();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tile_size));
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(), tile_size, false,
+                                   false, false);
+  txn_manager.CommitTransaction();
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0),
+                                                  txn_id));
+
+  // Drop the second row
+  source_logical_tile1->RemoveVisibility(1);
+  auto source_base_tile = source_logical_tile1->GetBaseTile(1);
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()));
+
+  // SELECT B, A + 20
+  std::vector<catalog::Column> columns;
+  auto orig_schema = data_table.get()->GetSchema();
+  columns.push_back(orig_schema->GetColumn(1));
+  columns.push_back(orig_schema->GetColumn(0));
+  auto schema = new catalog::Schema(columns);
+
+  planner::ProjectInfo::DirectMapList direct_map_list = {{0, {0, 1}}};
+
+  planner::ProjectInfo::TargetList target_list;
+  expression::AbstractExpression *expr = expression::OperatorFactory(
+      EXPRESSION_TYPE_OPERATOR_PLUS, expression::TupleValueFactory(0, 0),
+      new expression::ConstantValueExpression(
+          ValueFactory::GetIntegerValue(20)));
+  target_list.push_back(std::make_pair(1, expr));
+
+  auto project_info = new planner::ProjectInfo(std::move(target_list),
+                                               std::move(direct_map_list));
+
+  planner::ProjectionPlan node(project_info, schema);
+
+  executor::ProjectionExecutor executor(&node, nullptr);
+  executor.AddChild(&child_executor);
+
+  EXPECT_TRUE(executor.Init());
+  EXPECT_TRUE(executor.Execute());
+  std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+  EXPECT_FALSE(executor.Execute());
+
+  // The direct map still points to the table's tile
+  EXPECT_EQ(result_tile->GetBaseTile(0), source_base_tile);
+  EXPECT_EQ(result_tile->GetTupleCount(), tile_size - 1);
+
+  auto tile_group = data_table->GetTileGroup(0);
+  oid_t new_tuple_id = 0;
+  for (oid_t old_tuple_id = 0; old_tuple_id < tile_size; old_tuple_id++) {
+    if (old_tuple_id == 1) continue;
+
+    EXPECT_TRUE(result_tile->GetValue(new_tuple_id, 0)
+                    .OpEquals(tile_group->GetValue(old_tuple_id, 1))
+                    .IsTrue());
+    EXPECT_TRUE(result_tile->GetValue(new_tuple_id, 1)
+                    .OpEquals(tile_group->GetValue(old_tuple_id, 0).OpAdd(
+                        ValueFactory::GetIntegerValue(20)))
+                    .IsTrue());
+    new_tuple_id++;
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -25,6 +25,8 @@
 #include "backend/expression/tuple_value_expression.h"
 #include "backend/expression/comparison_expression.h"
 #include "backend/expression/conjunction_expression.h"
+#include "backend/expression/expression_program.h"
+#include "backend/expression/expression_util.h"
 #include "backend/expression/vector_expression.h"
 
 namespace peloton {
@@ -402,5 +404,95 @@ TEST(ExpressionTest, SimpleInFilter) {
   delete tuple;
 }
 
+TEST(ExpressionTest, ProgramConstantFolding) {
+  // (1 + 4) * 5
+  std::unique_ptr<expression::AbstractExpression> expr(
+      expression::OperatorFactory(
+          EXPRESSION_TYPE_OPERATOR_MULTIPLY,
+          expression::OperatorFactory(
+              EXPRESSION_TYPE_OPERATOR_PLUS,
+              expression::ConstantValueFactory(
+                  ValueFactory::GetIntegerValue(1)),
+              expression::ConstantValueFactory(
+                  ValueFactory::GetIntegerValue(4))),
+          expression::ConstantValueFactory(ValueFactory::GetIntegerValue(5))));
+
+  expression::ExpressionProgram program(expr.get());
+  std::cout << program.GetInfo();
+
+  EXPECT_TRUE(program.IsConstant(0));
+  EXPECT_EQ(program.GetInstructionCount(), 0u);
+  EXPECT_EQ(ValuePeeker::PeekAsBigInt(
+                program.Evaluate(nullptr, nullptr, nullptr)),
+            25LL);
+}
+
+TEST(ExpressionTest, ProgramEvaluation) {
+  // WHERE (A + B) > 10 AND (A + B) < 100
+  auto sum = [] {
+    return expression::OperatorFactory(EXPRESSION_TYPE_OPERATOR_PLUS,
+                                       expression::TupleValueFactory(0, 0),
+                                       expression::TupleValueFactory(0, 1));
+  };
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      expression::ConjunctionFactory(
+          EXPRESSION_TYPE_CONJUNCTION_AND,
+          expression::ComparisonFactory(
+              EXPRESSION_TYPE_COMPARE_GREATERTHAN, sum(),
+              expression::ConstantValueFactory(
+                  ValueFactory::GetIntegerValue(10))),
+          expression::ComparisonFactory(
+              EXPRESSION_TYPE_COMPARE_LESSTHAN, sum(),
+              expression::ConstantValueFactory(
+                  ValueFactory::GetIntegerValue(100)))));
+  std::unique_ptr<expression::AbstractExpression> projection(
+      expression::OperatorFactory(
+          EXPRESSION_TYPE_OPERATOR_MULTIPLY, sum(),
+          expression::ConstantValueFactory(ValueFactory::GetIntegerValue(2))));
+
+  // Both expressions share the sum, and it is computed once
+  expression::ExpressionProgram program({predicate.get(), projection.get()});
+  std::cout << program.GetInfo();
+
+  // 2 loads, add, compare, move, jump, compare, and, multiply
+  EXPECT_EQ(program.GetInstructionCount(), 9u);
+  EXPECT_EQ(program.GetResultCount(), 2u);
+
+  std::vector<catalog::Column> columns;
+  catalog::Column column1(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                          "A", true);
+  catalog::Column column2(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                          "B", true);
+  columns.push_back(column1);
+  columns.push_back(column2);
+  std::unique_ptr<catalog::Schema> schema(new catalog::Schema(columns));
+  std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema.get(), true));
+
+  // Registers are reused over all the rows, like in a scan
+  expression::ExpressionProgram::Registers registers(program);
+  std::vector<std::pair<int, int>> rows = {
+      {1, 2}, {5, 6}, {50, 49}, {50, 50}, {-1, 0}, {INT32_MIN, 3}};
+
+  for (auto row : rows) {
+    // INT32_MIN is the null integer
+    tuple->SetValue(0, ValueFactory::GetIntegerValue(row.first), nullptr);
+    tuple->SetValue(1, ValueFactory::GetIntegerValue(row.second), nullptr);
+
+    program.Run(registers, tuple.get(), nullptr, nullptr);
+
+    Value expected = predicate->Evaluate(tuple.get(), nullptr, nullptr);
+    const Value &result = program.GetResult(registers, 0);
+    EXPECT_EQ(expected.IsNull(), result.IsNull());
+    EXPECT_EQ(expected.IsTrue(), result.IsTrue());
+
+    expected = projection->Evaluate(tuple.get(), nullptr, nullptr);
+    EXPECT_EQ(expected.IsNull(), program.GetResult(registers, 1).IsNull());
+    if (expected.IsNull() == false) {
+      EXPECT_EQ(ValuePeeker::PeekAsBigInt(expected),
+                ValuePeeker::PeekAsBigInt(program.GetResult(registers, 1)));
+    }
+  }
+}
+
 }  // End test namespace
 }  // End peloton namespace
@@ -290,5 +290,38 @@ TEST(IndexTests, MultiThreadedInsertTest) {
   delete tuple_schema;
 }
 
+TEST(IndexTests, ScanTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer> locations;
+
+  // INDEX
+  std::unique_ptr<index::Index> index(BuildIndex());
+  InsertTest(index.get(), pool, 1);
+
+  // Equality on the whole key starts at the key, not at the first entry,
+  // which would end the scan right away
+  locations = index->Scan(
+      {ValueFactory::GetIntegerValue(100), ValueFactory::GetStringValue("b")},
+      {0, 1}, {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_EQUAL},
+      SCAN_DIRECTION_TYPE_FORWARD);
+  EXPECT_EQ(locations.size(), 5u);
+
+  locations = index->Scan(
+      {ValueFactory::GetIntegerValue(400), ValueFactory::GetStringValue("d")},
+      {0, 1}, {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_EQUAL},
+      SCAN_DIRECTION_TYPE_FORWARD);
+  EXPECT_EQ(locations.size(), 1u);
+  EXPECT_EQ(locations[0].block, item1.block);
+  EXPECT_EQ(locations[0].offset, item1.offset);
+
+  // Equality on the leading column only
+  locations = index->Scan({ValueFactory::GetIntegerValue(100)}, {0},
+                          {EXPRESSION_TYPE_COMPARE_EQUAL},
+                          SCAN_DIRECTION_TYPE_FORWARD);
+  EXPECT_EQ(locations.size(), 7u);
+
+  delete tuple_schema;
+}
+
 }  // End test namespace
 }  // End peloton namespace
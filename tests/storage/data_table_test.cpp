@@ -12,8 +12,13 @@
 
 #include "gtest/gtest.h"
 
+#include "backend/common/value_peeker.h"
+#include "backend/concurrency/transaction.h"
 #include "backend/storage/data_table.h"
+#include "backend/storage/eviction_manager.h"
 #include "backend/storage/tile_group.h"
+#include "backend/storage/tuple.h"
+#include "harness.h"
 #include "executor/executor_tests_util.h"
 
 namespace peloton {
@@ -67,5 +72,152 @@ TEST(DataTableTests, TransformTileGroupTest) {
   data_table->TransformTileGroup(0, theta);
 }
 
+TEST(DataTableTests, BulkInsertTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP * 2 + 2;
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, true));
+
+  std::vector<std::unique_ptr<storage::Tuple>> tuples;
+  std::vector<const storage::Tuple *> batch;
+  for (int tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    tuples.emplace_back(
+        ExecutorTestsUtil::GetTuple(data_table.get(), tuple_itr, testing_pool));
+    batch.push_back(tuples.back().get());
+  }
+
+  // Load the batch, spilling over into new tile groups
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::vector<ItemPointer> locations;
+  EXPECT_TRUE(data_table->InsertTuples(txn, batch, locations));
+  EXPECT_EQ(tuple_count, (int)locations.size());
+  for (auto location : locations) txn->RecordInsert(location);
+  txn_manager.CommitTransaction();
+
+  EXPECT_EQ(3, (int)data_table->GetTileGroupCount());
+
+  // Check that the columns landed in the claimed slots
+  for (int tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    auto location = locations[tuple_itr];
+    auto tile_group = data_table->GetTileGroupById(location.block);
+    auto value = tile_group->GetValue(location.offset, 0);
+    EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(tuple_itr, 0),
+              ValuePeeker::PeekAsInteger(value));
+  }
+
+  // Loading the same keys again violates the primary key
+  txn = txn_manager.BeginTransaction();
+  locations.clear();
+  EXPECT_FALSE(data_table->InsertTuples(txn, batch, locations));
+  for (auto location : locations) txn->RecordInsert(location);
+  txn_manager.AbortTransaction();
+}
+
+TEST(DataTableTests, EvictionTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuple_count, false));
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(), tuple_count * 3,
+                                   false, false, false);
+  txn_manager.CommitTransaction();
+
+  auto &eviction_manager = storage::EvictionManager::GetInstance();
+  oid_t tile_group_count = data_table->GetTileGroupCount();
+  EXPECT_GE((int)tile_group_count, 3);
+
+  // The tile groups were just loaded, so they are not cold yet
+  EXPECT_EQ(0, (int)eviction_manager.EvictColdTileGroups(data_table.get()));
+
+  // Nobody touched them during the last epoch, but a tile group someone
+  // holds on to stays in memory
+  auto held_tile_group = data_table->GetTileGroup(1);
+  auto held_tile_group_id = held_tile_group->GetTileGroupId();
+  EXPECT_EQ(tile_group_count - 2,
+            eviction_manager.EvictColdTileGroups(data_table.get(), 0));
+  EXPECT_FALSE(eviction_manager.IsEvicted(held_tile_group_id));
+  held_tile_group.reset();
+
+  EXPECT_TRUE(eviction_manager.EvictTileGroup(held_tile_group_id));
+  EXPECT_GT((int)eviction_manager.GetEvictedSize(), 0);
+
+  // The tail of the table takes inserts, so passes leave it alone
+  auto tail_tile_group_id = data_table->GetTileGroupId(tile_group_count - 1);
+  EXPECT_FALSE(eviction_manager.IsEvicted(tail_tile_group_id));
+
+  // Fetch the second tile group in the background
+  auto prefetched_tile_group_id = data_table->GetTileGroupId(1);
+  EXPECT_TRUE(eviction_manager.IsEvicted(prefetched_tile_group_id));
+  eviction_manager.Prefetch(prefetched_tile_group_id);
+  eviction_manager.WaitForPrefetches();
+  EXPECT_FALSE(eviction_manager.IsEvicted(prefetched_tile_group_id));
+
+  // A lookup faults the others back in, along with their strings
+  for (int tuple_itr = 0; tuple_itr < tuple_count * 3; tuple_itr++) {
+    auto tile_group = data_table->GetTileGroup(tuple_itr / tuple_count);
+    oid_t tuple_offset = tuple_itr % tuple_count;
+
+    auto value = tile_group->GetValue(tuple_offset, 0);
+    EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(tuple_itr, 0),
+              ValuePeeker::PeekAsInteger(value));
+
+    value = tile_group->GetValue(tuple_offset, 3);
+    EXPECT_EQ(std::to_string(ExecutorTestsUtil::PopulatedValue(tuple_itr, 3)),
+              ValuePeeker::PeekStringCopyWithoutNull(value));
+  }
+  EXPECT_EQ(0, (int)eviction_manager.GetEvictedTileGroupCount());
+
+  // Dropping the table drops the evicted copies
+  EXPECT_TRUE(eviction_manager.EvictTileGroup(data_table->GetTileGroupId(0)));
+  data_table.reset();
+  EXPECT_EQ(0, (int)eviction_manager.GetEvictedTileGroupCount());
+  EXPECT_EQ(0, (int)eviction_manager.GetEvictedSize());
+}
+
+TEST(DataTableTests, EvictionBudgetTest) {
+  // Tile groups well over a kilobyte each
+  const int tuple_count = 100;
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto &eviction_manager = storage::EvictionManager::GetInstance();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuple_count, false));
+
+  auto txn = txn_manager.BeginTransaction();
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(), tuple_count * 3,
+                                   false, false, false);
+  txn_manager.CommitTransaction();
+  EXPECT_EQ(0, (int)eviction_manager.GetEvictedTileGroupCount());
+
+  // Way over budget, every new tile group runs a pass, and the committed
+  // tile groups go cold after two of them
+  peloton_eviction_budget = 1;
+
+  txn = txn_manager.BeginTransaction();
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(), tuple_count * 3,
+                                   false, false, false);
+  txn_manager.CommitTransaction();
+
+  peloton_eviction_budget = 0;
+
+  EXPECT_GE((int)eviction_manager.GetEvictedTileGroupCount(), 3);
+  for (oid_t tile_group_itr = 0; tile_group_itr < 3; tile_group_itr++) {
+    EXPECT_TRUE(eviction_manager.IsEvicted(
+        data_table->GetTileGroupId(tile_group_itr)));
+  }
+
+  // Evicted tuples fault back in
+  auto value = data_table->GetTileGroup(0)->GetValue(0, 0);
+  EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(0, 0),
+            ValuePeeker::PeekAsInteger(value));
+
+  data_table.reset();
+  EXPECT_EQ(0, (int)eviction_manager.GetEvictedTileGroupCount());
+}
+
 }  // End test namespace
 }  // End peloton namespace
@@ -10,8 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <unistd.h>
+
 #include "gtest/gtest.h"
 #include "backend/storage/storage_manager.h"
+#include "backend/storage/slab_allocator.h"
 
 namespace peloton {
 namespace test {
@@ -51,5 +54,90 @@ TEST(StorageManagerTests, BasicTest) {
   }
 }
 
+TEST(StorageManagerTests, SlabAllocatorTest) {
+  std::string file_name = "/tmp/peloton_slab_allocator_test.pmem";
+  unlink(file_name.c_str());
+
+  size_t allocated_size;
+
+  {
+    storage::SlabAllocator allocator(file_name, SLAB_SEGMENT_SIZE);
+    EXPECT_EQ(1u, allocator.GetSegmentCount());
+
+    // Small blocks
+    auto first = allocator.Allocate(100);
+    auto second = allocator.Allocate(100);
+    EXPECT_NE(first, second);
+    memset(first, '-', 100);
+    memset(second, '-', 100);
+
+    // Freed blocks get reused
+    allocator.Release(first);
+    EXPECT_EQ(first, allocator.Allocate(120));
+
+    // Large runs, more than a segment can hold
+    std::vector<void *> runs;
+    for (int run_itr = 0; run_itr < 40; run_itr++) {
+      auto run = allocator.Allocate(2 * SLAB_SIZE);
+      EXPECT_NE(nullptr, run);
+      memset(run, '-', 2 * SLAB_SIZE);
+      runs.push_back(run);
+    }
+    EXPECT_EQ(2u, allocator.GetSegmentCount());
+
+    for (int run_itr = 0; run_itr < 40; run_itr += 2) {
+      allocator.Release(runs[run_itr]);
+    }
+
+    allocated_size = allocator.GetAllocatedSize();
+    EXPECT_EQ(20 * 2 * SLAB_SIZE + 2 * 128u, allocated_size);
+  }
+
+  // Reopen the data file
+  {
+    storage::SlabAllocator allocator(file_name, SLAB_SEGMENT_SIZE);
+    EXPECT_EQ(2u, allocator.GetSegmentCount());
+    EXPECT_EQ(allocated_size, allocator.GetAllocatedSize());
+
+    auto block = allocator.Allocate(100);
+    EXPECT_NE(nullptr, block);
+    allocator.Release(block);
+    EXPECT_EQ(allocated_size, allocator.GetAllocatedSize());
+  }
+
+  unlink(file_name.c_str());
+}
+
+TEST(StorageManagerTests, SlabAllocatorRestartTest) {
+  std::string file_name = "/tmp/peloton_slab_allocator_restart_test.pmem";
+  unlink(file_name.c_str());
+
+  const size_t run_size = 40 * 2 * SLAB_SIZE + 100 * 128u;
+
+  // Every run fills up more than a segment
+  for (int restart_itr = 0; restart_itr < 4; restart_itr++) {
+    storage::SlabAllocator allocator(file_name, SLAB_SEGMENT_SIZE);
+
+    // Nothing refers to the blocks of the last run anymore
+    if (restart_itr > 0) {
+      EXPECT_EQ(run_size, allocator.GetAllocatedSize());
+      EXPECT_EQ(run_size, allocator.ReleaseRecovered());
+    }
+    EXPECT_EQ(0u, allocator.GetAllocatedSize());
+
+    for (int run_itr = 0; run_itr < 40; run_itr++) {
+      EXPECT_NE(nullptr, allocator.Allocate(2 * SLAB_SIZE));
+    }
+    for (int block_itr = 0; block_itr < 100; block_itr++) {
+      EXPECT_NE(nullptr, allocator.Allocate(100));
+    }
+
+    // The data file doesn't grow across restarts
+    EXPECT_EQ(2u, allocator.GetSegmentCount());
+  }
+
+  unlink(file_name.c_str());
+}
+
 }  // End test namespace
 }  // End peloton namespace
@@ -0,0 +1,201 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// table_stats_test.cpp
+//
+// Identification: tests/storage/table_stats_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "backend/common/hyperloglog.h"
+#include "backend/common/value_factory.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/storage/data_table.h"
+#include "backend/storage/table_stats.h"
+#include "harness.h"
+#include "executor/executor_tests_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Table Stats Tests
+//===--------------------------------------------------------------------===//
+
+static void PopulateTable(storage::DataTable *table, int tuple_count,
+                          bool group_by) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  ExecutorTestsUtil::PopulateTable(txn, table, tuple_count, false, false,
+                                   group_by);
+  txn_manager.CommitTransaction();
+}
+
+TEST(TableStatsTests, HyperLogLogTest) {
+  HyperLogLog small_sketch;
+  for (int value_itr = 0; value_itr < 100; value_itr++) {
+    small_sketch.AddValue(ValueFactory::GetIntegerValue(value_itr % 50));
+  }
+  EXPECT_NEAR(small_sketch.Estimate(), 50, 1);
+
+  // Sketches of overlapping ranges merge into a sketch of their union
+  HyperLogLog first_sketch, second_sketch;
+  for (int value_itr = 0; value_itr < 100000; value_itr++) {
+    first_sketch.AddValue(ValueFactory::GetBigIntValue(value_itr));
+    second_sketch.AddValue(ValueFactory::GetBigIntValue(value_itr + 50000));
+  }
+  EXPECT_NEAR(first_sketch.Estimate(), 100000, 5000);
+
+  first_sketch.Merge(second_sketch);
+  EXPECT_NEAR(first_sketch.Estimate(), 150000, 7500);
+
+  first_sketch.Reset();
+  EXPECT_EQ(first_sketch.Estimate(), 0);
+}
+
+TEST(TableStatsTests, ColumnStatsTest) {
+  const int tuple_count = 1000;
+
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(100, false));
+  PopulateTable(data_table.get(), tuple_count, true);
+
+  auto table_stats = data_table->GetTableStats();
+  EXPECT_EQ(table_stats->GetSnapshot(), nullptr);
+  EXPECT_TRUE(table_stats->IsStale());
+
+  table_stats->Rebuild();
+  EXPECT_FALSE(table_stats->IsStale());
+
+  auto stats = table_stats->GetSnapshot();
+  EXPECT_EQ((int)stats->tuple_count, tuple_count);
+  EXPECT_EQ((int)stats->columns.size(), 4);
+
+  // First column has two values, each in half of the tuples
+  auto &group_column = stats->columns[0];
+  EXPECT_EQ(group_column.null_fraction, 0);
+  EXPECT_NEAR(group_column.distinct_count, 2, 0.1);
+  EXPECT_EQ(group_column.average_width, sizeof(int32_t));
+  EXPECT_EQ((int)group_column.most_common_values.size(), 2);
+  for (auto frequency : group_column.most_common_frequencies) {
+    EXPECT_DOUBLE_EQ(frequency, 0.5);
+  }
+  EXPECT_TRUE(group_column.histogram_bounds.empty());
+
+  // Second column is unique, so it only gets a histogram
+  auto &unique_column = stats->columns[1];
+  EXPECT_NEAR(unique_column.distinct_count, tuple_count, 0.05 * tuple_count);
+  EXPECT_TRUE(unique_column.most_common_values.empty());
+
+  auto &bounds = unique_column.histogram_bounds;
+  EXPECT_EQ((int)bounds.size(),
+            (int)storage::TABLE_STATS_HISTOGRAM_BUCKET_COUNT + 1);
+  EXPECT_EQ(bounds.front(), ValueFactory::GetIntegerValue(
+                                ExecutorTestsUtil::PopulatedValue(0, 1)));
+  EXPECT_EQ(bounds.back(),
+            ValueFactory::GetIntegerValue(
+                ExecutorTestsUtil::PopulatedValue(tuple_count - 1, 1)));
+  for (size_t bound_itr = 1; bound_itr < bounds.size(); bound_itr++) {
+    EXPECT_LT(bounds[bound_itr - 1].Compare(bounds[bound_itr]), 0);
+  }
+
+  // String values outlive the tile groups they were sampled from
+  // (and sort lexicographically)
+  auto &string_column = stats->columns[3];
+  EXPECT_GT(string_column.average_width, 0);
+  EXPECT_FALSE(string_column.histogram_bounds.empty());
+  data_table.reset();
+  EXPECT_EQ(string_column.histogram_bounds.front(),
+            ValueFactory::GetStringValue(
+                std::to_string(ExecutorTestsUtil::PopulatedValue(100, 3))));
+}
+
+TEST(TableStatsTests, IncrementalRefreshTest) {
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(100, false));
+  auto table_stats = data_table->GetTableStats();
+
+  PopulateTable(data_table.get(), 250, false);
+  table_stats->Refresh();
+
+  auto stats = table_stats->GetSnapshot();
+  EXPECT_EQ((int)stats->tuple_count, 250);
+  EXPECT_EQ((int)stats->tile_group_count, 3);
+  EXPECT_FALSE(table_stats->IsStale());
+
+  // The full tile groups are folded in, the new ones get scanned
+  PopulateTable(data_table.get(), 250, false);
+  EXPECT_TRUE(table_stats->IsStale());
+  table_stats->Refresh();
+
+  stats = table_stats->GetSnapshot();
+  EXPECT_EQ((int)stats->tuple_count, 500);
+  EXPECT_EQ((int)stats->tile_group_count, 5);
+
+  // The same values were inserted twice, none is more common than another
+  auto &column_stats = stats->columns[1];
+  EXPECT_NEAR(column_stats.distinct_count, 250, 0.05 * 250);
+  EXPECT_TRUE(column_stats.most_common_values.empty());
+  EXPECT_EQ((int)column_stats.histogram_bounds.size(),
+            (int)storage::TABLE_STATS_HISTOGRAM_BUCKET_COUNT + 1);
+
+  // A rebuild agrees with the incremental refreshes
+  table_stats->Rebuild();
+  auto rebuilt_stats = table_stats->GetSnapshot();
+  EXPECT_EQ(rebuilt_stats->tuple_count, stats->tuple_count);
+  EXPECT_EQ(rebuilt_stats->columns[1].distinct_count,
+            stats->columns[1].distinct_count);
+}
+
+TEST(TableStatsTests, StaleTest) {
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(100, false));
+  auto table_stats = data_table->GetTableStats();
+
+  PopulateTable(data_table.get(), 250, false);
+  table_stats->Refresh();
+  EXPECT_FALSE(table_stats->IsStale());
+
+  // A new tile group alone doesn't call for a refresh
+  PopulateTable(data_table.get(), 60, false);
+  EXPECT_GT(data_table->GetTileGroupCount(),
+            table_stats->GetSnapshot()->tile_group_count);
+  EXPECT_FALSE(table_stats->IsStale());
+
+  // Enough new tuples do
+  PopulateTable(data_table.get(), 60, false);
+  EXPECT_TRUE(table_stats->IsStale());
+}
+
+TEST(TableStatsTests, SampleTest) {
+  // Enough tuples for the sample to be thinned out
+  const int tuple_count = 2 * storage::TABLE_STATS_SAMPLE_SIZE + 10000;
+
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(1000, false));
+  PopulateTable(data_table.get(), tuple_count, true);
+
+  auto table_stats = data_table->GetTableStats();
+  table_stats->Refresh();
+
+  // Counts are exact, frequencies are estimated from the sample
+  auto stats = table_stats->GetSnapshot();
+  EXPECT_EQ((int)stats->tuple_count, tuple_count);
+
+  auto &column_stats = stats->columns[0];
+  EXPECT_EQ((int)column_stats.most_common_values.size(), 2);
+  for (auto frequency : column_stats.most_common_frequencies) {
+    EXPECT_NEAR(frequency, 0.5, 0.02);
+  }
+
+  EXPECT_NEAR(stats->columns[1].distinct_count, tuple_count,
+              0.05 * tuple_count);
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -14,6 +14,7 @@
 #include "harness.h"
 
 #include "backend/common/value_factory.h"
+#include "backend/common/value_peeker.h"
 #include "backend/concurrency/transaction.h"
 #include "backend/storage/tile_group.h"
 #include "backend/storage/tile_group_factory.h"
@@ -21,6 +22,7 @@
 #include "backend/storage/tuple.h"
 #include "backend/storage/tile_group.h"
 #include "backend/storage/tile_group_header.h"
+#include "backend/storage/zone_map.h"
 
 namespace peloton {
 namespace test {
@@ -327,6 +329,153 @@ TEST(TileGroupTests, MVCCInsert) {
   delete schema2;
 }
 
+TEST(TileGroupTests, ZoneMapTest) {
+  std::vector<catalog::Column> columns;
+  std::vector<catalog::Schema> schemas;
+
+  // SCHEMA
+  catalog::Column column1(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                          "A", true);
+  catalog::Column column2(VALUE_TYPE_VARCHAR, 50, "B", false);
+
+  columns.push_back(column1);
+  columns.push_back(column2);
+
+  catalog::Schema *schema = new catalog::Schema(columns);
+  schemas.push_back(*schema);
+
+  // TILE GROUP
+  std::map<oid_t, std::pair<oid_t, oid_t>> column_map;
+  column_map[0] = std::make_pair(0, 0);
+  column_map[1] = std::make_pair(0, 1);
+
+  storage::TileGroup *tile_group = storage::TileGroupFactory::GetTileGroup(
+      INVALID_OID, INVALID_OID, INVALID_OID, nullptr, schemas, column_map, 5);
+  auto zone_map = tile_group->GetZoneMap();
+  auto pool = tile_group->GetTilePool(0);
+
+  EXPECT_TRUE(zone_map->IsTracked(0));
+  EXPECT_FALSE(zone_map->IsTracked(1));
+  EXPECT_FALSE(zone_map->HasRange(0));
+
+  txn_id_t txn_id = 100;
+  storage::Tuple *tuple = new storage::Tuple(schema, true);
+  tuple->SetValue(1, ValueFactory::GetStringValue("abc"), pool);
+
+  for (int value : {20, 10, 30}) {
+    tuple->SetValue(0, ValueFactory::GetIntegerValue(value), pool);
+    tile_group->InsertTuple(txn_id, tuple);
+  }
+
+  tuple->SetValue(0, ValueFactory::GetNullValueByType(VALUE_TYPE_INTEGER),
+                  pool);
+  tile_group->InsertTuple(txn_id, tuple);
+
+  EXPECT_TRUE(zone_map->HasRange(0));
+  EXPECT_EQ(10, ValuePeeker::PeekAsInteger(zone_map->GetMin(0)));
+  EXPECT_EQ(30, ValuePeeker::PeekAsInteger(zone_map->GetMax(0)));
+  EXPECT_EQ(1u, zone_map->GetNullCount(0));
+
+  // Pruning
+  auto value = ValueFactory::GetIntegerValue(30);
+  EXPECT_TRUE(zone_map->CanSkip(0, EXPRESSION_TYPE_COMPARE_GREATERTHAN, value));
+  EXPECT_FALSE(zone_map->CanSkip(
+      0, EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO, value));
+  EXPECT_FALSE(zone_map->CanSkip(0, EXPRESSION_TYPE_COMPARE_EQUAL, value));
+
+  value = ValueFactory::GetBigIntValue(5);
+  EXPECT_TRUE(zone_map->CanSkip(0, EXPRESSION_TYPE_COMPARE_EQUAL, value));
+  EXPECT_TRUE(zone_map->CanSkip(0, EXPRESSION_TYPE_COMPARE_LESSTHAN, value));
+  EXPECT_FALSE(zone_map->CanSkip(0, EXPRESSION_TYPE_COMPARE_NOTEQUAL, value));
+
+  // Untracked column
+  EXPECT_FALSE(zone_map->CanSkip(1, EXPRESSION_TYPE_COMPARE_EQUAL, value));
+
+  // Aborted inserts are dropped on rebuild
+  tile_group->AbortInsertedTuple(2);
+  tile_group->RebuildZoneMap();
+
+  EXPECT_EQ(10, ValuePeeker::PeekAsInteger(zone_map->GetMin(0)));
+  EXPECT_EQ(20, ValuePeeker::PeekAsInteger(zone_map->GetMax(0)));
+  EXPECT_EQ(1u, zone_map->GetNullCount(0));
+
+  delete tuple;
+  delete tile_group;
+  delete schema;
+}
+
+TEST(TileGroupTests, ColumnAccessorTest) {
+  std::vector<catalog::Column> columns;
+  std::vector<catalog::Schema> schemas;
+
+  // SCHEMA
+  catalog::Column column1(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                          "A", true);
+  catalog::Column column2(VALUE_TYPE_BIGINT, GetTypeSize(VALUE_TYPE_BIGINT),
+                          "B", true);
+  catalog::Column column3(VALUE_TYPE_VARCHAR, 50, "C", false);
+
+  columns.push_back(column1);
+  columns.push_back(column2);
+  columns.push_back(column3);
+  catalog::Schema *schema = new catalog::Schema(columns);
+
+  // Two tiles : <B, A> and <C>
+  schemas.push_back(catalog::Schema({column2, column1}));
+  schemas.push_back(catalog::Schema({column3}));
+
+  std::map<oid_t, std::pair<oid_t, oid_t>> column_map;
+  column_map[0] = std::make_pair(0, 1);
+  column_map[1] = std::make_pair(0, 0);
+  column_map[2] = std::make_pair(1, 0);
+
+  storage::TileGroup *tile_group = storage::TileGroupFactory::GetTileGroup(
+      INVALID_OID, INVALID_OID, INVALID_OID, nullptr, schemas, column_map, 4);
+
+  txn_id_t txn_id = 100;
+  storage::Tuple *tuple = new storage::Tuple(schema, true);
+  auto pool = tile_group->GetTilePool(1);
+
+  for (int tuple_itr = 0; tuple_itr < 3; tuple_itr++) {
+    tuple->SetValue(0, ValueFactory::GetIntegerValue(tuple_itr), pool);
+    tuple->SetValue(1, ValueFactory::GetBigIntValue(tuple_itr * 10), pool);
+    tuple->SetValue(2, ValueFactory::GetStringValue("abc"), pool);
+    tile_group->InsertTuple(txn_id, tuple);
+  }
+
+  // Flattened column map
+  oid_t tile_offset, tile_column_offset;
+  tile_group->LocateTileAndColumn(0, tile_offset, tile_column_offset);
+  EXPECT_EQ(0u, tile_offset);
+  EXPECT_EQ(1u, tile_column_offset);
+  EXPECT_EQ(1u, tile_group->GetTileIdFromColumnId(2));
+  EXPECT_EQ(0u, tile_group->GetTileColumnId(2));
+
+  auto &int_accessor = tile_group->GetColumnAccessor(0);
+  auto &bigint_accessor = tile_group->GetColumnAccessor(1);
+  auto &varchar_accessor = tile_group->GetColumnAccessor(2);
+
+  EXPECT_EQ(tile_group->GetTile(0), int_accessor.tile);
+  EXPECT_EQ(tile_group->GetTile(1), varchar_accessor.tile);
+  EXPECT_EQ(VALUE_TYPE_INTEGER, int_accessor.column_type);
+  EXPECT_FALSE(varchar_accessor.is_inlined);
+
+  for (int tuple_itr = 0; tuple_itr < 3; tuple_itr++) {
+    EXPECT_EQ(tuple_itr, int_accessor.GetFixedLengthValue<int32_t>(tuple_itr));
+    EXPECT_EQ(tuple_itr * 10,
+              bigint_accessor.GetFixedLengthValue<int64_t>(tuple_itr));
+    EXPECT_EQ(tuple_itr,
+              ValuePeeker::PeekAsInteger(tile_group->GetValue(tuple_itr, 0)));
+
+    auto value = varchar_accessor.GetValue(tuple_itr);
+    EXPECT_EQ(0, value.Compare(ValueFactory::GetStringValue("abc")));
+  }
+
+  delete tuple;
+  delete tile_group;
+  delete schema;
+}
+
 TEST(TileGroupTests, TileCopyTest) {
   std::vector<catalog::Column> columns;
   std::vector<std::string> tile_column_names;
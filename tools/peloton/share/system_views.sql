@@ -663,6 +663,18 @@ CREATE VIEW pg_stat_ssl AS
             S.sslclientdn AS clientdn
     FROM pg_stat_get_activity(NULL) AS S;
 
+CREATE VIEW pg_stat_peloton_metrics AS
+    SELECT
+            M.name,
+            M.kind,
+            M.count,
+            M.mean,
+            M.p50,
+            M.p95,
+            M.p99,
+            M.max
+    FROM peloton_metrics() AS M;
+
 CREATE VIEW pg_replication_slots AS
     SELECT
             L.slot_name,